@@ -0,0 +1,65 @@
+#ifndef CommonTools_MVAUtils_FlatGBRForest_h
+#define CommonTools_MVAUtils_FlatGBRForest_h
+
+//--------------------------------------------------------------------------------------------------
+//
+// FlatGBRForest
+//
+// A GBRForest compiled into a single array of nodes, to be built once from the forest of the
+// conditions (or of the weights file) and evaluated many times. The two daughters of a node are
+// next to each other, so that going down a tree is a load of the node and an index increment
+// without branches, and the trees are walked for a fixed number of steps, with the leaves pointing
+// to themselves. The batch evaluation walks each tree for several vectors in lock-step, so that
+// their memory accesses overlap.
+//
+// The responses are identical to those of GBRForest::GetResponse: the same cuts are applied, and
+// the responses of the trees are added in double precision in the same order.
+//
+//--------------------------------------------------------------------------------------------------
+
+#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class FlatGBRForest {
+public:
+  explicit FlatGBRForest(const GBRForest& forest);
+
+  double GetResponse(const float* vector) const;
+  // as GBRForest::GetGradBoostClassifier, between -1 and 1
+  double GetGradBoostClassifier(const float* vector) const {
+    double response = GetResponse(vector);
+    return 2.0 / (1.0 + std::exp(-2.0 * response)) - 1;
+  }
+  double GetClassifier(const float* vector) const { return GetGradBoostClassifier(vector); }
+
+  // Responses of nVectors vectors, the i-th starting at vectors[i * stride]
+  void GetResponses(const float* vectors, size_t nVectors, size_t stride, double* responses) const;
+
+  size_t nTrees() const { return trees_.size(); }
+  size_t nNodes() const { return nodes_.size(); }
+
+private:
+  struct Node {
+    float cut;      // +infinity for the leaves, so that they point to themselves
+    uint32_t left;  // the right daughter follows the left one
+    uint32_t variable;
+    float response;  // only for the leaves
+  };
+
+  struct Tree {
+    uint32_t root;
+    uint32_t depth;
+  };
+
+  void addTree(const GBRTree& tree);
+
+  double initialResponse_;
+  std::vector<Node> nodes_;
+  std::vector<Tree> trees_;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "CommonTools/MVAUtils/interface/FlatGBRForest.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+namespace {
+  // number of vectors going down a tree together in GetResponses
+  constexpr size_t kBlockSize = 8;
+}  // namespace
+
+FlatGBRForest::FlatGBRForest(const GBRForest& forest) : initialResponse_(forest.InitialResponse()) {
+  trees_.reserve(forest.Trees().size());
+  for (auto const& tree : forest.Trees()) {
+    addTree(tree);
+  }
+}
+
+void FlatGBRForest::addTree(const GBRTree& tree) {
+  auto const& cutIndices = tree.CutIndices();
+  auto const& cutVals = tree.CutVals();
+  auto const& leftIndices = tree.LeftIndices();
+  auto const& rightIndices = tree.RightIndices();
+  auto const& responses = tree.Responses();
+
+  // Copy the tree breadth-first. A node of the GBRTree is an intermediate one if its index is
+  // positive, or the root, and a leaf with response -index otherwise; every node is placed where
+  // its parent expects it, and the daughters of an intermediate node are appended as a pair.
+  struct Pending {
+    int index;
+    uint32_t position;
+    uint32_t depth;
+  };
+  uint32_t const root = nodes_.size();
+  uint32_t depth = 0;
+  nodes_.emplace_back();
+  std::deque<Pending> pending{{0, root, 0}};
+  while (not pending.empty()) {
+    Pending const node = pending.front();
+    pending.pop_front();
+    if (node.index > 0 or node.position == root) {
+      unsigned int const i = node.index;
+      if (i >= cutIndices.size() or node.depth > cutIndices.size()) {
+        throw cms::Exception("FlatGBRForest") << "Invalid GBRTree: node " << i << " of " << cutIndices.size()
+                                              << " intermediate nodes reached at depth " << node.depth << "\n";
+      }
+      uint32_t const left = nodes_.size();
+      if (left > std::numeric_limits<uint32_t>::max() - 2) {
+        throw cms::Exception("FlatGBRForest") << "Too many nodes in the GBRForest\n";
+      }
+      nodes_[node.position] = Node{cutVals[i], left, cutIndices[i], 0.f};
+      nodes_.resize(left + 2);
+      pending.push_back({leftIndices[i], left, node.depth + 1});
+      pending.push_back({rightIndices[i], left + 1, node.depth + 1});
+    } else {
+      unsigned int const i = -node.index;
+      if (i >= responses.size()) {
+        throw cms::Exception("FlatGBRForest")
+            << "Invalid GBRTree: leaf " << i << " of " << responses.size() << " terminal nodes\n";
+      }
+      nodes_[node.position] = Node{std::numeric_limits<float>::infinity(), node.position, 0, responses[i]};
+      depth = std::max(depth, node.depth);
+    }
+  }
+  trees_.push_back(Tree{root, depth});
+}
+
+double FlatGBRForest::GetResponse(const float* vector) const {
+  double response = initialResponse_;
+  for (auto const& tree : trees_) {
+    uint32_t index = tree.root;
+    for (uint32_t step = 0; step < tree.depth; ++step) {
+      Node const& node = nodes_[index];
+      index = node.left + (vector[node.variable] > node.cut);
+    }
+    response += nodes_[index].response;
+  }
+  return response;
+}
+
+void FlatGBRForest::GetResponses(const float* vectors, size_t nVectors, size_t stride, double* responses) const {
+  std::fill(responses, responses + nVectors, initialResponse_);
+  for (size_t first = 0; first < nVectors; first += kBlockSize) {
+    size_t const size = std::min(kBlockSize, nVectors - first);
+    float const* block = vectors + first * stride;
+    double* blockResponses = responses + first;
+    // the trees in the outer loop, to keep the order of the sums of GetResponse for each vector
+    for (auto const& tree : trees_) {
+      uint32_t index[kBlockSize];
+      std::fill(index, index + kBlockSize, tree.root);
+      for (uint32_t step = 0; step < tree.depth; ++step) {
+        for (size_t k = 0; k < size; ++k) {
+          Node const& node = nodes_[index[k]];
+          index[k] = node.left + (block[k * stride + node.variable] > node.cut);
+        }
+      }
+      for (size_t k = 0; k < size; ++k) {
+        blockResponses[k] += nodes_[index[k]].response;
+      }
+    }
+  }
+}
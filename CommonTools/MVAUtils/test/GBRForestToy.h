@@ -0,0 +1,116 @@
+#ifndef CommonTools_MVAUtils_GBRForestToy_h
+#define CommonTools_MVAUtils_GBRForestToy_h
+
+// Toy GBRForest for the tests and the benchmark of FlatGBRForest: a TMVA BDTG regression with random
+// trees read with createGBRForest, and input vectors with random values, values on and just above the
+// cuts of the forest, and a few NaNs.
+
+#include "CondFormats/EgammaObjects/interface/GBRForest.h"
+#include "CommonTools/MVAUtils/interface/GBRForestTools.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace gbrForestToy {
+
+  constexpr int kVariables = 6;
+
+  // A node of a TMVA BDTG tree, a leaf with a probability growing with its depth
+  inline void writeNode(std::ostream& out, std::mt19937& rng, char pos, int depth, int maxDepth) {
+    std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+    std::uniform_int_distribution<int> variable(0, kVariables - 1);
+    out << "<Node pos=\"" << pos << "\" depth=\"" << depth << "\" NCoef=\"0\" ";
+    if (depth == maxDepth or (depth > 0 and uniform(rng) < -1.f + 0.25f * depth)) {
+      out << "IVar=\"-1\" Cut=\"0\" cType=\"1\" res=\"" << uniform(rng) << "\"/>\n";
+      return;
+    }
+    out << "IVar=\"" << variable(rng) << "\" Cut=\"" << uniform(rng) << "\" cType=\"" << (uniform(rng) > -0.5f)
+        << "\" res=\"0\">\n";
+    writeNode(out, rng, 'l', depth + 1, maxDepth);
+    writeNode(out, rng, 'r', depth + 1, maxDepth);
+    out << "</Node>\n";
+  }
+
+  // A regression trained with a recent ROOT release, whose cuts are adjusted when they are read;
+  // the first tree is a single leaf, the others go down to maxDepth
+  inline void writeWeightsFile(std::string const& name, unsigned int nTrees, int maxDepth) {
+    std::mt19937 rng(13579);
+    std::ofstream out(name);
+    out << std::setprecision(9);
+    out << "<?xml version=\"1.0\"?>\n<MethodSetup Method=\"BDT::BDTG\">\n<GeneralInfo>\n"
+        << "<Info name=\"ROOT Release\" value=\"6.10/09 [395785]\"/>\n"
+        << "<Info name=\"AnalysisType\" value=\"Regression\"/>\n</GeneralInfo>\n"
+        << "<Options>\n<Option name=\"BoostType\" modified=\"Yes\">Grad</Option>\n</Options>\n"
+        << "<Variables NVar=\"" << kVariables << "\">\n";
+    for (int i = 0; i < kVariables; ++i) {
+      out << "<Variable VarIndex=\"" << i << "\" Expression=\"x" << i << "\"/>\n";
+    }
+    out << "</Variables>\n<Weights NTrees=\"" << nTrees << "\" AnalysisType=\"1\">\n";
+    for (unsigned int itree = 0; itree < nTrees; ++itree) {
+      out << "<BinaryTree type=\"DecisionTree\" boostWeight=\"" << (itree == 0 ? 0.25 : 1.) << "\" itree=\"" << itree
+          << "\">\n";
+      writeNode(out, rng, 's', 0, itree == 0 ? 0 : maxDepth);
+      out << "</BinaryTree>\n";
+    }
+    out << "</Weights>\n</MethodSetup>\n";
+  }
+
+  inline std::unique_ptr<const GBRForest> makeForest(unsigned int nTrees, int maxDepth) {
+    char name[] = "/tmp/testFlatGBRForestXXXXXX.xml";
+    int fd = mkstemps(name, 4);
+    if (fd < 0) {
+      throw std::runtime_error("cannot create a temporary weights file");
+    }
+    close(fd);
+    writeWeightsFile(name, nTrees, maxDepth);
+    auto forest = createGBRForest(std::string(name));
+    std::remove(name);
+    return forest;
+  }
+
+  // nVectors vectors, the i-th starting at i * stride, padded with NaNs
+  inline std::vector<float> makeVectors(GBRForest const& forest, size_t nVectors, size_t stride) {
+    std::vector<std::vector<float>> cuts(kVariables);
+    for (auto const& tree : forest.Trees()) {
+      for (size_t i = 0; i < tree.CutIndices().size(); ++i) {
+        cuts[tree.CutIndices()[i]].push_back(tree.CutVals()[i]);
+      }
+    }
+
+    std::mt19937 rng(24680);
+    std::uniform_real_distribution<float> uniform(-1.2f, 1.2f);
+    std::uniform_int_distribution<int> kind(0, 9);
+    std::vector<float> vectors(nVectors * stride, std::numeric_limits<float>::quiet_NaN());
+    for (size_t i = 0; i < nVectors; ++i) {
+      for (int j = 0; j < kVariables; ++j) {
+        float& value = vectors[i * stride + j];
+        int const k = kind(rng);
+        if (k < 6 or cuts[j].empty()) {
+          value = uniform(rng);
+        } else if (k < 9) {
+          value = cuts[j][std::uniform_int_distribution<size_t>(0, cuts[j].size() - 1)(rng)];
+          if (k == 8) {
+            value = std::nextafter(value, std::numeric_limits<float>::max());
+          }
+        } else if (i % 7 == 0) {
+          value = std::numeric_limits<float>::quiet_NaN();
+        } else {
+          value = uniform(rng);
+        }
+      }
+    }
+    return vectors;
+  }
+}  // namespace gbrForestToy
+
+#endif
@@ -0,0 +1,64 @@
+// Time of the evaluation of a GBRForest per input vector, with GBRForest::GetResponse, and with
+// FlatGBRForest::GetResponse and FlatGBRForest::GetResponses, on the toy forests of GBRForestToy.h.
+// The arguments are the number of trees, of at most 8 levels, and the number of different vectors:
+// evaluating the same vector again and again would let the branches of GBRForest be predicted.
+
+#include <benchmark/benchmark.h>
+#include "CommonTools/MVAUtils/interface/FlatGBRForest.h"
+#include "CommonTools/MVAUtils/test/GBRForestToy.h"
+
+#include <vector>
+
+namespace {
+  constexpr size_t kStride = gbrForestToy::kVariables;
+}  // namespace
+
+static void BM_GBRForest_GetResponse(benchmark::State& state) {
+  auto forest = gbrForestToy::makeForest(state.range(0), 8);
+  std::vector<float> const vectors = gbrForestToy::makeVectors(*forest, state.range(1), kStride);
+  std::vector<double> responses(state.range(1));
+  for (auto _ : state) {
+    for (size_t i = 0; i < responses.size(); ++i)
+      responses[i] = forest->GetResponse(&vectors[i * kStride]);
+    benchmark::DoNotOptimize(responses.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(responses.size()));
+}
+BENCHMARK(BM_GBRForest_GetResponse)->ArgsProduct({{100, 400, 1600}, {16, 1024}});
+
+static void BM_FlatGBRForest_GetResponse(benchmark::State& state) {
+  auto forest = gbrForestToy::makeForest(state.range(0), 8);
+  FlatGBRForest const flat(*forest);
+  std::vector<float> const vectors = gbrForestToy::makeVectors(*forest, state.range(1), kStride);
+  std::vector<double> responses(state.range(1));
+  for (auto _ : state) {
+    for (size_t i = 0; i < responses.size(); ++i)
+      responses[i] = flat.GetResponse(&vectors[i * kStride]);
+    benchmark::DoNotOptimize(responses.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(responses.size()));
+}
+BENCHMARK(BM_FlatGBRForest_GetResponse)->ArgsProduct({{100, 400, 1600}, {16, 1024}});
+
+static void BM_FlatGBRForest_GetResponses(benchmark::State& state) {
+  auto forest = gbrForestToy::makeForest(state.range(0), 8);
+  FlatGBRForest const flat(*forest);
+  std::vector<float> const vectors = gbrForestToy::makeVectors(*forest, state.range(1), kStride);
+  std::vector<double> responses(state.range(1));
+  for (auto _ : state) {
+    flat.GetResponses(vectors.data(), responses.size(), kStride, responses.data());
+    benchmark::DoNotOptimize(responses.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(responses.size()));
+}
+BENCHMARK(BM_FlatGBRForest_GetResponses)->ArgsProduct({{100, 400, 1600}, {16, 1024}});
+
+// the construction, once per forest of the conditions
+static void BM_FlatGBRForest_build(benchmark::State& state) {
+  auto forest = gbrForestToy::makeForest(state.range(0), 8);
+  for (auto _ : state) {
+    FlatGBRForest const flat(*forest);
+    benchmark::DoNotOptimize(flat.nNodes());
+  }
+}
+BENCHMARK(BM_FlatGBRForest_build)->Arg(100)->Arg(400)->Arg(1600);
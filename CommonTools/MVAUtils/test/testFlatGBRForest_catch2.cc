@@ -0,0 +1,50 @@
+#include "CommonTools/MVAUtils/interface/FlatGBRForest.h"
+#include "CommonTools/MVAUtils/test/GBRForestToy.h"
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace {
+  using gbrForestToy::kVariables;
+  constexpr unsigned int kTrees = 200;
+  // the vectors are padded, to check the stride of the batch evaluation
+  constexpr size_t kStride = kVariables + 1;
+}  // namespace
+
+TEST_CASE("FlatGBRForest responses", "[FlatGBRForest]") {
+  auto forest = gbrForestToy::makeForest(kTrees, 8);
+  REQUIRE(forest->Trees().size() == kTrees);
+  FlatGBRForest const flat(*forest);
+  REQUIRE(flat.nTrees() == kTrees);
+
+  // not a multiple of the number of vectors evaluated together
+  size_t const nVectors = 1003;
+  std::vector<float> const vectors = gbrForestToy::makeVectors(*forest, nVectors, kStride);
+
+  SECTION("GetResponse") {
+    for (size_t i = 0; i < nVectors; ++i) {
+      float const* vector = &vectors[i * kStride];
+      REQUIRE(flat.GetResponse(vector) == forest->GetResponse(vector));
+    }
+  }
+
+  SECTION("GetClassifier") {
+    for (size_t i = 0; i < nVectors; ++i) {
+      float const* vector = &vectors[i * kStride];
+      REQUIRE(flat.GetClassifier(vector) == forest->GetClassifier(vector));
+    }
+  }
+
+  SECTION("GetResponses") {
+    for (size_t n : {size_t(1), size_t(8), size_t(13), nVectors}) {
+      std::vector<double> responses(n);
+      flat.GetResponses(vectors.data(), n, kStride, responses.data());
+      for (size_t i = 0; i < n; ++i) {
+        REQUIRE(responses[i] == forest->GetResponse(&vectors[i * kStride]));
+      }
+    }
+  }
+}
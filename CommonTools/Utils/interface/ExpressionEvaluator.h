@@ -16,8 +16,12 @@ namespace reco {
       return reinterpret_cast<factoryP*>(m_expr)();
     }
 
+    // handle of the loaded library; the expression stays valid as long as it is not dlclose'd
+    void* library() const { return m_library; }
+
   private:
     std::string m_name;
+    void* m_library = nullptr;
     void* m_expr;
   };
 
@@ -10,17 +10,28 @@
 #include "CommonTools/Utils/src/SelectorPtr.h"
 #include "CommonTools/Utils/src/SelectorBase.h"
 #include "CommonTools/Utils/interface/cutParser.h"
+#include "CommonTools/Utils/interface/expressionCompiler.h"
 #include "FWCore/Reflection/interface/ObjectWithDict.h"
 
+// If jitPackage is given, and its src/precompile.h provides the declaration of T,
+// the cut is also compiled into native code (see expressionCompiler.h), which is
+// then used instead of the interpreter.
 template <typename T, bool DefaultLazyness = false>
 struct StringCutObjectSelector {
-  StringCutObjectSelector(const std::string &cut, bool lazy = DefaultLazyness) : type_(typeid(T)) {
+  StringCutObjectSelector(const std::string &cut, bool lazy = DefaultLazyness, const char *jitPackage = nullptr)
+      : type_(typeid(T)) {
     if (!reco::parser::cutParser<T>(cut, select_, lazy)) {
       throw edm::Exception(edm::errors::Configuration, "failed to parse \"" + cut + "\"");
     }
+    if (jitPackage != nullptr) {
+      compiled_ = reco::parser::compileCut<T>(cut, jitPackage);
+    }
   }
   StringCutObjectSelector(const reco::parser::SelectorPtr &select) : select_(select), type_(typeid(T)) {}
   bool operator()(const T &t) const {
+    if (compiled_) {
+      return compiled_->eval(t);
+    }
     edm::ObjectWithDict o(type_, const_cast<T *>(&t));
     return (*select_)(o);
   }
@@ -28,6 +39,7 @@ struct StringCutObjectSelector {
 private:
   reco::parser::SelectorPtr select_;
   edm::TypeWithDict type_;
+  std::shared_ptr<reco::CutOnObject<T> const> compiled_;
 };
 
 #endif
@@ -10,17 +10,28 @@
 #include "CommonTools/Utils/src/ExpressionPtr.h"
 #include "CommonTools/Utils/src/ExpressionBase.h"
 #include "CommonTools/Utils/interface/expressionParser.h"
+#include "CommonTools/Utils/interface/expressionCompiler.h"
 #include "FWCore/Reflection/interface/ObjectWithDict.h"
 
+// If jitPackage is given, and its src/precompile.h provides the declaration of T,
+// the expression is also compiled into native code (see expressionCompiler.h),
+// which is then used instead of the interpreter.
 template <typename T, bool DefaultLazyness = false>
 struct StringObjectFunction {
-  StringObjectFunction(const std::string &expr, bool lazy = DefaultLazyness) : type_(typeid(T)) {
+  StringObjectFunction(const std::string &expr, bool lazy = DefaultLazyness, const char *jitPackage = nullptr)
+      : type_(typeid(T)) {
     if (!reco::parser::expressionParser<T>(expr, expr_, lazy)) {
       throw edm::Exception(edm::errors::Configuration, "failed to parse \"" + expr + "\"");
     }
+    if (jitPackage != nullptr) {
+      compiled_ = reco::parser::compileFunction<T>(expr, jitPackage);
+    }
   }
   StringObjectFunction(const reco::parser::ExpressionPtr &expr) : expr_(expr), type_(typeid(T)) {}
   double operator()(const T &t) const {
+    if (compiled_) {
+      return compiled_->eval(t);
+    }
     edm::ObjectWithDict o(type_, const_cast<T *>(&t));
     return expr_->value(o);
   }
@@ -28,6 +39,7 @@ struct StringObjectFunction {
 private:
   reco::parser::ExpressionPtr expr_;
   edm::TypeWithDict type_;
+  std::shared_ptr<reco::ValueOnObject<T> const> compiled_;
 };
 
 template <typename Object>
@@ -0,0 +1,85 @@
+#ifndef CommonTools_Utils_expressionCompiler_h
+#define CommonTools_Utils_expressionCompiler_h
+/* Lowering of StringCutObjectSelector and StringObjectFunction strings into
+ * native code, compiled and cached through the ExpressionEvaluator.
+ *
+ * The lowering only handles the subset of the grammar that maps one-to-one
+ * onto C++ (methods, arithmetic, comparisons, logical operators and the
+ * standard math functions); for anything else, or if the compilation fails,
+ * the callers keep using the interpreter.
+ *
+ * The compiled expressions are shared by all their users in the job, and
+ * the library is unloaded once the last one is gone. Failures are
+ * remembered as well, so that the compiler runs at most once per expression.
+ * Strings that the grammar does not accept are reported with an exception,
+ * as by the interpreter, and are never compiled.
+ */
+#include "CommonTools/Utils/interface/ExpressionEvaluator.h"
+#include "CommonTools/Utils/interface/ExpressionEvaluatorTemplates.h"
+#include "CommonTools/Utils/interface/cutParser.h"
+#include "CommonTools/Utils/interface/expressionParser.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+#include "FWCore/Reflection/interface/TypeWithDict.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace reco {
+  namespace parser {
+    // translate a cut or expression into a C++ expression on an object named "obj";
+    // returns false if it uses constructs that cannot be lowered
+    bool lowerExpression(const std::string &expr, std::string &code);
+
+    // compile the class iname with the given body, or find it among those already compiled in
+    // the job; returns nullptr if the compilation fails
+    std::shared_ptr<void const> compileShared(const std::string &expr,
+                                              const char *pkg,
+                                              const std::string &iname,
+                                              const std::string &body,
+                                              std::function<void const *(ExpressionEvaluator const &)> const &get);
+
+    template <typename EXPR>
+    std::shared_ptr<EXPR const> compileLowered(const std::string &expr,
+                                               const char *pkg,
+                                               const std::string &iname,
+                                               const std::string &body) {
+      return std::static_pointer_cast<EXPR const>(compileShared(
+          expr, pkg, iname, body, [](ExpressionEvaluator const &ee) -> void const * { return ee.expr<EXPR>(); }));
+    }
+
+    template <typename T>
+    std::shared_ptr<reco::CutOnObject<T> const> compileCut(const std::string &cut, const char *pkg) {
+      SelectorPtr select;
+      if (!cutParser<T>(cut, select, true))
+        throw edm::Exception(edm::errors::Configuration, "failed to parse \"" + cut + "\"");
+      std::string code;
+      if (!lowerExpression(cut, code))
+        return nullptr;
+      std::string const type = edm::TypeWithDict(typeid(T)).name();
+      return compileLowered<reco::CutOnObject<T>>(
+          cut,
+          pkg,
+          "reco::CutOnObject<" + type + ">",
+          "bool eval(" + type + " const & obj) const final { return " + code + "; }");
+    }
+
+    template <typename T>
+    std::shared_ptr<reco::ValueOnObject<T> const> compileFunction(const std::string &expr, const char *pkg) {
+      ExpressionPtr value;
+      if (!expressionParser<T>(expr, value, true))
+        throw edm::Exception(edm::errors::Configuration, "failed to parse \"" + expr + "\"");
+      std::string code;
+      if (!lowerExpression(expr, code))
+        return nullptr;
+      std::string const type = edm::TypeWithDict(typeid(T)).name();
+      return compileLowered<reco::ValueOnObject<T>>(
+          expr,
+          pkg,
+          "reco::ValueOnObject<" + type + ">",
+          "double eval(" + type + " const & obj) const final { return " + code + "; }");
+    }
+  }  // namespace parser
+}  // namespace reco
+
+#endif
@@ -2,13 +2,24 @@
 #include "FWCore/Version/interface/GetReleaseVersion.h"
 #include "FWCore/Utilities/interface/GetEnvironmentVariable.h"
 #include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/Digest.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
 #include "popenCPP.h"
 
+#include <algorithm>
+#include <ctime>
 #include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <unistd.h>
 #include <regex>
+#include <dirent.h>
 #include <dlfcn.h>
+#include <sys/stat.h>
+#include <utime.h>
 
 // #define VI_DEBUG
 
@@ -22,10 +33,44 @@
 using namespace reco::exprEvalDetails;
 
 namespace {
-  std::string generateName() {
-    auto n1 = execSysCommand("uuidgen | sed 's/-//g'");
-    n1.pop_back();
-    return n1;
+  // the name of the generated class and library depends only on their content,
+  // so that each expression is compiled once and then found in the cache
+  std::string generateName(std::string const& content) { return cms::Digest(content).digest().toString(); }
+
+  // size and modification time of a file, which change whenever it is rebuilt
+  std::string fingerprint(std::string const& file) {
+    struct stat st;
+    if (stat(file.c_str(), &st) != 0)
+      return "-";
+    return std::to_string(st.st_size) + ':' + std::to_string(st.st_mtime);
+  }
+
+  // the cache keeps at most this many libraries and failures, each for at most this long since its last use
+  constexpr unsigned int kMaxCacheEntries = 512;
+  constexpr time_t kMaxCacheAge = 30 * 24 * 3600;
+
+  // remove the least recently used entries of the cache
+  void pruneCache(std::string const& cacheDir) {
+    DIR* dir = opendir(cacheDir.c_str());
+    if (dir == nullptr)
+      return;
+    std::vector<std::pair<time_t, std::string>> entries;
+    while (dirent* entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      bool cached = name.compare(0, 3, "VI_") == 0 and
+                    (name.size() > 3 and (name.compare(name.size() - 3, 3, ".so") == 0 or
+                                          (name.size() > 7 and name.compare(name.size() - 7, 7, ".failed") == 0)));
+      struct stat st;
+      if (cached and stat((cacheDir + "/" + name).c_str(), &st) == 0)
+        entries.emplace_back(st.st_mtime, name);
+    }
+    closedir(dir);
+    std::sort(entries.begin(), entries.end(), std::greater<>());
+    time_t const oldest = time(nullptr) - kMaxCacheAge;
+    for (unsigned int i = 0; i < entries.size(); ++i) {
+      if (i >= kMaxCacheEntries or entries[i].first < oldest)
+        ::remove((cacheDir + "/" + entries[i].second).c_str());
+    }
   }
 
   void remove(std::string const& name, std::string const& tmpDir = "/tmp") {
@@ -42,8 +87,7 @@ namespace {
 
 namespace reco {
 
-  ExpressionEvaluator::ExpressionEvaluator(const char* pkg, const char* iname, std::string const& iexpr)
-      : m_name("VI_" + generateName()) {
+  ExpressionEvaluator::ExpressionEvaluator(const char* pkg, const char* iname, std::string const& iexpr) {
     std::string pch = pkg;
     pch += "/src/precompile.h";
     std::string quote("\"");
@@ -52,8 +96,8 @@ namespace reco {
     auto baseDir = edm::getEnvironmentVariable("CMSSW_BASE");
     auto relDir = edm::getEnvironmentVariable("CMSSW_RELEASE_BASE");
 
-    std::string sfile = baseDir + "/tmp/" + m_name + ".cc";
-    std::string ofile = baseDir + "/tmp/" + m_name + ".so";
+    // compiled expressions are kept across jobs in the cache area
+    auto cacheDir = edm::getEnvironmentVariable("CMSSW_EXPRESSION_CACHE", baseDir + "/tmp");
 
     std::string incDir = "/include/" + arch + "/";
     std::string cxxf;
@@ -105,10 +149,25 @@ namespace reco {
       COUT << '|' << cxxf << "|\n" << std::endl;
     }
 
+    // the precompiled header is rebuilt whenever one of the headers it includes changes, so a
+    // library compiled against an older version of the data formats is never picked up
+    std::string const headers = fingerprint(incDir + pch) + '|' + fingerprint(incDir + pch + ".gch") + '|' +
+                                fingerprint(incDir + pch + ".cxxflags");
+    m_name = "VI_" + generateName(edm::getReleaseVersion() + '|' + pkg + '|' + iname + '|' + iexpr + '|' + cxxf +
+                                  '|' + incDir + '|' + headers);
+    std::string ofile = cacheDir + "/" + m_name + ".so";
+    std::string ffile = cacheDir + "/" + m_name + ".failed";
+    // compile into process- and thread-specific files, and move the library in
+    // place once complete, so that concurrent jobs never load a partial one
+    std::string tname = m_name + '_' + std::to_string(getpid()) + '_' +
+                        std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::string sfile = cacheDir + "/" + tname + ".cc";
+    std::string tfile = cacheDir + "/" + tname + ".so";
+
     std::string cpp = "c++ -H -Wall -shared -Winvalid-pch ";
     cpp += cxxf;
     cpp += " -I" + incDir;
-    cpp += " -o " + ofile + ' ' + sfile + " 2>&1\n";
+    cpp += " -o " + tfile + ' ' + sfile + " 2>&1 && mv -f " + tfile + ' ' + ofile + " 2>&1\n";
 
     COUT << cpp << std::endl;
 
@@ -126,27 +185,60 @@ namespace reco {
 
     COUT << source << std::endl;
 
-    {
-      std::ofstream tmp(sfile.c_str());
-      tmp << source << std::endl;
-    }
-
-    // compile
-    auto ss = execSysCommand(cpp);
-    COUT << ss << std::endl;
-
+    // look for a library compiled from the same source by a previous job, or for its failure
     void* dl = dlopen(ofile.c_str(), RTLD_LAZY);
     if (!dl) {
-      remove(m_name, baseDir + "/tmp");
-      throw cms::Exception("ExpressionEvaluator",
-                           std::string("compilation/linking failed\n") + cpp + ss + "dlerror " + dlerror());
-      return;
+      {
+        std::ifstream failed(ffile.c_str());
+        if (failed) {
+          std::ostringstream output;
+          output << failed.rdbuf();
+          utime(ffile.c_str(), nullptr);
+          throw cms::Exception("ExpressionEvaluator",
+                               std::string("compilation/linking failed in a previous job\n") + output.str());
+        }
+      }
+      {
+        std::ofstream tmp(sfile.c_str());
+        tmp << source << std::endl;
+      }
+
+      // compile
+      auto ss = execSysCommand(cpp);
+      COUT << ss << std::endl;
+
+      dl = dlopen(ofile.c_str(), RTLD_LAZY);
+      remove(tname, cacheDir);
+      if (!dl) {
+        std::string error = cpp + ss + "dlerror " + dlerror();
+        // remember the failure, so that the next jobs do not run the compiler again, only if the
+        // compiler rejected the generated source: a compiler that could not run or was killed, a
+        // full disk or a library that fails to load may work in the next job
+        if (std::regex_search(ss, std::regex(tname + "\\.cc:[0-9]+(:[0-9]+)?: error:"))) {
+          std::string tfailed = cacheDir + "/" + tname + ".failed";
+          {
+            std::ofstream failed(tfailed.c_str());
+            failed << error << std::endl;
+          }
+          rename(tfailed.c_str(), ffile.c_str());
+        }
+        pruneCache(cacheDir);
+        throw cms::Exception("ExpressionEvaluator", std::string("compilation/linking failed\n") + error);
+        return;
+      }
+      pruneCache(cacheDir);
+    } else {
+      COUT << "using cached " << ofile << std::endl;
+      // the modification time orders the entries of the cache by their last use
+      utime(ofile.c_str(), nullptr);
     }
 
+    m_library = dl;
     m_expr = dlsym(dl, factory.c_str());
-    remove(m_name, baseDir + "/tmp");
+    if (!m_expr)
+      throw cms::Exception("ExpressionEvaluator", "no " + factory + " in " + ofile);
   }
 
-  ExpressionEvaluator::~ExpressionEvaluator() { remove(m_name, edm::getEnvironmentVariable("CMSSW_BASE") + "/tmp"); }
+  ExpressionEvaluator::~ExpressionEvaluator() {}
 
 }  // namespace reco
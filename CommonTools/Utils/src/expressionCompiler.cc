@@ -0,0 +1,252 @@
+#include "CommonTools/Utils/interface/expressionCompiler.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+#include <dlfcn.h>
+
+namespace {
+  // functions of the grammar with a direct equivalent in the standard library
+  const std::map<std::string, std::string> functions = {{"abs", "std::abs"},
+                                                        {"acos", "std::acos"},
+                                                        {"asin", "std::asin"},
+                                                        {"atan", "std::atan"},
+                                                        {"cosh", "std::cosh"},
+                                                        {"cos", "std::cos"},
+                                                        {"exp", "std::exp"},
+                                                        {"log", "std::log"},
+                                                        {"log10", "std::log10"},
+                                                        {"sinh", "std::sinh"},
+                                                        {"sin", "std::sin"},
+                                                        {"sqrt", "std::sqrt"},
+                                                        {"tanh", "std::tanh"},
+                                                        {"tan", "std::tan"},
+                                                        {"atan2", "std::atan2"},
+                                                        {"pow", "std::pow"},
+                                                        {"min", "std::min"},
+                                                        {"max", "std::max"},
+                                                        {"hypot", "std::hypot"}};
+
+  // functions of the grammar left to the interpreter
+  const std::vector<std::string> interpretedFunctions = {"chi2prob", "deltaPhi", "deltaR", "test_bit"};
+
+  class Lowering {
+  public:
+    explicit Lowering(const std::string &expr) : s_(expr), i_(0) {}
+
+    bool run(std::string &code) {
+      // one counter of comparisons per parenthesis level, to detect "a < x < b"
+      std::vector<int> comparisons(1, 0);
+      skipBlanks();
+      if (i_ == s_.size())
+        return false;
+      while (i_ < s_.size()) {
+        char c = s_[i_];
+        if (std::isdigit(c) or (c == '.' and i_ + 1 < s_.size() and std::isdigit(s_[i_ + 1]))) {
+          // all the arithmetic of the interpreter is done in double precision
+          code += "double(" + number() + ")";
+        } else if (std::isalpha(c)) {
+          if (not identifierOrMethod(code))
+            return false;
+        } else if (c == '&' or c == '|') {
+          ++i_;
+          if (i_ < s_.size() and s_[i_] == c)
+            ++i_;
+          code += (c == '&') ? " && " : " || ";
+          comparisons.back() = 0;
+        } else if (c == '<' or c == '>' or c == '=' or c == '!') {
+          ++i_;
+          bool equal = (i_ < s_.size() and s_[i_] == '=');
+          if (equal)
+            ++i_;
+          if (c == '!' and not equal) {
+            code += '!';
+          } else {
+            if (++comparisons.back() > 1)
+              return false;
+            code += ' ';
+            code += (c == '=') ? '=' : c;
+            if (equal or c == '=')
+              code += '=';
+            code += ' ';
+          }
+        } else if (c == '(') {
+          comparisons.push_back(0);
+          code += c;
+          ++i_;
+        } else if (c == ')') {
+          if (comparisons.size() == 1)
+            return false;
+          comparisons.pop_back();
+          code += c;
+          ++i_;
+        } else if (c == ',') {
+          comparisons.back() = 0;
+          code += ", ";
+          ++i_;
+        } else if (c == '+' or c == '-' or c == '*' or c == '/') {
+          code += ' ';
+          code += c;
+          code += ' ';
+          ++i_;
+        } else {
+          // '^', the "? cond ? a : b" conditional, and anything unexpected
+          return false;
+        }
+        skipBlanks();
+      }
+      return comparisons.size() == 1;
+    }
+
+  private:
+    void skipBlanks() {
+      while (i_ < s_.size() and std::isspace(s_[i_]))
+        ++i_;
+    }
+
+    std::string identifier() {
+      auto begin = i_;
+      while (i_ < s_.size() and (std::isalnum(s_[i_]) or s_[i_] == '_'))
+        ++i_;
+      return s_.substr(begin, i_ - begin);
+    }
+
+    std::string number() {
+      auto begin = i_;
+      while (i_ < s_.size() and (std::isdigit(s_[i_]) or s_[i_] == '.'))
+        ++i_;
+      if (i_ < s_.size() and (s_[i_] == 'e' or s_[i_] == 'E')) {
+        ++i_;
+        if (i_ < s_.size() and (s_[i_] == '+' or s_[i_] == '-'))
+          ++i_;
+        while (i_ < s_.size() and std::isdigit(s_[i_]))
+          ++i_;
+      }
+      return s_.substr(begin, i_ - begin);
+    }
+
+    // copy the literal arguments of a method call or array access, up to the closing character
+    bool arguments(char close, std::string &code) {
+      while (i_ < s_.size()) {
+        char c = s_[i_];
+        if (c == close) {
+          code += c;
+          ++i_;
+          return true;
+        } else if (c == '"' or c == '\'') {
+          auto end = s_.find(c, i_ + 1);
+          if (end == std::string::npos)
+            return false;
+          code += '"' + s_.substr(i_ + 1, end - i_ - 1) + '"';
+          i_ = end + 1;
+        } else if (std::isalnum(c) or c == '.' or c == ',' or c == '-' or c == '+' or c == '_' or std::isspace(c)) {
+          code += c;
+          ++i_;
+        } else {
+          return false;
+        }
+      }
+      return false;
+    }
+
+    // one element of a method chain: "name", "name()" or "name(args)"
+    bool method(std::string &code) {
+      if (i_ == s_.size() or not std::isalpha(s_[i_]))
+        return false;
+      code += identifier();
+      skipBlanks();
+      if (i_ < s_.size() and s_[i_] == '(') {
+        code += '(';
+        ++i_;
+        return arguments(')', code);
+      }
+      code += "()";
+      return true;
+    }
+
+    bool identifierOrMethod(std::string &code) {
+      auto begin = i_;
+      auto name = identifier();
+      skipBlanks();
+      if (i_ < s_.size() and s_[i_] == '(') {
+        auto f = functions.find(name);
+        if (f != functions.end()) {
+          code += f->second;
+          return true;
+        }
+        if (std::find(interpretedFunctions.begin(), interpretedFunctions.end(), name) != interpretedFunctions.end())
+          return false;
+      }
+      // a chain of methods on the object, with optional array access
+      i_ = begin;
+      std::string chain = "obj.";
+      if (not method(chain))
+        return false;
+      while (true) {
+        skipBlanks();
+        if (i_ < s_.size() and s_[i_] == '[') {
+          chain += '[';
+          ++i_;
+          if (not arguments(']', chain))
+            return false;
+        } else if (i_ < s_.size() and s_[i_] == '.') {
+          chain += '.';
+          ++i_;
+          skipBlanks();
+          if (not method(chain))
+            return false;
+        } else {
+          break;
+        }
+      }
+      code += "double(" + chain + ")";
+      return true;
+    }
+
+    const std::string &s_;
+    std::string::size_type i_;
+  };
+}  // namespace
+
+bool reco::parser::lowerExpression(const std::string &expr, std::string &code) {
+  std::string lowered;
+  if (not Lowering(expr).run(lowered))
+    return false;
+  code = "(" + lowered + ")";
+  return true;
+}
+
+std::shared_ptr<void const> reco::parser::compileShared(
+    const std::string &expr,
+    const char *pkg,
+    const std::string &iname,
+    const std::string &body,
+    std::function<void const *(ExpressionEvaluator const &)> const &get) {
+  // the expressions compiled in the job, and those that failed to compile
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<void const>> compiled;
+  static std::set<std::string> failed;
+
+  std::string const key = std::string(pkg) + '|' + iname + '|' + body;
+  std::lock_guard<std::mutex> guard(mutex);
+  if (failed.count(key))
+    return nullptr;
+  if (auto shared = compiled[key].lock())
+    return shared;
+  try {
+    reco::ExpressionEvaluator ee(pkg, iname.c_str(), body);
+    void *library = ee.library();
+    std::shared_ptr<void const> shared(get(ee), [library](void const *) { dlclose(library); });
+    compiled[key] = shared;
+    return shared;
+  } catch (cms::Exception const &e) {
+    edm::LogInfo("ExpressionCompiler") << "could not compile \"" << expr << "\", using the interpreter instead:\n"
+                                       << e.what();
+    failed.insert(key);
+    return nullptr;
+  }
+}
@@ -0,0 +1,102 @@
+#include <cppunit/extensions/HelperMacros.h>
+#include "CommonTools/Utils/interface/StringCutObjectSelector.h"
+#include "CommonTools/Utils/interface/StringObjectFunction.h"
+#include "CommonTools/Utils/interface/expressionCompiler.h"
+#include "DataFormats/Candidate/interface/LeafCandidate.h"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+class testExpressionCompiler : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testExpressionCompiler);
+  CPPUNIT_TEST(checkAll);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+  void checkAll();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testExpressionCompiler);
+
+namespace {
+  // the package whose precompile.h declares reco::LeafCandidate
+  const char *const pkg = "CommonTools/CandUtils";
+
+  std::vector<reco::LeafCandidate> generate() {
+    std::vector<reco::LeafCandidate> ret;
+    reco::Candidate::LorentzVector p(10, -10, -10, 25);
+    reco::Candidate::LorentzVector incr(3, 7, 11, 20);
+    int charge = 1;
+    for (int i = 0; i < 20; ++i) {
+      ret.emplace_back(charge, p);
+      charge = -charge;
+      p += incr;
+      p.SetPx(-p.px());
+    }
+    return ret;
+  }
+
+  void checkCut(const std::string &cut) {
+    std::cerr << "compiling \"" << cut << "\"" << std::endl;
+    auto compiled = reco::parser::compileCut<reco::LeafCandidate>(cut, pkg);
+    CPPUNIT_ASSERT(compiled);
+    // compiled once, and shared by all its users
+    CPPUNIT_ASSERT(compiled == reco::parser::compileCut<reco::LeafCandidate>(cut, pkg));
+
+    StringCutObjectSelector<reco::LeafCandidate> interpreted(cut);
+    StringCutObjectSelector<reco::LeafCandidate> jit(cut, false, pkg);
+    for (auto const &cand : generate()) {
+      CPPUNIT_ASSERT_EQUAL(interpreted(cand), compiled->eval(cand));
+      CPPUNIT_ASSERT_EQUAL(interpreted(cand), jit(cand));
+    }
+  }
+
+  void checkFunction(const std::string &expr) {
+    std::cerr << "compiling \"" << expr << "\"" << std::endl;
+    auto compiled = reco::parser::compileFunction<reco::LeafCandidate>(expr, pkg);
+    CPPUNIT_ASSERT(compiled);
+
+    StringObjectFunction<reco::LeafCandidate> interpreted(expr);
+    StringObjectFunction<reco::LeafCandidate> jit(expr, false, pkg);
+    for (auto const &cand : generate()) {
+      double value = interpreted(cand);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(value, compiled->eval(cand), 1.e-12 * std::abs(value));
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(value, jit(cand), 1.e-12 * std::abs(value));
+    }
+  }
+}  // namespace
+
+void testExpressionCompiler::checkAll() {
+  checkCut("pt > 20 & abs(eta) < 1.2");
+  checkCut("charge < 0 || (mass > 10 && energy >= 100)");
+  checkCut("!(pt > 30) && p4.pt = pt");
+  checkCut("sqrt(px * px + py * py) > 15 && -pz <= 40");
+
+  checkFunction("pt");
+  checkFunction("pt * cosh(eta) - p");
+  checkFunction("max(pt, 30) - abs(eta) / 2 + charge");
+  checkFunction("atan2(py, px) + 2 * phi");
+
+  // constructs left to the interpreter
+  std::string code;
+  CPPUNIT_ASSERT(!reco::parser::lowerExpression("1 < pt < 3", code));
+  CPPUNIT_ASSERT(!reco::parser::compileCut<reco::LeafCandidate>("deltaR(eta, phi, 0, 0) < 0.3", pkg));
+  StringCutObjectSelector<reco::LeafCandidate> chained("1 < pt < 30", false, pkg);
+  StringCutObjectSelector<reco::LeafCandidate> interpreted("1 < pt < 30");
+  for (auto const &cand : generate())
+    CPPUNIT_ASSERT_EQUAL(interpreted(cand), chained(cand));
+
+  // a cut that is lowered but does not compile is not compiled again: daughter() returns a pointer,
+  // which the interpreter dereferences
+  CPPUNIT_ASSERT(!reco::parser::compileCut<reco::LeafCandidate>("pt > 1 && daughter(0).pt > 2", pkg));
+  CPPUNIT_ASSERT(!reco::parser::compileCut<reco::LeafCandidate>("pt > 1 && daughter(0).pt > 2", pkg));
+
+  // a cut that the grammar does not accept is reported every time, and neither compiled nor cached
+  for (int i = 0; i < 2; ++i) {
+    CPPUNIT_ASSERT_THROW(reco::parser::compileCut<reco::LeafCandidate>("pt > 1 and eta < 2", pkg), cms::Exception);
+    CPPUNIT_ASSERT_THROW(StringCutObjectSelector<reco::LeafCandidate>("pt > 1 and eta < 2", false, pkg),
+                         cms::Exception);
+  }
+}
@@ -24,6 +24,9 @@ namespace cond {
 namespace cond {
 
   namespace persistency {
+
+    class PayloadCache;
+
     //
     enum DbAuthenticationSystem { UndefinedAuthentication = 0, CondDbKey, CoralXMLFile };
 
@@ -38,6 +41,8 @@ namespace cond {
       void setAuthenticationSystem(int authSysCode);
       void setFrontierSecurity(const std::string& signature);
       void setLogging(bool flag);
+      // directory of the node-local payload cache used by the read-only sessions, empty to disable it
+      void setPayloadCachePath(const std::string& path);
       bool isLoggingEnabled() const;
       void setParameters(const edm::ParameterSet& connectionPset);
       void configure();
@@ -66,6 +71,7 @@ namespace cond {
       // this one has to be moved!
       cond::CoralServiceManager* m_pluginManager = nullptr;
       std::map<std::string, int> m_dbTypes;
+      std::shared_ptr<PayloadCache> m_payloadCache;
     };
   }  // namespace persistency
 }  // namespace cond
@@ -0,0 +1,53 @@
+#ifndef CondCore_CondDB_PayloadCache_h
+#define CondCore_CondDB_PayloadCache_h
+//
+// Package:     CondDB
+// Class  :     PayloadCache
+//
+/**\class PayloadCache PayloadCache.h CondCore/CondDB/interface/PayloadCache.h
+   Description: node-local cache of the payload data, addressed by the payload hash.
+
+   Each payload is a file <path>/<first two characters of the hash>/<hash>, written
+   once (to a temporary file, then renamed) and then only read, through a read-only
+   memory mapping, by any number of concurrent processes. A file is used only if its
+   content matches the hash; anything unexpected is a miss, and the caller reads the
+   payload from the database as usual.
+*/
+//
+
+#include "CondCore/CondDB/interface/Binary.h"
+#include "CondCore/CondDB/interface/Types.h"
+//
+#include <string>
+
+namespace cond {
+
+  namespace persistency {
+
+    class PayloadCache {
+    public:
+      explicit PayloadCache(const std::string& path);
+
+      // true if the payload has been found in the cache
+      bool fetch(const cond::Hash& payloadHash,
+                 std::string& payloadType,
+                 cond::Binary& payloadData,
+                 cond::Binary& streamerInfoData) const;
+
+      // best effort: a payload which cannot be written is simply not cached
+      void store(const cond::Hash& payloadHash,
+                 const std::string& payloadType,
+                 const cond::Binary& payloadData,
+                 const cond::Binary& streamerInfoData) const;
+
+      const std::string& path() const { return m_path; }
+
+    private:
+      std::string fileName(const cond::Hash& payloadHash) const;
+
+      std::string m_path;
+    };
+
+  }  // namespace persistency
+}  // namespace cond
+#endif
@@ -5,6 +5,7 @@
 //
 #include "CondCore/CondDB/interface/CoralServiceManager.h"
 #include "CondCore/CondDB/interface/Auth.h"
+#include "CondCore/CondDB/interface/PayloadCache.h"
 // CMSSW includes
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 // coral includes
@@ -37,6 +38,13 @@ namespace cond {
 
     void ConnectionPool::setLogging(bool flag) { m_loggingEnabled = flag; }
 
+    void ConnectionPool::setPayloadCachePath(const std::string& path) {
+      if (path.empty())
+        m_payloadCache.reset();
+      else
+        m_payloadCache = std::make_shared<PayloadCache>(path);
+    }
+
     void ConnectionPool::setParameters(const edm::ParameterSet& connectionPset) {
       //set the connection parameters from a ParameterSet
       //if a parameter is not defined, keep the values already set in the data members
@@ -65,6 +73,8 @@ namespace cond {
       }
       setMessageVerbosity(level);
       setLogging(connectionPset.getUntrackedParameter<bool>("logging", m_loggingEnabled));
+      setPayloadCachePath(connectionPset.getUntrackedParameter<std::string>(
+          "payloadCachePath", m_payloadCache ? m_payloadCache->path() : std::string("")));
     }
 
     bool ConnectionPool::isLoggingEnabled() const { return m_loggingEnabled; }
@@ -148,7 +158,10 @@ namespace cond {
                                           bool writeCapable) {
       std::shared_ptr<coral::ISessionProxy> coralSession =
           createCoralSession(connectionString, transactionId, writeCapable);
-      return Session(std::make_shared<SessionImpl>(coralSession, connectionString));
+      auto session = std::make_shared<SessionImpl>(coralSession, connectionString);
+      if (!writeCapable)
+        session->payloadCache = m_payloadCache;
+      return Session(session);
     }
 
     Session ConnectionPool::createSession(const std::string& connectionString, bool writeCapable) {
@@ -10,6 +10,9 @@ namespace cond {
 
   namespace persistency {
 
+    // the hash identifying a payload in the PAYLOAD table
+    cond::Hash makeHash(const std::string& objectType, const cond::Binary& data);
+
     conddb_table(TAG) {
       conddb_column(NAME, std::string);
       conddb_column(TIME_TYPE, cond::TimeType);
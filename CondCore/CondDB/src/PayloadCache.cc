@@ -0,0 +1,140 @@
+#include "CondCore/CondDB/interface/PayloadCache.h"
+#include "IOVSchema.h"
+//
+#include <boost/filesystem/operations.hpp>
+//
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cond {
+
+  namespace persistency {
+
+    namespace {
+
+      // file layout: magic, then the sizes of the type, the data and the streamer info, then their bytes
+      const char s_magic[8] = {'C', 'O', 'N', 'D', 'P', 'L', 'C', '1'};
+      const size_t s_headerSize = sizeof(s_magic) + 3 * sizeof(std::uint64_t);
+
+      bool isValidHash(const cond::Hash& payloadHash) {
+        if (payloadHash.size() != 40)
+          return false;
+        for (char c : payloadHash) {
+          if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')))
+            return false;
+        }
+        return true;
+      }
+
+      // read-only mapping of a whole file, released at the end of the scope
+      class MappedFile {
+      public:
+        explicit MappedFile(const std::string& fileName) {
+          int fd = ::open(fileName.c_str(), O_RDONLY);
+          if (fd < 0)
+            return;
+          struct stat st;
+          if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (addr != MAP_FAILED) {
+              m_data = static_cast<const char*>(addr);
+              m_size = st.st_size;
+            }
+          }
+          ::close(fd);
+        }
+        ~MappedFile() {
+          if (m_data)
+            ::munmap(const_cast<char*>(m_data), m_size);
+        }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+      private:
+        const char* m_data = nullptr;
+        size_t m_size = 0;
+      };
+
+      bool writeAll(int fd, const void* data, size_t size) {
+        const char* p = static_cast<const char*>(data);
+        while (size > 0) {
+          ssize_t n = ::write(fd, p, size);
+          if (n < 0)
+            return false;
+          p += n;
+          size -= n;
+        }
+        return true;
+      }
+
+    }  // namespace
+
+    PayloadCache::PayloadCache(const std::string& path) : m_path(path) {}
+
+    std::string PayloadCache::fileName(const cond::Hash& payloadHash) const {
+      return m_path + "/" + payloadHash.substr(0, 2) + "/" + payloadHash;
+    }
+
+    bool PayloadCache::fetch(const cond::Hash& payloadHash,
+                             std::string& payloadType,
+                             cond::Binary& payloadData,
+                             cond::Binary& streamerInfoData) const {
+      if (!isValidHash(payloadHash))
+        return false;
+      MappedFile file(fileName(payloadHash));
+      if (file.size() < s_headerSize || ::memcmp(file.data(), s_magic, sizeof(s_magic)) != 0)
+        return false;
+      std::uint64_t sizes[3];
+      ::memcpy(sizes, file.data() + sizeof(s_magic), sizeof(sizes));
+      if (sizes[0] > file.size() || sizes[1] > file.size() || sizes[2] > file.size() ||
+          s_headerSize + sizes[0] + sizes[1] + sizes[2] != file.size())
+        return false;
+      const char* p = file.data() + s_headerSize;
+      std::string type(p, sizes[0]);
+      cond::Binary data(p + sizes[0], sizes[1]);
+      // a truncated or otherwise damaged file is never used
+      if (makeHash(type, data) != payloadHash)
+        return false;
+      payloadType = type;
+      payloadData = data;
+      streamerInfoData = cond::Binary(p + sizes[0] + sizes[1], sizes[2]);
+      return true;
+    }
+
+    void PayloadCache::store(const cond::Hash& payloadHash,
+                             const std::string& payloadType,
+                             const cond::Binary& payloadData,
+                             const cond::Binary& streamerInfoData) const {
+      if (!isValidHash(payloadHash))
+        return;
+      std::string target = fileName(payloadHash);
+      boost::system::error_code ec;
+      boost::filesystem::create_directories(boost::filesystem::path(target).parent_path(), ec);
+      if (ec)
+        return;
+
+      // written aside and renamed, so that the readers see either no file or the complete one
+      std::string tmpName = target + ".XXXXXX";
+      int fd = ::mkstemp(&tmpName[0]);
+      if (fd < 0)
+        return;
+      ::fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+      const std::uint64_t sizes[3] = {payloadType.size(), payloadData.size(), streamerInfoData.size()};
+      bool ok = writeAll(fd, s_magic, sizeof(s_magic)) && writeAll(fd, sizes, sizeof(sizes)) &&
+                writeAll(fd, payloadType.data(), payloadType.size()) &&
+                writeAll(fd, payloadData.data(), payloadData.size()) &&
+                writeAll(fd, streamerInfoData.data(), streamerInfoData.size());
+      ok = (::close(fd) == 0) && ok;
+      if (!ok || ::rename(tmpName.c_str(), target.c_str()) != 0)
+        ::unlink(tmpName.c_str());
+    }
+
+  }  // namespace persistency
+}  // namespace cond
@@ -195,8 +195,15 @@ namespace cond {
                                    std::string& payloadType,
                                    cond::Binary& payloadData,
                                    cond::Binary& streamerInfoData) {
+      if (m_session->payloadCache &&
+          m_session->payloadCache->fetch(payloadHash, payloadType, payloadData, streamerInfoData))
+        return true;
       m_session->openIovDb();
-      return m_session->iovSchema().payloadTable().select(payloadHash, payloadType, payloadData, streamerInfoData);
+      bool found =
+          m_session->iovSchema().payloadTable().select(payloadHash, payloadType, payloadData, streamerInfoData);
+      if (found && m_session->payloadCache)
+        m_session->payloadCache->store(payloadHash, payloadType, payloadData, streamerInfoData);
+      return found;
     }
 
     RunInfoProxy Session::getRunInfo(cond::Time_t start, cond::Time_t end) {
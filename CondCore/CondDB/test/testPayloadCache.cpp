@@ -0,0 +1,89 @@
+#include "FWCore/PluginManager/interface/PluginManager.h"
+#include "FWCore/PluginManager/interface/standard.h"
+//
+#include "CondCore/CondDB/interface/ConnectionPool.h"
+#include "CondCore/CondDB/interface/PayloadCache.h"
+//
+#include "MyTestData.h"
+//
+#include <boost/filesystem/operations.hpp>
+#include <fstream>
+#include <iostream>
+
+using namespace cond::persistency;
+
+namespace {
+  int readPayload(ConnectionPool& connPool, const std::string& connectionString, const cond::Hash& pid, int seed) {
+    Session session = connPool.createSession(connectionString);
+    session.transaction().start(true);
+    std::shared_ptr<MyTestData> payload = session.fetchPayload<MyTestData>(pid);
+    session.transaction().commit();
+    if (*payload != MyTestData(seed)) {
+      std::cout << "ERROR: payload " << pid << " found to be wrong, expected: " << seed << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+}  // namespace
+
+int main(int argc, char** argv) {
+  edmplugin::PluginManager::Config config;
+  edmplugin::PluginManager::configure(edmplugin::standard::config());
+
+  std::string connectionString("sqlite_file:PayloadCache.db");
+  std::string cachePath("PayloadCache");
+  boost::filesystem::remove_all(cachePath);
+  std::cout << "# Connecting with db in " << connectionString << std::endl;
+  int nFail = 0;
+  try {
+    cond::Hash pid;
+    {
+      ConnectionPool connPool;
+      Session session = connPool.createSession(connectionString, true);
+      session.transaction().start(false);
+      pid = session.storePayload(MyTestData(40000), boost::posix_time::microsec_clock::universal_time());
+      session.transaction().commit();
+    }
+
+    ConnectionPool connPool;
+    connPool.setPayloadCachePath(cachePath);
+    PayloadCache cache(cachePath);
+    std::string payloadType;
+    cond::Binary payloadData;
+    cond::Binary streamerInfoData;
+
+    // miss: read from the db, then stored in the cache
+    nFail += readPayload(connPool, connectionString, pid, 40000);
+    if (!cache.fetch(pid, payloadType, payloadData, streamerInfoData)) {
+      std::cout << "ERROR: payload " << pid << " not stored in the cache" << std::endl;
+      nFail++;
+    }
+    // hit
+    nFail += readPayload(connPool, connectionString, pid, 40000);
+
+    // a damaged file is ignored, and replaced by the next read from the db
+    std::string fileName = cachePath + "/" + pid.substr(0, 2) + "/" + pid;
+    boost::filesystem::resize_file(fileName, boost::filesystem::file_size(fileName) - 1);
+    if (cache.fetch(pid, payloadType, payloadData, streamerInfoData)) {
+      std::cout << "ERROR: truncated payload " << pid << " read from the cache" << std::endl;
+      nFail++;
+    }
+    nFail += readPayload(connPool, connectionString, pid, 40000);
+    if (!cache.fetch(pid, payloadType, payloadData, streamerInfoData)) {
+      std::cout << "ERROR: payload " << pid << " not stored again in the cache" << std::endl;
+      nFail++;
+    }
+  } catch (const std::exception& e) {
+    std::cout << "ERROR: " << e.what() << std::endl;
+    return -1;
+  } catch (...) {
+    std::cout << "UNEXPECTED FAILURE." << std::endl;
+    return -1;
+  }
+  if (nFail == 0) {
+    std::cout << "## Run successfully completed." << std::endl;
+  } else {
+    std::cout << "## Run completed with ERRORS. nFail = " << nFail << std::endl;
+  }
+  return nFail;
+}
@@ -90,6 +90,7 @@ namespace {
  *  RefreshEachRun: if true will refresh the IOV at each new run (or lumiSection)
  *  DumpStat: if true dump the statistics of all DataProxy (currently on cout)
  *  DBParameters: configuration set of the connection
+ *                (payloadCachePath: directory of the node-local payload cache, none if empty)
  *  globaltag: The GlobalTag
  *  toGet: list of record label tag connection-string to add/overwrite the content of the global-tag
  */
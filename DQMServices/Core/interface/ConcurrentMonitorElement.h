@@ -6,11 +6,194 @@
  * ...
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <type_traits>
+#include <vector>
+#include <tbb/enumerable_thread_specific.h>
 #include <tbb/spin_mutex.h>
 
 #include "DQMServices/Core/interface/MonitorElement.h"
 
+class ConcurrentFillBuffer;
+
+/* A histogram whose fills may be buffered by a ConcurrentFillBuffer.
+ *
+ * The lock protects the MonitorElement against the concurrent direct fills
+ * and replays of buffered ones. Once closed, at the end of the run, the
+ * fills are no longer buffered.
+ */
+struct ConcurrentFillTarget {
+  typedef dqm::impl::MonitorElement MonitorElement;
+
+  ConcurrentFillTarget(MonitorElement* m, ConcurrentFillBuffer* b) : me(m), buffer(b) {}
+
+  template <typename... Args>
+  bool push(Args... args);
+
+  MonitorElement* me;
+  ConcurrentFillBuffer* buffer;
+  tbb::spin_mutex lock;
+  std::atomic<bool> closed{false};
+};
+
+/* Per-thread buffers of histogram fills, shared by all the buffered
+ * ConcurrentMonitorElements of a DQMStore.
+ *
+ * Each fill made while a thread processes an event is appended, together
+ * with its histogram and lumisection, to the buffer of that thread, without
+ * touching the histogram. At the end of a lumisection the DQMStore replays
+ * the fills of that and earlier lumisections, keeping those of the later
+ * ones, so that with concurrent lumisections a fill is never merged before
+ * the end of an earlier lumisection. A full buffer replays the fills of the
+ * oldest open lumisection; if that does not make room, and outside of the
+ * event processing, the histogram is filled directly.
+ *
+ * The memory used is `capacity` fills per thread, whatever the number of
+ * histograms.
+ */
+class ConcurrentFillBuffer {
+public:
+  typedef dqm::impl::MonitorElement MonitorElement;
+
+  static constexpr std::size_t capacity = 256;
+
+  ConcurrentFillBuffer() = default;
+
+  ConcurrentFillBuffer(ConcurrentFillBuffer const&) = delete;
+  ConcurrentFillBuffer& operator=(ConcurrentFillBuffer const&) = delete;
+
+  // lumisection of the event the current thread works on, 0 if none
+  static uint32_t currentLumi() { return currentLumi_; }
+
+  // called around the event methods of the modules, which may be nested on a thread
+  static void enterLumi(uint32_t lumi) {
+    savedLumis_.push_back(currentLumi_);
+    currentLumi_ = lumi;
+  }
+  static void leaveLumi() {
+    currentLumi_ = savedLumis_.back();
+    savedLumis_.pop_back();
+  }
+
+  // buffer a fill of target made in lumi, and return false if it must be filled directly
+  template <typename... Args>
+  bool push(ConcurrentFillTarget* target, uint32_t lumi, Args... args) {
+    static_assert(sizeof...(Args) >= 1 and sizeof...(Args) <= 4);
+    auto& local = localBuffer();
+    // this lock is only ever contended by flush()
+    std::lock_guard<tbb::spin_mutex> guard(local.lock);
+    if (target->closed.load(std::memory_order_relaxed))
+      return false;
+    if (local.entries.size() >= capacity) {
+      replay(local.entries, oldestOpenLumi_.load(std::memory_order_relaxed));
+      if (local.entries.size() >= capacity)
+        return false;
+    }
+    local.entries.push_back(
+        Entry{target, lumi, static_cast<uint8_t>(sizeof...(Args)), {static_cast<double>(args)...}});
+    return true;
+  }
+
+  // the fills of the lumisections up to this one may be replayed whenever a buffer is full
+  void setOldestOpenLumi(uint32_t lumi) { oldestOpenLumi_.store(lumi, std::memory_order_relaxed); }
+  uint32_t oldestOpenLumi() const { return oldestOpenLumi_.load(std::memory_order_relaxed); }
+
+  // replay the fills of all threads made in the lumisections up to lumi
+  void flush(uint32_t lumi) {
+    std::lock_guard<std::mutex> guard(buffersLock_);
+    for (auto buffer : buffers_) {
+      std::lock_guard<tbb::spin_mutex> bufferGuard(buffer->lock);
+      replay(buffer->entries, lumi);
+    }
+  }
+
+  // replay all the fills, and fill the targets directly from now on
+  void close(std::vector<std::shared_ptr<ConcurrentFillTarget>> const& targets) {
+    // the threads check `closed` while holding the lock of their buffer, so
+    // any fill buffered before is replayed by flush()
+    for (auto const& target : targets)
+      target->closed.store(true, std::memory_order_relaxed);
+    flush(std::numeric_limits<uint32_t>::max());
+  }
+
+private:
+  struct Entry {
+    ConcurrentFillTarget* target;
+    uint32_t lumi;
+    uint8_t size;
+    double args[4];
+  };
+
+  struct ThreadBuffer {
+    tbb::spin_mutex lock;
+    std::vector<Entry> entries;
+  };
+
+  ThreadBuffer& localBuffer() {
+    bool exists;
+    auto& local = localBuffers_.local(exists);
+    if (not exists) {
+      local.entries.reserve(capacity);
+      std::lock_guard<std::mutex> guard(buffersLock_);
+      buffers_.push_back(&local);
+    }
+    return local;
+  }
+
+  // replay the entries up to lumi, target by target and in order, and keep the others
+  static void replay(std::vector<Entry>& entries, uint32_t lumi) {
+    auto later = std::stable_partition(
+        entries.begin(), entries.end(), [lumi](Entry const& entry) { return entry.lumi <= lumi; });
+    std::stable_sort(entries.begin(), later, [](Entry const& a, Entry const& b) {
+      return std::less<ConcurrentFillTarget*>()(a.target, b.target);
+    });
+    for (auto first = entries.begin(); first != later;) {
+      auto target = first->target;
+      std::lock_guard<tbb::spin_mutex> guard(target->lock);
+      for (; first != later and first->target == target; ++first)
+        fill(target->me, *first);
+    }
+    entries.erase(entries.begin(), later);
+  }
+
+  static void fill(MonitorElement* me, Entry const& entry) {
+    switch (entry.size) {
+      case 1:
+        me->Fill(entry.args[0]);
+        break;
+      case 2:
+        me->Fill(entry.args[0], entry.args[1]);
+        break;
+      case 3:
+        me->Fill(entry.args[0], entry.args[1], entry.args[2]);
+        break;
+      case 4:
+        me->Fill(entry.args[0], entry.args[1], entry.args[2], entry.args[3]);
+        break;
+    }
+  }
+
+  static inline thread_local uint32_t currentLumi_ = 0;
+  static inline thread_local std::vector<uint32_t> savedLumis_;
+
+  std::atomic<uint32_t> oldestOpenLumi_{0};
+  tbb::enumerable_thread_specific<ThreadBuffer> localBuffers_;
+  std::mutex buffersLock_;
+  std::vector<ThreadBuffer*> buffers_;
+};
+
+template <typename... Args>
+bool ConcurrentFillTarget::push(Args... args) {
+  uint32_t lumi = ConcurrentFillBuffer::currentLumi();
+  return lumi != 0 and buffer->push(this, lumi, args...);
+}
+
 class ConcurrentMonitorElement {
 public:
   typedef dqm::impl::MonitorElement MonitorElement;
@@ -18,12 +201,17 @@ public:
 private:
   mutable MonitorElement* me_;
   mutable tbb::spin_mutex lock_;
+  // if set, histogram fills go through the per-thread buffers of the DQMStore
+  std::shared_ptr<ConcurrentFillTarget> target_;
 
 public:
   ConcurrentMonitorElement(void) : me_(nullptr) {}
 
   explicit ConcurrentMonitorElement(MonitorElement* me) : me_(me) {}
 
+  ConcurrentMonitorElement(MonitorElement* me, std::shared_ptr<ConcurrentFillTarget> target)
+      : me_(me), target_(std::move(target)) {}
+
   // non-copiable
   ConcurrentMonitorElement(ConcurrentMonitorElement const&) = delete;
 
@@ -32,6 +220,7 @@ public:
     std::lock_guard<tbb::spin_mutex> guard(other.lock_);
     me_ = other.me_;
     other.me_ = nullptr;
+    target_ = std::move(other.target_);
   }
 
   // not copy-assignable
@@ -45,6 +234,7 @@ public:
     std::lock_guard<tbb::spin_mutex> others(other.lock_, std::adopt_lock);
     me_ = other.me_;
     other.me_ = nullptr;
+    target_ = std::move(other.target_);
     return *this;
   }
 
@@ -54,12 +244,30 @@ public:
   // expose as a const method to mean that it is concurrent-safe
   template <typename... Args>
   void fill(Args&&... args) const {
+    if (target_) {
+      if constexpr (sizeof...(Args) >= 1 and sizeof...(Args) <= 4 and
+                    (std::is_arithmetic_v<std::decay_t<Args>> and ...)) {
+        if (target_->push(args...))
+          return;
+      }
+      std::lock_guard<tbb::spin_mutex> guard(target_->lock);
+      me_->Fill(std::forward<Args>(args)...);
+      return;
+    }
     std::lock_guard<tbb::spin_mutex> guard(lock_);
     me_->Fill(std::forward<Args>(args)...);
   }
 
   // expose as a const method to mean that it is concurrent-safe
   void shiftFillLast(double y, double ye = 0., int32_t xscale = 1) const {
+    // the result depends on the order of the fills, so apply the buffered ones first
+    if (target_) {
+      uint32_t lumi = ConcurrentFillBuffer::currentLumi();
+      target_->buffer->flush(lumi != 0 ? lumi : target_->buffer->oldestOpenLumi());
+      std::lock_guard<tbb::spin_mutex> guard(target_->lock);
+      me_->ShiftFillLast(y, ye, xscale);
+      return;
+    }
     std::lock_guard<tbb::spin_mutex> guard(lock_);
     me_->ShiftFillLast(y, ye, xscale);
   }
@@ -68,6 +276,7 @@ public:
   void reset() {
     std::lock_guard<tbb::spin_mutex> guard(lock_);
     me_ = nullptr;
+    target_.reset();
   }
 
   operator bool() const {
@@ -226,6 +226,7 @@ namespace dqm::impl {
     private:
       explicit IBooker(DQMStore* store) noexcept : owner_{store} { assert(store); }
 
+    protected:
       // Embedded classes do not natively own a pointer to the embedding
       // class. We therefore need to store a pointer to the main
       // DQMStore instance (owner_).
@@ -358,6 +359,9 @@ namespace dqm::impl {
       explicit ConcurrentBooker(DQMStore* store) noexcept : IBooker{store} {}
 
       ~ConcurrentBooker() = default;
+
+      // wrap a histogram, with per-thread fill buffers if enabled in the DQMStore
+      ConcurrentMonitorElement makeBuffered(MonitorElement* me);
     };
 
     class IGetter {
@@ -730,6 +734,9 @@ namespace dqm::impl {
     void reset();
     void forceReset();
     void postGlobalBeginLumi(const edm::GlobalContext&);
+    void beginLumiFillBuffers(uint32_t lumi);
+    void endLumiFillBuffers(uint32_t lumi);
+    void endRunFillBuffers();
 
     bool extract(TObject* obj, std::string const& dir, bool overwrite, bool collateHistograms);
     TObject* extractNextObject(TBufferFile&) const;
@@ -829,6 +836,14 @@ namespace dqm::impl {
 
     std::mutex book_mutex_;
 
+    // per-thread buffers of the fills of the ConcurrentMonitorElements booked
+    // in the current run, and the open lumisections; flushed at the end of
+    // each lumisection and run
+    bool bufferConcurrentFills_{false};
+    ConcurrentFillBuffer fillBuffer_;
+    std::vector<std::shared_ptr<ConcurrentFillTarget>> fillTargets_;
+    std::set<uint32_t> openLumis_;
+
     friend DQMService;
     friend DQMNet;
     friend DQMArchiver;
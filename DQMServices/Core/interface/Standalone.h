@@ -9,6 +9,7 @@
 #include "FWCore/ServiceRegistry/interface/ModuleCallingContext.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/ServiceRegistry/interface/ServiceRegistry.h"
+#include "FWCore/ServiceRegistry/interface/StreamContext.h"
 #include "FWCore/ServiceRegistry/interface/SystemBounds.h"
 #include "FWCore/Utilities/interface/LuminosityBlockIndex.h"
 #include "FWCore/Utilities/interface/RunIndex.h"
@@ -106,6 +107,27 @@ namespace edm {
     template <typename F>
     void watchPostModuleGlobalEndRun(F) {}
 
+    template <typename F>
+    void watchPreGlobalBeginLumi(F) {}
+
+    template <typename F>
+    void watchPreGlobalEndLumi(F) {}
+
+    template <typename F>
+    void watchPreGlobalEndRun(F) {}
+
+    template <typename F>
+    void watchPreModuleEvent(F) {}
+
+    template <typename F>
+    void watchPostModuleEvent(F) {}
+
+    template <typename F>
+    void watchPreModuleEventAcquire(F) {}
+
+    template <typename F>
+    void watchPostModuleEventAcquire(F) {}
+
     PreallocationSignal preallocateSignal_;
   };
 
@@ -120,6 +142,16 @@ namespace edm {
     LuminosityBlockID luminosityBlockID() const { return LuminosityBlockID(); }
   };
 
+  class EventID {
+  public:
+    unsigned int luminosityBlock() const { return 0; }
+  };
+
+  class StreamContext {
+  public:
+    EventID eventID() const { return EventID(); }
+  };
+
   class ModuleDescription {
   public:
     unsigned int id() const { return 0; }
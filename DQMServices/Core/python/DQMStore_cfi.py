@@ -14,4 +14,7 @@ DQMStore = cms.Service("DQMStore",
     # similar to LSBasedMode but for offline. Explicitly sets LumiFLag on all
     # MEs/modules that allow it (canSaveByLumi)
     saveByLumi = cms.untracked.bool(False),
+    # accumulate the fills of ConcurrentMonitorElements in per-thread buffers,
+    # and merge them into the histograms at the end of each lumisection and run
+    bufferConcurrentFills = cms.untracked.bool(False),
 )
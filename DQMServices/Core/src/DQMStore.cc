@@ -461,6 +461,15 @@ namespace dqm::impl {
   void DQMStore::IGetter::setCurrentFolder(std::string const& fullpath) { owner_->setCurrentFolder(fullpath); }
 
   // ConcurrentBooker methods
+  ConcurrentMonitorElement DQMStore::ConcurrentBooker::makeBuffered(MonitorElement* me) {
+    if (not owner_->bufferConcurrentFills_)
+      return ConcurrentMonitorElement(me);
+    // called within bookConcurrentTransaction, while holding book_mutex_
+    auto target = std::make_shared<ConcurrentFillTarget>(me, &owner_->fillBuffer_);
+    owner_->fillTargets_.push_back(target);
+    return ConcurrentMonitorElement(me, std::move(target));
+  }
+
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookInt(TString const& name) {
     MonitorElement* me = IBooker::bookInt(name);
     return ConcurrentMonitorElement(me);
@@ -479,7 +488,7 @@ namespace dqm::impl {
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1D(
       TString const& name, TString const& title, int const nchX, double const lowX, double const highX) {
     MonitorElement* me = IBooker::book1D(name, title, nchX, lowX, highX);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1D(TString const& name,
@@ -487,34 +496,34 @@ namespace dqm::impl {
                                                               int nchX,
                                                               float const* xbinsize) {
     MonitorElement* me = IBooker::book1D(name, title, nchX, xbinsize);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   };
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1D(TString const& name, TH1F* object) {
     MonitorElement* me = IBooker::book1D(name, object);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1S(
       TString const& name, TString const& title, int nchX, double lowX, double highX) {
     MonitorElement* me = IBooker::book1S(name, title, nchX, lowX, highX);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1S(TString const& name, TH1S* object) {
     MonitorElement* me = IBooker::book1S(name, object);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1DD(
       TString const& name, TString const& title, int nchX, double lowX, double highX) {
     MonitorElement* me = IBooker::book1DD(name, title, nchX, lowX, highX);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book1DD(TString const& name, TH1D* object) {
     MonitorElement* me = IBooker::book1DD(name, object);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2D(TString const& name,
@@ -526,18 +535,18 @@ namespace dqm::impl {
                                                               double lowY,
                                                               double highY) {
     MonitorElement* me = IBooker::book2D(name, title, nchX, lowX, highX, nchY, lowY, highY);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2D(
       TString const& name, TString const& title, int nchX, float const* xbinsize, int nchY, float const* ybinsize) {
     MonitorElement* me = IBooker::book2D(name, title, nchX, xbinsize, nchY, ybinsize);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2D(TString const& name, TH2F* object) {
     MonitorElement* me = IBooker::book2D(name, object);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2S(TString const& name,
@@ -549,18 +558,18 @@ namespace dqm::impl {
                                                               double lowY,
                                                               double highY) {
     MonitorElement* me = IBooker::book2S(name, title, nchX, lowX, highX, nchY, lowY, highY);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2S(
       TString const& name, TString const& title, int nchX, float const* xbinsize, int nchY, float const* ybinsize) {
     MonitorElement* me = IBooker::book2S(name, title, nchX, xbinsize, nchY, ybinsize);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2S(TString const& name, TH2S* object) {
     MonitorElement* me = IBooker::book2S(name, object);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2DD(TString const& name,
@@ -572,12 +581,12 @@ namespace dqm::impl {
                                                                double lowY,
                                                                double highY) {
     MonitorElement* me = IBooker::book2DD(name, title, nchX, lowX, highX, nchY, lowY, highY);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book2DD(TString const& name, TH2D* object) {
     MonitorElement* me = IBooker::book2DD(name, object);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book3D(TString const& name,
@@ -592,12 +601,12 @@ namespace dqm::impl {
                                                               double lowZ,
                                                               double highZ) {
     MonitorElement* me = IBooker::book3D(name, title, nchX, lowX, highX, nchY, lowY, highY, nchZ, lowZ, highZ);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::book3D(TString const& name, TH3F* object) {
     MonitorElement* me = IBooker::book3D(name, object);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile(TString const& name,
@@ -610,7 +619,7 @@ namespace dqm::impl {
                                                                    double highY,
                                                                    char const* option) {
     MonitorElement* me = IBooker::bookProfile(name, title, nchX, lowX, highX, nchY, lowY, highY, option);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile(TString const& name,
@@ -622,7 +631,7 @@ namespace dqm::impl {
                                                                    double highY,
                                                                    char const* option) {
     MonitorElement* me = IBooker::bookProfile(name, title, nchX, (double)lowX, highX, lowY, highY, option);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile(TString const& name,
@@ -634,7 +643,7 @@ namespace dqm::impl {
                                                                    double highY,
                                                                    char const* option) {
     MonitorElement* me = IBooker::bookProfile(name, title, nchX, xbinsize, nchY, lowY, highY, option);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile(TString const& name,
@@ -645,12 +654,12 @@ namespace dqm::impl {
                                                                    double highY,
                                                                    char const* option) {
     MonitorElement* me = IBooker::bookProfile(name, title, nchX, xbinsize, lowY, highY, option);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile(TString const& name, TProfile* object) {
     MonitorElement* me = IBooker::bookProfile(name, object);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile2D(TString const& name,
@@ -665,7 +674,7 @@ namespace dqm::impl {
                                                                      double highZ,
                                                                      char const* option) {
     MonitorElement* me = IBooker::bookProfile2D(name, title, nchX, lowX, highX, nchY, lowY, highY, lowZ, highZ, option);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   ConcurrentMonitorElement DQMStore::ConcurrentBooker::bookProfile2D(TString const& name,
@@ -682,7 +691,7 @@ namespace dqm::impl {
                                                                      char const* option) {
     MonitorElement* me =
         IBooker::bookProfile2D(name, title, nchX, lowX, highX, nchY, lowY, highY, nchZ, lowZ, highZ, option);
-    return ConcurrentMonitorElement(me);
+    return makeBuffered(me);
   }
 
   //////////////////////////////////////////////////////////////////////
@@ -702,6 +711,25 @@ namespace dqm::impl {
 #endif
     }
     ar.watchPostGlobalBeginLumi(this, &DQMStore::postGlobalBeginLumi);
+    if (bufferConcurrentFills_) {
+      // tag the fills with the lumisection of the event being processed
+      auto enter = [](edm::StreamContext const& sc, edm::ModuleCallingContext const&) {
+        ConcurrentFillBuffer::enterLumi(sc.eventID().luminosityBlock());
+      };
+      auto leave = [](edm::StreamContext const&, edm::ModuleCallingContext const&) {
+        ConcurrentFillBuffer::leaveLumi();
+      };
+      ar.watchPreModuleEvent(enter);
+      ar.watchPostModuleEvent(leave);
+      ar.watchPreModuleEventAcquire(enter);
+      ar.watchPostModuleEventAcquire(leave);
+      ar.watchPreGlobalBeginLumi(
+          [this](edm::GlobalContext const& gc) { beginLumiFillBuffers(gc.luminosityBlockID().luminosityBlock()); });
+      // all the events of the lumisection (run) have been processed at this point
+      ar.watchPreGlobalEndLumi(
+          [this](edm::GlobalContext const& gc) { endLumiFillBuffers(gc.luminosityBlockID().luminosityBlock()); });
+      ar.watchPreGlobalEndRun([this](edm::GlobalContext const&) { endRunFillBuffers(); });
+    }
   }
 
   DQMStore::DQMStore(edm::ParameterSet const& pset) { initializeFrom(pset); }
@@ -739,6 +767,10 @@ namespace dqm::impl {
     if (LSbasedMode_)
       std::cout << "DQMStore: LSbasedMode option is enabled\n";
 
+    bufferConcurrentFills_ = pset.getUntrackedParameter<bool>("bufferConcurrentFills", false);
+    if (bufferConcurrentFills_)
+      std::cout << "DQMStore: bufferConcurrentFills option is enabled\n";
+
     doSaveByLumi_ = pset.getUntrackedParameter<bool>("saveByLumi", false);
     if (doSaveByLumi_)
       std::cout << "DQMStore: saveByLumi option is enabled\n";
@@ -1967,6 +1999,38 @@ namespace dqm::impl {
     }
   }
 
+  //////////////////////////////////////////////////////////////////////
+  /** Keep track of the open lumisections, whose buffered fills can be
+ * replayed only once all the earlier lumisections have been closed.
+ */
+  void DQMStore::beginLumiFillBuffers(uint32_t const lumi) {
+    std::lock_guard<std::mutex> guard(book_mutex_);
+    openLumis_.insert(lumi);
+    fillBuffer_.setOldestOpenLumi(*openLumis_.begin());
+  }
+
+  /** Replay the buffered fills of the lumisection, and of the earlier
+ * ones, into the underlying MonitorElements.
+ */
+  void DQMStore::endLumiFillBuffers(uint32_t const lumi) {
+    std::lock_guard<std::mutex> guard(book_mutex_);
+    fillBuffer_.flush(lumi);
+    openLumis_.erase(lumi);
+    fillBuffer_.setOldestOpenLumi(openLumis_.empty() ? 0 : *openLumis_.begin());
+  }
+
+  /** Replay all the buffered fills. The MonitorElements of the run are
+ * filled directly from now on, since the ConcurrentMonitorElements are
+ * booked again for the next run.
+ */
+  void DQMStore::endRunFillBuffers() {
+    std::lock_guard<std::mutex> guard(book_mutex_);
+    fillBuffer_.close(fillTargets_);
+    fillTargets_.clear();
+    openLumis_.clear();
+    fillBuffer_.setOldestOpenLumi(0);
+  }
+
   //////////////////////////////////////////////////////////////////////
   //////////////////////////////////////////////////////////////////////
   //////////////////////////////////////////////////////////////////////
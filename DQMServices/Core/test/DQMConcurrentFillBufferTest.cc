@@ -0,0 +1,147 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "DataFormats/Provenance/interface/EventID.h"
+#include "DataFormats/Provenance/interface/LuminosityBlockID.h"
+#include "DataFormats/Provenance/interface/ModuleDescription.h"
+#include "DataFormats/Provenance/interface/Timestamp.h"
+#include "DQMServices/Core/interface/DQMStore.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+#include "FWCore/ServiceRegistry/interface/GlobalContext.h"
+#include "FWCore/ServiceRegistry/interface/ModuleCallingContext.h"
+#include "FWCore/ServiceRegistry/interface/StreamContext.h"
+
+/*
+ * Test case for the per-thread buffers of the ConcurrentMonitorElement fills:
+ * fills made concurrently in two open lumisections must be in the histogram
+ * after the end of their lumisection, and not before the end of an earlier one.
+ */
+using namespace dqm::impl;
+
+namespace {
+  constexpr unsigned int kRun = 1;
+  constexpr unsigned int kThreads = 4;
+
+  edm::GlobalContext globalContext(edm::GlobalContext::Transition transition, unsigned int lumi) {
+    return edm::GlobalContext(transition,
+                              edm::LuminosityBlockID(kRun, lumi),
+                              edm::RunIndex::invalidRunIndex(),
+                              edm::LuminosityBlockIndex::invalidLuminosityBlockIndex(),
+                              edm::Timestamp(),
+                              nullptr);
+  }
+
+  // fill the histogram from an event method of a module, on kThreads threads
+  void fillInEvents(edm::ActivityRegistry& ar,
+                    ConcurrentMonitorElement const& me,
+                    std::vector<std::pair<unsigned int, double>> const& lumisAndValues,
+                    unsigned int fills) {
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&]() {
+        edm::ModuleDescription md;
+        edm::ModuleCallingContext mcc(&md);
+        for (auto const& lumiAndValue : lumisAndValues) {
+          edm::StreamContext sc(edm::StreamID::invalidStreamID(),
+                                edm::StreamContext::Transition::kEvent,
+                                edm::EventID(kRun, lumiAndValue.first, 1),
+                                edm::RunIndex::invalidRunIndex(),
+                                edm::LuminosityBlockIndex::invalidLuminosityBlockIndex(),
+                                edm::Timestamp(),
+                                nullptr);
+          ar.preModuleEventSignal_(sc, mcc);
+          for (unsigned int i = 0; i < fills; ++i)
+            me.fill(lumiAndValue.second);
+          ar.postModuleEventSignal_(sc, mcc);
+        }
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+  }
+
+  bool check(MonitorElement* me, double value, double expected, char const* when) {
+    double content = me->getBinContent(me->getTH1()->FindBin(value));
+    if (content != expected) {
+      std::cout << "Error: " << when << ", the bin of " << value << " has " << content << " entries instead of "
+                << expected << std::endl;
+      return false;
+    }
+    return true;
+  }
+}  // namespace
+
+int main(int argc, char** argv) {
+  edm::ParameterSet pset;
+  pset.addUntrackedParameter<bool>("bufferConcurrentFills", true);
+  edm::ActivityRegistry ar;
+  DQMStore store(pset, ar);
+
+  ConcurrentMonitorElement histo;
+  store.bookConcurrentTransaction(
+      [&](DQMStore::ConcurrentBooker& booker) {
+        booker.setCurrentFolder("Test");
+        histo = booker.book1D("Histo", "Histo", 10, 0., 10.);
+      },
+      kRun);
+  MonitorElement* me = nullptr;
+  store.meBookerGetter([&](DQMStore::IBooker&, DQMStore::IGetter& getter) { me = getter.get("Test/Histo"); });
+  if (me == nullptr) {
+    std::cout << "Error: the histogram was not booked" << std::endl;
+    return 1;
+  }
+
+  // nested module calls on a thread restore the lumisection of the outer one
+  ConcurrentFillBuffer::enterLumi(1);
+  ConcurrentFillBuffer::enterLumi(2);
+  ConcurrentFillBuffer::leaveLumi();
+  if (ConcurrentFillBuffer::currentLumi() != 1) {
+    std::cout << "Error: the lumisection of the outer module call was not restored" << std::endl;
+    return 1;
+  }
+  ConcurrentFillBuffer::leaveLumi();
+
+  // two concurrent lumisections: the fills of lumi 1 are more than the buffers
+  // can hold, while those of lumi 2 stay buffered until its end
+  ar.preGlobalBeginLumiSignal_(globalContext(edm::GlobalContext::Transition::kBeginLuminosityBlock, 1));
+  ar.preGlobalBeginLumiSignal_(globalContext(edm::GlobalContext::Transition::kBeginLuminosityBlock, 2));
+  fillInEvents(ar, histo, {{2, 2.5}, {1, 1.5}, {2, 2.5}}, 50);
+  fillInEvents(ar, histo, {{1, 1.5}}, 1000);
+
+  // outside of the event processing the histogram is filled directly
+  histo.fill(7.5);
+  if (not check(me, 7.5, 1, "outside of the events"))
+    return 1;
+
+  ar.preGlobalEndLumiSignal_(globalContext(edm::GlobalContext::Transition::kEndLuminosityBlock, 1));
+  if (not check(me, 1.5, kThreads * 1050, "after the end of lumi 1") or
+      not check(me, 2.5, 0, "after the end of lumi 1"))
+    return 1;
+
+  ar.preGlobalEndLumiSignal_(globalContext(edm::GlobalContext::Transition::kEndLuminosityBlock, 2));
+  if (not check(me, 2.5, kThreads * 100, "after the end of lumi 2"))
+    return 1;
+
+  // the end of the run replays the fills of all the lumisections
+  ar.preGlobalBeginLumiSignal_(globalContext(edm::GlobalContext::Transition::kBeginLuminosityBlock, 3));
+  fillInEvents(ar, histo, {{3, 3.5}}, 50);
+  ar.preGlobalEndRunSignal_(globalContext(edm::GlobalContext::Transition::kEndRun, 0));
+  if (not check(me, 3.5, kThreads * 50, "after the end of the run"))
+    return 1;
+
+  // and the later fills are not lost
+  fillInEvents(ar, histo, {{3, 4.5}}, 10);
+  if (not check(me, 4.5, kThreads * 10, "for the fills after the end of the run"))
+    return 1;
+
+  if (me->getTH1()->GetEntries() != kThreads * 1210 + 1) {
+    std::cout << "Error: the histogram has " << me->getTH1()->GetEntries() << " entries instead of "
+              << kThreads * 1210 + 1 << std::endl;
+    return 1;
+  }
+
+  // test was ok
+  return 0;
+}
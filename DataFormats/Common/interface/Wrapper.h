@@ -70,6 +70,7 @@ namespace edm {
                           std::vector<void const*>& oPtr) const override;
 
     std::shared_ptr<soa::TableExaminerBase> tableExaminer_() const override;
+    std::shared_ptr<soa::TableFillerBase> tableFiller_() override;
 
   private:
     // We wish to disallow copy construction and assignment.
@@ -153,12 +154,23 @@ namespace edm {
         return std::shared_ptr<edm::soa::TableExaminerBase>{};
       }
     };
+    template <class T>
+    struct MakeTableFiller {
+      static std::shared_ptr<edm::soa::TableFillerBase> make(void*) {
+        return std::shared_ptr<edm::soa::TableFillerBase>{};
+      }
+    };
   }  // namespace soa
   template <typename T>
   inline std::shared_ptr<edm::soa::TableExaminerBase> Wrapper<T>::tableExaminer_() const {
     return soa::MakeTableExaminer<T>::make(&obj);
   }
 
+  template <typename T>
+  inline std::shared_ptr<edm::soa::TableFillerBase> Wrapper<T>::tableFiller_() {
+    return soa::MakeTableFiller<T>::make(&obj);
+  }
+
 }  // namespace edm
 
 #include "DataFormats/Common/interface/WrapperView.icc"
@@ -18,6 +18,7 @@ WrapperBase: The base class of all things that will be inserted into the Event.
 namespace edm {
   namespace soa {
     class TableExaminerBase;
+    class TableFillerBase;
   }
 
   class WrapperBase : public ViewTypeChecker {
@@ -53,6 +54,8 @@ namespace edm {
     void swapProduct(WrapperBase* newProduct) { swapProduct_(newProduct); }
 
     std::shared_ptr<soa::TableExaminerBase> tableExaminer() const { return tableExaminer_(); }
+    // Used when reading a product whose Table columns are stored in their own branches
+    std::shared_ptr<soa::TableFillerBase> tableFiller() { return tableFiller_(); }
 
   private:
     virtual std::type_info const& dynamicTypeInfo_() const = 0;
@@ -81,6 +84,7 @@ namespace edm {
                                   std::vector<void const*>& oPtr) const = 0;
 
     virtual std::shared_ptr<soa::TableExaminerBase> tableExaminer_() const = 0;
+    virtual std::shared_ptr<soa::TableFillerBase> tableFiller_() = 0;
   };
 }  // namespace edm
 #endif
@@ -92,6 +92,9 @@ private:
   const bool alwaysStartFromFirstLS_;
   const bool verifyChecksum_;
   const bool useL1EventID_;
+  // map raw file chunks into memory instead of copying them with read(2); the FED data are still
+  // copied from the mapping into the FEDRawDataCollection, which owns its storage
+  bool useMmap_;
   std::vector<std::string> fileNames_;
   bool useFileBroker_;
   //std::vector<std::string> fileNamesSorted_;
@@ -184,18 +187,39 @@ struct InputChunk {
   unsigned int fileIndex_;
   std::atomic<bool> readComplete_;
 
-  InputChunk(unsigned int index, uint32_t size) : size_(size), index_(index) {
-    buf_ = new unsigned char[size_];
+  bool mapped_;
+  //owned copy of the events spanning the end of a mapped chunk, the mapping itself is read-only
+  std::unique_ptr<unsigned char[]> spanBuf_;
+
+  InputChunk(unsigned int index, uint32_t size, bool mapped = false) : size_(size), index_(index), mapped_(mapped) {
+    buf_ = mapped_ ? nullptr : new unsigned char[size_];
     reset(0, 0, 0);
   }
   void reset(unsigned int newOffset, unsigned int toRead, unsigned int fileIndex) {
+    unmap();
     offset_ = newOffset;
     usedSize_ = toRead;
     fileIndex_ = fileIndex;
     readComplete_ = false;
   }
+  //map usedSize_ bytes of the file at offset_, read-only
+  bool map(int fd);
+  void unmap();
+  //where an event spanning the end of this chunk is assembled
+  unsigned char* spanBuffer() {
+    if (!mapped_)
+      return buf_;
+    if (!spanBuf_)
+      spanBuf_.reset(new unsigned char[size_]);
+    return spanBuf_.get();
+  }
 
-  ~InputChunk() { delete[] buf_; }
+  ~InputChunk() {
+    if (mapped_)
+      unmap();
+    else
+      delete[] buf_;
+  }
 };
 
 struct InputFile {
@@ -5,6 +5,7 @@
 #include <sstream>
 #include <sys/types.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/time.h>
 #include <unistd.h>
 #include <vector>
@@ -61,6 +62,7 @@ FedRawDataInputSource::FedRawDataInputSource(edm::ParameterSet const& pset, edm:
       alwaysStartFromFirstLS_(pset.getUntrackedParameter<bool>("alwaysStartFromFirstLS", false)),
       verifyChecksum_(pset.getUntrackedParameter<bool>("verifyChecksum", true)),
       useL1EventID_(pset.getUntrackedParameter<bool>("useL1EventID", false)),
+      useMmap_(pset.getUntrackedParameter<bool>("useMmap", false)),
       fileNames_(pset.getUntrackedParameter<std::vector<std::string>>("fileNames", std::vector<std::string>())),
       fileListMode_(pset.getUntrackedParameter<bool>("fileListMode", false)),
       fileListLoopMode_(pset.getUntrackedParameter<bool>("fileListLoopMode", false)),
@@ -107,6 +109,11 @@ FedRawDataInputSource::FedRawDataInputSource(edm::ParameterSet const& pset, edm:
   singleBufferMode_ = !(numBuffers_ > 1);
   readingFilesCount_ = 0;
 
+  if (useMmap_ && singleBufferMode_) {
+    edm::LogWarning("FedRawDataInputSource") << "useMmap requires numBuffers > 1, falling back to buffered read";
+    useMmap_ = false;
+  }
+
   if (!crc32c_hw_test())
     edm::LogError("FedRawDataInputSource::FedRawDataInputSource") << "Intel crc32c checksum computation unavailable";
 
@@ -141,7 +148,7 @@ FedRawDataInputSource::FedRawDataInputSource(edm::ParameterSet const& pset, edm:
   }
   //should delete chunks when run stops
   for (unsigned int i = 0; i < numBuffers_; i++) {
-    freeChunks_.push(new InputChunk(i, eventChunkSize_));
+    freeChunks_.push(new InputChunk(i, eventChunkSize_, useMmap_));
   }
 
   quit_threads_ = false;
@@ -208,6 +215,10 @@ void FedRawDataInputSource::fillDescriptions(edm::ConfigurationDescriptions& des
       ->setComment("Verify event CRC-32C checksum of FRDv5 and higher or Adler32 with v3 and v4");
   desc.addUntracked<bool>("useL1EventID", false)
       ->setComment("Use L1 event ID from FED header if true or from TCDS FED if false");
+  desc.addUntracked<bool>("useMmap", false)
+      ->setComment(
+          "Map raw file chunks into memory instead of reading them into buffers (requires numBuffers > 1); "
+          "the FED data are still copied from the mapping into the FEDRawDataCollection");
   desc.addUntracked<bool>("fileListMode", false)
       ->setComment("Use fileNames parameter to directly specify raw files to open");
   desc.addUntracked<std::vector<std::string>>("fileNames", std::vector<std::string>())
@@ -1263,7 +1274,18 @@ void FedRawDataInputSource::readWorker(unsigned int tid) {
 
     unsigned int skipped = bufferLeft;
     auto start = std::chrono::high_resolution_clock::now();
-    for (unsigned int i = 0; i < readBlocks_; i++) {
+    if (useMmap_) {
+      //the mapping covers the file header too, giving the same chunk layout as read(2) at the inherited position
+      if (!chunk->map(fileDescriptor)) {
+        edm::LogError("FedRawDataInputSource") << "readWorker failed to map file -: " << file->fileName_
+                                               << " fd:" << fileDescriptor << " offset:" << chunk->offset_
+                                               << " size:" << chunk->usedSize_ << " error: " << strerror(errno);
+        setExceptionState_ = true;
+        continue;
+      }
+      bufferLeft = chunk->usedSize_;
+    }
+    for (unsigned int i = 0; i < readBlocks_ && !useMmap_; i++) {
       ssize_t last;
 
       //protect against reading into next block
@@ -1344,11 +1366,10 @@ inline bool InputFile::advance(unsigned char*& dataPosition, const size_t size)
       if (parent_->exceptionState())
         parent_->threadError();
     }
-    //copy everything to beginning of the first chunk
-    dataPosition -= chunkPosition_;
-    assert(dataPosition == chunks_[currentChunk_]->buf_);
-    memmove(chunks_[currentChunk_]->buf_, chunks_[currentChunk_]->buf_ + chunkPosition_, currentLeft);
-    memcpy(chunks_[currentChunk_]->buf_ + currentLeft, chunks_[currentChunk_ + 1]->buf_, size - currentLeft);
+    //copy everything to beginning of the first chunk (or of its own buffer if the chunk is mapped)
+    dataPosition = chunks_[currentChunk_]->spanBuffer();
+    memmove(dataPosition, chunks_[currentChunk_]->buf_ + chunkPosition_, currentLeft);
+    memcpy(dataPosition + currentLeft, chunks_[currentChunk_ + 1]->buf_, size - currentLeft);
     //set pointers at the end of the old data position
     bufferPosition_ += size;
     chunkPosition_ = size - currentLeft;
@@ -1365,7 +1386,7 @@ inline void InputFile::moveToPreviousChunk(const size_t size, const size_t offse
   //this will fail in case of events that are too large
   assert(size < chunks_[currentChunk_]->size_ - chunkPosition_);
   assert(size - offset < chunks_[currentChunk_]->size_);
-  memcpy(chunks_[currentChunk_ - 1]->buf_ + offset, chunks_[currentChunk_]->buf_ + chunkPosition_, size);
+  memcpy(chunks_[currentChunk_ - 1]->spanBuffer() + offset, chunks_[currentChunk_]->buf_ + chunkPosition_, size);
   chunkPosition_ += size;
   bufferPosition_ += size;
 }
@@ -1375,6 +1396,27 @@ inline void InputFile::rewindChunk(const size_t size) {
   bufferPosition_ -= size;
 }
 
+bool InputChunk::map(int fd) {
+  assert(mapped_ && buf_ == nullptr);
+  if (!usedSize_)
+    return true;
+  void* addr = mmap(nullptr, usedSize_, PROT_READ, MAP_SHARED, fd, offset_);
+  if (addr == MAP_FAILED)
+    return false;
+  //the chunk is read once from start to end, start the read-ahead from the reader thread
+  madvise(addr, usedSize_, MADV_SEQUENTIAL);
+  madvise(addr, usedSize_, MADV_WILLNEED);
+  buf_ = static_cast<unsigned char*>(addr);
+  return true;
+}
+
+void InputChunk::unmap() {
+  if (mapped_ && buf_ != nullptr) {
+    munmap(buf_, usedSize_);
+    buf_ = nullptr;
+  }
+}
+
 InputFile::~InputFile() {
   if (rawFd_ != -1)
     close(rawFd_);
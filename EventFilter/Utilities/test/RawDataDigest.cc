@@ -0,0 +1,59 @@
+/** \file
+ *
+ *  Writes one line per event with its id and an Adler32 checksum of the FED ids, sizes and data
+ *  of its FEDRawDataCollection, so that the events read by different input modes can be compared.
+ *
+*/
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Adler32Calculator.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
+#include "DataFormats/FEDRawData/interface/FEDNumbering.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+namespace test {
+
+  class RawDataDigest : public edm::one::EDAnalyzer<> {
+  private:
+    edm::EDGetTokenT<FEDRawDataCollection> m_fedRawDataCollectionToken;
+    std::ofstream m_output;
+
+  public:
+    RawDataDigest(const edm::ParameterSet& pset)
+        : m_fedRawDataCollectionToken(consumes<FEDRawDataCollection>(
+              pset.getUntrackedParameter<edm::InputTag>("inputTag", edm::InputTag("source")))),
+          m_output(pset.getUntrackedParameter<std::string>("outputFile")) {
+      if (!m_output) {
+        throw cms::Exception("RawDataDigest")
+            << "cannot open " << pset.getUntrackedParameter<std::string>("outputFile");
+      }
+    }
+
+    void analyze(const edm::Event& e, const edm::EventSetup& c) override {
+      edm::Handle<FEDRawDataCollection> rawdata;
+      e.getByToken(m_fedRawDataCollectionToken, rawdata);
+      uint32_t a = 1, b = 0;
+      size_t totalSize = 0;
+      for (int fedId = 0; fedId <= FEDNumbering::lastFEDId(); ++fedId) {
+        const FEDRawData& data = rawdata->FEDData(fedId);
+        if (data.size() == 0)
+          continue;
+        const uint64_t header[2] = {uint64_t(fedId), uint64_t(data.size())};
+        cms::Adler32(reinterpret_cast<const char*>(header), sizeof(header), a, b);
+        cms::Adler32(reinterpret_cast<const char*>(data.data()), data.size(), a, b);
+        totalSize += data.size();
+      }
+      m_output << e.id().run() << " " << e.luminosityBlock() << " " << e.id().event() << " " << totalSize << " "
+               << ((b << 16) | a) << "\n";
+    }
+  };
+  DEFINE_FWK_MODULE(RawDataDigest);
+}  // namespace test
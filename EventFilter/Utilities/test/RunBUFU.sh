@@ -1,7 +1,7 @@
 #!/bin/bash
 SCRIPTDIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
 
-function die { echo Failure $1: status $2 ; rm -rf $3/{ramdisk,data,*.py}; exit $2 ; }
+function die { echo Failure $1: status $2 ; rm -rf $3/{ramdisk,ramdisk_orig,data,*.py}; exit $2 ; }
 
 if [ -z  $LOCAL_TEST_DIR ]; then
 LOCAL_TEST_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
@@ -43,8 +43,41 @@ CMDLINE_STARTFU="cmsRun startFU.py runNumber=101 fffBaseDir=${OUTDIR}"
 ${CMDLINE_STARTBU}  > out_2_bu.log 2>&1 || die "${CMDLINE_STARTBU}" $? $OUTDIR
 ${CMDLINE_STARTFU}  > out_2_fu.log 2>&1 || die "${CMDLINE_STARTFU}" $? $OUTDIR
 
+rm -rf $OUTDIR/{ramdisk,data}
+
+
+echo "Running test with mapped input chunks"
+#files of about 2 MB read in 1 MB chunks, so that events span the chunk boundaries
+CMDLINE_STARTBU="cmsRun startBU.py runNumber=101 fffBaseDir=${OUTDIR} maxLS=2 fedMeanSize=128 eventsPerFile=11 eventsPerLS=35 frdFileVersion=1"
+${CMDLINE_STARTBU}  > out_3_bu.log 2>&1 || die "${CMDLINE_STARTBU}" $? $OUTDIR
+if [ -z "$(find ${OUTDIR}/ramdisk -name '*.raw' -size +1024k)" ]; then
+  die "no raw file spans several chunks" 1 $OUTDIR
+fi
+#the input source deletes the files it has read, keep them for the next modes
+cp -r ${OUTDIR}/ramdisk ${OUTDIR}/ramdisk_orig
+
+i=3
+for mode in "useMmap=False numBuffers=2" "useMmap=True numBuffers=2" "useMmap=True numBuffers=1"; do
+  DIGEST=digest_$(echo ${mode} | tr ' =' '__').txt
+  CMDLINE_STARTFU="cmsRun startFU.py runNumber=101 fffBaseDir=${OUTDIR} eventChunkSize=1 ${mode} digestFile=${OUTDIR}/${DIGEST}"
+  ${CMDLINE_STARTFU}  > out_${i}_fu.log 2>&1 || die "${CMDLINE_STARTFU}" $? $OUTDIR
+  sort ${DIGEST} -o ${DIGEST}
+  rm -rf $OUTDIR/{ramdisk,data}
+  cp -r ${OUTDIR}/ramdisk_orig ${OUTDIR}/ramdisk
+  i=$((i+1))
+done
+#the numBuffers=1 job falls back to buffered reads
+grep -q "useMmap requires numBuffers > 1" out_5_fu.log || die "no fallback to buffered reads with numBuffers=1" 1 $OUTDIR
+
+REFERENCE=digest_useMmap_False_numBuffers_2.txt
+[ $(wc -l < ${REFERENCE}) -eq 70 ] || die "${REFERENCE} does not have 70 events" 1 $OUTDIR
+for DIGEST in digest_useMmap_True_numBuffers_2.txt digest_useMmap_True_numBuffers_1.txt; do
+  diff ${REFERENCE} ${DIGEST} > /dev/null || die "the raw data of ${DIGEST} differ from ${REFERENCE}" 1 $OUTDIR
+done
+rm -rf $OUTDIR/ramdisk_orig
+
 
 #no failures, clean up everything including logs if there are no errors
-rm -rf $OUTDIR/{ramdisk,data,*.py,*.log}
+rm -rf $OUTDIR/{ramdisk,data,*.py,*.log,*.txt}
 
 exit ${RC}
@@ -41,6 +41,29 @@ options.register ('numFwkStreams',
                   VarParsing.VarParsing.varType.int,          # string, int, or float
                   "Number of CMSSW streams")
 
+options.register ('numBuffers',
+                  2, # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.int,          # string, int, or float
+                  "Number of input chunks")
+
+options.register ('eventChunkSize',
+                  8, # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.int,          # string, int, or float
+                  "Size of the input chunks in MB")
+
+options.register ('useMmap',
+                  False, # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.bool,
+                  "Map the input chunks instead of reading them")
+
+options.register ('digestFile',
+                  '', # default value
+                  VarParsing.VarParsing.multiplicity.singleton,
+                  VarParsing.VarParsing.varType.string,          # string, int, or float
+                  "Write a checksum of the raw data of each event to this file")
 
 options.parseArguments()
 
@@ -85,10 +108,11 @@ process.source = cms.Source("FedRawDataInputSource",
     getLSFromFilename = cms.untracked.bool(True),
     verifyChecksum = cms.untracked.bool(True),
     useL1EventID = cms.untracked.bool(True),
-    eventChunkSize = cms.untracked.uint32(8),
-    eventChunkBlock = cms.untracked.uint32(8),
-    numBuffers = cms.untracked.uint32(2),
-    maxBufferedFiles = cms.untracked.uint32(2)
+    eventChunkSize = cms.untracked.uint32(options.eventChunkSize),
+    eventChunkBlock = cms.untracked.uint32(options.eventChunkSize),
+    numBuffers = cms.untracked.uint32(options.numBuffers),
+    maxBufferedFiles = cms.untracked.uint32(2),
+    useMmap = cms.untracked.bool(options.useMmap)
 )
 
 process.PrescaleService = cms.Service( "PrescaleService",
@@ -123,6 +147,12 @@ process.b = cms.EDAnalyzer("ExceptionGenerator",
 process.p1 = cms.Path(process.a*process.filter1)
 process.p2 = cms.Path(process.b*process.filter2)
 
+if options.digestFile:
+  process.digest = cms.EDAnalyzer("RawDataDigest",
+      outputFile = cms.untracked.string(options.digestFile)
+  )
+  process.p3 = cms.Path(process.digest)
+
 process.streamA = cms.OutputModule("EvFOutputModule",
     SelectEvents = cms.untracked.PSet(SelectEvents = cms.vstring( 'p1' ))
 )
@@ -10,6 +10,7 @@ PSet script.   See notes in EventProcessor.cpp for details about it.
 #include "FWCore/MessageLogger/interface/MessageDrop.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetSnapshot.h"
 #include "FWCore/ParameterSet/interface/ProcessDesc.h"
 #include "FWCore/ParameterSet/interface/validateTopLevelParameterSets.h"
 #include "FWCore/PluginManager/interface/PluginManager.h"
@@ -265,11 +266,25 @@ int main(int argc, char* argv[]) {
       jobRep.reset(new edm::serviceregistry::ServiceWrapper<edm::JobReport>(std::move(jobRepPtr)));
       edm::ServiceToken jobReportToken = edm::ServiceRegistry::createContaining(jobRep);
 
-      context = "Processing the python configuration file named ";
+      // A snapshot written by edmConfigSnapshot is already fully processed and is read without python
+      bool const snapshot = edm::isParameterSetSnapshot(fileName);
+      if (snapshot && vm.count(kPythonOpt)) {
+        edm::LogAbsolute("CommandLineProcessing")
+            << "cmsRun: Options cannot be passed to python when the configuration is a snapshot.\n"
+            << "They have to be given to edmConfigSnapshot when writing the snapshot.";
+        return edm::errors::CommandLineProcessing;
+      }
+      context = snapshot ? "Reading the configuration snapshot named "
+                         : "Processing the python configuration file named ";
       context += fileName;
       std::shared_ptr<edm::ProcessDesc> processDesc;
       try {
-        std::unique_ptr<edm::ParameterSet> parameterSet = edm::readConfig(fileName, argc, argv);
+        std::unique_ptr<edm::ParameterSet> parameterSet;
+        if (snapshot) {
+          parameterSet = edm::readParameterSetSnapshot(fileName);
+        } else {
+          parameterSet = edm::readConfig(fileName, argc, argv);
+        }
         processDesc.reset(new edm::ProcessDesc(std::move(parameterSet)));
       } catch (cms::Exception& iException) {
         edm::Exception e(edm::errors::ConfigFileReadError, "", iException);
@@ -0,0 +1,17 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TABLEREAD")
+
+process.source = cms.Source("PoolSource", fileNames = cms.untracked.vstring("file:testTableTest.root"))
+
+anInts = [1,2,3]
+aFloats = [4.,5., 6.]
+aStrings =["einie", "meanie", "meinie"]
+
+process.checkTable = cms.EDAnalyzer("edmtest::TableTestAnalyzer",
+                                    table = cms.untracked.InputTag("tableTest"),
+                                    anInts = cms.untracked.vint32(*anInts),
+                                    aFloats = cms.untracked.vdouble(*aFloats),
+                                    aStrings = cms.untracked.vstring(*aStrings) )
+
+process.p = cms.Path(process.checkTable)
@@ -2,4 +2,5 @@
 
 function die { echo $1: status $2 ;  exit $2; }
 
-cmsRun ${LOCAL_TEST_DIR}/testTableTest_cfg.py || die 'Failed in testTableTest_cfg.py' $?
\ No newline at end of file
+cmsRun ${LOCAL_TEST_DIR}/testTableTest_cfg.py || die 'Failed in testTableTest_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/testTableTestRead_cfg.py || die 'Failed in testTableTestRead_cfg.py' $?
@@ -0,0 +1,73 @@
+#ifndef FWCore_MessageService_MessageRingBuffers_h
+#define FWCore_MessageService_MessageRingBuffers_h
+
+// ----------------------------------------------------------------------
+//
+// MessageRingBuffers.h
+//
+// Messages waiting to be logged by the asynchronous drain of the
+// ThreadSafeLogMessageLoggerScribe.
+//
+// Each thread which logs gets its own single-producer/single-consumer
+// ring, so that queueing a message takes no lock and does not contend
+// with the other threads.  The rings are emptied by a single consumer,
+// which gets the messages in the order of their serial numbers.
+//
+// When the ring of a thread is full, the message is either dropped and
+// counted (OverflowPolicy::drop) or the thread waits for the consumer to
+// make room (OverflowPolicy::wait).
+//
+// -----------------------------------------------------------------------
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace edm {
+
+  class ErrorObj;
+
+  namespace service {
+
+    class MessageRingBuffers {
+    public:
+      enum class OverflowPolicy { drop, wait };
+
+      // capacity of each ring, rounded up to a power of 2
+      MessageRingBuffers(unsigned int capacity, OverflowPolicy policy);
+      ~MessageRingBuffers();
+
+      MessageRingBuffers(MessageRingBuffers const&) = delete;
+      MessageRingBuffers& operator=(MessageRingBuffers const&) = delete;
+
+      // --- producers (any thread):
+      // takes ownership of the message unless false is returned, which happens
+      // when there are too many threads for the thread to get a ring
+      bool push(ErrorObj* errorobj_p);
+
+      // --- consumer (one thread at a time):
+      // appends the queued messages to "messages", in the order of their serial numbers
+      void popAll(std::vector<ErrorObj*>& messages);
+
+      unsigned long dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+      struct Ring;
+
+      Ring* threadRing();
+
+      static constexpr unsigned int maxRings = 1024;
+
+      const unsigned int m_mask;
+      const OverflowPolicy m_policy;
+      const unsigned long m_id;  // identifies this instance for the thread-local ring cache
+      std::atomic<unsigned int> m_nRings;
+      std::array<std::atomic<Ring*>, maxRings> m_rings;
+      std::atomic<unsigned long> m_dropped;
+    };
+
+  }  // end of namespace service
+}  // namespace edm
+
+#endif  // FWCore_MessageService_MessageRingBuffers_h
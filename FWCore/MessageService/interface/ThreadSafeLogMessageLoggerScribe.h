@@ -6,6 +6,7 @@
 
 #include "FWCore/MessageService/interface/ELdestination.h"
 #include "FWCore/MessageService/interface/MessageLoggerDefaults.h"
+#include "FWCore/MessageService/interface/MessageRingBuffers.h"
 #include "FWCore/MessageLogger/interface/MessageLoggerQ.h"
 #include "FWCore/MessageLogger/interface/AbstractMLscribe.h"
 
@@ -19,6 +20,8 @@
 
 #include <iostream>
 #include <atomic>
+#include <mutex>
+#include <thread>
 #include "tbb/concurrent_queue.h"
 
 namespace edm {
@@ -30,6 +33,11 @@ namespace edm {
     //
     // OpCodeLOG_A_MESSAGE messages can be handled from multiple threads
     //
+    // With asynchronous_logging, the messages below ERROR are queued in
+    // per-thread MessageRingBuffers and sent to the destinations by a drain
+    // thread. Messages of higher severity and the other commands first send
+    // the messages queued before them.
+    //
     // -----------------------------------------------------------------------
 
     class ELadministrator;
@@ -59,6 +67,13 @@ namespace edm {
       // --- log one consumed message
       void log(ErrorObj* errorobj_p);
 
+      // --- asynchronous logging:
+      void startDrain(unsigned int ringSize, MessageRingBuffers::OverflowPolicy policy);
+      void stopDrain();
+      bool drain();        // send the queued messages, returns false if there was none
+      bool drainLocked();  // same, with m_drainMutex already held
+      void route(ErrorObj* errorobj_p, std::vector<std::string>& categories);
+
       // --- cause statistics destinations to output
       void triggerStatisticsSummaries();
       void triggerFJRmessageSummary(std::map<std::string, double>& sm);
@@ -107,6 +122,11 @@ namespace edm {
       tbb::concurrent_queue<ErrorObj*> m_waitingMessages;
       size_t m_waitingThreshold;
       std::atomic<unsigned long> m_tooManyWaitingMessagesCount;
+      std::unique_ptr<MessageRingBuffers> m_rings;
+      std::atomic<bool> m_asynchronous;
+      std::atomic<bool> m_stopDrain;
+      std::recursive_mutex m_drainMutex;  // serializes the consumers of m_rings and the other commands
+      std::thread m_drainThread;
 
     };  // ThreadSafeLogMessageLoggerScribe
 
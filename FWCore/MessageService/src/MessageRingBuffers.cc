@@ -0,0 +1,114 @@
+// ----------------------------------------------------------------------
+//
+// MessageRingBuffers.cc
+//
+// ----------------------------------------------------------------------
+
+#include "FWCore/MessageService/interface/MessageRingBuffers.h"
+
+#include "FWCore/MessageLogger/interface/ErrorObj.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+  std::atomic<unsigned long> nextInstanceId{1};
+
+  // ring of the current thread for the MessageRingBuffers last used by it
+  struct ThreadRingCache {
+    unsigned long id = 0;
+    void* ring = nullptr;
+  };
+  thread_local ThreadRingCache threadRingCache;
+
+  unsigned int ringSize(unsigned int capacity) {
+    unsigned int size = 2;
+    while (size < capacity)
+      size *= 2;
+    return size;
+  }
+}  // namespace
+
+namespace edm {
+  namespace service {
+
+    struct MessageRingBuffers::Ring {
+      explicit Ring(unsigned int size) : slots(new ErrorObj*[size]), head(0), tail(0) {}
+
+      std::unique_ptr<ErrorObj*[]> slots;
+      alignas(64) std::atomic<unsigned long> head;  // next slot to fill, written by the producer only
+      alignas(64) std::atomic<unsigned long> tail;  // next slot to empty, written by the consumer only
+    };
+
+    MessageRingBuffers::MessageRingBuffers(unsigned int capacity, OverflowPolicy policy)
+        : m_mask(ringSize(capacity) - 1), m_policy(policy), m_id(nextInstanceId++), m_nRings(0), m_dropped(0) {
+      for (auto& ring : m_rings)
+        ring.store(nullptr, std::memory_order_relaxed);
+    }
+
+    MessageRingBuffers::~MessageRingBuffers() {
+      std::vector<ErrorObj*> messages;
+      popAll(messages);
+      for (ErrorObj* errorobj_p : messages)
+        delete errorobj_p;
+      for (auto& ring : m_rings)
+        delete ring.load(std::memory_order_acquire);
+    }
+
+    MessageRingBuffers::Ring* MessageRingBuffers::threadRing() {
+      ThreadRingCache& cache = threadRingCache;
+      if (cache.id == m_id)
+        return static_cast<Ring*>(cache.ring);
+
+      // first message of this thread: the ring is published for the consumer
+      Ring* ring = nullptr;
+      const unsigned int index = m_nRings.fetch_add(1);
+      if (index < maxRings) {
+        ring = new Ring(m_mask + 1);
+        m_rings[index].store(ring, std::memory_order_release);
+      }
+      cache.id = m_id;
+      cache.ring = ring;
+      return ring;
+    }
+
+    bool MessageRingBuffers::push(ErrorObj* errorobj_p) {
+      Ring* ring = threadRing();
+      if (ring == nullptr)
+        return false;
+
+      const unsigned long head = ring->head.load(std::memory_order_relaxed);
+      while (head - ring->tail.load(std::memory_order_acquire) > m_mask) {
+        if (m_policy == OverflowPolicy::drop) {
+          delete errorobj_p;
+          m_dropped.fetch_add(1, std::memory_order_relaxed);
+          return true;
+        }
+        std::this_thread::yield();
+      }
+      ring->slots[head & m_mask] = errorobj_p;
+      ring->head.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    void MessageRingBuffers::popAll(std::vector<ErrorObj*>& messages) {
+      const auto first = messages.size();
+      const unsigned int nRings = std::min(m_nRings.load(std::memory_order_acquire), maxRings);
+      for (unsigned int i = 0; i < nRings; ++i) {
+        Ring* ring = m_rings[i].load(std::memory_order_acquire);
+        if (ring == nullptr)
+          continue;  // being published
+        unsigned long tail = ring->tail.load(std::memory_order_relaxed);
+        const unsigned long head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail)
+          messages.push_back(ring->slots[tail & m_mask]);
+        ring->tail.store(tail, std::memory_order_release);
+      }
+      // each ring is in order already, this restores the order across the threads
+      std::stable_sort(messages.begin() + first, messages.end(), [](ErrorObj const* a, ErrorObj const* b) {
+        return a->serial() < b->serial();
+      });
+    }
+
+  }  // end of namespace service
+}  // end of namespace edm
@@ -59,6 +59,14 @@ namespace edm {
       if (!thresh.empty())
         validateThreshold(thresh, "MessageLogger");
       check<unsigned int>(pset, "MessageLogger", "waiting_threshold");
+      check<bool>(pset, "MessageLogger", "asynchronous_logging");
+      check<unsigned int>(pset, "MessageLogger", "ring_buffer_size");
+      std::string overflow = check<std::string>(pset, "MessageLogger", "ring_buffer_overflow");
+      if (!overflow.empty() && overflow != "drop" && overflow != "wait") {
+        flaws << "MessageLogger"
+              << " PSet: \n"
+              << "ring_buffer_overflow has value " << overflow << " which is not among {drop, wait}\n";
+      }
 
       // Nested PSets
 
@@ -75,13 +83,16 @@ namespace edm {
       // Nothing else -- look for int, unsigned int, bool, float, double, string
 
       noneExcept<int>(pset, "MessageLogger", "int");
-      noneExcept<unsigned int>(pset, "MessageLogger", "unsigned int", "waiting_threshold");
-      noneExcept<bool>(pset, "MessageLogger", "bool", "messageSummaryToJobReport");
+      noneExcept<unsigned int>(pset, "MessageLogger", "unsigned int", vString{"waiting_threshold", "ring_buffer_size"});
+      noneExcept<bool>(pset, "MessageLogger", "bool", vString{"messageSummaryToJobReport", "asynchronous_logging"});
       // Note - at this, the upper MessageLogger PSet level, the use of
       // optionalPSet makes no sense, so we are OK letting that be a flaw
       noneExcept<float>(pset, "MessageLogger", "float");
       noneExcept<double>(pset, "MessageLogger", "double");
-      noneExcept<std::string>(pset, "MessageLogger", "string", "threshold", "generate_preconfiguration_message");
+      noneExcept<std::string>(pset,
+                              "MessageLogger",
+                              "string",
+                              vString{"threshold", "generate_preconfiguration_message", "ring_buffer_overflow"});
 
       // Append explanatory information if flaws were found
 
@@ -23,9 +23,11 @@
 
 #include "FWCore/Utilities/interface/EDMException.h"
 #include "FWCore/Utilities/interface/Algorithms.h"
+#include "FWCore/Utilities/interface/UnixSignalHandlers.h"
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <fstream>
 #include <string>
 #include <csignal>
@@ -48,9 +50,13 @@ namespace edm {
           ,
           m_messageBeingSent(false),
           m_waitingThreshold(100),
-          m_tooManyWaitingMessagesCount(0) {}
+          m_tooManyWaitingMessagesCount(0),
+          m_asynchronous(false),
+          m_stopDrain(false) {}
 
     ThreadSafeLogMessageLoggerScribe::~ThreadSafeLogMessageLoggerScribe() {
+      stopDrain();
+
       //if there are any waiting message, finish them off
       ErrorObj* errorobj_p = nullptr;
       std::vector<std::string> categories;
@@ -72,6 +78,14 @@ namespace edm {
     void ThreadSafeLogMessageLoggerScribe::runCommand(  // changeLog 32
         MessageLoggerQ::OpCode opcode,
         void* operand) {
+      // the commands other than logging use the destinations: with asynchronous logging they
+      // exclude the drain thread, and first send the messages queued before them
+      std::unique_lock<std::recursive_mutex> drainLock;
+      if (opcode != MessageLoggerQ::LOG_A_MESSAGE and m_asynchronous.load(std::memory_order_acquire)) {
+        drainLock = std::unique_lock<std::recursive_mutex>(m_drainMutex);
+        drainLocked();
+      }
+
       switch (opcode) {  // interpret the work item
         default: {
           assert(false);  // can't happen (we certainly hope!)
@@ -159,6 +173,13 @@ namespace edm {
     }  // ThreadSafeLogMessageLoggerScribe::runCommand(opcode, operand)
 
     void ThreadSafeLogMessageLoggerScribe::log(ErrorObj* errorobj_p) {
+      if (m_asynchronous.load(std::memory_order_acquire)) {
+        if (errorobj_p->xid().severity < ELseverityLevel::ELsev_error and m_rings->push(errorobj_p)) {
+          return;
+        }
+        drain();
+      }
+
       bool expected = false;
       std::unique_ptr<ErrorObj> obj(errorobj_p);
       if (m_messageBeingSent.compare_exchange_strong(expected, true)) {
@@ -190,6 +211,89 @@ namespace edm {
       }
     }
 
+    void ThreadSafeLogMessageLoggerScribe::startDrain(unsigned int ringSize,
+                                                      MessageRingBuffers::OverflowPolicy policy) {
+      m_rings = std::make_unique<MessageRingBuffers>(ringSize, policy);
+      m_stopDrain = false;
+      m_drainThread = std::thread([this]() {
+        // signals are handled by the main thread
+        sigset_t oldset;
+        edm::disableAllSigs(&oldset);
+        while (not m_stopDrain.load(std::memory_order_acquire)) {
+          if (not drain()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          }
+        }
+      });
+      m_asynchronous.store(true, std::memory_order_release);
+    }
+
+    void ThreadSafeLogMessageLoggerScribe::stopDrain() {
+      if (not m_drainThread.joinable())
+        return;
+      m_stopDrain.store(true, std::memory_order_release);
+      m_drainThread.join();
+      m_asynchronous.store(false, std::memory_order_release);
+      drain();
+    }
+
+    bool ThreadSafeLogMessageLoggerScribe::drain() {
+      std::lock_guard<std::recursive_mutex> guard(m_drainMutex);
+      return drainLocked();
+    }
+
+    bool ThreadSafeLogMessageLoggerScribe::drainLocked() {
+      std::vector<ErrorObj*> messages;
+      m_rings->popAll(messages);
+      if (messages.empty() and m_waitingMessages.empty())
+        return false;
+
+      bool expected = false;
+      if (not m_messageBeingSent.compare_exchange_strong(expected, true)) {
+        // the thread sending messages (possibly this one, if a destination logged) also sends these
+        for (ErrorObj* errorobj_p : messages)
+          m_waitingMessages.push(errorobj_p);
+        return not messages.empty();
+      }
+      std::vector<std::string> categories;
+      for (ErrorObj* errorobj_p : messages)
+        route(errorobj_p, categories);
+      ErrorObj* errorobj_p = nullptr;
+      while (m_waitingMessages.try_pop(errorobj_p))
+        route(errorobj_p, categories);
+      m_messageBeingSent.store(false);
+      return true;
+    }
+
+    void ThreadSafeLogMessageLoggerScribe::route(ErrorObj* errorobj_p, std::vector<std::string>& categories) {
+      std::unique_ptr<ErrorObj> obj(errorobj_p);
+      if (not active or purge_mode)
+        return;
+      try {
+        categories.clear();
+        parseCategories(errorobj_p->xid().id, categories);
+        for (unsigned int icat = 0; icat < categories.size(); ++icat) {
+          errorobj_p->setID(categories[icat]);
+          admin_p->log(*errorobj_p);  // route the message text
+        }
+      } catch (cms::Exception& e) {
+        ++count;
+        std::cerr << "ThreadSafeLogMessageLoggerScribe caught " << count << " cms::Exceptions, text = \n"
+                  << e.what() << "\n";
+
+        if (count > 25) {
+          cerr << "MessageLogger will no longer be processing "
+               << "messages due to errors (entering purge mode).\n";
+          purge_mode = true;
+        }
+      } catch (...) {
+        std::cerr << "ThreadSafeLogMessageLoggerScribe caught an unknown exception and "
+                  << "will no longer be processing "
+                  << "messages. (entering purge mode)\n";
+        purge_mode = true;
+      }
+    }
+
     void ThreadSafeLogMessageLoggerScribe::configure_errorlog() {
       vString empty_vString;
       String empty_String;
@@ -214,7 +318,15 @@ namespace edm {
       m_waitingThreshold = getAparameter<unsigned int>(*job_pset_p, "waiting_threshold", 100);
       configure_ordinary_destinations();  // Change Log 16
       configure_statistics();             // Change Log 16
-    }                                     // ThreadSafeLogMessageLoggerScribe::configure_errorlog()
+
+      if (getAparameter<bool>(*job_pset_p, "asynchronous_logging", false) and not m_drainThread.joinable()) {
+        unsigned int ringSize = getAparameter<unsigned int>(*job_pset_p, "ring_buffer_size", 1024);
+        String overflow = getAparameter<String>(*job_pset_p, "ring_buffer_overflow", "drop");
+        startDrain(ringSize,
+                   overflow == "wait" ? MessageRingBuffers::OverflowPolicy::wait
+                                      : MessageRingBuffers::OverflowPolicy::drop);
+      }
+    }  // ThreadSafeLogMessageLoggerScribe::configure_errorlog()
 
     void ThreadSafeLogMessageLoggerScribe::configure_dest(std::shared_ptr<ELdestination> dest_ctrl,
                                                           String const& filename) {
@@ -696,7 +808,7 @@ namespace edm {
     void ThreadSafeLogMessageLoggerScribe::triggerStatisticsSummaries() {
       assert(statisticsDestControls.size() == statisticsResets.size());
       for (unsigned int i = 0; i != statisticsDestControls.size(); ++i) {
-        statisticsDestControls[i]->summary(m_tooManyWaitingMessagesCount.load());
+        statisticsDestControls[i]->summary(m_tooManyWaitingMessagesCount.load() + (m_rings ? m_rings->dropped() : 0));
         if (statisticsResets[i])
           statisticsDestControls[i]->wipe();
       }
@@ -0,0 +1,76 @@
+# Unit test configuration file for MessageLogger service:
+# same as u1, with asynchronous logging: the output must be identical
+# threshold levels for destinations
+# limit=0 for a category (needed to avoid time stamps in files to be compared)
+# enabling all (*) LogDebug, with one destination responding
+# verify that by default, the threshold for a destination is INFO
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+import FWCore.Framework.test.cmsExceptionsFatal_cff
+process.options = FWCore.Framework.test.cmsExceptionsFatal_cff.options
+
+process.load("FWCore.MessageService.test.Services_cff")
+
+process.MessageLogger = cms.Service("MessageLogger",
+    asynchronous_logging = cms.untracked.bool(True),
+    ring_buffer_overflow = cms.untracked.string('wait'),
+    u37_infos = cms.untracked.PSet(
+        threshold = cms.untracked.string('INFO'),
+        noTimeStamps = cms.untracked.bool(True),
+        FwkJob = cms.untracked.PSet(
+            limit = cms.untracked.int32(0)
+        ),
+        preEventProcessing = cms.untracked.PSet(
+            limit = cms.untracked.int32(0)
+        )
+    ),
+    u37_warnings = cms.untracked.PSet(
+        threshold = cms.untracked.string('WARNING'),
+        noTimeStamps = cms.untracked.bool(True)
+    ),
+    u37_debugs = cms.untracked.PSet(
+        threshold = cms.untracked.string('DEBUG'),
+        noTimeStamps = cms.untracked.bool(True),
+        FwkJob = cms.untracked.PSet(
+            limit = cms.untracked.int32(0)
+        ),
+        preEventProcessing = cms.untracked.PSet(
+            limit = cms.untracked.int32(0)
+        )
+    ),
+    u37_default = cms.untracked.PSet(
+        noTimeStamps = cms.untracked.bool(True),
+        FwkJob = cms.untracked.PSet(
+            limit = cms.untracked.int32(0)
+        ),
+        preEventProcessing = cms.untracked.PSet(
+            limit = cms.untracked.int32(0)
+        )
+    ),
+    u37_errors = cms.untracked.PSet(
+        threshold = cms.untracked.string('ERROR'),
+        noTimeStamps = cms.untracked.bool(True)
+    ),
+    fwkJobReports = cms.untracked.vstring('u37_job_report.mxml'),
+    debugModules = cms.untracked.vstring('*'),
+    categories = cms.untracked.vstring('preEventProcessing', 
+        'FwkJob'),
+    destinations = cms.untracked.vstring('u37_warnings', 
+        'u37_errors', 
+        'u37_infos', 
+        'u37_debugs', 
+        'u37_default')
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(2)
+)
+
+process.source = cms.Source("EmptySource")
+
+process.sendSomeMessages = cms.EDAnalyzer("UnitTestClient_A")
+
+process.p = cms.Path(process.sendSomeMessages)
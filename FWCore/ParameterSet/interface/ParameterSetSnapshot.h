@@ -0,0 +1,32 @@
+#ifndef FWCore_ParameterSet_ParameterSetSnapshot_h
+#define FWCore_ParameterSet_ParameterSetSnapshot_h
+
+// A snapshot is a compact binary file holding a fully processed top level
+// ParameterSet, with its tracked and untracked parameters, so that a job can
+// be configured again without running the python configuration.
+//
+// Each distinct nested ParameterSet is stored once and referred to by its
+// index in the file.  The ParameterSetID of the top level ParameterSet is
+// stored in the header and checked when the snapshot is read back.
+
+#include "DataFormats/Provenance/interface/ParameterSetID.h"
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+namespace edm {
+
+  class ParameterSet;
+
+  /// write the snapshot of pset, returns the ParameterSetID stored in it
+  ParameterSetID writeParameterSetSnapshot(ParameterSet const& pset, std::ostream& os);
+  ParameterSetID writeParameterSetSnapshot(ParameterSet const& pset, std::string const& fileName);
+
+  std::unique_ptr<ParameterSet> readParameterSetSnapshot(std::istream& is);
+  std::unique_ptr<ParameterSet> readParameterSetSnapshot(std::string const& fileName);
+
+  /// true if the file starts like a snapshot, false for any other file (e.g. a python configuration)
+  bool isParameterSetSnapshot(std::string const& fileName);
+}  // namespace edm
+#endif
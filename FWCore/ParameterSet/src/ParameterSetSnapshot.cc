@@ -0,0 +1,259 @@
+#include "FWCore/ParameterSet/interface/ParameterSetSnapshot.h"
+
+#include "FWCore/ParameterSet/interface/Entry.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetEntry.h"
+#include "FWCore/ParameterSet/interface/VParameterSetEntry.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+// File layout, all integers are 32 bit little endian and all strings are
+// preceded by their length:
+//
+//   magic, version, ParameterSetID of the top level ParameterSet,
+//   number of ParameterSets, then each of them encoded as
+//     number of entries,  then for each: name, Entry::toString()
+//     number of PSets,    then for each: name, tracked, index
+//     number of VPSets,   then for each: name, tracked, size, indices
+//
+// A ParameterSet only refers to ParameterSets written before it, and the
+// top level ParameterSet is the last one.
+
+namespace {
+  char const kMagic[] = {'E', 'D', 'M', 'P', 'S', 'N', 'A', 'P'};
+  constexpr std::uint32_t kVersion = 1;
+
+  void writeInt(std::string& out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+      out += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+  }
+
+  void writeString(std::string& out, std::string const& value) {
+    writeInt(out, value.size());
+    out += value;
+  }
+
+  class Writer {
+  public:
+    // returns the index of pset, which is encoded the first time it is seen
+    std::uint32_t add(edm::ParameterSet const& pset) {
+      std::string code;
+      writeInt(code, pset.tbl().size());
+      for (auto const& item : pset.tbl()) {
+        writeString(code, item.first);
+        writeString(code, item.second.toString());
+      }
+      writeInt(code, pset.psetTable().size());
+      for (auto const& item : pset.psetTable()) {
+        std::uint32_t const index = add(item.second.pset());
+        writeString(code, item.first);
+        code += static_cast<char>(item.second.isTracked());
+        writeInt(code, index);
+      }
+      writeInt(code, pset.vpsetTable().size());
+      for (auto const& item : pset.vpsetTable()) {
+        std::vector<std::uint32_t> indices;
+        for (auto const& element : item.second.vpset()) {
+          indices.push_back(add(element));
+        }
+        writeString(code, item.first);
+        code += static_cast<char>(item.second.isTracked());
+        writeInt(code, indices.size());
+        for (auto index : indices) {
+          writeInt(code, index);
+        }
+      }
+
+      auto const found = indices_.find(code);
+      if (found != indices_.end()) {
+        return found->second;
+      }
+      std::uint32_t const index = codes_.size();
+      indices_.emplace(code, index);
+      codes_.push_back(std::move(code));
+      return index;
+    }
+
+    std::vector<std::string> const& codes() const { return codes_; }
+
+  private:
+    std::vector<std::string> codes_;
+    std::unordered_map<std::string, std::uint32_t> indices_;
+  };
+
+  class Reader {
+  public:
+    explicit Reader(std::string data) : data_(std::move(data)), pos_(0) {}
+
+    bool atEnd() const { return pos_ == data_.size(); }
+
+    std::uint32_t readInt() {
+      need(4);
+      std::uint32_t value = 0;
+      for (int i = 0; i < 4; ++i) {
+        value |= static_cast<std::uint32_t>(static_cast<unsigned char>(data_[pos_ + i])) << (8 * i);
+      }
+      pos_ += 4;
+      return value;
+    }
+
+    bool readBool() {
+      need(1);
+      return data_[pos_++] != 0;
+    }
+
+    std::string readBytes(std::size_t size) {
+      need(size);
+      std::string value(data_, pos_, size);
+      pos_ += size;
+      return value;
+    }
+
+    std::string readString() { return readBytes(readInt()); }
+
+    static void throwCorrupted(char const* what) {
+      throw edm::Exception(edm::errors::ConfigFileReadError)
+          << "The ParameterSet snapshot is corrupted: " << what << ".\n";
+    }
+
+  private:
+    void need(std::size_t size) const {
+      if (data_.size() - pos_ < size) {
+        throwCorrupted("unexpected end of data");
+      }
+    }
+
+    std::string data_;
+    std::size_t pos_;
+  };
+
+  std::string readAll(std::istream& is) {
+    return std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+  }
+}  // namespace
+
+namespace edm {
+
+  ParameterSetID writeParameterSetSnapshot(ParameterSet const& pset, std::ostream& os) {
+    // the ID is calculated on a copy, so that pset itself can still be modified
+    ParameterSet registered(pset);
+    registered.registerIt();
+    ParameterSetID const id = registered.id();
+
+    Writer writer;
+    writer.add(pset);
+
+    std::string header(kMagic, sizeof(kMagic));
+    writeInt(header, kVersion);
+    writeString(header, id.compactForm());
+    writeInt(header, writer.codes().size());
+    os.write(header.data(), header.size());
+    for (auto const& code : writer.codes()) {
+      std::string size;
+      writeInt(size, code.size());
+      os.write(size.data(), size.size());
+      os.write(code.data(), code.size());
+    }
+    if (!os) {
+      throw Exception(errors::Configuration) << "Failed to write the ParameterSet snapshot.\n";
+    }
+    return id;
+  }
+
+  ParameterSetID writeParameterSetSnapshot(ParameterSet const& pset, std::string const& fileName) {
+    std::ofstream os(fileName, std::ios::binary);
+    if (!os) {
+      throw Exception(errors::Configuration) << "Unable to create the ParameterSet snapshot '" << fileName << "'.\n";
+    }
+    return writeParameterSetSnapshot(pset, os);
+  }
+
+  std::unique_ptr<ParameterSet> readParameterSetSnapshot(std::istream& is) {
+    Reader reader(readAll(is));
+    if (reader.readBytes(sizeof(kMagic)) != std::string(kMagic, sizeof(kMagic))) {
+      Reader::throwCorrupted("this is not a ParameterSet snapshot");
+    }
+    std::uint32_t const version = reader.readInt();
+    if (version != kVersion) {
+      throw Exception(errors::ConfigFileReadError)
+          << "The ParameterSet snapshot has version " << version << " but only version " << kVersion
+          << " can be read.\n";
+    }
+    ParameterSetID const id(reader.readString());
+
+    std::uint32_t const nPSets = reader.readInt();
+    if (nPSets == 0) {
+      Reader::throwCorrupted("there is no ParameterSet");
+    }
+    std::vector<ParameterSet> psets;
+    psets.reserve(nPSets);
+    auto pset = [&psets](std::uint32_t index) -> ParameterSet const& {
+      if (index >= psets.size()) {
+        Reader::throwCorrupted("reference to a ParameterSet not yet read");
+      }
+      return psets[index];
+    };
+    for (std::uint32_t i = 0; i < nPSets; ++i) {
+      Reader code(reader.readString());
+      ParameterSet current;
+      for (std::uint32_t n = code.readInt(); n != 0; --n) {
+        std::string const name = code.readString();
+        current.insert(true, name, Entry(name, code.readString()));
+      }
+      for (std::uint32_t n = code.readInt(); n != 0; --n) {
+        std::string const name = code.readString();
+        bool const tracked = code.readBool();
+        current.insertParameterSet(true, name, ParameterSetEntry(pset(code.readInt()), tracked));
+      }
+      for (std::uint32_t n = code.readInt(); n != 0; --n) {
+        std::string const name = code.readString();
+        bool const tracked = code.readBool();
+        std::vector<ParameterSet> vpset;
+        for (std::uint32_t size = code.readInt(); size != 0; --size) {
+          vpset.push_back(pset(code.readInt()));
+        }
+        current.insertVParameterSet(true, name, VParameterSetEntry(vpset, tracked));
+      }
+      if (!code.atEnd()) {
+        Reader::throwCorrupted("unexpected data after a ParameterSet");
+      }
+      psets.push_back(std::move(current));
+    }
+    if (!reader.atEnd()) {
+      Reader::throwCorrupted("unexpected data after the last ParameterSet");
+    }
+
+    auto result = std::make_unique<ParameterSet>(std::move(psets.back()));
+    ParameterSet registered(*result);
+    registered.registerIt();
+    if (registered.id() != id) {
+      throw Exception(errors::ConfigFileReadError)
+          << "The ParameterSetID of the ParameterSet snapshot does not match its content.\n"
+          << "Stored: " << id << " computed: " << registered.id() << "\n";
+    }
+    return result;
+  }
+
+  std::unique_ptr<ParameterSet> readParameterSetSnapshot(std::string const& fileName) {
+    std::ifstream is(fileName, std::ios::binary);
+    if (!is) {
+      throw Exception(errors::ConfigFileNotFound) << "Unable to open the ParameterSet snapshot '" << fileName << "'.\n";
+    }
+    return readParameterSetSnapshot(is);
+  }
+
+  bool isParameterSetSnapshot(std::string const& fileName) {
+    std::ifstream is(fileName, std::ios::binary);
+    char magic[sizeof(kMagic)];
+    return is.read(magic, sizeof(magic)) && std::equal(magic, magic + sizeof(magic), kMagic);
+  }
+}  // namespace edm
@@ -6,10 +6,12 @@
 #include <algorithm>
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <string>
 #include <cassert>
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetSnapshot.h"
 #include "FWCore/Utilities/interface/EDMException.h"
 #include "FWCore/Utilities/interface/Algorithms.h"
 #include "FWCore/Utilities/interface/Digest.h"
@@ -37,6 +39,7 @@ class testps : public CppUnit::TestFixture {
   CPPUNIT_TEST(testCopyFrom);
   CPPUNIT_TEST(testGetParameterAsString);
   CPPUNIT_TEST(calculateIDTest);
+  CPPUNIT_TEST(snapshotTest);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -63,6 +66,7 @@ public:
   void testCopyFrom();
   void testGetParameterAsString();
   void calculateIDTest();
+  void snapshotTest();
   // Still more to do...
 private:
 };
@@ -596,4 +600,47 @@ void testps::testGetParameterAsString() {
   CPPUNIT_ASSERT(vpsetStr == vpsetStr2);
 }
 
+void testps::snapshotTest() {
+  // nested ParameterSets differing only by untracked parameters have the same ID
+  edm::ParameterSet first;
+  first.addParameter<int>("tracked", 1);
+  first.addUntrackedParameter<std::string>("untracked", "first");
+  edm::ParameterSet second(first);
+  second.addUntrackedParameter<std::string>("untracked", "second");
+
+  edm::ParameterSet ps;
+  ps.addParameter<double>("pi", 3.14);
+  ps.addUntrackedParameter<std::vector<std::string> >("names", {"a", "b;c", "<d>"});
+  ps.addParameter<edm::InputTag>("tag", edm::InputTag("label", "instance", "process"));
+  ps.addParameter<edm::ParameterSet>("first", first);
+  ps.addUntrackedParameter<edm::ParameterSet>("second", second);
+  ps.addParameter<std::vector<edm::ParameterSet> >("vps", {first, second, first});
+  ps.addParameter<std::vector<edm::ParameterSet> >("empty", {});
+
+  std::stringstream stream;
+  edm::ParameterSetID const id = edm::writeParameterSetSnapshot(ps, stream);
+  std::string const data = stream.str();
+  CPPUNIT_ASSERT(!ps.isRegistered());
+
+  std::istringstream input(data);
+  std::unique_ptr<edm::ParameterSet> read = edm::readParameterSetSnapshot(input);
+  CPPUNIT_ASSERT(!read->isRegistered());
+  CPPUNIT_ASSERT(read->dump() == ps.dump());
+  CPPUNIT_ASSERT(read->getUntrackedParameterSet("second").getUntrackedParameter<std::string>("untracked") == "second");
+  auto const vps = read->getParameter<std::vector<edm::ParameterSet> >("vps");
+  CPPUNIT_ASSERT(vps.size() == 3);
+  CPPUNIT_ASSERT(vps[1].getUntrackedParameter<std::string>("untracked") == "second");
+  CPPUNIT_ASSERT(vps[2].getUntrackedParameter<std::string>("untracked") == "first");
+  read->registerIt();
+  CPPUNIT_ASSERT(read->id() == id);
+
+  // truncated, or with a modified value
+  std::istringstream truncated(data.substr(0, data.size() - 1));
+  CPPUNIT_ASSERT_THROW(edm::readParameterSetSnapshot(truncated), cms::Exception);
+  std::string modified(data);
+  modified[modified.find("3.14")] = '4';
+  std::istringstream modifiedInput(modified);
+  CPPUNIT_ASSERT_THROW(edm::readParameterSetSnapshot(modifiedInput), cms::Exception);
+}
+
 #include <Utilities/Testing/interface/CppUnit_testdriver.icpp>
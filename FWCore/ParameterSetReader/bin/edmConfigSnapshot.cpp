@@ -0,0 +1,43 @@
+// Runs a python configuration, as cmsRun would, and writes the resulting
+// top level ParameterSet to a binary snapshot.  cmsRun recognizes such a
+// file and configures the job from it without starting python.
+//
+//   edmConfigSnapshot <snapshot file> <configuration file> [python options]
+//
+// The python options are applied when writing the snapshot, the same way
+// cmsRun applies them after the configuration file name.
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetSnapshot.h"
+#include "FWCore/ParameterSetReader/interface/ParameterSetReader.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) try {
+  if (argc < 3) {
+    std::cout << "Usage: edmConfigSnapshot <snapshot file> <configuration file> [python options]" << std::endl;
+    return 1;
+  }
+  std::string const snapshotName(argv[1]);
+  std::string const fileName(argv[2]);
+
+  // python sees the same arguments as in "cmsRun <configuration file> [python options]"
+  std::vector<char*> pythonArgv;
+  pythonArgv.push_back(argv[0]);
+  for (int i = 2; i < argc; ++i) {
+    pythonArgv.push_back(argv[i]);
+  }
+  std::unique_ptr<edm::ParameterSet> parameterSet = edm::readConfig(fileName, pythonArgv.size(), pythonArgv.data());
+  std::cout << edm::writeParameterSetSnapshot(*parameterSet, snapshotName) << std::endl;
+  return 0;
+} catch (cms::Exception const& e) {
+  std::cout << e.explainSelf() << std::endl;
+  return 1;
+} catch (std::exception const& e) {
+  std::cout << e.what() << std::endl;
+  return 1;
+}
@@ -127,6 +127,7 @@
 
 //The following is needed for edm::Wrapper
 #include "FWCore/SOA/interface/TableExaminer.h"
+#include "FWCore/SOA/interface/TableFiller.h"
 
 // forward declarations
 
@@ -450,6 +451,16 @@ namespace edm {
         return std::make_unique<TableExaminer<Table<Args...>>>(iTable);
       }
     };
+
+    template <typename T>
+    struct MakeTableFiller;
+
+    template <typename... Args>
+    struct MakeTableFiller<Table<Args...>> {
+      static std::unique_ptr<TableFillerBase> make(Table<Args...>* iTable) {
+        return std::make_unique<TableFiller<Table<Args...>>>(iTable);
+      }
+    };
   }  // namespace soa
 }  // namespace edm
 #endif
@@ -19,6 +19,8 @@
 //
 
 // system include files
+#include <tuple>
+#include <vector>
 
 // user include files
 #include "FWCore/SOA/interface/TableExaminerBase.h"
@@ -62,6 +64,14 @@ namespace edm {
 
       const std::type_info* typeID() const override final { return &typeid(T); }
 
+      const std::type_info& columnVectorType(unsigned int iColumnIndex) const override final {
+        return columnVectorTypeImpl<0, T::kNColumns>(iColumnIndex);
+      }
+
+      void copyColumnTo(unsigned int iColumnIndex, void* oVector) const override final {
+        copyColumnToImpl<0, T::kNColumns>(iColumnIndex, oVector);
+      }
+
     private:
       template <int I, int S>
       void columnTypesImpl(std::vector<std::type_index>& iV) const {
@@ -82,6 +92,34 @@ namespace edm {
         }
       }
 
+      template <int I, int S>
+      const std::type_info& columnVectorTypeImpl(unsigned int iColumnIndex) const {
+        if constexpr (I != S) {
+          using Layout = typename T::Layout;
+          using Type = typename std::tuple_element<I, Layout>::type::type;
+          if (iColumnIndex == I) {
+            return typeid(std::vector<Type>);
+          }
+          return columnVectorTypeImpl<I + 1, S>(iColumnIndex);
+        } else {
+          return typeid(void);
+        }
+      }
+
+      template <int I, int S>
+      void copyColumnToImpl(unsigned int iColumnIndex, void* oVector) const {
+        if constexpr (I != S) {
+          using Layout = typename T::Layout;
+          using Type = typename std::tuple_element<I, Layout>::type::type;
+          if (iColumnIndex == I) {
+            auto begin = static_cast<Type const*>(m_table->columnAddressByIndex(I));
+            static_cast<std::vector<Type>*>(oVector)->assign(begin, begin + m_table->size());
+            return;
+          }
+          copyColumnToImpl<I + 1, S>(iColumnIndex, oVector);
+        }
+      }
+
       // ---------- member data --------------------------------
       T const* m_table;
     };
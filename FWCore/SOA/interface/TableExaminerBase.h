@@ -49,6 +49,12 @@ namespace edm {
 
       virtual const std::type_info* typeID() const = 0;
 
+      /// type of the std::vector<> of the column type, used to store the column
+      virtual const std::type_info& columnVectorType(unsigned int iColumnIndex) const = 0;
+
+      /// copies the column into the std::vector<> of the column type oVector points to
+      virtual void copyColumnTo(unsigned int iColumnIndex, void* oVector) const = 0;
+
     private:
       // ---------- member data --------------------------------
     };
@@ -0,0 +1,95 @@
+#ifndef FWCore_SOA_TableFiller_h
+#define FWCore_SOA_TableFiller_h
+// -*- C++ -*-
+//
+// Package:     FWCore/SOA
+// Class  :     TableFiller
+//
+/**\class TableFiller TableFiller.h "TableFiller.h"
+
+ Description: Concrete implementation of TableFillerBase
+
+ Usage:
+    Columns of trivially copyable types are copied as a single block of memory.
+
+*/
+//
+
+// system include files
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// user include files
+#include "FWCore/SOA/interface/TableFillerBase.h"
+
+// forward declarations
+namespace edm {
+  namespace soa {
+
+    template <typename T>
+    class TableFiller : public TableFillerBase {
+    public:
+      explicit TableFiller(T* iTable) : m_table(iTable) {}
+
+      TableFiller(const TableFiller<T>&) = default;
+
+      TableFiller<T>& operator=(const TableFiller<T>&) = default;
+
+      ~TableFiller() override {}
+
+      // ---------- const member functions ---------------------
+
+      size_t size() const override final { return m_table->size(); }
+
+      // ---------- member functions ---------------------------
+
+      void reset(size_t iSize) override final {
+        //the columns may not match the size, e.g. if only the size was read
+        *m_table = T();
+        m_table->resize(iSize);
+      }
+
+      bool copyColumnFrom(unsigned int iColumnIndex, void const* iVector) override final {
+        return copyColumnFromImpl<0, T::kNColumns>(iColumnIndex, iVector);
+      }
+
+    private:
+      template <int I, int S>
+      bool copyColumnFromImpl(unsigned int iColumnIndex, void const* iVector) {
+        if constexpr (I != S) {
+          using Layout = typename T::Layout;
+          using ColumnType = typename std::tuple_element<I, Layout>::type;
+          using Type = typename ColumnType::type;
+          if (iColumnIndex == I) {
+            auto const& values = *static_cast<std::vector<Type> const*>(iVector);
+            if (values.size() != m_table->size()) {
+              return false;
+            }
+            if (values.empty()) {
+              return true;
+            }
+            Type* column = &(m_table->template get<ColumnType>(0));
+            if constexpr (std::is_trivially_copyable<Type>::value) {
+              std::memcpy(column, values.data(), values.size() * sizeof(Type));
+            } else {
+              std::copy(values.begin(), values.end(), column);
+            }
+            return true;
+          }
+          return copyColumnFromImpl<I + 1, S>(iColumnIndex, iVector);
+        } else {
+          return false;
+        }
+      }
+
+      // ---------- member data --------------------------------
+      T* m_table;
+    };
+
+  }  // namespace soa
+}  // namespace edm
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef FWCore_SOA_TableFillerBase_h
+#define FWCore_SOA_TableFillerBase_h
+// -*- C++ -*-
+//
+// Package:     FWCore/SOA
+// Class  :     TableFillerBase
+//
+/**\class TableFillerBase TableFillerBase.h "TableFillerBase.h"
+
+ Description: Base class interface for filling the columns of a edm::soa::Table
+
+ Usage:
+    Used when reading a Table whose columns are stored separately from
+ the Table itself, e.g. one ROOT branch per column.
+
+*/
+//
+
+// system include files
+#include <cstddef>
+
+// user include files
+
+// forward declarations
+
+namespace edm {
+  namespace soa {
+
+    class TableFillerBase {
+    public:
+      TableFillerBase() = default;
+      virtual ~TableFillerBase() = default;
+      TableFillerBase(const TableFillerBase&) = default;
+      TableFillerBase& operator=(const TableFillerBase&) = default;
+
+      // ---------- const member functions ---------------------
+      virtual size_t size() const = 0;
+
+      // ---------- member functions ---------------------------
+      /// replaces all the columns by iSize default values
+      virtual void reset(size_t iSize) = 0;
+
+      /** copies the std::vector<> of the column type iVector points to into the column,
+       returns false if its size differs from the size of the Table */
+      virtual bool copyColumnFrom(unsigned int iColumnIndex, void const* iVector) = 0;
+
+    private:
+      // ---------- member data --------------------------------
+    };
+  }  // namespace soa
+}  // namespace edm
+
+#endif
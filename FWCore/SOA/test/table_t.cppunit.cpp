@@ -17,6 +17,7 @@ Changed by Viji on 29-06-2005
 #include "FWCore/SOA/interface/Column.h"
 #include "FWCore/SOA/interface/TableItr.h"
 #include "FWCore/SOA/interface/TableExaminer.h"
+#include "FWCore/SOA/interface/TableFiller.h"
 
 class testTable : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(testTable);
@@ -28,6 +29,7 @@ class testTable : public CppUnit::TestFixture {
   CPPUNIT_TEST(tableColumnTest);
   CPPUNIT_TEST(tableViewConversionTest);
   CPPUNIT_TEST(tableExaminerTest);
+  CPPUNIT_TEST(tableFillerTest);
   CPPUNIT_TEST(tableResizeTest);
   CPPUNIT_TEST(mutabilityTest);
   CPPUNIT_TEST_SUITE_END();
@@ -43,6 +45,7 @@ public:
   void tableColumnTest();
   void tableViewConversionTest();
   void tableExaminerTest();
+  void tableFillerTest();
   void tableResizeTest();
   void mutabilityTest();
 };
@@ -351,6 +354,52 @@ void testTable::tableExaminerTest() {
   checkColumnDescriptions(r);
 }
 
+void testTable::tableFillerTest() {
+  using namespace edm::soa;
+  using namespace ts;
+
+  std::array<double, 3> eta = {{1., 2., 4.}};
+  std::array<double, 3> phi = {{3.14, 0., 1.3}};
+  std::array<std::string, 3> labels = {{"a", "b", "c"}};
+  MyJetTable jets{eta, phi, labels};
+
+  //copy the columns out as done when storing each in its own branch
+  TableExaminer<MyJetTable> examiner(&jets);
+  CPPUNIT_ASSERT(examiner.columnVectorType(0) == typeid(std::vector<float>));
+  CPPUNIT_ASSERT(examiner.columnVectorType(2) == typeid(std::vector<std::string>));
+  std::vector<float> etas;
+  std::vector<float> phis;
+  std::vector<std::string> labelValues;
+  examiner.copyColumnTo(0, &etas);
+  examiner.copyColumnTo(1, &phis);
+  examiner.copyColumnTo(2, &labelValues);
+  CPPUNIT_ASSERT(etas.size() == 3);
+  CPPUNIT_ASSERT(labelValues[1] == "b");
+
+  //and back in a table of which only the size is known, as after reading
+  MyJetTable read;
+  TableFiller<MyJetTable> filler(&read);
+  filler.reset(3);
+  CPPUNIT_ASSERT(read.size() == 3);
+  CPPUNIT_ASSERT(filler.copyColumnFrom(0, &etas));
+  CPPUNIT_ASSERT(filler.copyColumnFrom(1, &phis));
+  CPPUNIT_ASSERT(filler.copyColumnFrom(2, &labelValues));
+  for (size_t i = 0; i < 3; ++i) {
+    CPPUNIT_ASSERT(read.get<Eta>(i) == jets.get<Eta>(i));
+    CPPUNIT_ASSERT(read.get<Phi>(i) == jets.get<Phi>(i));
+    CPPUNIT_ASSERT(read.get<Label>(i) == jets.get<Label>(i));
+  }
+
+  //columns of the wrong size are refused
+  etas.pop_back();
+  CPPUNIT_ASSERT(not filler.copyColumnFrom(0, &etas));
+
+  //a missing column keeps default values
+  filler.reset(3);
+  CPPUNIT_ASSERT(read.get<Eta>(2) == 0.f);
+  CPPUNIT_ASSERT(read.get<Label>(2).empty());
+}
+
 void testTable::tableResizeTest() {
   using namespace edm::soa;
   using namespace ts;
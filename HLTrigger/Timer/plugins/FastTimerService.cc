@@ -32,6 +32,7 @@
 
 // local headers
 #include "memory_usage.h"
+#include "perf_counters.h"
 #include "processor_model.h"
 
 using namespace std::literals;
@@ -68,13 +69,16 @@ FastTimerService::Resources::Resources()
     : time_thread(boost::chrono::nanoseconds::zero()),
       time_real(boost::chrono::nanoseconds::zero()),
       allocated(0ul),
-      deallocated(0ul) {}
+      deallocated(0ul) {
+  counters.fill(0ul);
+}
 
 void FastTimerService::Resources::reset() {
   time_thread = boost::chrono::nanoseconds::zero();
   time_real = boost::chrono::nanoseconds::zero();
   allocated = 0ul;
   deallocated = 0ul;
+  counters.fill(0ul);
 }
 
 FastTimerService::Resources& FastTimerService::Resources::operator+=(Resources const& other) {
@@ -82,6 +86,8 @@ FastTimerService::Resources& FastTimerService::Resources::operator+=(Resources c
   time_real += other.time_real;
   allocated += other.allocated;
   deallocated += other.deallocated;
+  for (unsigned int i = 0; i < perf_counters::size; ++i)
+    counters[i] += other.counters[i];
   return *this;
 }
 
@@ -97,19 +103,27 @@ FastTimerService::Resources FastTimerService::Resources::operator+(Resources con
 // of results should yield the correct result.
 
 FastTimerService::AtomicResources::AtomicResources()
-    : time_thread(0ul), time_real(0ul), allocated(0ul), deallocated(0ul) {}
+    : time_thread(0ul), time_real(0ul), allocated(0ul), deallocated(0ul) {
+  for (auto& counter : counters)
+    counter = 0ul;
+}
 
 FastTimerService::AtomicResources::AtomicResources(AtomicResources const& other)
     : time_thread(other.time_thread.load()),
       time_real(other.time_real.load()),
       allocated(other.allocated.load()),
-      deallocated(other.deallocated.load()) {}
+      deallocated(other.deallocated.load()) {
+  for (unsigned int i = 0; i < perf_counters::size; ++i)
+    counters[i] = other.counters[i].load();
+}
 
 void FastTimerService::AtomicResources::reset() {
   time_thread = 0ul;
   time_real = 0ul;
   allocated = 0ul;
   deallocated = 0ul;
+  for (auto& counter : counters)
+    counter = 0ul;
 }
 
 FastTimerService::AtomicResources& FastTimerService::AtomicResources::operator=(AtomicResources const& other) {
@@ -117,6 +131,8 @@ FastTimerService::AtomicResources& FastTimerService::AtomicResources::operator=(
   time_real = other.time_real.load();
   allocated = other.allocated.load();
   deallocated = other.deallocated.load();
+  for (unsigned int i = 0; i < perf_counters::size; ++i)
+    counters[i] = other.counters[i].load();
   return *this;
 }
 
@@ -125,6 +141,8 @@ FastTimerService::AtomicResources& FastTimerService::AtomicResources::operator+=
   time_real += other.time_real.load();
   allocated += other.allocated.load();
   deallocated += other.deallocated.load();
+  for (unsigned int i = 0; i < perf_counters::size; ++i)
+    counters[i] += other.counters[i].load();
   return *this;
 }
 
@@ -273,6 +291,7 @@ void FastTimerService::Measurement::measure() noexcept {
   time_real = boost::chrono::high_resolution_clock::now();
   allocated = memory_usage::allocated();
   deallocated = memory_usage::deallocated();
+  perf_counters::read(counters);
 }
 
 void FastTimerService::Measurement::measure_and_store(Resources& store) noexcept {
@@ -283,14 +302,19 @@ void FastTimerService::Measurement::measure_and_store(Resources& store) noexcept
   auto new_time_real = boost::chrono::high_resolution_clock::now();
   auto new_allocated = memory_usage::allocated();
   auto new_deallocated = memory_usage::deallocated();
+  perf_counters::values new_counters;
+  perf_counters::read(new_counters);
   store.time_thread = new_time_thread - time_thread;
   store.time_real = new_time_real - time_real;
   store.allocated = new_allocated - allocated;
   store.deallocated = new_deallocated - deallocated;
+  for (unsigned int i = 0; i < perf_counters::size; ++i)
+    store.counters[i] = new_counters[i] - counters[i];
   time_thread = new_time_thread;
   time_real = new_time_real;
   allocated = new_allocated;
   deallocated = new_deallocated;
+  counters = new_counters;
 }
 
 void FastTimerService::Measurement::measure_and_accumulate(Resources& store) noexcept {
@@ -301,14 +325,19 @@ void FastTimerService::Measurement::measure_and_accumulate(Resources& store) noe
   auto new_time_real = boost::chrono::high_resolution_clock::now();
   auto new_allocated = memory_usage::allocated();
   auto new_deallocated = memory_usage::deallocated();
+  perf_counters::values new_counters;
+  perf_counters::read(new_counters);
   store.time_thread += new_time_thread - time_thread;
   store.time_real += new_time_real - time_real;
   store.allocated += new_allocated - allocated;
   store.deallocated += new_deallocated - deallocated;
+  for (unsigned int i = 0; i < perf_counters::size; ++i)
+    store.counters[i] += new_counters[i] - counters[i];
   time_thread = new_time_thread;
   time_real = new_time_real;
   allocated = new_allocated;
   deallocated = new_deallocated;
+  counters = new_counters;
 }
 
 void FastTimerService::Measurement::measure_and_accumulate(AtomicResources& store) noexcept {
@@ -319,14 +348,19 @@ void FastTimerService::Measurement::measure_and_accumulate(AtomicResources& stor
   auto new_time_real = boost::chrono::high_resolution_clock::now();
   auto new_allocated = memory_usage::allocated();
   auto new_deallocated = memory_usage::deallocated();
+  perf_counters::values new_counters;
+  perf_counters::read(new_counters);
   store.time_thread += boost::chrono::duration_cast<boost::chrono::nanoseconds>(new_time_thread - time_thread).count();
   store.time_real += boost::chrono::duration_cast<boost::chrono::nanoseconds>(new_time_real - time_real).count();
   store.allocated += new_allocated - allocated;
   store.deallocated += new_deallocated - deallocated;
+  for (unsigned int i = 0; i < perf_counters::size; ++i)
+    store.counters[i] += new_counters[i] - counters[i];
   time_thread = new_time_thread;
   time_real = new_time_real;
   allocated = new_allocated;
   deallocated = new_deallocated;
+  counters = new_counters;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -362,6 +396,15 @@ void FastTimerService::PlotsPerElement::book(dqm::reco::DQMStore::ConcurrentBook
     deallocated_.setYTitle(y_title_kB.c_str());
   }
 
+  if (perf_counters::is_available()) {
+    // the sum of each counter over all events, so that their ratios give e.g. the instructions per cycle
+    counters_ = booker.book1DD(
+        name + " counters", title + " hardware counters", perf_counters::size, -0.5, perf_counters::size - 0.5);
+    counters_.setYTitle("counts");
+    for (unsigned int i = 0; i < perf_counters::size; ++i)
+      counters_.setBinLabel(i + 1, perf_counters::name(i));
+  }
+
   if (not byls)
     return;
 
@@ -443,6 +486,10 @@ void FastTimerService::PlotsPerElement::fill(Resources const& data, unsigned int
 
   if (deallocated_byls_)
     deallocated_byls_.fill(lumisection, kB(data.deallocated));
+
+  if (counters_)
+    for (unsigned int i = 0; i < perf_counters::size; ++i)
+      counters_.fill(i, data.counters[i]);
 }
 
 void FastTimerService::PlotsPerElement::fill(AtomicResources const& data, unsigned int lumisection) {
@@ -472,6 +519,10 @@ void FastTimerService::PlotsPerElement::fill(AtomicResources const& data, unsign
 
   if (deallocated_byls_)
     deallocated_byls_.fill(lumisection, kB(data.deallocated));
+
+  if (counters_)
+    for (unsigned int i = 0; i < perf_counters::size; ++i)
+      counters_.fill(i, data.counters[i].load());
 }
 
 void FastTimerService::PlotsPerElement::fill_fraction(Resources const& data,
@@ -514,6 +565,11 @@ void FastTimerService::PlotsPerElement::fill_fraction(Resources const& data,
 
   if (deallocated_byls_)
     deallocated_byls_.fill(lumisection, total, fraction);
+
+  // the counters of the part, rather than their fraction, so that they can be compared among themselves
+  if (counters_)
+    for (unsigned int i = 0; i < perf_counters::size; ++i)
+      counters_.fill(i, part.counters[i]);
 }
 
 void FastTimerService::PlotsPerPath::book(dqm::reco::DQMStore::ConcurrentBooker& booker,
@@ -756,6 +812,12 @@ FastTimerService::FastTimerService(const edm::ParameterSet& config, edm::Activit
       highlight_module_psets_(config.getUntrackedParameter<std::vector<edm::ParameterSet>>("highlightModules")),
       highlight_modules_(highlight_module_psets_.size())  // filled in postBeginJob()
 {
+  // enable the hardware performance counters before any thread takes its first measurement
+  if (config.getUntrackedParameter<bool>("enablePerfCounters") and not perf_counters::enable())
+    edm::LogWarning("FastTimerService")
+        << "The hardware performance counters are not available, and will not be measured.\n"
+        << "Check that the processor exposes them, and the value of /proc/sys/kernel/perf_event_paranoid .";
+
   // start observing when a thread enters or leaves the TBB global thread arena
   tbb::task_scheduler_observer::observe();
 
@@ -1196,6 +1258,24 @@ void FastTimerService::printPathSummaryLine(
              (events ? -static_cast<int64_t>(kB(total.deallocated) / events) : 0) % label;
 }
 
+template <typename T>
+void FastTimerService::printCountersHeader(T& out, std::string const& label) const {
+  out << "FastReport    Instructions          Cycles    Cache misses   Branch misses  Stalled cycles  ";
+  //      FastReport  ##############  ##############  ##############  ##############  ##############  ...
+  out << label << '\n';
+}
+
+template <typename T>
+void FastTimerService::printCountersLine(T& out,
+                                         Resources const& data,
+                                         uint64_t events,
+                                         std::string const& label) const {
+  out << "FastReport  ";
+  for (auto counter : data.counters)
+    out << boost::format("%14.0f  ") % (events ? (double)counter / events : 0.);
+  out << label << '\n';
+}
+
 template <typename T>
 void FastTimerService::printSummary(T& out, ResourcesPerJob const& data, std::string const& label) const {
   printHeader(out, label);
@@ -1215,6 +1295,19 @@ void FastTimerService::printSummary(T& out, ResourcesPerJob const& data, std::st
   }
   printSummaryLine(out, data.total, data.events, "total");
   out << '\n';
+  if (perf_counters::is_available()) {
+    // average hardware counters per event
+    printCountersHeader(out, "Modules");
+    printCountersLine(out, source.total, data.events, source_d.moduleLabel());
+    for (unsigned int i = 0; i < callgraph_.processes().size(); ++i) {
+      auto const& proc_d = callgraph_.processDescription(i);
+      printCountersLine(out, data.processes[i].total, data.events, "process " + proc_d.name_);
+      for (unsigned int m : proc_d.modules_)
+        printCountersLine(out, data.modules[m].total, data.events, "  " + callgraph_.module(m).moduleLabel());
+    }
+    printCountersLine(out, data.total, data.events, "total");
+    out << '\n';
+  }
   printPathSummaryHeader(out, "Processes and Paths");
   printSummaryLine(out, source.total, data.events, source_d.moduleLabel());
   for (unsigned int i = 0; i < callgraph_.processes().size(); ++i) {
@@ -1544,6 +1637,10 @@ void FastTimerService::fillDescriptions(edm::ConfigurationDescriptions& descript
   desc.addUntracked<double>("dqmModuleMemoryResolution", 500.);  // kB
   desc.addUntracked<unsigned>("dqmLumiSectionsRange", 2500);     // ~ 16 hours
   desc.addUntracked<std::string>("dqmPath", "HLT/TimerService");
+  desc.addUntracked<bool>("enablePerfCounters", false)
+      ->setComment(
+          "Measure per thread the instructions, cycles, cache misses, branch misses and stalled cycles of each module, "
+          "with the Linux perf_event_open interface.");
 
   edm::ParameterSetDescription highlightModulesDescription;
   highlightModulesDescription.addUntracked<std::vector<std::string>>("modules", {});
@@ -5,6 +5,7 @@
 #include <unistd.h>
 
 // C++ headers
+#include <array>
 #include <chrono>
 #include <cmath>
 #include <map>
@@ -40,6 +41,9 @@
 #include "DQMServices/Core/interface/DQMStore.h"
 #include "HLTrigger/Timer/interface/ProcessCallGraph.h"
 
+// local headers
+#include "perf_counters.h"
+
 /*
 procesing time is divided into
  - source
@@ -200,6 +204,7 @@ private:
     boost::chrono::high_resolution_clock::time_point time_real;
     uint64_t allocated;
     uint64_t deallocated;
+    perf_counters::values counters;
   };
 
   // highlight a group of modules
@@ -222,6 +227,7 @@ private:
     boost::chrono::nanoseconds time_real;
     uint64_t allocated;
     uint64_t deallocated;
+    perf_counters::values counters;  // hardware performance counters, zero unless enabled
   };
 
   // atomic version of Resources
@@ -240,6 +246,7 @@ private:
     std::atomic<boost::chrono::nanoseconds::rep> time_real;
     std::atomic<uint64_t> allocated;
     std::atomic<uint64_t> deallocated;
+    std::array<std::atomic<uint64_t>, perf_counters::size> counters;
   };
 
   struct ResourcesPerModule {
@@ -332,6 +339,7 @@ private:
     ConcurrentMonitorElement allocated_byls_;    // TProfile
     ConcurrentMonitorElement deallocated_;       // TH1F
     ConcurrentMonitorElement deallocated_byls_;  // TProfile
+    ConcurrentMonitorElement counters_;          // TH1D, sum of each hardware counter
   };
 
   // plots associated to each path or endpath
@@ -517,6 +525,12 @@ private:
   void printPathSummaryLine(
       T& out, Resources const& data, Resources const& total, uint64_t events, std::string const& label) const;
 
+  template <typename T>
+  void printCountersHeader(T& out, std::string const& label) const;
+
+  template <typename T>
+  void printCountersLine(T& out, Resources const& data, uint64_t events, std::string const& label) const;
+
   template <typename T>
   void printSummary(T& out, ResourcesPerJob const& data, std::string const& label) const;
 
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "perf_counters.h"
+
+namespace {
+  constexpr uint64_t event_config[perf_counters::size] = {PERF_COUNT_HW_INSTRUCTIONS,
+                                                          PERF_COUNT_HW_CPU_CYCLES,
+                                                          PERF_COUNT_HW_CACHE_MISSES,
+                                                          PERF_COUNT_HW_BRANCH_MISSES,
+                                                          PERF_COUNT_HW_STALLED_CYCLES_BACKEND};
+  constexpr char const* event_name[perf_counters::size] = {
+      "instructions", "cycles", "cache misses", "branch misses", "stalled cycles"};
+
+  bool enabled = false;
+  std::atomic<bool> multiplexing_reported{false};
+
+  long perf_event_open(perf_event_attr* attr, pid_t pid, int cpu, int group_fd, unsigned long flags) {
+    return ::syscall(__NR_perf_event_open, attr, pid, cpu, group_fd, flags);
+  }
+
+  // the group of counters of a thread; the events that the processor does not support are
+  // left out of the group, and read as zero
+  struct thread_counters {
+    thread_counters() {
+      for (unsigned int i = 0; i < perf_counters::size; ++i) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = event_config[i];
+        // the times the group was enabled and actually counting, which differ if the counters are multiplexed
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // count only the user-space activity of this thread, which is allowed to unprivileged users
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        int fd = perf_event_open(&attr, 0, -1, leader, 0);
+        if (fd < 0) {
+          // without the first event there is no group
+          if (leader < 0)
+            return;
+          continue;
+        }
+        if (leader < 0)
+          leader = fd;
+        fds[events] = fd;
+        slot[events] = i;
+        ++events;
+      }
+    }
+
+    ~thread_counters() {
+      for (unsigned int i = 0; i < events; ++i)
+        ::close(fds[i]);
+    }
+
+    // the values of the last successful read are given again if a read fails, so that the differences
+    // of two reads do not wrap around
+    void read(perf_counters::values& counters) const {
+      update();
+      counters = last;
+    }
+
+    void update() const {
+      // layout of a group read: the number of events, the times enabled and running, and the values
+      uint64_t buffer[3 + perf_counters::size];
+      ssize_t const size = (3 + events) * sizeof(uint64_t);
+      if (leader < 0 or ::read(leader, buffer, sizeof(buffer)) != size or buffer[0] != events or buffer[2] == 0)
+        return;
+      uint64_t const time_enabled = buffer[1];
+      uint64_t const time_running = buffer[2];
+      if (time_running < time_enabled and not multiplexing_reported.exchange(true)) {
+        edm::LogWarning("FastTimerService")
+            << "The hardware performance counters are multiplexed with other events, and counted only "
+            << (100. * time_running / time_enabled) << "% of the time.\n"
+            << "Their values are scaled accordingly, and are only estimates.";
+      }
+      for (unsigned int i = 0; i < events; ++i) {
+        uint64_t value = buffer[3 + i];
+        if (time_running < time_enabled)
+          value = (uint64_t)((double)value * time_enabled / time_running);
+        // a scaled estimate may be lower than the previous one
+        last[slot[i]] = std::max(last[slot[i]], value);
+      }
+    }
+
+    int leader = -1;
+    unsigned int events = 0;
+    int fds[perf_counters::size];
+    unsigned int slot[perf_counters::size];
+    mutable perf_counters::values last = {};
+  };
+
+  // open the counters lazily, only in the threads that read them after they have been enabled
+  thread_counters const& this_thread_counters() {
+    thread_local const thread_counters counters;
+    return counters;
+  }
+
+}  // namespace
+
+bool perf_counters::enable() {
+  enabled = (this_thread_counters().leader >= 0);
+  return enabled;
+}
+
+bool perf_counters::is_available() { return enabled; }
+
+char const* perf_counters::name(unsigned int counter) { return event_name[counter]; }
+
+void perf_counters::read(values& counters) {
+  if (enabled)
+    this_thread_counters().read(counters);
+  else
+    counters.fill(0);
+}
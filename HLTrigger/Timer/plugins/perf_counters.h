@@ -0,0 +1,25 @@
+#ifndef perf_counters_h
+#define perf_counters_h
+
+#include <array>
+#include <cstdint>
+
+// per-thread hardware performance counters, read via the Linux perf_event_open interface;
+// each thread opens its own group of counters the first time it reads them, so that the
+// counters only measure the thread itself and reading them does not need any synchronisation
+class perf_counters {
+public:
+  enum counter { instructions, cycles, cache_misses, branch_misses, stalled_cycles, size };
+  using values = std::array<uint64_t, size>;
+
+  // try to open the counters in the calling thread, and enable them in all threads if successful
+  static bool enable();
+  static bool is_available();
+  static char const* name(unsigned int counter);
+  // read the counters of the calling thread, or zeros if they are not available; the counters that are
+  // multiplexed with other events are scaled by the fraction of the time they were counting, and a
+  // failed read gives the values of the previous one
+  static void read(values& counters);
+};
+
+#endif  // perf_counters_h
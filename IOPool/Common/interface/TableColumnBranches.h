@@ -0,0 +1,76 @@
+#ifndef IOPool_Common_TableColumnBranches_h
+#define IOPool_Common_TableColumnBranches_h
+
+/*----------------------------------------------------------------------
+
+TableColumnBranches: the branches holding the columns of an edm::soa::Table
+product, one per column, next to the branch of the product itself.
+
+Each column is stored as a std::vector of the column type, in the branch
+named tableColumnBranchName(<product branch name>, <column label>), so
+that a reader can read and decompress only the columns it needs, and the
+columns of trivially copyable types are streamed as a single array.
+
+----------------------------------------------------------------------*/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class TBranch;
+class TClass;
+class TTree;
+
+namespace edm {
+  namespace soa {
+    class TableExaminerBase;
+    class TableFillerBase;
+  }  // namespace soa
+
+  std::string tableColumnBranchName(std::string const& productBranchName, char const* columnLabel);
+
+  class TableColumnBranches {
+  public:
+    ~TableColumnBranches();
+
+    TableColumnBranches(TableColumnBranches const&) = delete;             // Disallow copying and moving
+    TableColumnBranches& operator=(TableColumnBranches const&) = delete;  // Disallow copying and moving
+
+    /// Adds to the tree a branch for each column of the examined Table
+    static std::unique_ptr<TableColumnBranches> make(TTree* tree,
+                                                     std::string const& productBranchName,
+                                                     soa::TableExaminerBase const& examiner,
+                                                     int splitLevel,
+                                                     int basketSize);
+
+    /// Finds in the tree the branches of the columns of the examined Table; columns without a branch are skipped
+    static std::unique_ptr<TableColumnBranches> find(TTree* tree,
+                                                     std::string const& productBranchName,
+                                                     soa::TableExaminerBase const& examiner);
+
+    std::vector<TBranch*> const& branches() const { return branches_; }
+
+    /// Copies the columns of the examined Table into the buffers of the branches, before filling them
+    void copyFrom(soa::TableExaminerBase const& examiner);
+
+    /// Copies the buffers of the branches, after reading them, into the columns of the Table;
+    /// the columns without a branch are left with default values
+    void copyTo(soa::TableFillerBase& filler) const;
+
+  private:
+    struct Column {
+      unsigned int index_;
+      TClass* class_;
+      void* buffer_;
+    };
+
+    TableColumnBranches() = default;
+
+    void addColumn(unsigned int index, TClass* cl);
+    void setAddresses();
+
+    std::vector<Column> columns_;
+    std::vector<TBranch*> branches_;
+  };
+}  // namespace edm
+#endif
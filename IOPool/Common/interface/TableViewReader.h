@@ -0,0 +1,95 @@
+#ifndef IOPool_Common_TableViewReader_h
+#define IOPool_Common_TableViewReader_h
+
+/*----------------------------------------------------------------------
+
+TableViewReader: reads from the Events tree of a file only the columns
+Args... of an edm::soa::Table product, and gives them as a TableView.
+
+  edm::TableViewReader<Eta, Phi> reader(tree, "edmtestMyTable_producer__PROD.");
+  for (Long64_t i = 0; i < tree->GetEntries(); ++i) {
+    auto view = reader.get(i);
+    ...
+  }
+
+Only the branches of the requested columns are read and decompressed,
+and the view points into buffers reused from one entry to the next.
+
+----------------------------------------------------------------------*/
+
+#include "FWCore/SOA/interface/TableView.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+#include "IOPool/Common/interface/TableColumnBranches.h"
+
+#include "TBranch.h"
+#include "TTree.h"
+
+#include <array>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace edm {
+  template <typename... Args>
+  class TableViewReader {
+    static_assert(sizeof...(Args) > 0, "TableViewReader needs at least one column");
+
+  public:
+    using View = soa::TableView<Args...>;
+
+    TableViewReader(TTree* tree, std::string const& productBranchName) : productBranchName_(productBranchName) {
+      findBranches(tree, std::make_index_sequence<sizeof...(Args)>{});
+    }
+
+    TableViewReader(TableViewReader const&) = delete;             // Disallow copying and moving
+    TableViewReader& operator=(TableViewReader const&) = delete;  // Disallow copying and moving
+
+    /// The view stays valid until the next call
+    View get(Long64_t entry) { return read(entry, std::make_index_sequence<sizeof...(Args)>{}); }
+
+  private:
+    template <size_t... I>
+    void findBranches(TTree* tree, std::index_sequence<I...>) {
+      ((branches_[I] = findBranch(tree, std::tuple_element<I, std::tuple<Args...>>::type::label())), ...);
+      ((addresses_[I] = &std::get<I>(columns_)), ...);
+      for (unsigned int i = 0; i < branches_.size(); ++i) {
+        branches_[i]->SetAddress(&addresses_[i]);
+      }
+    }
+
+    TBranch* findBranch(TTree* tree, char const* label) const {
+      std::string const name = tableColumnBranchName(productBranchName_, label);
+      TBranch* branch = tree->GetBranch(name.c_str());
+      if (branch == nullptr) {
+        throw edm::Exception(errors::ProductNotFound) << "No branch " << name << " for the column '" << label
+                                                      << "' of the Table in " << productBranchName_ << "\n";
+      }
+      return branch;
+    }
+
+    template <size_t... I>
+    View read(Long64_t entry, std::index_sequence<I...>) {
+      for (auto branch : branches_) {
+        if (branch->GetEntry(entry) < 0) {
+          throw edm::Exception(errors::FileReadError)
+              << "Failed to read entry " << entry << " of the branch " << branch->GetName() << "\n";
+        }
+      }
+      unsigned int const size = std::get<0>(columns_).size();
+      if (((std::get<I>(columns_).size() != size) || ...)) {
+        throw edm::Exception(errors::FileReadError)
+            << "The columns of the Table in " << productBranchName_ << " differ in size in entry " << entry << "\n";
+      }
+      std::array<void const*, sizeof...(Args)> values = {{std::get<I>(columns_).data()...}};
+      return View(size, values);
+    }
+
+    std::string const productBranchName_;
+    std::array<TBranch*, sizeof...(Args)> branches_;
+    std::tuple<std::vector<typename Args::type>...> columns_;
+    // ROOT needs the address of a pointer to each buffer
+    std::array<void*, sizeof...(Args)> addresses_;
+  };
+}  // namespace edm
+#endif
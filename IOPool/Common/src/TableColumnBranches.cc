@@ -0,0 +1,102 @@
+#include "IOPool/Common/interface/TableColumnBranches.h"
+
+#include "FWCore/SOA/interface/TableExaminerBase.h"
+#include "FWCore/SOA/interface/TableFillerBase.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+
+#include "TBranch.h"
+#include "TClass.h"
+#include "TTree.h"
+
+namespace edm {
+  namespace {
+    TClass* columnClass(soa::TableExaminerBase const& examiner, unsigned int index, char const* label) {
+      TClass* cl = TClass::GetClass(examiner.columnVectorType(index));
+      if (cl == nullptr) {
+        throw edm::Exception(errors::DictionaryNotFound)
+            << "No dictionary for the std::vector of the type of the column '" << label << "' of "
+            << examiner.typeID()->name() << ",\nwhich is needed to store the column in its own branch.\n";
+      }
+      return cl;
+    }
+  }  // namespace
+
+  std::string tableColumnBranchName(std::string const& productBranchName, char const* columnLabel) {
+    return productBranchName + "column_" + columnLabel;
+  }
+
+  TableColumnBranches::~TableColumnBranches() {
+    // The branches belong to the tree, only the buffers are ours.
+    for (auto& column : columns_) {
+      column.class_->Destructor(column.buffer_);
+    }
+  }
+
+  std::unique_ptr<TableColumnBranches> TableColumnBranches::make(TTree* tree,
+                                                                 std::string const& productBranchName,
+                                                                 soa::TableExaminerBase const& examiner,
+                                                                 int splitLevel,
+                                                                 int basketSize) {
+    std::unique_ptr<TableColumnBranches> result(new TableColumnBranches());
+    auto const descriptions = examiner.columnDescriptions();
+    for (unsigned int i = 0; i < descriptions.size(); ++i) {
+      result->addColumn(i, columnClass(examiner, i, descriptions[i].first));
+    }
+    for (auto& column : result->columns_) {
+      std::string const name = tableColumnBranchName(productBranchName, descriptions[column.index_].first);
+      TBranch* branch =
+          tree->Branch(name.c_str(), column.class_->GetName(), &column.buffer_, basketSize, splitLevel);
+      if (branch == nullptr) {
+        throw edm::Exception(errors::FatalRootError) << "Failed to create the branch: " << name << "\n";
+      }
+      result->branches_.push_back(branch);
+    }
+    return result;
+  }
+
+  std::unique_ptr<TableColumnBranches> TableColumnBranches::find(TTree* tree,
+                                                                 std::string const& productBranchName,
+                                                                 soa::TableExaminerBase const& examiner) {
+    std::unique_ptr<TableColumnBranches> result(new TableColumnBranches());
+    auto const descriptions = examiner.columnDescriptions();
+    std::vector<TBranch*> found;
+    for (unsigned int i = 0; i < descriptions.size(); ++i) {
+      TBranch* branch = tree->GetBranch(tableColumnBranchName(productBranchName, descriptions[i].first).c_str());
+      if (branch != nullptr) {
+        result->addColumn(i, columnClass(examiner, i, descriptions[i].first));
+        found.push_back(branch);
+      }
+    }
+    result->branches_ = std::move(found);
+    result->setAddresses();
+    return result;
+  }
+
+  void TableColumnBranches::addColumn(unsigned int index, TClass* cl) {
+    columns_.push_back(Column{index, cl, cl->New()});
+  }
+
+  void TableColumnBranches::setAddresses() {
+    for (unsigned int i = 0; i < columns_.size(); ++i) {
+      branches_[i]->SetAddress(&columns_[i].buffer_);
+    }
+  }
+
+  void TableColumnBranches::copyFrom(soa::TableExaminerBase const& examiner) {
+    for (auto& column : columns_) {
+      examiner.copyColumnTo(column.index_, column.buffer_);
+    }
+  }
+
+  void TableColumnBranches::copyTo(soa::TableFillerBase& filler) const {
+    // The Table read from the product branch only knows its size.
+    filler.reset(filler.size());
+    for (unsigned int i = 0; i < columns_.size(); ++i) {
+      if (not filler.copyColumnFrom(columns_[i].index_, columns_[i].buffer_)) {
+        throw edm::Exception(errors::FileReadError)
+            << "The column branch " << branches_[i]->GetName() << " does not have the " << filler.size()
+            << " rows of its Table.\n";
+      }
+    }
+  }
+}  // namespace edm
@@ -45,6 +45,7 @@ namespace edm {
     static void reportReadBranches();
     static void reportReadBranch(InputType inputType, std::string const& branchname);
 
+    bool isOpen() const { return file_.get() != nullptr; }
     TObject* Get(char const* name) { return file_->Get(name); }
     TFileCacheRead* GetCacheRead() const { return file_->GetCacheRead(); }
     void SetCacheRead(TFileCacheRead* tfcr) { file_->SetCacheRead(tfcr, nullptr, TFile::kDoNotDisconnect); }
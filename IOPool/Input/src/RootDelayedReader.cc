@@ -6,16 +6,21 @@
 #include "DataFormats/Common/interface/EDProductGetter.h"
 #include "DataFormats/Common/interface/RefCoreStreamer.h"
 
+#include "FWCore/Concurrency/interface/FunctorTask.h"
 #include "FWCore/Framework/interface/SharedResourcesAcquirer.h"
 #include "FWCore/Framework/src/SharedResourcesRegistry.h"
 
 #include "IOPool/Common/interface/getWrapperBasePtr.h"
+#include "FWCore/SOA/interface/TableFillerBase.h"
 
+#include "FWCore/ServiceRegistry/interface/ServiceRegistry.h"
 #include "FWCore/Utilities/interface/EDMException.h"
 
 #include "TBranch.h"
 #include "TClass.h"
 
+#include "tbb/task.h"
+
 #include <cassert>
 
 namespace edm {
@@ -35,7 +40,110 @@ namespace edm {
     }
   }
 
-  RootDelayedReader::~RootDelayedReader() {}
+  RootDelayedReader::~RootDelayedReader() { stopPrefetching(); }
+
+  void RootDelayedReader::enablePrefetching(unsigned int nIndexes) {
+    if (not resourceAcquirer_ or tree_.branchType() != InEvent) {
+      return;
+    }
+    std::lock_guard<std::recursive_mutex> guard(*mutex_);
+    prefetching_ = true;
+    prefetched_.resize(nIndexes);
+    prefetchingState_ = std::make_shared<PrefetchingState>();
+  }
+
+  void RootDelayedReader::stopPrefetching() {
+    if (not prefetching_) {
+      return;
+    }
+    std::lock_guard<std::recursive_mutex> guard(*mutex_);
+    prefetching_ = false;
+    prefetchingState_->active_ = false;
+    prefetched_.clear();
+  }
+
+  // Called by the source, which holds mutex_, after the event has been read for the given index
+  void RootDelayedReader::prefetchAsync(unsigned int index, EDProductGetter const* ep) {
+    if (not prefetching_) {
+      return;
+    }
+    auto& slot = prefetched_[index];
+    slot.entry_ = tree_.entryNumberForIndex(index);
+    slot.ep_ = ep;
+    slot.toRead_.swap(slot.requested_);
+    slot.requested_.clear();
+    slot.next_ = 0;
+    slot.products_.clear();
+    slot.delivered_.clear();
+    schedulePrefetching();
+  }
+
+  // Called with mutex_ held. The read-ahead runs in low priority tasks outside of the serial queue
+  // of the source, one branch per task, and never waits for mutex_: the reads requested by the
+  // modules are not queued behind it, and wait at most for the read of one branch.
+  void RootDelayedReader::schedulePrefetching() {
+    if (prefetchingState_->deferred_.exchange(false)) {
+      prefetchScheduled_ = false;
+    }
+    if (prefetchScheduled_ or lastException_) {
+      return;
+    }
+    prefetchScheduled_ = true;
+    auto mutex = mutex_;
+    auto state = prefetchingState_;
+    auto token = ServiceRegistry::instance().presentToken();
+    auto task = make_functor_task(tbb::task::allocate_root(), [this, mutex, state, token]() {
+      std::unique_lock<std::recursive_mutex> guard(*mutex, std::try_to_lock);
+      if (not guard.owns_lock()) {
+        state->deferred_ = true;
+        return;
+      }
+      if (not state->active_) {
+        return;
+      }
+      ServiceRegistry::Operate operate(token);
+      prefetchScheduled_ = false;
+      if (prefetchOne()) {
+        schedulePrefetching();
+      }
+    });
+    tbb::task::enqueue(*task, tbb::priority_low);
+  }
+
+  // Reads the next branch of one of the indexes, returns false if there is nothing left to read
+  bool RootDelayedReader::prefetchOne() {
+    if (lastException_) {
+      return false;
+    }
+    for (unsigned int i = 0; i < prefetched_.size(); ++i) {
+      unsigned int index = (nextIndex_ + i) % prefetched_.size();
+      auto& slot = prefetched_[index];
+      // the stream may have moved on to another event
+      if (slot.entry_ < 0 or tree_.entryNumberForIndex(index) != slot.entry_) {
+        continue;
+      }
+      while (slot.next_ < slot.toRead_.size()) {
+        BranchID const& k = slot.toRead_[slot.next_++];
+        if (slot.delivered_.count(k.id()) != 0 or slot.products_.count(k.id()) != 0) {
+          continue;
+        }
+        auto branchInfo = getBranchInfo(k);
+        if (not branchInfo or branchInfo->productBranch_ == nullptr) {
+          continue;
+        }
+        try {
+          slot.products_.emplace(k.id(), readProduct(*branchInfo, slot.entry_, slot.ep_, true));
+        } catch (...) {
+          // dropped, the modules will read the products of this event on demand
+          slot.next_ = slot.toRead_.size();
+          slot.products_.clear();
+        }
+        nextIndex_ = index + 1;
+        return true;
+      }
+    }
+    return false;
+  }
 
   std::pair<SharedResourcesAcquirer*, std::recursive_mutex*> RootDelayedReader::sharedResources_() const {
     return std::make_pair(resourceAcquirer_.get(), mutex_.get());
@@ -62,37 +170,85 @@ namespace edm {
       }
     }
 
+    //Run and Lumi only have 1 entry number, which is index 0
+    auto entry = tree_.entryNumberForIndex(tree_.branchType() == InEvent ? ep->transitionIndex() : 0);
+    std::unique_ptr<WrapperBase> edp;
+    if (prefetching_) {
+      auto& slot = prefetched_[ep->transitionIndex()];
+      if (slot.entry_ == entry) {
+        auto found = slot.products_.find(k.id());
+        if (found != slot.products_.end()) {
+          edp = std::move(found->second);
+          slot.products_.erase(found);
+        }
+        if (slot.delivered_.insert(k.id()).second) {
+          slot.requested_.push_back(k);
+        }
+      }
+    }
+    if (not edp) {
+      edp = readProduct(*branchInfo, entry, ep);
+    }
+    if (prefetching_ and prefetchingState_->deferred_) {
+      schedulePrefetching();
+    }
+    if (tree_.branchType() == InEvent) {
+      // CMS-THREADING For the primary input source calls to this function need to be serialized
+      InputFile::reportReadBranch(inputType_, std::string(br->GetName()));
+    }
+    return edp;
+  }
+
+  std::unique_ptr<WrapperBase> RootDelayedReader::readProduct(BranchInfo const& branchInfo,
+                                                              EntryNumber entry,
+                                                              EDProductGetter const* ep,
+                                                              bool speculative) {
+    TBranch* br = branchInfo.productBranch_;
     setRefCoreStreamer(ep);
     //make code exception safe
     std::shared_ptr<void> refCoreStreamerGuard(nullptr, [](void*) {
       setRefCoreStreamer(false);
       ;
     });
-    TClass* cp = branchInfo->classCache_;
+    TClass* cp = branchInfo.classCache_;
     if (nullptr == cp) {
-      branchInfo->classCache_ = TClass::GetClass(branchInfo->branchDescription_.wrappedName().c_str());
-      cp = branchInfo->classCache_;
-      branchInfo->offsetToWrapperBase_ = cp->GetBaseClassOffset(wrapperBaseTClass_);
+      branchInfo.classCache_ = TClass::GetClass(branchInfo.branchDescription_.wrappedName().c_str());
+      cp = branchInfo.classCache_;
+      branchInfo.offsetToWrapperBase_ = cp->GetBaseClassOffset(wrapperBaseTClass_);
     }
     void* p = cp->New();
-    std::unique_ptr<WrapperBase> edp = getWrapperBasePtr(p, branchInfo->offsetToWrapperBase_);
+    std::unique_ptr<WrapperBase> edp = getWrapperBasePtr(p, branchInfo.offsetToWrapperBase_);
     br->SetAddress(&p);
     try {
-      //Run and Lumi only have 1 entry number, which is index 0
-      tree_.getEntry(br, tree_.entryNumberForIndex(tree_.branchType() == InEvent ? ep->transitionIndex() : 0));
+      tree_.getEntry(br, entry);
+      if (branchInfo.tableColumnBranches_) {
+        readTableColumns(*branchInfo.tableColumnBranches_, entry, *edp);
+      }
     } catch (edm::Exception& exception) {
+      // only a read requested by a module stops the reading of the file
+      if (speculative) {
+        throw;
+      }
       exception.addContext("Rethrowing an exception that happened on a different thread.");
       lastException_ = std::current_exception();
     } catch (...) {
+      if (speculative) {
+        throw;
+      }
       lastException_ = std::current_exception();
     }
     if (lastException_) {
       std::rethrow_exception(lastException_);
     }
-    if (tree_.branchType() == InEvent) {
-      // CMS-THREADING For the primary input source calls to this function need to be serialized
-      InputFile::reportReadBranch(inputType_, std::string(br->GetName()));
-    }
     return edp;
   }
+
+  void RootDelayedReader::readTableColumns(TableColumnBranches const& columns, EntryNumber entry, WrapperBase& edp) {
+    for (auto branch : columns.branches()) {
+      tree_.getEntry(branch, entry);
+    }
+    auto filler = edp.tableFiller();
+    assert(filler);
+    columns.copyTo(*filler);
+  }
 }  // namespace edm
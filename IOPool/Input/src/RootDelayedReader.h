@@ -13,10 +13,14 @@ RootDelayedReader.h // used by ROOT input sources
 #include "FWCore/Utilities/interface/propagate_const.h"
 #include "RootTree.h"
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
 #include <exception>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 class TClass;
 namespace edm {
@@ -57,8 +61,32 @@ namespace edm {
       postEventReadFromSourceSignal_ = postEventReadSource;
     }
 
+    // Read ahead the products of an event as soon as the source has read it.
+    // The branches read are those requested by the modules in the previous event of the same index.
+    // Only for the events of the primary input.
+    void enablePrefetching(unsigned int nIndexes);
+    void prefetchAsync(unsigned int index, EDProductGetter const* ep);
+    void stopPrefetching();
+
   private:
+    struct PrefetchedProducts {
+      EntryNumber entry_ = -1;
+      EDProductGetter const* ep_ = nullptr;
+      std::vector<BranchID> toRead_;     // requested in the previous event
+      unsigned int next_ = 0;            // next branch of toRead_ to read
+      std::vector<BranchID> requested_;  // requested in this event, in order of first request
+      std::unordered_map<unsigned int, std::unique_ptr<WrapperBase>> products_;
+      std::unordered_set<unsigned int> delivered_;
+    };
+
     std::unique_ptr<WrapperBase> getProduct_(BranchID const& k, EDProductGetter const* ep) override;
+    std::unique_ptr<WrapperBase> readProduct(BranchInfo const& branchInfo,
+                                             EntryNumber entry,
+                                             EDProductGetter const* ep,
+                                             bool speculative = false);
+    void readTableColumns(TableColumnBranches const& columns, EntryNumber entry, WrapperBase& edp);
+    void schedulePrefetching();
+    bool prefetchOne();
     void mergeReaders_(DelayedReader* other) override { nextReader_ = other; }
     void reset_() override { nextReader_ = nullptr; }
     std::pair<SharedResourcesAcquirer*, std::recursive_mutex*> sharedResources_() const override;
@@ -85,6 +113,19 @@ namespace edm {
     // rethrow that exception on other threads. This avoids TTree
     // non-exception safety problems on later calls to TTree.
     mutable std::exception_ptr lastException_;
+
+    // The prefetching state is protected by mutex_.
+    bool prefetching_ = false;
+    std::vector<PrefetchedProducts> prefetched_;  // one per index
+    unsigned int nextIndex_ = 0;                  // the indexes are served in turn
+    bool prefetchScheduled_ = false;              // a prefetching task is pending, or deferred
+    // Shared with the pending prefetching tasks, which may outlive the reader
+    struct PrefetchingState {
+      bool active_ = true;  // cleared when the file is closed, protected by mutex_
+      // set by a prefetching task that found mutex_ taken, the next holder of mutex_ schedules a new one
+      std::atomic<bool> deferred_{false};
+    };
+    std::shared_ptr<PrefetchingState> prefetchingState_;
   };  // class RootDelayedReader
   //------------------------------------------------------------
 }  // namespace edm
@@ -1456,6 +1456,7 @@ namespace edm {
                                  std::move(branchListIndexes_),
                                  *(makeProductProvenanceRetriever(principal.streamID().value())),
                                  eventTree_.resetAndGetRootDelayedReader());
+    eventTree_.prefetchProductsAsync(principal.transitionIndex(), &principal);
 
     // report event read from file
     filePtr_->eventReadFromFile();
@@ -199,6 +199,7 @@ namespace edm {
     void close();
     bool readCurrentEvent(EventPrincipal& cache);
     void readEvent(EventPrincipal& cache);
+    void enableEventProductPrefetching() { eventTree_.enableProductPrefetching(); }
 
     std::shared_ptr<LuminosityBlockAuxiliary> readLuminosityBlockAuxiliary_();
     std::shared_ptr<RunAuxiliary> readRunAuxiliary_();
@@ -4,15 +4,19 @@
 #include "RootInputFileSequence.h"
 
 #include "DataFormats/Provenance/interface/BranchID.h"
+#include "DataFormats/Provenance/interface/BranchType.h"
 #include "DataFormats/Provenance/interface/IndexIntoFile.h"
 #include "DataFormats/Provenance/interface/ProductRegistry.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ServiceRegistry/interface/ServiceRegistry.h"
 #include "Utilities/StorageFactory/interface/StorageFactory.h"
 
 #include "TSystem.h"
 
+#include <algorithm>
+
 namespace edm {
   class BranchIDListHelper;
   class EventPrincipal;
@@ -46,7 +50,66 @@ namespace edm {
     return rootFile()->branchIDListHelper();
   }
 
-  RootInputFileSequence::~RootInputFileSequence() {}
+  RootInputFileSequence::~RootInputFileSequence() { closeFilesOpenedAhead(); }
+
+  void RootInputFileSequence::openFilesAhead(unsigned int nFiles, InputType inputType) {
+    if (noMoreFiles()) {
+      return;
+    }
+    size_t current = sequenceNumberOfFile();
+    size_t last = std::min(current + nFiles, numberOfFiles() - 1);
+    auto token = ServiceRegistry::instance().presentToken();
+    for (size_t i = current + 1; i <= last; ++i) {
+      FileCatalogItem const& item = fileCatalogItems()[i];
+      if (item.fileName().empty() or filesOpenedAhead_.find(i) != filesOpenedAhead_.end()) {
+        continue;
+      }
+      std::unique_ptr<char[]> fullName(gSystem->ExpandPathName(item.fileName().c_str()));
+      auto ahead = std::make_shared<FileOpenedAhead>();
+      filesOpenedAhead_.emplace(i, ahead);
+      openingAhead_ = true;
+      openAheadQueue_.push([ahead, fileName = std::string(fullName.get()), inputType, token]() {
+        // initTheFile() may have dropped it, or already opened it itself
+        if (ahead->claimed_.exchange(true)) {
+          ahead->opened_.doneWaiting(nullptr);
+          return;
+        }
+        ServiceRegistry::Operate operate(token);
+        // the open signals are emitted when initTheFile() adopts the file, on the thread of the source
+        try {
+          auto filePtr = std::make_shared<InputFile>(fileName.c_str(), "  Initiating request to open file ", inputType);
+          if (filePtr->isOpen()) {
+            // The trees are kept by the TFile, RootFile will find them already in memory.
+            for (auto const& treeName : {poolNames::metaDataTreeName(),
+                                         poolNames::parameterSetsTreeName(),
+                                         poolNames::parentageTreeName(),
+                                         BranchTypeToProductTreeName(InEvent),
+                                         BranchTypeToProductTreeName(InLumi),
+                                         BranchTypeToProductTreeName(InRun)}) {
+              filePtr->Get(treeName.c_str());
+            }
+            ahead->file_ = std::move(filePtr);
+          }
+        } catch (...) {
+          // initTheFile() will try again, and report the failure
+        }
+        ahead->opened_.doneWaiting(nullptr);
+      });
+    }
+  }
+
+  void RootInputFileSequence::closeFilesOpenedAhead() {
+    if (not openingAhead_) {
+      return;
+    }
+    // the opens that have not started are dropped, the one running is waited for
+    for (auto& file : filesOpenedAhead_) {
+      file.second->claimed_ = true;
+    }
+    openAheadQueue_.pushAndWait([]() {});
+    filesOpenedAhead_.clear();
+    openingAhead_ = false;
+  }
 
   std::shared_ptr<RunAuxiliary> RootInputFileSequence::readRunAuxiliary_() {
     assert(rootFile());
@@ -224,30 +287,56 @@ namespace edm {
 
     std::shared_ptr<InputFile> filePtr;
     std::list<std::string> originalInfo;
-    try {
-      std::unique_ptr<InputSource::FileOpenSentry> sentry(
-          input ? std::make_unique<InputSource::FileOpenSentry>(*input, lfn_, usedFallback_) : nullptr);
-      std::unique_ptr<char[]> name(gSystem->ExpandPathName(fileName().c_str()));
-      ;
-      filePtr = std::make_shared<InputFile>(name.get(), "  Initiating request to open file ", inputType);
-    } catch (cms::Exception const& e) {
-      if (!skipBadFiles) {
-        if (hasFallbackUrl) {
-          std::ostringstream out;
-          out << e.explainSelf();
+    // The files before this one that were to be opened ahead will not be used.
+    std::shared_ptr<FileOpenedAhead> ahead;
+    for (auto it = filesOpenedAhead_.begin();
+         it != filesOpenedAhead_.end() and it->first <= sequenceNumberOfFile();
+         it = filesOpenedAhead_.erase(it)) {
+      if (it->first == sequenceNumberOfFile()) {
+        ahead = it->second;
+      } else {
+        it->second->claimed_ = true;
+      }
+    }
+    // If its open has not started, the file is opened here instead.
+    if (ahead and ahead->claimed_.exchange(true)) {
+      auto waitTask = make_empty_waiting_task();
+      waitTask->increment_ref_count();
+      ahead->opened_.add(waitTask.get());
+      // takes part in the other tasks until the open is done
+      waitTask->wait_for_all();
+      filePtr = ahead->file_;
+      // adopted now: emit the preOpenFile and postOpenFile signals, as for the files opened below
+      if (filePtr and input) {
+        InputSource::FileOpenSentry sentry(*input, lfn_, usedFallback_);
+      }
+    }
+    if (!filePtr) {
+      try {
+        std::unique_ptr<InputSource::FileOpenSentry> sentry(
+            input ? std::make_unique<InputSource::FileOpenSentry>(*input, lfn_, usedFallback_) : nullptr);
+        std::unique_ptr<char[]> name(gSystem->ExpandPathName(fileName().c_str()));
+        ;
+        filePtr = std::make_shared<InputFile>(name.get(), "  Initiating request to open file ", inputType);
+      } catch (cms::Exception const& e) {
+        if (!skipBadFiles) {
+          if (hasFallbackUrl) {
+            std::ostringstream out;
+            out << e.explainSelf();
 
-          std::unique_ptr<char[]> name(gSystem->ExpandPathName(fallbackFileName().c_str()));
-          std::string pfn(name.get());
-          InputFile::reportFallbackAttempt(pfn, logicalFileName(), out.str());
-          originalInfo = e.additionalInfo();
-        } else {
-          InputFile::reportSkippedFile(fileName(), logicalFileName());
-          Exception ex(errors::FileOpenError, "", e);
-          ex.addContext("Calling RootFileSequenceBase::initTheFile()");
-          std::ostringstream out;
-          out << "Input file " << fileName() << " could not be opened.";
-          ex.addAdditionalInfo(out.str());
-          throw ex;
+            std::unique_ptr<char[]> name(gSystem->ExpandPathName(fallbackFileName().c_str()));
+            std::string pfn(name.get());
+            InputFile::reportFallbackAttempt(pfn, logicalFileName(), out.str());
+            originalInfo = e.additionalInfo();
+          } else {
+            InputFile::reportSkippedFile(fileName(), logicalFileName());
+            Exception ex(errors::FileOpenError, "", e);
+            ex.addContext("Calling RootFileSequenceBase::initTheFile()");
+            std::ostringstream out;
+            out << "Input file " << fileName() << " could not be opened.";
+            ex.addAdditionalInfo(out.str());
+            throw ex;
+          }
         }
       }
     }
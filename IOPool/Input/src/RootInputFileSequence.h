@@ -10,9 +10,13 @@ RootInputFileSequence: This is an InputSource
 #include "InputFile.h"
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "FWCore/Catalog/interface/InputFileCatalog.h"
+#include "FWCore/Concurrency/interface/SerialTaskQueue.h"
+#include "FWCore/Concurrency/interface/WaitingTaskList.h"
 #include "FWCore/Utilities/interface/InputType.h"
 #include "FWCore/Utilities/interface/get_underlying_safe.h"
 
+#include <atomic>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -56,6 +60,11 @@ namespace edm {
                      InputSource* input,
                      char const* inputTypeName,
                      InputType inputType);
+    // Open in the background, one after the other, the next nFiles files of the sequence, and read
+    // their metadata trees, so that initTheFile() finds them ready. The file open signals of the
+    // source are emitted when initTheFile() adopts such a file.
+    void openFilesAhead(unsigned int nFiles, InputType inputType);
+    void closeFilesOpenedAhead();
     bool skipToItemInNewFile(RunNumber_t run, LuminosityBlockNumber_t lumi, EventNumber_t event);
     bool skipToItemInNewFile(RunNumber_t run, LuminosityBlockNumber_t lumi, EventNumber_t event, size_t fileNameHash);
 
@@ -99,6 +108,15 @@ namespace edm {
     edm::propagate_const<RootFileSharedPtr> rootFile_;
     std::vector<std::shared_ptr<IndexIntoFile>> indexesIntoFiles_;
 
+    struct FileOpenedAhead {
+      std::atomic<bool> claimed_{false};  // by the task opening it, or by the source dropping it before
+      std::shared_ptr<InputFile> file_;   // null if the open failed
+      WaitingTaskList opened_;
+    };
+    std::map<size_t, std::shared_ptr<FileOpenedAhead>> filesOpenedAhead_;  // by sequence number
+    SerialTaskQueue openAheadQueue_;
+    bool openingAhead_ = false;  // tasks were pushed to openAheadQueue_
+
   private:
     virtual RootFileSharedPtr makeRootFile(std::shared_ptr<InputFile> filePtr) = 0;
     virtual void initFile_(bool skipBadFiles) = 0;
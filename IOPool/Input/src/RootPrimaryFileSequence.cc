@@ -32,7 +32,10 @@ namespace edm {
         treeCacheSize_(noEventSort_ ? pset.getUntrackedParameter<unsigned int>("cacheSize") : 0U),
         duplicateChecker_(new DuplicateChecker(pset)),
         usingGoToEvent_(false),
-        enablePrefetching_(false) {
+        enablePrefetching_(false),
+        prefetchEventProducts_(pset.getUntrackedParameter<bool>("prefetchEventProducts") &&
+                               pset.getUntrackedParameter<bool>("delayReadingEventProducts")),
+        filesToOpenAhead_(pset.getUntrackedParameter<unsigned int>("filesToOpenAhead")) {
     // The SiteLocalConfig controls the TTreeCache size and the prefetching settings.
     Service<SiteLocalConfig> pSLC;
     if (pSLC.isAvailable()) {
@@ -67,7 +70,10 @@ namespace edm {
 
   RootPrimaryFileSequence::~RootPrimaryFileSequence() {}
 
-  void RootPrimaryFileSequence::endJob() { closeFile_(); }
+  void RootPrimaryFileSequence::endJob() {
+    closeFile_();
+    closeFilesOpenedAhead();
+  }
 
   std::unique_ptr<FileBlock> RootPrimaryFileSequence::readFile_() {
     if (firstFile_) {
@@ -105,39 +111,46 @@ namespace edm {
     bool deleteIndexIntoFile = !usingGoToEvent_ && !(duplicateChecker_ && duplicateChecker_->checkingAllFiles() &&
                                                      !duplicateChecker_->checkDisabled());
     initTheFile(skipBadFiles, deleteIndexIntoFile, &input_, "primaryFiles", InputType::Primary);
+    if (filesToOpenAhead_ != 0U) {
+      openFilesAhead(filesToOpenAhead_, InputType::Primary);
+    }
   }
 
   RootPrimaryFileSequence::RootFileSharedPtr RootPrimaryFileSequence::makeRootFile(std::shared_ptr<InputFile> filePtr) {
     size_t currentIndexIntoFile = sequenceNumberOfFile();
-    return std::make_shared<RootFile>(fileName(),
-                                      input_.processConfiguration(),
-                                      logicalFileName(),
-                                      filePtr,
-                                      eventSkipperByID(),
-                                      initialNumberOfEventsToSkip_ != 0,
-                                      remainingEvents(),
-                                      remainingLuminosityBlocks(),
-                                      input_.nStreams(),
-                                      treeCacheSize_,
-                                      input_.treeMaxVirtualSize(),
-                                      input_.processingMode(),
-                                      input_.runHelper(),
-                                      noEventSort_,
-                                      input_.productSelectorRules(),
-                                      InputType::Primary,
-                                      input_.branchIDListHelper(),
-                                      input_.thinnedAssociationsHelper(),
-                                      nullptr,  // associationsFromSecondary
-                                      duplicateChecker(),
-                                      input_.dropDescendants(),
-                                      input_.processHistoryRegistryForUpdate(),
-                                      indexesIntoFiles(),
-                                      currentIndexIntoFile,
-                                      orderedProcessHistoryIDs_,
-                                      input_.bypassVersionCheck(),
-                                      input_.labelRawDataLikeMC(),
-                                      usingGoToEvent_,
-                                      enablePrefetching_);
+    auto file = std::make_shared<RootFile>(fileName(),
+                                           input_.processConfiguration(),
+                                           logicalFileName(),
+                                           filePtr,
+                                           eventSkipperByID(),
+                                           initialNumberOfEventsToSkip_ != 0,
+                                           remainingEvents(),
+                                           remainingLuminosityBlocks(),
+                                           input_.nStreams(),
+                                           treeCacheSize_,
+                                           input_.treeMaxVirtualSize(),
+                                           input_.processingMode(),
+                                           input_.runHelper(),
+                                           noEventSort_,
+                                           input_.productSelectorRules(),
+                                           InputType::Primary,
+                                           input_.branchIDListHelper(),
+                                           input_.thinnedAssociationsHelper(),
+                                           nullptr,  // associationsFromSecondary
+                                           duplicateChecker(),
+                                           input_.dropDescendants(),
+                                           input_.processHistoryRegistryForUpdate(),
+                                           indexesIntoFiles(),
+                                           currentIndexIntoFile,
+                                           orderedProcessHistoryIDs_,
+                                           input_.bypassVersionCheck(),
+                                           input_.labelRawDataLikeMC(),
+                                           usingGoToEvent_,
+                                           enablePrefetching_);
+    if (prefetchEventProducts_) {
+      file->enableEventProductPrefetching();
+    }
+    return file;
   }
 
   bool RootPrimaryFileSequence::nextFile() {
@@ -322,6 +335,14 @@ namespace edm {
         ->setComment(
             "'strict':     Branches in each input file must match those in the first file.\n"
             "'permissive': Branches in each input file may be any subset of those in the first file.");
+    desc.addUntracked<unsigned int>("filesToOpenAhead", 0U)
+        ->setComment(
+            "Number of the next input files to open in the background, with their metadata trees, while the "
+            "current file is processed.");
+    desc.addUntracked<bool>("prefetchEventProducts", false)
+        ->setComment(
+            "If True: as soon as an event is read, read ahead in the background the products that were requested in "
+            "the previous events, while the modules are processing. Ignored if 'delayReadingEventProducts' is False.");
 
     EventSkipperByID::fillDescription(desc);
     DuplicateChecker::fillDescription(desc);
@@ -77,6 +77,8 @@ namespace edm {
     edm::propagate_const<std::shared_ptr<DuplicateChecker>> duplicateChecker_;
     bool usingGoToEvent_;
     bool enablePrefetching_;
+    bool prefetchEventProducts_;
+    unsigned int filesToOpenAhead_;
   };  // class RootPrimaryFileSequence
 }  // namespace edm
 #endif
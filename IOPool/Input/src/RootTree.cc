@@ -3,7 +3,10 @@
 #include "FWCore/Utilities/interface/EDMException.h"
 #include "FWCore/Utilities/interface/Exception.h"
 #include "DataFormats/Provenance/interface/BranchDescription.h"
+#include "FWCore/SOA/interface/TableExaminerBase.h"
+#include "IOPool/Common/interface/getWrapperBasePtr.h"
 #include "InputFile.h"
+#include "TClass.h"
 #include "TTree.h"
 #include "TTreeIndex.h"
 #include "TTreeCache.h"
@@ -127,6 +130,12 @@ namespace edm {
 
   DelayedReader* RootTree::rootDelayedReader() const { return rootDelayedReader_.get(); }
 
+  void RootTree::enableProductPrefetching() { rootDelayedReader_->enablePrefetching(entryNumberForIndex_->size()); }
+
+  void RootTree::prefetchProductsAsync(unsigned int index, EDProductGetter const* ep) {
+    rootDelayedReader_->prefetchAsync(index, ep);
+  }
+
   void RootTree::setPresence(BranchDescription& prod, std::string const& oldBranchName) {
     assert(isValid());
     if (tree_->GetBranch(oldBranchName.c_str()) == nullptr) {
@@ -144,12 +153,33 @@ namespace edm {
       info.productBranch_ = branch;
       //we want the new branch name for the JobReport
       branchNames_.push_back(prod.branchName());
+      info.tableColumnBranches_ = findTableColumnBranches(prod, oldBranchName);
     }
     TTree* provTree = (metaTree_ != nullptr ? metaTree_ : tree_);
     info.provenanceBranch_ = provTree->GetBranch(oldBranchName.c_str());
     branches_.insert(prod.branchID(), info);
   }
 
+  std::shared_ptr<TableColumnBranches> RootTree::findTableColumnBranches(BranchDescription const& prod,
+                                                                         std::string const& oldBranchName) {
+    static std::string const tablePrefix("edm::soa::Table<");
+    if (prod.className().compare(0, tablePrefix.size(), tablePrefix) != 0) {
+      return std::shared_ptr<TableColumnBranches>();
+    }
+    // The columns of the Table are known from its type, an empty one is enough to examine them.
+    TClass* cp = TClass::GetClass(prod.wrappedName().c_str());
+    if (cp == nullptr) {
+      return std::shared_ptr<TableColumnBranches>();
+    }
+    std::unique_ptr<WrapperBase> dummy =
+        getWrapperBasePtr(cp->New(), cp->GetBaseClassOffset(TClass::GetClass("edm::WrapperBase")));
+    auto examiner = dummy->tableExaminer();
+    if (not examiner) {
+      return std::shared_ptr<TableColumnBranches>();
+    }
+    return TableColumnBranches::find(tree_, oldBranchName, *examiner);
+  }
+
   void RootTree::dropBranch(std::string const& oldBranchName) {
     //use the translated branch name
     TBranch* branch = tree_->GetBranch(oldBranchName.c_str());
@@ -440,6 +470,8 @@ namespace edm {
   void RootTree::close() {
     // The TFile is about to be closed, and destructed.
     // Just to play it safe, zero all pointers to quantities that are owned by the TFile.
+    // The pending read-ahead of products must not use them either.
+    rootDelayedReader_->stopPrefetching();
     auxBranch_ = branchEntryInfoBranch_ = nullptr;
     tree_ = metaTree_ = infoTree_ = nullptr;
     // We own the treeCache_.
@@ -13,6 +13,7 @@ RootTree.h // used by ROOT input sources
 #include "DataFormats/Provenance/interface/ProvenanceFwd.h"
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "FWCore/Utilities/interface/InputType.h"
+#include "IOPool/Common/interface/TableColumnBranches.h"
 
 #include "Rtypes.h"
 #include "TBranch.h"
@@ -30,6 +31,7 @@ class TTreeCache;
 
 namespace edm {
   class BranchKey;
+  class EDProductGetter;
   class RootDelayedReader;
   class InputFile;
   class RootTree;
@@ -60,6 +62,8 @@ namespace edm {
       TBranch* provenanceBranch_;  // For backward compatibility
       mutable TClass* classCache_;
       mutable Int_t offsetToWrapperBase_;
+      // For an edm::soa::Table product, the branches of its columns
+      std::shared_ptr<TableColumnBranches> tableColumnBranches_;
     };
 
     class BranchMap {
@@ -138,6 +142,8 @@ namespace edm {
     std::vector<std::string> const& branchNames() const { return branchNames_; }
     DelayedReader* rootDelayedReader() const;
     DelayedReader* resetAndGetRootDelayedReader() const;
+    void enableProductPrefetching();
+    void prefetchProductsAsync(unsigned int index, EDProductGetter const* ep);
     template <typename T>
     void fillAux(T*& pAux) {
       auxBranch_->SetAddress(&pAux);
@@ -198,6 +204,8 @@ namespace edm {
         signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* postEventReadSource);
 
   private:
+    std::shared_ptr<TableColumnBranches> findTableColumnBranches(BranchDescription const& prod,
+                                                                 std::string const& oldBranchName);
     void setCacheSize(unsigned int cacheSize);
     void setTreeMaxVirtualSize(int treeMaxVirtualSize);
     void startTraining();
@@ -0,0 +1,68 @@
+// Checks that the products of EventNumberIntProducer read from the input hold the number of the event
+// they are read with, and counts the events.
+
+#include "DataFormats/TestObjects/interface/ToyProducts.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/EDGetToken.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include <atomic>
+#include <vector>
+
+namespace edmtest {
+  class EventNumberProductAnalyzer : public edm::global::EDAnalyzer<> {
+  public:
+    explicit EventNumberProductAnalyzer(edm::ParameterSet const& pset);
+
+    void analyze(edm::StreamID, edm::Event const& e, edm::EventSetup const&) const override;
+    void endJob() override;
+
+    static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  private:
+    std::vector<edm::EDGetTokenT<UInt64Product>> tokens_;
+    unsigned int const expectedEvents_;
+    mutable std::atomic<unsigned int> events_{0};
+  };
+
+  EventNumberProductAnalyzer::EventNumberProductAnalyzer(edm::ParameterSet const& pset)
+      : expectedEvents_(pset.getUntrackedParameter<unsigned int>("expectedEvents")) {
+    for (auto const& tag : pset.getUntrackedParameter<std::vector<edm::InputTag>>("products")) {
+      tokens_.push_back(consumes<UInt64Product>(tag));
+    }
+  }
+
+  void EventNumberProductAnalyzer::analyze(edm::StreamID, edm::Event const& e, edm::EventSetup const&) const {
+    for (auto const& token : tokens_) {
+      auto const& product = e.get(token);
+      if (product.value != e.id().event()) {
+        throw cms::Exception("TestFail") << "EventNumberProductAnalyzer: product of event " << product.value
+                                         << " read with event " << e.id();
+      }
+    }
+    ++events_;
+  }
+
+  void EventNumberProductAnalyzer::endJob() {
+    if (events_ != expectedEvents_) {
+      throw cms::Exception("TestFail") << "EventNumberProductAnalyzer: " << events_ << " events were analyzed, "
+                                       << expectedEvents_ << " were expected";
+    }
+  }
+
+  void EventNumberProductAnalyzer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+    edm::ParameterSetDescription desc;
+    desc.addUntracked<std::vector<edm::InputTag>>("products");
+    desc.addUntracked<unsigned int>("expectedEvents");
+    descriptions.add("eventNumberProductAnalyzer", desc);
+  }
+}  // namespace edmtest
+
+using edmtest::EventNumberProductAnalyzer;
+DEFINE_FWK_MODULE(EventNumberProductAnalyzer);
@@ -0,0 +1,33 @@
+# Reads four files, opening the next two ahead, with the number of threads and streams given as argument
+
+import FWCore.ParameterSet.Config as cms
+from sys import argv
+
+process = cms.Process("TESTRECO")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(-1)
+)
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(int(argv[2])),
+    numberOfStreams = cms.untracked.uint32(int(argv[2]))
+)
+process.OtherThing = cms.EDProducer("OtherThingProducer")
+
+process.Analysis = cms.EDAnalyzer("OtherThingAnalyzer")
+
+process.check = cms.EDAnalyzer("EventNumberProductAnalyzer",
+    products = cms.untracked.VInputTag("eventNumber1", "eventNumber2", "eventNumber3", "eventNumber4"),
+    expectedEvents = cms.untracked.uint32(160)
+)
+
+process.source = cms.Source("PoolSource",
+    filesToOpenAhead = cms.untracked.uint32(2),
+    fileNames = cms.untracked.vstring('file:PoolInputPrefetch1.root',
+        'file:PoolInputPrefetch2.root',
+        'file:PoolInputPrefetch3.root',
+        'file:PoolInputPrefetch4.root')
+)
+
+process.p = cms.Path(process.OtherThing*process.Analysis*process.check)
@@ -0,0 +1,29 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TESTRECO")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(-1)
+)
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(4)
+)
+process.OtherThing = cms.EDProducer("OtherThingProducer")
+
+process.Analysis = cms.EDAnalyzer("OtherThingAnalyzer")
+
+# the products read ahead must be those of the event they are delivered with
+process.check = cms.EDAnalyzer("EventNumberProductAnalyzer",
+    products = cms.untracked.VInputTag("eventNumber1", "eventNumber2", "eventNumber3", "eventNumber4"),
+    expectedEvents = cms.untracked.uint32(80)
+)
+
+process.source = cms.Source("PoolSource",
+    prefetchEventProducts = cms.untracked.bool(True),
+    fileNames = cms.untracked.vstring('file:PoolInputPrefetch1.root',
+        'file:PoolInputPrefetch2.root')
+)
+
+process.p = cms.Path(process.OtherThing*process.Analysis*process.check)
@@ -0,0 +1,29 @@
+# Writes events with several products holding the event number, for PoolInputTest_prefetch_cfg.py
+
+import FWCore.ParameterSet.Config as cms
+from sys import argv
+
+process = cms.Process("TESTPROD")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(40)
+)
+
+process.Thing = cms.EDProducer("ThingProducer")
+process.eventNumber1 = cms.EDProducer("EventNumberIntProducer")
+process.eventNumber2 = cms.EDProducer("EventNumberIntProducer")
+process.eventNumber3 = cms.EDProducer("EventNumberIntProducer")
+process.eventNumber4 = cms.EDProducer("EventNumberIntProducer")
+
+process.output = cms.OutputModule("PoolOutputModule",
+    fileName = cms.untracked.string(argv[2])
+)
+
+process.source = cms.Source("EmptySource",
+    firstRun = cms.untracked.uint32(int(argv[3])),
+    numberEventsInLuminosityBlock = cms.untracked.uint32(10)
+)
+
+process.p = cms.Path(process.Thing+process.eventNumber1+process.eventNumber2+process.eventNumber3+process.eventNumber4)
+process.ep = cms.EndPath(process.output)
@@ -11,6 +11,13 @@ cp PoolInputTest.root PoolInputOther.root
 cmsRun --parameter-set ${LOCAL_TEST_DIR}/PoolInputTest_cfg.py || die 'Failure using PoolInputTest_cfg.py' $?
 cmsRun  ${LOCAL_TEST_DIR}/PoolInputTest_noDelay_cfg.py >& ${LOCAL_TMP_DIR}/PoolInputTest_noDelay_cfg.txt || die 'Failure using PoolInputTest_noDelay_cfg.py' $?
 grep 'event delayed read from source' ${LOCAL_TMP_DIR}/PoolInputTest_noDelay_cfg.txt && die 'Failure in PoolInputTest_noDelay_cfg.py, found delay reads from source' 1
+cmsRun ${LOCAL_TEST_DIR}/PrePoolInputTest_prefetch_cfg.py PoolInputPrefetch1.root 1 || die 'Failure using PrePoolInputTest_prefetch_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/PrePoolInputTest_prefetch_cfg.py PoolInputPrefetch2.root 2 || die 'Failure using PrePoolInputTest_prefetch_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/PoolInputTest_prefetch_cfg.py || die 'Failure using PoolInputTest_prefetch_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/PrePoolInputTest_prefetch_cfg.py PoolInputPrefetch3.root 3 || die 'Failure using PrePoolInputTest_prefetch_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/PrePoolInputTest_prefetch_cfg.py PoolInputPrefetch4.root 4 || die 'Failure using PrePoolInputTest_prefetch_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/PoolInputTest_openAhead_cfg.py 1 || die 'Failure using PoolInputTest_openAhead_cfg.py with 1 thread' $?
+cmsRun ${LOCAL_TEST_DIR}/PoolInputTest_openAhead_cfg.py 4 || die 'Failure using PoolInputTest_openAhead_cfg.py with 4 threads' $?
 
 cmsRun ${LOCAL_TEST_DIR}/PrePool2FileInputTest_cfg.py || die 'Failure using PrePool2FileInputTest_cfg.py' $?
 cmsRun ${LOCAL_TEST_DIR}/Pool2FileInputTest_cfg.py || die 'Failure using Pool2FileInputTest_cfg.py' $?
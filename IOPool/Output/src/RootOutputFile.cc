@@ -33,9 +33,11 @@
 #include "FWCore/ParameterSet/interface/Registry.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/Utilities/interface/ExceptionPropagate.h"
+#include "FWCore/SOA/interface/TableExaminerBase.h"
 #include "IOPool/Common/interface/getWrapperBasePtr.h"
 #include "IOPool/Provenance/interface/CommonProvenanceFiller.h"
 
+#include "TBranch.h"
 #include "TTree.h"
 #include "TFile.h"
 #include "TClass.h"
@@ -161,6 +163,7 @@ namespace edm {
                            item.splitLevel_,
                            item.basketSize_,
                            item.branchDescription_->produced());
+        tableColumnBranches_[branchType].push_back(addTableColumnBranches(*theTree, item));
         //make sure we always store product registry info for all branches we create
         branchesWithStoredHistory_.insert(item.branchID());
       }
@@ -684,6 +687,24 @@ namespace edm {
     }
   }
 
+  TableColumnBranches* RootOutputFile::addTableColumnBranches(RootOutputTree& tree, OutputItem const& item) {
+    static std::string const tablePrefix("edm::soa::Table<");
+    BranchDescription const& desc = *item.branchDescription_;
+    if (desc.className().compare(0, tablePrefix.size(), tablePrefix) != 0) {
+      return nullptr;
+    }
+    // The columns of the Table are known from its type, an empty one is enough to examine them.
+    TClass* cp = desc.wrappedType().getClass();
+    assert(cp != nullptr);
+    std::unique_ptr<WrapperBase> dummy = getWrapperBasePtr(cp->New(), cp->GetBaseClassOffset(wrapperBaseTClass_));
+    auto examiner = dummy->tableExaminer();
+    if (not examiner) {
+      return nullptr;
+    }
+    return tree.addTableColumnBranches(
+        desc.branchName(), *examiner, item.splitLevel_, item.basketSize_, desc.produced());
+  }
+
   void RootOutputFile::fillBranches(BranchType const& branchType,
                                     OccurrenceForOutput const& occurrence,
                                     StoredProductProvenanceVector* productProvenanceVecPtr,
@@ -714,13 +735,21 @@ namespace edm {
     }
 
     // Loop over EDProduct branches, possibly fill the provenance, and write the branch.
+    auto tableColumns = tableColumnBranches_[branchType].begin();
     for (auto const& item : items) {
       BranchID const& id = item.branchDescription_->branchID();
       branchesWithStoredHistory_.insert(id);
+      TableColumnBranches* columns = *tableColumns++;
 
       bool produced = item.branchDescription_->produced();
       bool getProd =
           (produced || !fastCloning || treePointers_[branchType]->uncloned(item.branchDescription_->branchName()));
+      if (columns != nullptr && !getProd) {
+        // The columns are also needed if any of their branches was not fast cloned
+        for (auto branch : columns->branches()) {
+          getProd = getProd || treePointers_[branchType]->uncloned(branch->GetName());
+        }
+      }
       bool keepProvenance = doProvenance && (produced || keepProvenanceForPrior);
 
       WrapperBase const* product = nullptr;
@@ -743,6 +772,9 @@ namespace edm {
           dummies.emplace_back(std::move(dummy));
         }
         item.product_ = product;
+        if (columns != nullptr) {
+          columns->copyFrom(*product->tableExaminer());
+        }
       }
       if (keepProvenance && productProvenance == nullptr) {
         productProvenance = provRetriever->branchIDToProvenance(item.branchDescription_->originalBranchID());
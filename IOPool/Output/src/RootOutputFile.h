@@ -85,6 +85,8 @@ namespace edm {
 
     void setBranchAliases(TTree* tree, SelectedProducts const& branches) const;
 
+    TableColumnBranches* addTableColumnBranches(RootOutputTree& tree, OutputItem const& item);
+
     void fillBranches(BranchType const& branchType,
                       OccurrenceForOutput const& occurrence,
                       StoredProductProvenanceVector* productProvenanceVecPtr = nullptr,
@@ -143,6 +145,8 @@ namespace edm {
     std::map<ParentageID, unsigned int> parentageIDs_;
     std::set<BranchID> branchesWithStoredHistory_;
     edm::propagate_const<TClass*> wrapperBaseTClass_;
+    // The branches of the columns of each selected Table product, nullptr for the other products
+    std::array<std::vector<TableColumnBranches*>, NumBranchTypes> tableColumnBranches_;
   };
 
 }  // namespace edm
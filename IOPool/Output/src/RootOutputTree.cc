@@ -280,7 +280,9 @@ namespace edm {
       tree->SetEntries(-1);
     }
     setRefCoreStreamer(true);
-    tree->AutoSave("FlushBaskets");
+    // The baskets of all branches are compressed concurrently when the tree
+    // uses implicit multi-threading, so isolate as is done for Fill.
+    tbb::this_task_arena::isolate([&] { tree->AutoSave("FlushBaskets"); });
   }
 
   void RootOutputTree::fillTTree(std::vector<TBranch*> const& branches) {
@@ -350,6 +352,19 @@ namespace edm {
     }
   }
 
+  TableColumnBranches* RootOutputTree::addTableColumnBranches(std::string const& branchName,
+                                                              soa::TableExaminerBase const& examiner,
+                                                              int splitLevel,
+                                                              int basketSize,
+                                                              bool produced) {
+    tableColumnBranches_.push_back(TableColumnBranches::make(tree_, branchName, examiner, splitLevel, basketSize));
+    auto& branches = produced ? producedBranches_ : readBranches_;
+    for (auto branch : tableColumnBranches_.back()->branches()) {
+      branches.push_back(branch);
+    }
+    return tableColumnBranches_.back().get();
+  }
+
   void RootOutputTree::close() {
     // The TFile was just closed.
     // Just to play it safe, zero all pointers to quantities in the file.
@@ -358,6 +373,7 @@ namespace edm {
     producedBranches_.clear();
     readBranches_.clear();
     unclonedReadBranches_.clear();
+    tableColumnBranches_.clear();
     tree_ = nullptr;     // propagate_const<T> has no reset() function
     filePtr_ = nullptr;  // propagate_const<T> has no reset() function
   }
@@ -14,6 +14,7 @@ RootOutputTree.h // used by ROOT output modules
 
 #include "FWCore/Utilities/interface/BranchType.h"
 #include "FWCore/Utilities/interface/propagate_const.h"
+#include "IOPool/Common/interface/TableColumnBranches.h"
 
 #include "TTree.h"
 
@@ -21,6 +22,10 @@ class TFile;
 class TBranch;
 
 namespace edm {
+  namespace soa {
+    class TableExaminerBase;
+  }
+
   class RootOutputTree {
   public:
     RootOutputTree(std::shared_ptr<TFile> filePtr, BranchType const& branchType, int splitLevel, int treeMaxVirtualSize);
@@ -65,6 +70,13 @@ namespace edm {
                    int basketSize,
                    bool produced);
 
+    // Adds the branches of the columns of a Table product, next to its branch
+    TableColumnBranches* addTableColumnBranches(std::string const& branchName,
+                                                soa::TableExaminerBase const& examiner,
+                                                int splitLevel,
+                                                int basketSize,
+                                                bool produced);
+
     bool checkSplitLevelsAndBasketSizes(TTree* inputTree) const;
 
     bool checkIfFastClonable(TTree* inputTree) const;
@@ -109,6 +121,7 @@ namespace edm {
     std::vector<TBranch*> auxBranches_;
     std::vector<TBranch*> unclonedAuxBranches_;
     std::vector<TBranch*> unclonedReadBranches_;
+    std::vector<std::unique_ptr<TableColumnBranches>> tableColumnBranches_;
 
     std::set<std::string> clonedReadBranchNames_;
     bool currentlyFastCloning_;
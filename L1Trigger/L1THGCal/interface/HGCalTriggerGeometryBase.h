@@ -14,6 +14,8 @@
 #include "Geometry/CaloGeometry/interface/CaloGeometry.h"
 #include "Geometry/HcalTowerAlgo/interface/HcalGeometry.h"
 
+#include "L1Trigger/L1THGCal/interface/HGCalTriggerMappingTable.h"
+
 // Pure virtual trigger geometry class
 // Provides the interface to access trigger cell and module mappings
 class HGCalTriggerGeometryBase {
@@ -21,6 +23,7 @@ public:
   typedef std::unordered_map<unsigned, unsigned> geom_map;
   typedef std::unordered_set<unsigned> geom_set;
   typedef std::set<unsigned> geom_ordered_set;
+  typedef HGCalTriggerMappingTable::Span geom_span;
 
   HGCalTriggerGeometryBase(const edm::ParameterSet& conf);
   virtual ~HGCalTriggerGeometryBase() {}
@@ -77,6 +80,12 @@ public:
 
   virtual geom_set getNeighborsFromTriggerCell(const unsigned trigger_cell_det_id) const = 0;
 
+  // Allocation-free access to the same mappings, for the geometries which precompute them.
+  // The spans point into the geometry, and are empty for the ids which are not in it.
+  virtual geom_span getCellsFromTriggerCellSpan(const unsigned trigger_cell_det_id) const;
+  virtual geom_span getTriggerCellsFromModuleSpan(const unsigned module_det_id) const;
+  virtual geom_span getNeighborsFromTriggerCellSpan(const unsigned trigger_cell_det_id) const;
+
   virtual unsigned getLinksInModule(const unsigned module_id) const = 0;
   virtual unsigned getModuleSize(const unsigned module_id) const = 0;
 
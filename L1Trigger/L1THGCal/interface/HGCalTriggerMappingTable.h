@@ -0,0 +1,69 @@
+#ifndef __L1Trigger_L1THGCal_HGCalTriggerMappingTable_h__
+#define __L1Trigger_L1THGCal_HGCalTriggerMappingTable_h__
+
+#include <algorithm>
+#include <vector>
+
+// Immutable mapping from detector ids to sets of detector ids, stored in flat arrays:
+// the ids mapped to keys_[i] are values_[offsets_[i]], ..., values_[offsets_[i+1]-1].
+// The keys are sorted, so that a lookup is a binary search which neither hashes nor allocates,
+// and returns a span pointing into the table.
+class HGCalTriggerMappingTable {
+public:
+  class Span {
+  public:
+    Span() = default;
+    Span(const unsigned* begin, const unsigned* end) : begin_(begin), end_(end) {}
+
+    const unsigned* begin() const { return begin_; }
+    const unsigned* end() const { return end_; }
+    size_t size() const { return end_ - begin_; }
+    bool empty() const { return begin_ == end_; }
+    unsigned operator[](size_t i) const { return begin_[i]; }
+
+  private:
+    const unsigned* begin_ = nullptr;
+    const unsigned* end_ = nullptr;
+  };
+
+  // Collects the mapped ids, key by key in any order
+  class Builder {
+  public:
+    template <typename Container>
+    void add(unsigned key, const Container& values) {
+      keys_.push_back(key);
+      values_.insert(values_.end(), values.begin(), values.end());
+      offsets_.push_back(values_.size());
+    }
+    // sorts the keys, and the ids mapped to each of them
+    HGCalTriggerMappingTable build() const;
+
+  private:
+    std::vector<unsigned> keys_;
+    std::vector<unsigned> offsets_ = {0};
+    std::vector<unsigned> values_;
+  };
+
+  HGCalTriggerMappingTable() : offsets_(1, 0) {}
+
+  // empty span for the keys not in the table
+  Span find(unsigned key) const {
+    auto itr = std::lower_bound(keys_.begin(), keys_.end(), key);
+    if (itr == keys_.end() || *itr != key)
+      return Span();
+    size_t index = itr - keys_.begin();
+    return Span(values_.data() + offsets_[index], values_.data() + offsets_[index + 1]);
+  }
+  bool contains(unsigned key) const { return std::binary_search(keys_.begin(), keys_.end(), key); }
+
+  size_t size() const { return keys_.size(); }
+  bool empty() const { return keys_.empty(); }
+  const std::vector<unsigned>& keys() const { return keys_; }
+
+private:
+  std::vector<unsigned> keys_;
+  std::vector<unsigned> offsets_;
+  std::vector<unsigned> values_;
+};
+
+#endif
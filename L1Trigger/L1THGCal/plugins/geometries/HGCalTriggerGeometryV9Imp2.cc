@@ -7,6 +7,7 @@
 #include "DataFormats/ForwardDetId/interface/HGCScintillatorDetId.h"
 #include "DataFormats/ForwardDetId/interface/ForwardSubdetector.h"
 #include "DataFormats/ForwardDetId/interface/HGCSiliconDetIdToROC.h"
+#include "L1Trigger/L1THGCal/interface/HGCalTriggerMappingTable.h"
 
 #include <vector>
 #include <iostream>
@@ -34,6 +35,9 @@ public:
 
   geom_set getNeighborsFromTriggerCell(const unsigned) const final;
 
+  geom_span getCellsFromTriggerCellSpan(const unsigned) const final;
+  geom_span getTriggerCellsFromModuleSpan(const unsigned) const final;
+
   unsigned getLinksInModule(const unsigned module_id) const final;
   unsigned getModuleSize(const unsigned module_id) const final;
 
@@ -58,6 +62,10 @@ private:
   std::unordered_multimap<unsigned, unsigned> module_to_wafers_;
   std::unordered_map<unsigned, unsigned> links_per_module_;
 
+  // precomputed mappings, for the trigger cells with valid cells and for the connected modules
+  HGCalTriggerMappingTable cells_from_trigger_cell_;
+  HGCalTriggerMappingTable trigger_cells_from_module_;
+
   // Disconnected modules and layers
   std::unordered_set<unsigned> disconnected_modules_;
   std::unordered_set<unsigned> disconnected_layers_;
@@ -69,6 +77,11 @@ private:
   unsigned totalLayers_ = 0;
 
   void fillMaps();
+  void fillTables();
+  geom_set cellsFromTriggerCell(const unsigned) const;
+  geom_set triggerCellsFromModule(const unsigned) const;
+  template <typename Cells>
+  GlobalPoint cellsBarycenter(unsigned det, const Cells& cell_ids) const;
   bool validCellId(unsigned det, unsigned cell_id) const;
   bool validTriggerCellFromCells(const unsigned) const;
 
@@ -96,6 +109,8 @@ HGCalTriggerGeometryV9Imp2::HGCalTriggerGeometryV9Imp2(const edm::ParameterSet&
 void HGCalTriggerGeometryV9Imp2::reset() {
   wafer_to_module_.clear();
   module_to_wafers_.clear();
+  cells_from_trigger_cell_ = HGCalTriggerMappingTable();
+  trigger_cells_from_module_ = HGCalTriggerMappingTable();
 }
 
 void HGCalTriggerGeometryV9Imp2::initialize(const CaloGeometry* calo_geometry) {
@@ -125,6 +140,7 @@ void HGCalTriggerGeometryV9Imp2::initialize(const HGCalGeometry* hgc_ee_geometry
   }
   last_trigger_layer_ = trigger_layer - 1;
   fillMaps();
+  fillTables();
 }
 
 unsigned HGCalTriggerGeometryV9Imp2::getTriggerCellFromCell(const unsigned cell_id) const {
@@ -206,6 +222,14 @@ unsigned HGCalTriggerGeometryV9Imp2::getModuleFromTriggerCell(const unsigned tri
 
 HGCalTriggerGeometryBase::geom_set HGCalTriggerGeometryV9Imp2::getCellsFromTriggerCell(
     const unsigned trigger_cell_id) const {
+  const auto cell_ids = cells_from_trigger_cell_.find(trigger_cell_id);
+  if (!cell_ids.empty())
+    return geom_set(cell_ids.begin(), cell_ids.end());
+  return cellsFromTriggerCell(trigger_cell_id);
+}
+
+HGCalTriggerGeometryBase::geom_set HGCalTriggerGeometryV9Imp2::cellsFromTriggerCell(
+    const unsigned trigger_cell_id) const {
   DetId trigger_cell_det_id(trigger_cell_id);
   unsigned det = trigger_cell_det_id.det();
   geom_set cell_det_ids;
@@ -247,6 +271,13 @@ HGCalTriggerGeometryBase::geom_set HGCalTriggerGeometryV9Imp2::getCellsFromTrigg
 
 HGCalTriggerGeometryBase::geom_set HGCalTriggerGeometryV9Imp2::getCellsFromModule(const unsigned module_id) const {
   geom_set cell_det_ids;
+  if (trigger_cells_from_module_.contains(module_id)) {
+    for (auto trigger_cell_id : trigger_cells_from_module_.find(module_id)) {
+      const auto cells = cells_from_trigger_cell_.find(trigger_cell_id);
+      cell_det_ids.insert(cells.begin(), cells.end());
+    }
+    return cell_det_ids;
+  }
   geom_set trigger_cells = getTriggerCellsFromModule(module_id);
   for (auto trigger_cell_id : trigger_cells) {
     geom_set cells = getCellsFromTriggerCell(trigger_cell_id);
@@ -268,6 +299,14 @@ HGCalTriggerGeometryBase::geom_ordered_set HGCalTriggerGeometryV9Imp2::getOrdere
 
 HGCalTriggerGeometryBase::geom_set HGCalTriggerGeometryV9Imp2::getTriggerCellsFromModule(
     const unsigned module_id) const {
+  if (trigger_cells_from_module_.contains(module_id)) {
+    const auto trigger_cell_ids = trigger_cells_from_module_.find(module_id);
+    return geom_set(trigger_cell_ids.begin(), trigger_cell_ids.end());
+  }
+  return triggerCellsFromModule(module_id);
+}
+
+HGCalTriggerGeometryBase::geom_set HGCalTriggerGeometryV9Imp2::triggerCellsFromModule(const unsigned module_id) const {
   DetId module_det_id(module_id);
   unsigned det = module_det_id.det();
   geom_set trigger_cell_det_ids;
@@ -378,6 +417,16 @@ HGCalTriggerGeometryBase::geom_set HGCalTriggerGeometryV9Imp2::getNeighborsFromT
   throw cms::Exception("FeatureNotImplemented") << "Neighbor search is not implemented in HGCalTriggerGeometryV9Imp2";
 }
 
+HGCalTriggerGeometryBase::geom_span HGCalTriggerGeometryV9Imp2::getCellsFromTriggerCellSpan(
+    const unsigned trigger_cell_id) const {
+  return cells_from_trigger_cell_.find(trigger_cell_id);
+}
+
+HGCalTriggerGeometryBase::geom_span HGCalTriggerGeometryV9Imp2::getTriggerCellsFromModuleSpan(
+    const unsigned module_id) const {
+  return trigger_cells_from_module_.find(module_id);
+}
+
 unsigned HGCalTriggerGeometryV9Imp2::getLinksInModule(const unsigned module_id) const {
   DetId module_det_id(module_id);
   unsigned links = 0;
@@ -418,47 +467,39 @@ unsigned HGCalTriggerGeometryV9Imp2::getModuleSize(const unsigned module_id) con
 GlobalPoint HGCalTriggerGeometryV9Imp2::getTriggerCellPosition(const unsigned trigger_cell_det_id) const {
   unsigned det = DetId(trigger_cell_det_id).det();
   // Position: barycenter of the trigger cell.
-  Basic3DVector<float> triggerCellVector(0., 0., 0.);
-  const auto cell_ids = getCellsFromTriggerCell(trigger_cell_det_id);
-  // Scintillator
-  if (det == DetId::HGCalHSc) {
-    for (const auto& cell : cell_ids) {
-      triggerCellVector += hscGeometry()->getPosition(cell).basicVector();
-    }
-  }
-  // Silicon
-  else {
-    for (const auto& cell : cell_ids) {
-      HGCSiliconDetId cellDetId(cell);
-      triggerCellVector += (cellDetId.det() == DetId::HGCalEE ? eeGeometry()->getPosition(cellDetId)
-                                                              : hsiGeometry()->getPosition(cellDetId))
-                               .basicVector();
-    }
-  }
-  return GlobalPoint(triggerCellVector / cell_ids.size());
+  // The cells are summed in the order of the table, the single-precision sum may differ in the
+  // last bits from that over the cells of getCellsFromTriggerCell.
+  const auto cell_ids = cells_from_trigger_cell_.find(trigger_cell_det_id);
+  if (!cell_ids.empty())
+    return cellsBarycenter(det, cell_ids);
+  return cellsBarycenter(det, cellsFromTriggerCell(trigger_cell_det_id));
 }
 
 GlobalPoint HGCalTriggerGeometryV9Imp2::getModulePosition(const unsigned module_det_id) const {
   unsigned det = DetId(module_det_id).det();
   // Position: barycenter of the module.
-  Basic3DVector<float> moduleVector(0., 0., 0.);
-  const auto cell_ids = getCellsFromModule(module_det_id);
+  return cellsBarycenter(det, getCellsFromModule(module_det_id));
+}
+
+template <typename Cells>
+GlobalPoint HGCalTriggerGeometryV9Imp2::cellsBarycenter(unsigned det, const Cells& cell_ids) const {
+  Basic3DVector<float> cellsVector(0., 0., 0.);
   // Scintillator
   if (det == DetId::HGCalHSc) {
     for (const auto& cell : cell_ids) {
-      moduleVector += hscGeometry()->getPosition(cell).basicVector();
+      cellsVector += hscGeometry()->getPosition(cell).basicVector();
     }
   }
   // Silicon
   else {
     for (const auto& cell : cell_ids) {
       HGCSiliconDetId cellDetId(cell);
-      moduleVector += (cellDetId.det() == DetId::HGCalEE ? eeGeometry()->getPosition(cellDetId)
-                                                         : hsiGeometry()->getPosition(cellDetId))
-                          .basicVector();
+      cellsVector += (cellDetId.det() == DetId::HGCalEE ? eeGeometry()->getPosition(cellDetId)
+                                                        : hsiGeometry()->getPosition(cellDetId))
+                         .basicVector();
     }
   }
-  return GlobalPoint(moduleVector / cell_ids.size());
+  return GlobalPoint(cellsVector / cell_ids.size());
 }
 
 void HGCalTriggerGeometryV9Imp2::fillMaps() {
@@ -500,6 +541,42 @@ void HGCalTriggerGeometryV9Imp2::fillMaps() {
   l1tLinksMappingStream.close();
 }
 
+void HGCalTriggerGeometryV9Imp2::fillTables() {
+  // trigger cells with at least one valid cell
+  geom_set trigger_cells;
+  for (const auto* geometry : {eeGeometry(), hsiGeometry(), hscGeometry()}) {
+    for (const auto& cell_id : geometry->getValidDetIds()) {
+      trigger_cells.emplace(getTriggerCellFromCell(cell_id));
+    }
+  }
+  HGCalTriggerMappingTable::Builder cells_builder;
+  for (auto trigger_cell_id : trigger_cells) {
+    cells_builder.add(trigger_cell_id, cellsFromTriggerCell(trigger_cell_id));
+  }
+  cells_from_trigger_cell_ = cells_builder.build();
+
+  // silicon modules of the module mapping, in both endcaps, and scintillator modules with valid trigger cells
+  geom_set modules;
+  for (const auto& module_wafer : module_to_wafers_) {
+    unsigned layer_module = module_wafer.first;
+    ForwardSubdetector subdet = (ForwardSubdetector)((layer_module >> DetId::kSubdetOffset) & DetId::kSubdetMask);
+    unsigned layer = (layer_module >> HGCalDetId::kHGCalLayerOffset) & HGCalDetId::kHGCalLayerMask;
+    unsigned module = (layer_module >> HGCalDetId::kHGCalWaferOffset) & HGCalDetId::kHGCalWaferMask;
+    for (int zside : {-1, 1}) {
+      modules.emplace(HGCalDetId(subdet, zside, layer, 1, module, HGCalDetId::kHGCalCellMask).rawId());
+    }
+  }
+  for (auto trigger_cell_id : trigger_cells) {
+    if (DetId(trigger_cell_id).det() == DetId::HGCalHSc)
+      modules.emplace(getModuleFromTriggerCell(trigger_cell_id));
+  }
+  HGCalTriggerMappingTable::Builder trigger_cells_builder;
+  for (auto module_id : modules) {
+    trigger_cells_builder.add(module_id, triggerCellsFromModule(module_id));
+  }
+  trigger_cells_from_module_ = trigger_cells_builder.build();
+}
+
 unsigned HGCalTriggerGeometryV9Imp2::packWaferId(int waferU, int waferV) const {
   unsigned packed_value = 0;
   unsigned waferUsign = (waferU >= 0) ? 0 : 1;
@@ -576,7 +653,9 @@ bool HGCalTriggerGeometryV9Imp2::validTriggerCellFromCells(const unsigned trigge
   // validity of the cells. One valid cell in the
   // trigger cell is enough to make the trigger cell
   // valid.
-  const geom_set cells = getCellsFromTriggerCell(trigger_cell_id);
+  if (cells_from_trigger_cell_.contains(trigger_cell_id))
+    return true;
+  const geom_set cells = cellsFromTriggerCell(trigger_cell_id);
   bool is_valid = false;
   for (const auto cell_id : cells) {
     unsigned det = DetId(cell_id).det();
@@ -5,6 +5,18 @@ HGCalTriggerGeometryBase::HGCalTriggerGeometryBase(const edm::ParameterSet& conf
 
 void HGCalTriggerGeometryBase::reset() {}
 
+HGCalTriggerGeometryBase::geom_span HGCalTriggerGeometryBase::getCellsFromTriggerCellSpan(const unsigned) const {
+  throw cms::Exception("FeatureNotImplemented") << "Trigger cell to cell spans are not available in " << name();
+}
+
+HGCalTriggerGeometryBase::geom_span HGCalTriggerGeometryBase::getTriggerCellsFromModuleSpan(const unsigned) const {
+  throw cms::Exception("FeatureNotImplemented") << "Module to trigger cell spans are not available in " << name();
+}
+
+HGCalTriggerGeometryBase::geom_span HGCalTriggerGeometryBase::getNeighborsFromTriggerCellSpan(const unsigned) const {
+  throw cms::Exception("FeatureNotImplemented") << "Trigger cell neighbor spans are not available in " << name();
+}
+
 #include "FWCore/Utilities/interface/typelookup.h"
 TYPELOOKUP_DATA_REG(HGCalTriggerGeometryBase);
 
@@ -0,0 +1,26 @@
+#include "L1Trigger/L1THGCal/interface/HGCalTriggerMappingTable.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <numeric>
+
+HGCalTriggerMappingTable HGCalTriggerMappingTable::Builder::build() const {
+  std::vector<unsigned> order(keys_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [this](unsigned i, unsigned j) { return keys_[i] < keys_[j]; });
+
+  HGCalTriggerMappingTable table;
+  table.keys_.reserve(keys_.size());
+  table.offsets_.reserve(keys_.size() + 1);
+  table.values_.reserve(values_.size());
+  for (unsigned i : order) {
+    if (!table.keys_.empty() && table.keys_.back() == keys_[i]) {
+      throw cms::Exception("BadGeometry") << "HGCalTriggerMappingTable: id " << keys_[i] << " is mapped twice";
+    }
+    table.keys_.push_back(keys_[i]);
+    auto first =
+        table.values_.insert(table.values_.end(), values_.begin() + offsets_[i], values_.begin() + offsets_[i + 1]);
+    std::sort(first, table.values_.end());
+    table.offsets_.push_back(table.values_.size());
+  }
+  return table;
+}
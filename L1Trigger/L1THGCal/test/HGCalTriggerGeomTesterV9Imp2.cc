@@ -1,6 +1,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <algorithm>
 
 #include "TTree.h"
 
@@ -51,6 +52,7 @@ private:
   void fillTriggerGeometry();
   bool checkMappingConsistency();
   bool checkNeighborConsistency();
+  GlobalPoint cellsBarycenter(const HGCalTriggerGeometryBase::geom_set& cells) const;
   void setTreeModuleSize(const size_t n);
   void setTreeModuleCellSize(const size_t n);
   void setTreeTriggerCellSize(const size_t n);
@@ -436,6 +438,14 @@ bool HGCalTriggerGeomTesterV9Imp2::checkMappingConsistency() {
       }
     }
 
+    // the positions are summed in the order of the precomputed cells, not in that of the sets
+    float max_tc_position_difference = 0.;
+    auto checkPosition = [](const GlobalPoint& position, const GlobalPoint& barycenter, float& max_difference) {
+      const float difference = (position - barycenter).mag();
+      max_difference = std::max(max_difference, difference);
+      return difference <= 1.e-5f * std::max(barycenter.mag(), 1.f);
+    };
+
     edm::LogPrint("TriggerCellCheck") << "Checking cell -> trigger cell -> cell consistency";
     // Loop over trigger cells
     for (const auto& triggercell_cells : triggercells_to_cells) {
@@ -481,7 +491,25 @@ bool HGCalTriggerGeomTesterV9Imp2::checkMappingConsistency() {
               << "HGCalTriggerGeometry: Found inconsistency in cell <-> trigger cell mapping";
         }
       }
+      // Check that the precomputed cells are the same
+      const auto cells_span = triggerGeometry_->getCellsFromTriggerCellSpan(id);
+      if (cells_span.size() != cells_geom.size() ||
+          std::any_of(cells_span.begin(), cells_span.end(), [&cells_geom](unsigned cell) {
+            return cells_geom.find(cell) == cells_geom.end();
+          })) {
+        throw cms::Exception("BadGeometry")
+            << "HGCalTriggerGeometry: Found inconsistency between the trigger cell -> cell set and span";
+      }
+      // Check that the position is the barycenter of the cells up to the rounding
+      const GlobalPoint position = triggerGeometry_->getTriggerCellPosition(id);
+      const GlobalPoint barycenter = cellsBarycenter(cells_geom);
+      if (!checkPosition(position, barycenter, max_tc_position_difference)) {
+        throw cms::Exception("BadGeometry") << "HGCalTriggerGeometry: Trigger cell " << id.rawId() << " at "
+                                            << position << " instead of the barycenter of its cells " << barycenter;
+      }
     }
+    edm::LogPrint("TriggerCellCheck") << "Largest difference between the trigger cell positions and the barycenters"
+                                      << " of their cells: " << max_tc_position_difference << " cm";
     edm::LogPrint("ModuleCheck") << "Checking trigger cell -> module -> trigger cell consistency";
     // Loop over modules
     for (const auto& module_triggercells : modules_to_triggercells) {
@@ -518,8 +546,18 @@ bool HGCalTriggerGeomTesterV9Imp2::checkMappingConsistency() {
           }
         }
       }
+      // Check that the precomputed trigger cells are the same
+      const auto triggercells_span = triggerGeometry_->getTriggerCellsFromModuleSpan(id);
+      if (triggercells_span.size() != triggercells_geom.size() ||
+          std::any_of(triggercells_span.begin(), triggercells_span.end(), [&triggercells_geom](unsigned cell) {
+            return triggercells_geom.find(cell) == triggercells_geom.end();
+          })) {
+        throw cms::Exception("BadGeometry")
+            << "HGCalTriggerGeometry: Found inconsistency between the module -> trigger cell set and span";
+      }
     }
     edm::LogPrint("ModuleCheck") << "Checking cell -> module -> cell consistency";
+    float max_module_position_difference = 0.;
     for (const auto& module_cells : modules_to_cells) {
       DetId id(module_cells.first);
       // Check consistency of cells included in module
@@ -544,7 +582,16 @@ bool HGCalTriggerGeomTesterV9Imp2::checkMappingConsistency() {
               << "HGCalTriggerGeometry: Found inconsistency in cell <->  module mapping";
         }
       }
+      // Check that the position is the barycenter of the cells up to the rounding
+      const GlobalPoint position = triggerGeometry_->getModulePosition(id);
+      const GlobalPoint barycenter = cellsBarycenter(cells_geom);
+      if (!checkPosition(position, barycenter, max_module_position_difference)) {
+        throw cms::Exception("BadGeometry") << "HGCalTriggerGeometry: Module " << id.rawId() << " at " << position
+                                            << " instead of the barycenter of its cells " << barycenter;
+      }
     }
+    edm::LogPrint("ModuleCheck") << "Largest difference between the module positions and the barycenters"
+                                 << " of their cells: " << max_module_position_difference << " cm";
   } catch (const cms::Exception& e) {
     edm::LogWarning("HGCalTriggerGeometryTester")
         << "Problem with the trigger geometry detected. Only the basic cells tree will be filled\n";
@@ -631,6 +678,23 @@ bool HGCalTriggerGeomTesterV9Imp2::checkNeighborConsistency() {
 }
 
 /*****************************************************************/
+// barycenter of the cells summed in the order of the set, as the trigger geometry did before
+// precomputing the mappings
+GlobalPoint HGCalTriggerGeomTesterV9Imp2::cellsBarycenter(const HGCalTriggerGeometryBase::geom_set& cells) const {
+  Basic3DVector<float> cellsVector(0., 0., 0.);
+  for (const auto& cell : cells) {
+    DetId id(cell);
+    if (id.det() == DetId::HGCalHSc) {
+      cellsVector += triggerGeometry_->hscGeometry()->getPosition(id).basicVector();
+    } else {
+      cellsVector += (id.det() == DetId::HGCalEE ? triggerGeometry_->eeGeometry()->getPosition(id)
+                                                 : triggerGeometry_->hsiGeometry()->getPosition(id))
+                         .basicVector();
+    }
+  }
+  return GlobalPoint(cellsVector / cells.size());
+}
+
 void HGCalTriggerGeomTesterV9Imp2::fillTriggerGeometry()
 /*****************************************************************/
 {
@@ -29,6 +29,13 @@ public:
   /// Field value ad specified global point, in Tesla
   virtual GlobalVector inTesla(const GlobalPoint& gp) const = 0;
 
+  /// Field values at the n global points gp, in Tesla. Engines override it
+  /// where evaluating several points at once is cheaper than one by one.
+  virtual void inTeslaBatch(const GlobalPoint* gp, GlobalVector* result, int n) const {
+    for (int i = 0; i < n; ++i)
+      result[i] = inTesla(gp[i]);
+  }
+
   /// Field value ad specified global point, in KGauss
   GlobalVector inKGauss(const GlobalPoint& gp) const { return inTesla(gp) * 10.F; }
 
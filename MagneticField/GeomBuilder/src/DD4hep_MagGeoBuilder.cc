@@ -19,6 +19,7 @@
 
 #include "MagneticField/Interpolation/interface/MagProviderInterpol.h"
 #include "MagneticField/Interpolation/interface/MFGridFactory.h"
+#include "MagneticField/Interpolation/interface/MFGridPack.h"
 #include "MagneticField/Interpolation/interface/MFGrid.h"
 
 #include "MagneticField/VolumeGeometry/interface/MagVolume6Faces.h"
@@ -47,7 +48,11 @@ using namespace edm;
 using namespace angle_units::operators;
 
 MagGeoBuilder::MagGeoBuilder(string tableSet, int geometryVersion, bool debug)
-    : tableSet_(tableSet), geometryVersion_(geometryVersion), theGridFiles_(nullptr), debug_(debug) {
+    : tableSet_(tableSet),
+      geometryVersion_(geometryVersion),
+      theGridFiles_(nullptr),
+      gridPackSearched_(false),
+      debug_(debug) {
   LogTrace("MagGeoBuilder") << "Constructing a MagGeoBuilder";
 }
 
@@ -428,6 +433,20 @@ void MagGeoBuilder::buildMagVolumes(const handles& volumes, map<string, MagProvi
   }
 }
 
+const std::shared_ptr<const MFGridPack>& MagGeoBuilder::gridPack() {
+  if (!gridPackSearched_) {
+    gridPackSearched_ = true;
+    try {
+      edm::FileInPath pack("MagneticField/Interpolation/data/" + tableSet_ + "/grids.pack");
+      theGridPack_ = MFGridPack::open(pack.fullPath());
+      LogTrace("MagGeoBuilder") << "Reading the grid files from " << pack.fullPath();
+    } catch (edm::Exception&) {
+      // no pack for this table set, the grid files are read one by one
+    }
+  }
+  return theGridPack_;
+}
+
 void MagGeoBuilder::buildInterpolator(const volumeHandle* vol, map<string, MagProviderInterpol*>& interpolators) {
   // Phi of the master sector
   double masterSectorPhi = (vol->masterSector - 1) * 1._pi / 6.;
@@ -450,14 +469,16 @@ void MagGeoBuilder::buildInterpolator(const volumeHandle* vol, map<string, MagPr
 
   string fullPath;
 
-  try {
-    edm::FileInPath mydata("MagneticField/Interpolation/data/" + tableSet_ + "/" + vol->magFile);
-    fullPath = mydata.fullPath();
-  } catch (edm::Exception& exc) {
-    cerr << "MagGeoBuilder: exception in reading table; " << exc.what() << endl;
-    if (!debug_)
-      throw;
-    return;
+  if (!gridPack()) {
+    try {
+      edm::FileInPath mydata("MagneticField/Interpolation/data/" + tableSet_ + "/" + vol->magFile);
+      fullPath = mydata.fullPath();
+    } catch (edm::Exception& exc) {
+      cerr << "MagGeoBuilder: exception in reading table; " << exc.what() << endl;
+      if (!debug_)
+        throw;
+      return;
+    }
   }
 
   try {
@@ -481,7 +502,11 @@ void MagGeoBuilder::buildInterpolator(const volumeHandle* vol, map<string, MagPr
                                        vol->placement()->rotation() * rot);
       }
 
-      interpolators[vol->magFile] = MFGridFactory::build(fullPath, rf);
+      if (gridPack()) {
+        interpolators[vol->magFile] = MFGridFactory::build(gridPack(), vol->magFile, rf);
+      } else {
+        interpolators[vol->magFile] = MFGridFactory::build(fullPath, rf);
+      }
     }
   } catch (MagException& exc) {
     LogTrace("MagGeoBuilder") << exc.what();
@@ -29,6 +29,7 @@ class Surface;
 class MagBLayer;
 class MagESector;
 class MagVolume6Faces;
+class MFGridPack;
 
 namespace magneticfield {
 
@@ -65,6 +66,9 @@ namespace magneticfield {
     // Build interpolator for the volume with "correct" rotation
     void buildInterpolator(const volumeHandle* vol, std::map<std::string, MagProviderInterpol*>& interpolators);
 
+    // The packed grid files of tableSet_, null if there are none
+    const std::shared_ptr<const MFGridPack>& gridPack();
+
     // Build all MagVolumes setting the MagProviderInterpol
     void buildMagVolumes(const handles& volumes, std::map<std::string, MagProviderInterpol*>& interpolators);
 
@@ -86,6 +90,9 @@ namespace magneticfield {
     std::map<int, double> theScalingFactors_;
     const TableFileMap* theGridFiles_;  // Non-owned pointer assumed to be valid until build() is called
 
+    std::shared_ptr<const MFGridPack> theGridPack_;
+    bool gridPackSearched_;
+
     const bool debug_;
   };
 }  // namespace magneticfield
@@ -27,6 +27,7 @@
 
 #include "MagneticField/Interpolation/interface/MagProviderInterpol.h"
 #include "MagneticField/Interpolation/interface/MFGridFactory.h"
+#include "MagneticField/Interpolation/interface/MFGridPack.h"
 #include "MagneticField/Interpolation/interface/MFGrid.h"
 
 #include "MagneticField/VolumeGeometry/interface/MagVolume6Faces.h"
@@ -55,7 +56,11 @@ using namespace std;
 using namespace magneticfield;
 
 MagGeoBuilderFromDDD::MagGeoBuilderFromDDD(string tableSet_, int geometryVersion_, bool debug_)
-    : tableSet(tableSet_), geometryVersion(geometryVersion_), theGridFiles(nullptr), debug(debug_) {
+    : tableSet(tableSet_),
+      geometryVersion(geometryVersion_),
+      theGridFiles(nullptr),
+      gridPackSearched(false),
+      debug(debug_) {
   if (debug)
     cout << "Constructing a MagGeoBuilderFromDDD" << endl;
 }
@@ -499,6 +504,21 @@ void MagGeoBuilderFromDDD::buildMagVolumes(const handles& volumes, map<string, M
   }
 }
 
+const std::shared_ptr<const MFGridPack>& MagGeoBuilderFromDDD::gridPack() {
+  if (!gridPackSearched) {
+    gridPackSearched = true;
+    try {
+      edm::FileInPath pack("MagneticField/Interpolation/data/" + tableSet + "/grids.pack");
+      theGridPack = MFGridPack::open(pack.fullPath());
+      if (debug)
+        cout << "Reading the grid files from " << pack.fullPath() << endl;
+    } catch (edm::Exception&) {
+      // no pack for this table set, the grid files are read one by one
+    }
+  }
+  return theGridPack;
+}
+
 void MagGeoBuilderFromDDD::buildInterpolator(const volumeHandle* vol,
                                              map<string, MagProviderInterpol*>& interpolators) {
   // Phi of the master sector
@@ -520,14 +540,16 @@ void MagGeoBuilderFromDDD::buildInterpolator(const volumeHandle* vol,
 
   string fullPath;
 
-  try {
-    edm::FileInPath mydata("MagneticField/Interpolation/data/" + tableSet + "/" + vol->magFile);
-    fullPath = mydata.fullPath();
-  } catch (edm::Exception& exc) {
-    cerr << "MagGeoBuilderFromDDD: exception in reading table; " << exc.what() << endl;
-    if (!debug)
-      throw;
-    return;
+  if (!gridPack()) {
+    try {
+      edm::FileInPath mydata("MagneticField/Interpolation/data/" + tableSet + "/" + vol->magFile);
+      fullPath = mydata.fullPath();
+    } catch (edm::Exception& exc) {
+      cerr << "MagGeoBuilderFromDDD: exception in reading table; " << exc.what() << endl;
+      if (!debug)
+        throw;
+      return;
+    }
   }
 
   try {
@@ -551,7 +573,11 @@ void MagGeoBuilderFromDDD::buildInterpolator(const volumeHandle* vol,
                                        vol->placement()->rotation() * rot);
       }
 
-      interpolators[vol->magFile] = MFGridFactory::build(fullPath, rf);
+      if (gridPack()) {
+        interpolators[vol->magFile] = MFGridFactory::build(gridPack(), vol->magFile, rf);
+      } else {
+        interpolators[vol->magFile] = MFGridFactory::build(fullPath, rf);
+      }
     }
   } catch (MagException& exc) {
     cout << exc.what() << endl;
@@ -19,6 +19,7 @@
 #include <memory>
 
 class Surface;
+class MFGridPack;
 class MagBLayer;
 class MagESector;
 class MagVolume6Faces;
@@ -74,6 +75,9 @@ private:
   // Build interpolator for the volume with "correct" rotation
   void buildInterpolator(const volumeHandle* vol, std::map<std::string, MagProviderInterpol*>& interpolators);
 
+  // The packed grid files of tableSet, null if there are none
+  const std::shared_ptr<const MFGridPack>& gridPack();
+
   // Build all MagVolumes setting the MagProviderInterpol
   void buildMagVolumes(const magneticfield::handles& volumes,
                        std::map<std::string, MagProviderInterpol*>& interpolators);
@@ -96,6 +100,9 @@ private:
   std::map<int, double> theScalingFactors;
   const magneticfield::TableFileMap* theGridFiles;  // Non-owned pointer assumed to be valid until build() is called
 
+  std::shared_ptr<const MFGridPack> theGridPack;
+  bool gridPackSearched;
+
   const bool debug;
 };
 #endif
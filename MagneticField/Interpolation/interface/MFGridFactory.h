@@ -8,8 +8,10 @@
  *  \author T. Todorov
  */
 
+#include <memory>
 #include <string>
 class MFGrid;
+class MFGridPack;
 template <class T>
 class GloballyPositioned;
 
@@ -18,6 +20,11 @@ public:
   /// Build interpolator for a binary grid file
   static MFGrid* build(const std::string& name, const GloballyPositioned<float>& vol);
 
+  /// Build interpolator for a grid file of a pack; its field values are used in place
+  static MFGrid* build(std::shared_ptr<const MFGridPack> pack,
+                       const std::string& name,
+                       const GloballyPositioned<float>& vol);
+
   /// Build a 2pi phi-symmetric interpolator for a binary grid file
   static MFGrid* build(const std::string& name, const GloballyPositioned<float>& vol, double phiMin, double phiMax);
 };
@@ -0,0 +1,53 @@
+#ifndef MFGridPack_h
+#define MFGridPack_h
+
+/** \class MFGridPack
+ *
+ *  A set of binary grid files packed in a single file, which is memory mapped
+ *  read-only: the field values of the grids built from it are used in place, so
+ *  that all the jobs running on a node share a single copy of the field map.
+ *
+ *  The grid files are looked up with their path relative to the table set directory,
+ *  as in the "gridFiles" configuration of the field builders. The pack is written
+ *  by packGridFiles, from the same files.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class MFGridPack {
+public:
+  /// Maps the pack file; throws MagGeometryError if it is not a valid pack.
+  explicit MFGridPack(const std::string& fileName);
+  ~MFGridPack();
+
+  MFGridPack(const MFGridPack&) = delete;
+  MFGridPack& operator=(const MFGridPack&) = delete;
+
+  /// The pack of the given file, mapped only once per process.
+  static std::shared_ptr<const MFGridPack> open(const std::string& fileName);
+
+  /// Content of the grid file name, nullptr if it is not in the pack.
+  const char* find(const std::string& name, size_t& size) const;
+
+  const std::string& fileName() const { return fileName_; }
+
+  /// Packs the grid files, given by their path relative to directory.
+  static void write(const std::string& fileName, const std::string& directory, const std::vector<std::string>& names);
+
+private:
+  struct Entry {
+    size_t offset;
+    size_t size;
+  };
+
+  std::string fileName_;
+  const char* data_;
+  size_t size_;
+  std::unordered_map<std::string, Entry> entries_;
+};
+
+#endif
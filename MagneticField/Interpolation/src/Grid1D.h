@@ -2,6 +2,7 @@
 #define Grid1D_H
 #include <cmath>
 #include <algorithm>
+#include <cstdlib>
 #include "FWCore/Utilities/interface/Visibility.h"
 
 class dso_internal Grid1D {
@@ -43,6 +44,16 @@ public:
     }
   }
 
+  // same as index(a, f) followed by normalize(ind, f), but inlined and branch-free
+  // so that loops over many values can be vectorized
+  int normalizedIndex(Scalar a, Scalar& f) const {
+    Scalar x = (a - lower()) * stepinv_;
+    int ind = static_cast<int>(x);  // truncates like modff
+    int inRange = std::max(0, std::min(edges_, ind));
+    f = x - static_cast<Scalar>(ind) + static_cast<Scalar>(std::abs(ind - inRange));
+    return inRange;
+  }
+
   Scalar closestNode(Scalar a) const {
     Scalar b = (a - lower()) / step();
     Scalar c = floor(b);
@@ -11,6 +11,7 @@
 #include "DataFormats/GeometryVector/interface/Basic3DVector.h"
 // #include "DataFormats/Math/interface/SIMDVec.h"
 #include "Grid1D.h"
+#include <memory>
 #include <vector>
 #include "FWCore/Utilities/interface/Visibility.h"
 
@@ -36,15 +37,30 @@ public:
   //using BVector =  ValueType;
   using Container = std::vector<BVector>;
 
+  /// Field values, kept alive by owner: either a Container or a read-only file mapping.
+  struct Values {
+    const BVector* data = nullptr;
+    std::shared_ptr<const void> owner;
+  };
+
   Grid3D() {}
 
   Grid3D(const Grid1D& ga, const Grid1D& gb, const Grid1D& gc, std::vector<BVector>& data)
-      : grida_(ga), gridb_(gb), gridc_(gc) {
-    data_.swap(data);
+      : Grid3D(ga, gb, gc, own(data)) {}
+
+  Grid3D(const Grid1D& ga, const Grid1D& gb, const Grid1D& gc, Values values)
+      : grida_(ga), gridb_(gb), gridc_(gc), data_(values.data), owner_(std::move(values.owner)) {
     stride1_ = gridb_.nodes() * gridc_.nodes();
     stride2_ = gridc_.nodes();
   }
 
+  /// Takes over the content of data
+  static Values own(std::vector<BVector>& data) {
+    auto container = std::make_shared<Container>();
+    container->swap(data);
+    return Values{container->data(), container};
+  }
+
   //  Grid3D( const Grid1D& ga, const Grid1D& gb, const Grid1D& gc,
   //	  std::vector<ValueType> const & data);
 
@@ -60,7 +76,8 @@ public:
   const Grid1D& gridb() const { return gridb_; }
   const Grid1D& gridc() const { return gridc_; }
 
-  const Container& data() const { return data_; }
+  const BVector* data() const { return data_; }
+  int size() const { return grida_.nodes() * gridb_.nodes() * gridc_.nodes(); }
 
   void dump() const;
 
@@ -69,7 +86,9 @@ private:
   Grid1D gridb_;
   Grid1D gridc_;
 
-  Container data_;
+  // shared between copies, never modified
+  const BVector* data_ = nullptr;
+  std::shared_ptr<const void> owner_;
 
   int stride1_;
   int stride2_;
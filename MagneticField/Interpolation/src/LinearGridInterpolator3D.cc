@@ -3,6 +3,8 @@
 #include "Grid3D.h"
 #include "MagneticField/VolumeGeometry/interface/MagExceptions.h"
 
+#include <algorithm>
+
 void LinearGridInterpolator3D::throwGridInterpolator3DException(void) {
   throw GridInterpolator3DException(
       grida.lower(), gridb.lower(), gridc.lower(), grida.upper(), gridb.upper(), gridc.upper());
@@ -115,3 +117,61 @@ LinearGridInterpolator3D::ValueType LinearGridInterpolator3D::interpolate(Scalar
 
   return result;
 }
+
+void LinearGridInterpolator3D::interpolate(
+    const Scalar* a, const Scalar* b, const Scalar* c, ReturnType* result, int n) {
+  const int s1 = grid.stride1();
+  const int s2 = grid.stride2();
+  const int s3 = grid.stride3();
+  // the 8 corners of a cell, in the order of the scalar interpolation
+  const int offset[8] = {0, s3, s2, s2 + s3, s1, s1 + s3, s1 + s2, s1 + s2 + s3};
+  const Grid3D::BVector* values = grid.data();
+
+  for (int first = 0; first < n; first += chunkSize) {
+    const int m = std::min(chunkSize, n - first);
+    int ind[chunkSize];
+    Scalar s[chunkSize], t[chunkSize], u[chunkSize];
+    for (int l = 0; l < m; ++l) {
+      int i = grida.normalizedIndex(a[first + l], s[l]);
+      int j = gridb.normalizedIndex(b[first + l], t[l]);
+      int k = gridc.normalizedIndex(c[first + l], u[l]);
+      ind[l] = grid.index(i, j, k);
+    }
+
+    // gather the corners as structure of arrays
+    Scalar corner[8][3][chunkSize];
+    for (int l = 0; l < m; ++l) {
+      for (int v = 0; v < 8; ++v) {
+        const Grid3D::BVector& value = values[ind[l] + offset[v]];
+        corner[v][0][l] = value[0];
+        corner[v][1][l] = value[1];
+        corner[v][2][l] = value[2];
+      }
+    }
+
+    // same arithmetic as the scalar interpolation, one component at a time
+    Scalar out[3][chunkSize];
+    for (int x = 0; x < 3; ++x) {
+      const Scalar* g0 = corner[0][x];
+      const Scalar* g1 = corner[1][x];
+      const Scalar* g2 = corner[2][x];
+      const Scalar* g3 = corner[3][x];
+      const Scalar* g4 = corner[4][x];
+      const Scalar* g5 = corner[5][x];
+      const Scalar* g6 = corner[6][x];
+      const Scalar* g7 = corner[7][x];
+      for (int l = 0; l < m; ++l) {
+        Scalar r = ((1.f - s[l]) * (1.f - t[l]) * u[l]) * (g1[l] - g0[l]);
+        r = r + ((1.f - s[l]) * t[l] * u[l]) * (g3[l] - g2[l]);
+        r = r + (s[l] * (1.f - t[l]) * u[l]) * (g5[l] - g4[l]);
+        r = r + (s[l] * t[l] * u[l]) * (g7[l] - g6[l]);
+        r = r + ((1.f - s[l]) * t[l]) * (g2[l] - g0[l]);
+        r = r + (s[l] * t[l]) * (g6[l] - g4[l]);
+        r = r + (s[l]) * (g4[l] - g0[l]);
+        out[x][l] = r + g0[l];
+      }
+    }
+    for (int l = 0; l < m; ++l)
+      result[first + l] = ReturnType(out[0][l], out[1][l], out[2][l]);
+  }
+}
@@ -30,6 +30,12 @@ public:
   void throwGridInterpolator3DException(void);
 
   ReturnType interpolate(Scalar a, Scalar b, Scalar c);
+
+  /// Interpolates at the n points (a[i], b[i], c[i]); the points are processed
+  /// in vectorized loops, chunkSize at a time.
+  void interpolate(const Scalar* a, const Scalar* b, const Scalar* c, ReturnType* result, int n);
+
+  static constexpr int chunkSize = 16;
   //  Value operator()( Scalar a, Scalar b, Scalar c) {return interpolate(a,b,c);}
 
 private:
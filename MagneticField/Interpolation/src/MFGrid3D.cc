@@ -1,7 +1,14 @@
 #include "MFGrid3D.h"
+#include "LinearGridInterpolator3D.h"
+#include "binary_ifstream.h"
 #include "MagneticField/VolumeGeometry/interface/MagVolumeOutsideValidity.h"
 #include "MagneticField/VolumeGeometry/interface/MagExceptions.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
 MFGrid::LocalVector MFGrid3D::valueInTesla(const LocalPoint& p) const {
   try {
     return uncheckedValueInTesla(p);
@@ -12,3 +19,46 @@ MFGrid::LocalVector MFGrid3D::valueInTesla(const LocalPoint& p) const {
     throw MagVolumeOutsideValidity(lower, upper);
   }
 }
+
+void MFGrid3D::valuesInTesla(const LocalPoint* p, LocalVector* values, int n) const {
+  constexpr int chunk = LinearGridInterpolator3D::chunkSize;
+  GridType::Scalar a[chunk], b[chunk], c[chunk];
+  GridType::ReturnType result[chunk];
+  LinearGridInterpolator3D interpol(grid_);
+  for (int first = 0; first < n; first += chunk) {
+    int m = std::min(chunk, n - first);
+    for (int i = 0; i < m; ++i) {
+      double ga, gb, gc;
+      toGridFrame(p[first + i], ga, gb, gc);
+      a[i] = ga;
+      b[i] = gb;
+      c[i] = gc;
+    }
+    interpol.interpolate(a, b, c, result, m);
+    for (int i = 0; i < m; ++i)
+      values[first + i] = LocalVector(result[i]);
+  }
+}
+
+Grid3D::Values MFGrid3D::readValues(binary_ifstream& inFile, int n) {
+  // the files are written as native floats, which can be used in place if they are aligned
+  static_assert(sizeof(BVector) == 3 * sizeof(float), "BVector must have the layout of the grid files");
+  const char* mapped = inFile.mapped(n * sizeof(BVector));
+  if (mapped != nullptr) {
+    if (reinterpret_cast<std::uintptr_t>(mapped) % alignof(BVector) == 0)
+      return GridType::Values{reinterpret_cast<const BVector*>(mapped), inFile.owner()};
+    // only for a badly packed file
+    std::vector<BVector> fieldValues(n);
+    memcpy(fieldValues.data(), mapped, n * sizeof(BVector));
+    return GridType::own(fieldValues);
+  }
+
+  std::vector<BVector> fieldValues;
+  float Bx, By, Bz;
+  fieldValues.reserve(n);
+  for (int iLine = 0; iLine < n; ++iLine) {
+    inFile >> Bx >> By >> Bz;
+    fieldValues.push_back(BVector(Bx, By, Bz));
+  }
+  return GridType::own(fieldValues);
+}
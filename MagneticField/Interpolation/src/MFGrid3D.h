@@ -14,6 +14,8 @@
 #include "Grid3D.h"
 #include "FWCore/Utilities/interface/Visibility.h"
 
+class binary_ifstream;
+
 class dso_internal MFGrid3D : public MFGrid {
 public:
   explicit MFGrid3D(const GloballyPositioned<float>& vol) : MFGrid(vol) {}
@@ -49,6 +51,11 @@ public:
 
   LocalVector valueInTesla(const LocalPoint& p) const override;
 
+  /// Interpolated field values at n points, interpolated in batches.
+  /// Valid as is for the grids whose uncheckedValueInTesla is the interpolation at the
+  /// toGridFrame coordinates of the point; the other ones must override it.
+  void valuesInTesla(const LocalPoint* p, LocalVector* values, int n) const override;
+
   /// Interpolated field value at given point; does not check for exceptions
   virtual LocalVector uncheckedValueInTesla(const LocalPoint& p) const = 0;
 
@@ -59,6 +66,9 @@ protected:
   GridType grid_;  // should become private...
 
   void setGrid(const GridType& grid) { grid_ = grid; }
+
+  /// Reads n field values, which stay in place if the input is memory mapped.
+  static GridType::Values readValues(binary_ifstream& inFile, int n);
 };
 
 #endif
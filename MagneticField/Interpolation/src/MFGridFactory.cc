@@ -1,4 +1,6 @@
 #include "MagneticField/Interpolation/interface/MFGridFactory.h"
+#include "MagneticField/Interpolation/interface/MFGridPack.h"
+#include "MagneticField/VolumeGeometry/interface/MagExceptions.h"
 #include "binary_ifstream.h"
 #include "DataFormats/GeometrySurface/interface/GloballyPositioned.h"
 
@@ -13,37 +15,58 @@
 
 using namespace std;
 
+namespace {
+  MFGrid* buildFromStream(binary_ifstream& inFile, const GloballyPositioned<float>& vol) {
+    int gridType;
+    inFile >> gridType;
+
+    MFGrid* result;
+    switch (gridType) {
+      case 1:
+        result = new RectangularCartesianMFGrid(inFile, vol);
+        break;
+      case 2:
+        result = new TrapezoidalCartesianMFGrid(inFile, vol);
+        break;
+      case 3:
+        result = new RectangularCylindricalMFGrid(inFile, vol);
+        break;
+      case 4:
+        result = new TrapezoidalCylindricalMFGrid(inFile, vol);
+        break;
+      case 5:
+        result = new SpecialCylindricalMFGrid(inFile, vol, gridType);
+        break;
+      case 6:
+        result = new SpecialCylindricalMFGrid(inFile, vol, gridType);
+        break;
+      default:
+        cout << "ERROR Grid type unknown: " << gridType << endl;
+        //    result = new GlobalGridWrapper(vol, name);
+        result = nullptr;
+        break;
+    }
+    return result;
+  }
+}  // namespace
+
 MFGrid* MFGridFactory::build(const string& name, const GloballyPositioned<float>& vol) {
   binary_ifstream inFile(name);
-  int gridType;
-  inFile >> gridType;
-
-  MFGrid* result;
-  switch (gridType) {
-    case 1:
-      result = new RectangularCartesianMFGrid(inFile, vol);
-      break;
-    case 2:
-      result = new TrapezoidalCartesianMFGrid(inFile, vol);
-      break;
-    case 3:
-      result = new RectangularCylindricalMFGrid(inFile, vol);
-      break;
-    case 4:
-      result = new TrapezoidalCylindricalMFGrid(inFile, vol);
-      break;
-    case 5:
-      result = new SpecialCylindricalMFGrid(inFile, vol, gridType);
-      break;
-    case 6:
-      result = new SpecialCylindricalMFGrid(inFile, vol, gridType);
-      break;
-    default:
-      cout << "ERROR Grid type unknown: " << gridType << endl;
-      //    result = new GlobalGridWrapper(vol, name);
-      result = nullptr;
-      break;
+  MFGrid* result = buildFromStream(inFile, vol);
+  inFile.close();
+  return result;
+}
+
+MFGrid* MFGridFactory::build(std::shared_ptr<const MFGridPack> pack,
+                             const string& name,
+                             const GloballyPositioned<float>& vol) {
+  size_t size;
+  const char* data = pack->find(name, size);
+  if (data == nullptr) {
+    throw MagGeometryError((name + " not found in " + pack->fileName()).c_str());
   }
+  binary_ifstream inFile(data, size, std::move(pack));
+  MFGrid* result = buildFromStream(inFile, vol);
   inFile.close();
   return result;
 }
@@ -0,0 +1,189 @@
+#include "MagneticField/Interpolation/interface/MFGridPack.h"
+#include "MagneticField/VolumeGeometry/interface/MagExceptions.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// File layout, in the native byte order as the grid files themselves:
+//
+//   magic, version, number of files,
+//   for each file: length of the name, name, offset, size (64 bit),
+//   then the content of the files, at the offsets given.
+//
+// The offsets are chosen so that the field values of each grid start on a
+// cache line, and can be used in place.
+
+namespace {
+  const char kMagic[8] = {'M', 'F', 'G', 'R', 'I', 'D', 'P', 'K'};
+  constexpr std::uint32_t kVersion = 1;
+  constexpr size_t kAlignment = 64;
+
+  [[noreturn]] void throwError(const std::string& fileName, const std::string& what) {
+    throw MagGeometryError(("MFGridPack " + fileName + ": " + what).c_str());
+  }
+
+  // Offset of the field values in a grid file, from the header read by each grid type
+  size_t valuesOffset(const std::string& content) {
+    const size_t common = sizeof(int) * 4 + sizeof(double) * 6;  // type, nodes, reference point, steps
+    int gridType = 0;
+    if (content.size() >= sizeof(gridType))
+      memcpy(&gridType, content.data(), sizeof(gridType));
+    switch (gridType) {
+      case 1:
+      case 3:
+        return common;
+      case 2:
+      case 4:
+        return common + sizeof(double) * 18 + 3;  // basic distances, "easy" flags
+      case 5:
+      case 6:
+        return common + sizeof(double) * 4;  // R as a function of phi
+      default:
+        return 0;
+    }
+  }
+
+  template <typename T>
+  void append(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  class Reader {
+  public:
+    Reader(const std::string& fileName, const char* data, size_t size)
+        : fileName_(fileName), data_(data), size_(size), pos_(0) {}
+
+    template <typename T>
+    T read() {
+      T value;
+      memcpy(&value, bytes(sizeof(value)), sizeof(value));
+      return value;
+    }
+
+    const char* bytes(size_t n) {
+      if (n > size_ - pos_)
+        throwError(fileName_, "unexpected end of the index");
+      const char* result = data_ + pos_;
+      pos_ += n;
+      return result;
+    }
+
+  private:
+    const std::string& fileName_;
+    const char* data_;
+    size_t size_;
+    size_t pos_;
+  };
+}  // namespace
+
+MFGridPack::MFGridPack(const std::string& fileName) : fileName_(fileName), data_(nullptr), size_(0) {
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+    throwError(fileName, "cannot be opened for reading");
+  struct stat st;
+  if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+    void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr != MAP_FAILED) {
+      data_ = static_cast<const char*>(addr);
+      size_ = st.st_size;
+    }
+  }
+  ::close(fd);
+  if (data_ == nullptr)
+    throwError(fileName, "cannot be mapped");
+
+  try {
+    Reader reader(fileName_, data_, size_);
+    if (memcmp(reader.bytes(sizeof(kMagic)), kMagic, sizeof(kMagic)) != 0)
+      throwError(fileName_, "not a grid pack");
+    if (reader.read<std::uint32_t>() != kVersion)
+      throwError(fileName_, "unsupported version");
+    for (std::uint32_t n = reader.read<std::uint32_t>(); n != 0; --n) {
+      std::uint32_t length = reader.read<std::uint32_t>();
+      std::string name(reader.bytes(length), length);
+      Entry entry;
+      entry.offset = reader.read<std::uint64_t>();
+      entry.size = reader.read<std::uint64_t>();
+      if (entry.offset > size_ || entry.size > size_ - entry.offset)
+        throwError(fileName_, "file " + name + " beyond the end of the pack");
+      entries_[name] = entry;
+    }
+  } catch (...) {
+    ::munmap(const_cast<char*>(data_), size_);
+    throw;
+  }
+}
+
+MFGridPack::~MFGridPack() { ::munmap(const_cast<char*>(data_), size_); }
+
+std::shared_ptr<const MFGridPack> MFGridPack::open(const std::string& fileName) {
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<const MFGridPack>> packs;
+
+  std::lock_guard<std::mutex> guard(mutex);
+  std::shared_ptr<const MFGridPack> pack = packs[fileName].lock();
+  if (!pack) {
+    pack = std::make_shared<const MFGridPack>(fileName);
+    packs[fileName] = pack;
+  }
+  return pack;
+}
+
+const char* MFGridPack::find(const std::string& name, size_t& size) const {
+  auto entry = entries_.find(name);
+  if (entry == entries_.end())
+    return nullptr;
+  size = entry->second.size;
+  return data_ + entry->second.offset;
+}
+
+void MFGridPack::write(const std::string& fileName,
+                       const std::string& directory,
+                       const std::vector<std::string>& names) {
+  std::vector<std::string> contents;
+  for (const auto& name : names) {
+    std::ifstream in(directory + "/" + name, std::ios::binary);
+    if (!in)
+      throwError(fileName, "cannot read " + directory + "/" + name);
+    contents.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  }
+
+  size_t indexSize = sizeof(kMagic) + 2 * sizeof(std::uint32_t);
+  for (const auto& name : names)
+    indexSize += sizeof(std::uint32_t) + name.size() + 2 * sizeof(std::uint64_t);
+
+  std::string index(kMagic, sizeof(kMagic));
+  append<std::uint32_t>(index, kVersion);
+  append<std::uint32_t>(index, names.size());
+  std::vector<size_t> offsets;
+  size_t offset = indexSize;
+  for (size_t i = 0; i < names.size(); ++i) {
+    // pad so that offset + valuesOffset is a multiple of kAlignment
+    offset += (kAlignment - (offset + valuesOffset(contents[i])) % kAlignment) % kAlignment;
+    offsets.push_back(offset);
+    append<std::uint32_t>(index, names[i].size());
+    index += names[i];
+    append<std::uint64_t>(index, offset);
+    append<std::uint64_t>(index, contents[i].size());
+    offset += contents[i].size();
+  }
+
+  std::ofstream out(fileName, std::ios::binary);
+  out.write(index.data(), index.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    std::string padding(offsets[i] - static_cast<size_t>(out.tellp()), '\0');
+    out.write(padding.data(), padding.size());
+    out.write(contents[i].data(), contents[i].size());
+  }
+  if (!out)
+    throwError(fileName, "cannot be written");
+}
@@ -30,14 +30,7 @@ RectangularCartesianMFGrid::RectangularCartesianMFGrid(binary_ifstream& inFile,
   double stepx, stepy, stepz;
   inFile >> stepx >> stepy >> stepz;
 
-  vector<BVector> fieldValues;
-  float Bx, By, Bz;
-  int nLines = n1 * n2 * n3;
-  fieldValues.reserve(nLines);
-  for (int iLine = 0; iLine < nLines; ++iLine) {
-    inFile >> Bx >> By >> Bz;
-    fieldValues.push_back(BVector(Bx, By, Bz));
-  }
+  GridType::Values fieldValues = readValues(inFile, n1 * n2 * n3);
   // check completeness
   string lastEntry;
   inFile >> lastEntry;
@@ -75,7 +68,7 @@ void RectangularCartesianMFGrid::dump() const {
   cout << "Basic Distance from Grid1D " << grid_.grida().step() << " " << grid_.gridb().step() << " "
        << grid_.gridc().step() << endl;
 
-  cout << "Dumping " << grid_.data().size() << " field values " << endl;
+  cout << "Dumping " << grid_.size() << " field values " << endl;
   // grid_.dump();
 }
 
@@ -30,14 +30,7 @@ RectangularCylindricalMFGrid::RectangularCylindricalMFGrid(binary_ifstream& inFi
   double stepx, stepy, stepz;
   inFile >> stepx >> stepy >> stepz;
 
-  vector<BVector> fieldValues;
-  float Bx, By, Bz;
-  int nLines = n1 * n2 * n3;
-  fieldValues.reserve(nLines);
-  for (int iLine = 0; iLine < nLines; ++iLine) {
-    inFile >> Bx >> By >> Bz;
-    fieldValues.push_back(BVector(Bx, By, Bz));
-  }
+  GridType::Values fieldValues = readValues(inFile, n1 * n2 * n3);
   // check completeness
   string lastEntry;
   inFile >> lastEntry;
@@ -74,7 +67,7 @@ void RectangularCylindricalMFGrid::dump() const {
   cout << "Basic Distance from Grid1D " << grid_.grida().step() << " " << grid_.gridb().step() << " "
        << grid_.gridc().step() << endl;
 
-  cout << "Dumping " << grid_.data().size() << " field values " << endl;
+  cout << "Dumping " << grid_.size() << " field values " << endl;
   // grid_.dump();
 }
 
@@ -97,6 +90,16 @@ MFGrid::LocalVector RectangularCylindricalMFGrid::uncheckedValueInTesla(const Lo
   return LocalVector(value);
 }
 
+void RectangularCylindricalMFGrid::valuesInTesla(const LocalPoint* p, LocalVector* values, int n) const {
+  MFGrid3D::valuesInTesla(p, values, n);
+  // points on the axis are treated as in uncheckedValueInTesla
+  const float minimalSignificantR = 1e-6;
+  for (int i = 0; i < n; ++i) {
+    if (p[i].perp() < minimalSignificantR)
+      values[i] = uncheckedValueInTesla(p[i]);
+  }
+}
+
 void RectangularCylindricalMFGrid::toGridFrame(const LocalPoint& p, double& a, double& b, double& c) const {
   a = p.perp();
   // FIXME: "OLD" convention of phi.
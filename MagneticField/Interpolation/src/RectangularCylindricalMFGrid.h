@@ -12,6 +12,8 @@ public:
 
   LocalVector uncheckedValueInTesla(const LocalPoint& p) const override;
 
+  void valuesInTesla(const LocalPoint* p, LocalVector* values, int n) const override;
+
   void dump() const override;
 
   void toGridFrame(const LocalPoint& p, double& a, double& b, double& c) const override;
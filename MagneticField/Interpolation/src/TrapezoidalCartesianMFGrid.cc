@@ -56,20 +56,21 @@ TrapezoidalCartesianMFGrid::TrapezoidalCartesianMFGrid(binary_ifstream& inFile,
   inFile >> BasicDistance2[0][2] >> BasicDistance2[1][2] >> BasicDistance2[2][2];
   inFile >> easya >> easyb >> easyc;
 
-  vector<BVector> fieldValues;
-  float Bx, By, Bz;
+  GridType::Values fieldValues;
   int nLines = n1 * n2 * n3;
-  fieldValues.reserve(nLines);
-  for (int iLine = 0; iLine < nLines; ++iLine) {
-    inFile >> Bx >> By >> Bz;
-    if (convertToLocal) {
+  if (convertToLocal) {
+    vector<BVector> localValues;
+    float Bx, By, Bz;
+    localValues.reserve(nLines);
+    for (int iLine = 0; iLine < nLines; ++iLine) {
+      inFile >> Bx >> By >> Bz;
       // Preserve double precision!
       Vector3DBase<double, LocalTag> lB = frame().toLocal(Vector3DBase<double, GlobalTag>(Bx, By, Bz));
-      fieldValues.push_back(BVector(lB.x(), lB.y(), lB.z()));
-
-    } else {
-      fieldValues.push_back(BVector(Bx, By, Bz));
+      localValues.push_back(BVector(lB.x(), lB.y(), lB.z()));
     }
+    fieldValues = GridType::own(localValues);
+  } else {
+    fieldValues = readValues(inFile, nLines);
   }
   // check completeness
   string lastEntry;
@@ -195,7 +196,7 @@ void TrapezoidalCartesianMFGrid::dump() const {
   cout << "Basic Distance from Grid1D " << grid_.grida().step() << " " << grid_.gridb().step() << " "
        << grid_.gridc().step() << endl;
 
-  cout << "Dumping " << grid_.data().size() << " field values " << endl;
+  cout << "Dumping " << grid_.size() << " field values " << endl;
   // grid_.dump();
 
   // Dump ALL grid points and values
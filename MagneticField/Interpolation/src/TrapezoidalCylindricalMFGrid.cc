@@ -44,14 +44,7 @@ TrapezoidalCylindricalMFGrid::TrapezoidalCylindricalMFGrid(binary_ifstream& inFi
   inFile >> BasicDistance2[0][2] >> BasicDistance2[1][2] >> BasicDistance2[2][2];
   inFile >> easya >> easyb >> easyc;
 
-  vector<BVector> fieldValues;
-  float Bx, By, Bz;
-  int nLines = n1 * n2 * n3;
-  fieldValues.reserve(nLines);
-  for (int iLine = 0; iLine < nLines; ++iLine) {
-    inFile >> Bx >> By >> Bz;
-    fieldValues.push_back(BVector(Bx, By, Bz));
-  }
+  GridType::Values fieldValues = readValues(inFile, n1 * n2 * n3);
   // check completeness
   string lastEntry;
   inFile >> lastEntry;
@@ -139,6 +132,14 @@ MFGrid::LocalVector TrapezoidalCylindricalMFGrid::uncheckedValueInTesla(const Lo
   return frame().toLocal(gv);                      // must return a local vector
 }
 
+void TrapezoidalCylindricalMFGrid::valuesInTesla(const LocalPoint* p, LocalVector* values, int n) const {
+  MFGrid3D::valuesInTesla(p, values, n);
+  for (int i = 0; i < n; ++i) {
+    GlobalVector gv(values[i].basicVector());  // grid in global frame
+    values[i] = frame().toLocal(gv);
+  }
+}
+
 void TrapezoidalCylindricalMFGrid::toGridFrame(const LocalPoint& p, double& a, double& b, double& c) const {
   mapping_.rectangle(p.perp(), p.z(), a, c);
   // FIXME: "OLD" convention of phi.
@@ -1,13 +1,23 @@
 #include "binary_ifstream.h"
 
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 
 struct binary_ifstream_error {};
 
-binary_ifstream::binary_ifstream(const char* name) : file_(nullptr) { init(name); }
+binary_ifstream::binary_ifstream(const char* name)
+    : file_(nullptr), data_(nullptr), size_(0), pos_(0), eof_(false) {
+  init(name);
+}
+
+binary_ifstream::binary_ifstream(const std::string& name)
+    : file_(nullptr), data_(nullptr), size_(0), pos_(0), eof_(false) {
+  init(name.c_str());
+}
 
-binary_ifstream::binary_ifstream(const std::string& name) : file_(nullptr) { init(name.c_str()); }
+binary_ifstream::binary_ifstream(const char* data, size_t size, std::shared_ptr<const void> owner)
+    : file_(nullptr), data_(data), size_(size), pos_(0), eof_(false), owner_(std::move(owner)) {}
 
 void binary_ifstream::init(const char* name) {
   file_ = fopen(name, "rb");
@@ -22,55 +32,86 @@ void binary_ifstream::close() {
   if (file_ != nullptr)
     fclose(file_);
   file_ = nullptr;
+  data_ = nullptr;
+  owner_.reset();
+}
+
+size_t binary_ifstream::read(void* dest, size_t n) {
+  if (file_ != nullptr)
+    return fread(dest, 1, n, file_);
+  if (data_ == nullptr)
+    return 0;
+  if (n > size_ - pos_) {
+    n = size_ - pos_;
+    eof_ = true;
+  }
+  memcpy(dest, data_ + pos_, n);
+  pos_ += n;
+  return n;
+}
+
+int binary_ifstream::get() {
+  if (file_ != nullptr)
+    return fgetc(file_);
+  unsigned char c = 0;
+  return read(&c, 1) == 1 ? c : EOF;
+}
+
+const char* binary_ifstream::mapped(size_t n) {
+  if (data_ == nullptr || n > size_ - pos_)
+    return nullptr;
+  const char* result = data_ + pos_;
+  pos_ += n;
+  return result;
 }
 
 binary_ifstream& binary_ifstream::operator>>(char& n) {
-  n = static_cast<char>(fgetc(file_));
+  n = static_cast<char>(get());
   return *this;
 }
 
 binary_ifstream& binary_ifstream::operator>>(unsigned char& n) {
-  n = static_cast<unsigned char>(fgetc(file_));
+  n = static_cast<unsigned char>(get());
   return *this;
 }
 
 binary_ifstream& binary_ifstream::operator>>(short& n) {
-  fread(&n, sizeof(n), 1, file_);
+  read(&n, sizeof(n));
   return *this;
 }
 binary_ifstream& binary_ifstream::operator>>(unsigned short& n) {
-  fread(&n, sizeof(n), 1, file_);
+  read(&n, sizeof(n));
   return *this;
 }
 binary_ifstream& binary_ifstream::operator>>(int& n) {
-  fread(&n, sizeof(n), 1, file_);
+  read(&n, sizeof(n));
   return *this;
 }
 binary_ifstream& binary_ifstream::operator>>(unsigned int& n) {
-  fread(&n, sizeof(n), 1, file_);
+  read(&n, sizeof(n));
   return *this;
 }
 
 binary_ifstream& binary_ifstream::operator>>(long& n) {
-  fread(&n, sizeof(n), 1, file_);
+  read(&n, sizeof(n));
   return *this;
 }
 binary_ifstream& binary_ifstream::operator>>(unsigned long& n) {
-  fread(&n, sizeof(n), 1, file_);
+  read(&n, sizeof(n));
   return *this;
 }
 
 binary_ifstream& binary_ifstream::operator>>(float& n) {
-  fread(&n, sizeof(n), 1, file_);
+  read(&n, sizeof(n));
   return *this;
 }
 binary_ifstream& binary_ifstream::operator>>(double& n) {
-  fread(&n, sizeof(n), 1, file_);
+  read(&n, sizeof(n));
   return *this;
 }
 
 binary_ifstream& binary_ifstream::operator>>(bool& n) {
-  n = static_cast<bool>(fgetc(file_));
+  n = static_cast<bool>(get());
   return *this;
 }
 
@@ -78,7 +119,7 @@ binary_ifstream& binary_ifstream::operator>>(std::string& n) {
   unsigned int nchar;
   (*this) >> nchar;
   char* tmp = new char[nchar + 1];
-  unsigned int nread = fread(tmp, 1, nchar, file_);
+  unsigned int nread = read(tmp, nchar);
   if (nread != nchar)
     std::cout << "binary_ifstream error: read less then expected " << std::endl;
   n.assign(tmp, nread);
@@ -88,9 +129,9 @@ binary_ifstream& binary_ifstream::operator>>(std::string& n) {
 
 bool binary_ifstream::good() const { return !bad() && !eof(); }
 
-bool binary_ifstream::eof() const { return feof(file_); }
+bool binary_ifstream::eof() const { return file_ != nullptr ? feof(file_) : eof_; }
 
-bool binary_ifstream::fail() const { return file_ == nullptr || ferror(file_) != 0; }
+bool binary_ifstream::fail() const { return file_ == nullptr ? data_ == nullptr : ferror(file_) != 0; }
 
 // don't know the difference between fail() and bad() (yet)
 bool binary_ifstream::bad() const { return fail(); }
@@ -1,6 +1,8 @@
 #ifndef binary_ifstream_H
 #define binary_ifstream_H
 
+#include <cstddef>
+#include <memory>
 #include <string>
 #include <cstdio>
 #include "FWCore/Utilities/interface/Visibility.h"
@@ -9,6 +11,8 @@ class binary_ifstream {
 public:
   explicit binary_ifstream(const char* name);
   explicit binary_ifstream(const std::string& name);
+  /// Read from memory, e.g. a file mapping kept alive by owner
+  binary_ifstream(const char* data, size_t size, std::shared_ptr<const void> owner);
 
   ~binary_ifstream();
 
@@ -32,6 +36,11 @@ public:
 
   void close();
 
+  /// In memory: returns the next n bytes and skips them, kept valid by owner();
+  /// returns nullptr when reading from a file, or if less than n bytes are left.
+  const char* mapped(size_t n);
+  const std::shared_ptr<const void>& owner() const { return owner_; }
+
   /// stream state checking
   bool good() const;
   bool eof() const;
@@ -43,7 +52,15 @@ public:
 private:
   FILE* file_;
 
+  const char* data_;
+  size_t size_;
+  size_t pos_;
+  bool eof_;
+  std::shared_ptr<const void> owner_;
+
   void init(const char* name);
+  size_t read(void* dest, size_t n);
+  int get();
 };
 
 #endif
@@ -77,6 +77,26 @@ int grid3d_t() {
   std::cout << inter.interpolate(7.5, 7.2, -3.4) << std::endl;
   std::cout << inter.interpolate(-0.5, 10.2, -3.4) << std::endl;
 
+  // the batched interpolation gives the same values, also outside of the grid
+  constexpr int n = 3 * LinearGridInterpolator3D::chunkSize + 5;
+  Grid3D::Scalar a[n], b[n], c[n];
+  Grid3D::ReturnType result[n];
+  for (int i = 0; i < n; ++i) {
+    a[i] = -1.3f + 0.27f * i;
+    b[i] = 11.f - 0.43f * i;
+    c[i] = -10.6f + 0.31f * i;
+  }
+  inter.interpolate(a, b, c, result, n);
+  int nFail = 0;
+  for (int i = 0; i < n; ++i) {
+    Grid3D::ReturnType expected = inter.interpolate(a[i], b[i], c[i]);
+    if ((result[i] - expected).mag() > 1e-5f * (1.f + expected.mag())) {
+      std::cout << "batched interpolation at " << a[i] << "," << b[i] << "," << c[i] << " gives " << result[i]
+                << " instead of " << expected << std::endl;
+      ++nFail;
+    }
+  }
+
   delete grid;
-  return 0;
+  return nFail == 0 ? 0 : 1;
 }
@@ -0,0 +1,57 @@
+// Packs the binary grid files of a table set in a single file, which the field
+// builders map in memory instead of reading the grid files one by one:
+//
+//   packGridFiles <table set directory> [grid files]
+//
+// writes <table set directory>/grids.pack. The grid files are given relative to the
+// table set directory; by default all the .bin files below it are packed.
+
+#include "MagneticField/Interpolation/interface/MFGridPack.h"
+#include "MagneticField/VolumeGeometry/interface/MagExceptions.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    cout << "SYNOPSIS:" << endl << " packGridFiles <table set directory> [grid files]" << endl;
+    cout << "Example:" << endl << " packGridFiles grid_160812_3_8t" << endl;
+    return 1;
+  }
+  string directory = argv[1];
+  vector<string> names(argv + 2, argv + argc);
+  if (names.empty()) {
+    boost::filesystem::path top(directory);
+    for (boost::filesystem::recursive_directory_iterator it(top), end; it != end; ++it) {
+      if (boost::filesystem::is_regular_file(it->path()) && it->path().extension() == ".bin") {
+        names.push_back(it->path().lexically_relative(top).generic_string());
+      }
+    }
+    sort(names.begin(), names.end());
+  }
+
+  string packName = directory + "/grids.pack";
+  try {
+    MFGridPack::write(packName, directory, names);
+    // check that the pack can be read back
+    MFGridPack pack(packName);
+    for (const auto& name : names) {
+      size_t size;
+      if (pack.find(name, size) == nullptr) {
+        cout << "ERROR: " << name << " missing from " << packName << endl;
+        return 1;
+      }
+    }
+  } catch (MagException& exc) {
+    cout << "ERROR: " << exc.what() << endl;
+    return 1;
+  }
+  cout << "Packed " << names.size() << " grid files in " << packName << endl;
+  return 0;
+}
@@ -43,6 +43,9 @@ public:
 
   GlobalVector inTeslaUnchecked(const GlobalPoint& g) const override;
 
+  /// Consecutive points in the same volume are interpolated together
+  void inTeslaBatch(const GlobalPoint* gp, GlobalVector* result, int n) const override;
+
   const MagVolume* findVolume(const GlobalPoint& gp) const;
 
   bool isDefined(const GlobalPoint& gp) const override;
@@ -1,5 +1,6 @@
 #include "MagneticField/VolumeBasedEngine/interface/VolumeBasedMagneticField.h"
 #include "DataFormats/GeometryVector/interface/GlobalVector.h"
+#include "MagneticField/VolumeGeometry/interface/MagVolume.h"
 
 VolumeBasedMagneticField::VolumeBasedMagneticField(int geomVersion,
                                                    const std::vector<MagBLayer*>& theBLayers,
@@ -56,6 +57,26 @@ GlobalVector VolumeBasedMagneticField::inTeslaUnchecked(const GlobalPoint& gp) c
   return field->fieldInTesla(gp);
 }
 
+void VolumeBasedMagneticField::inTeslaBatch(const GlobalPoint* gp, GlobalVector* result, int n) const {
+  // points handled by the map, as in inTesla(); the volume of a point is kept for the
+  // following ones while they are inside it, as the volume cache of MagGeometry does
+  auto inMap = [this](const GlobalPoint& p) { return !(paramField && paramField->isDefined(p)) && isDefined(p); };
+  int i = 0;
+  while (i < n) {
+    const MagVolume* v = inMap(gp[i]) ? field->findVolume(gp[i]) : nullptr;
+    if (v == nullptr) {
+      result[i] = inTesla(gp[i]);
+      ++i;
+      continue;
+    }
+    int end = i + 1;
+    while (end < n && inMap(gp[end]) && v->inside(gp[end]))
+      ++end;
+    v->inTeslaBatch(gp + i, result + i, end - i);
+    i = end;
+  }
+}
+
 const MagVolume* VolumeBasedMagneticField::findVolume(const GlobalPoint& gp) const { return field->findVolume(gp); }
 
 bool VolumeBasedMagneticField::isDefined(const GlobalPoint& gp) const {
@@ -30,6 +30,8 @@ public:
 
   LocalVector fieldInTesla(const LocalPoint& lp) const;
   GlobalVector fieldInTesla(const GlobalPoint& lp) const;
+  /// Field at n local points, evaluated by the provider in a single batch
+  void fieldInTesla(const LocalPoint* lp, LocalVector* result, int n) const;
 
   virtual bool inside(const GlobalPoint& gp, double tolerance = 0.) const = 0;
   virtual bool inside(const LocalPoint& lp, double tolerance = 0.) const { return inside(toGlobal(lp), tolerance); }
@@ -41,6 +43,9 @@ public:
 
   ::GlobalVector inTesla(const ::GlobalPoint& gp) const override { return fieldInTesla(gp); }
 
+  /// Field at n global points, evaluated by the provider in a single batch
+  void inTeslaBatch(const ::GlobalPoint* gp, ::GlobalVector* result, int n) const override;
+
   /// Temporary hack to pass information on material. Will eventually be replaced!
   bool isIron() const { return isIronFlag; }
   void setIsIron(bool iron) { isIronFlag = iron; }
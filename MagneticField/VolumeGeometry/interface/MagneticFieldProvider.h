@@ -27,6 +27,14 @@ public:
    */
   virtual LocalVectorType valueInTesla(const LocalPointType& p) const = 0;
 
+  /** Fills values[i] with the field vector in the local frame at local position p[i], for i < n.
+   *  Providers that can evaluate several points at once override it.
+   */
+  virtual void valuesInTesla(const LocalPointType* p, LocalVectorType* values, int n) const {
+    for (int i = 0; i < n; ++i)
+      values[i] = valueInTesla(p[i]);
+  }
+
   /** Returns the field vector in the global frame, at global position p
    * Not needed, the MagVolume does the transformation to global!
    */
@@ -3,6 +3,8 @@
 #include "MagneticField/VolumeGeometry/interface/MagVolume.h"
 #include "MagneticField/VolumeGeometry/interface/MagneticFieldProvider.h"
 
+#include <algorithm>
+
 MagVolume::~MagVolume() {
   if (theProviderOwned)
     delete theProvider;
@@ -15,3 +17,23 @@ MagVolume::LocalVector MagVolume::fieldInTesla(const LocalPoint& lp) const {
 MagVolume::GlobalVector MagVolume::fieldInTesla(const GlobalPoint& gp) const {
   return toGlobal(theProvider->valueInTesla(toLocal(gp))) * theScalingFactor;
 }
+
+void MagVolume::fieldInTesla(const LocalPoint* lp, LocalVector* result, int n) const {
+  theProvider->valuesInTesla(lp, result, n);
+  for (int i = 0; i < n; ++i)
+    result[i] = result[i] * theScalingFactor;
+}
+
+void MagVolume::inTeslaBatch(const ::GlobalPoint* gp, ::GlobalVector* result, int n) const {
+  constexpr int chunk = 64;
+  LocalPoint lp[chunk];
+  LocalVector lv[chunk];
+  for (int first = 0; first < n; first += chunk) {
+    int m = std::min(chunk, n - first);
+    for (int i = 0; i < m; ++i)
+      lp[i] = toLocal(gp[first + i]);
+    theProvider->valuesInTesla(lp, lv, m);
+    for (int i = 0; i < m; ++i)
+      result[first + i] = toGlobal(lv[i]) * theScalingFactor;
+  }
+}
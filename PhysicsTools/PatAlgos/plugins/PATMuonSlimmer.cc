@@ -31,6 +31,11 @@ namespace pat {
     void beginLuminosityBlock(const edm::LuminosityBlock &, const edm::EventSetup &) final;
 
   private:
+    // package whose precompile.h declares pat::Muon, if the cuts are to be compiled
+    static const char *jitPackage(const edm::ParameterSet &iConfig) {
+      return iConfig.getUntrackedParameter<bool>("compileCuts", false) ? "CommonTools/RecoUtils" : nullptr;
+    }
+
     const edm::EDGetTokenT<pat::MuonCollection> src_;
     std::vector<edm::EDGetTokenT<reco::PFCandidateCollection>> pf_;
     std::vector<edm::EDGetTokenT<edm::Association<pat::PackedCandidateCollection>>> pf2pc_;
@@ -46,14 +51,14 @@ namespace pat {
 pat::PATMuonSlimmer::PATMuonSlimmer(const edm::ParameterSet &iConfig)
     : src_(consumes<pat::MuonCollection>(iConfig.getParameter<edm::InputTag>("src"))),
       linkToPackedPF_(iConfig.getParameter<bool>("linkToPackedPFCandidates")),
-      saveTeVMuons_(iConfig.getParameter<std::string>("saveTeVMuons")),
-      dropDirectionalIso_(iConfig.getParameter<std::string>("dropDirectionalIso")),
-      dropPfP4_(iConfig.getParameter<std::string>("dropPfP4")),
-      slimCaloVars_(iConfig.getParameter<std::string>("slimCaloVars")),
-      slimKinkVars_(iConfig.getParameter<std::string>("slimKinkVars")),
-      slimCaloMETCorr_(iConfig.getParameter<std::string>("slimCaloMETCorr")),
-      slimMatches_(iConfig.getParameter<std::string>("slimMatches")),
-      segmentsMuonSelection_(iConfig.getParameter<std::string>("segmentsMuonSelection")),
+      saveTeVMuons_(iConfig.getParameter<std::string>("saveTeVMuons"), false, jitPackage(iConfig)),
+      dropDirectionalIso_(iConfig.getParameter<std::string>("dropDirectionalIso"), false, jitPackage(iConfig)),
+      dropPfP4_(iConfig.getParameter<std::string>("dropPfP4"), false, jitPackage(iConfig)),
+      slimCaloVars_(iConfig.getParameter<std::string>("slimCaloVars"), false, jitPackage(iConfig)),
+      slimKinkVars_(iConfig.getParameter<std::string>("slimKinkVars"), false, jitPackage(iConfig)),
+      slimCaloMETCorr_(iConfig.getParameter<std::string>("slimCaloMETCorr"), false, jitPackage(iConfig)),
+      slimMatches_(iConfig.getParameter<std::string>("slimMatches"), false, jitPackage(iConfig)),
+      segmentsMuonSelection_(iConfig.getParameter<std::string>("segmentsMuonSelection"), false, jitPackage(iConfig)),
       saveSegments_(iConfig.getParameter<bool>("saveSegments")),
       modifyMuon_(iConfig.getParameter<bool>("modifyMuons")) {
   if (linkToPackedPF_) {
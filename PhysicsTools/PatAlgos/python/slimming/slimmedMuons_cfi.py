@@ -15,6 +15,7 @@ slimmedMuons = cms.EDProducer("PATMuonSlimmer",
     segmentsMuonSelection = cms.string("pt > 50"), #segments are needed for EXO analysis looking at TOF and for very high pt from e.g. Z' 
     saveSegments = cms.bool(True),
     modifyMuons = cms.bool(True),
+    compileCuts = cms.untracked.bool(False), # compile the cuts into native code, instead of interpreting them
     modifierConfig = cms.PSet( modifications = cms.VPSet() )
 )
 
@@ -0,0 +1,76 @@
+/*
+ * TensorFlow session shared by several modules, typically the stream copies of one module, which
+ * coalesces the inputs they submit from their acquire() method into larger batches.
+ *
+ * The inputs of a submission have the same leading batch dimension, e.g. the number of jets of an
+ * event. The pending submissions are concatenated along it and evaluated in a single call of the
+ * session, either by the thread whose submission fills a batch of maxBatchSize rows or, after
+ * maxLatency, by a helper thread. The outputs are then split along their leading dimension, and
+ * each submission gets its rows before its waiting task is released. The rows do not depend on each
+ * other, but the kernels may split or vectorize the computations differently for different batch
+ * sizes, so the outputs can differ in the last bits from those of an evaluation in another batch.
+ */
+
+#ifndef PHYSICSTOOLS_TENSORFLOW_BATCHINGSESSION_H
+#define PHYSICSTOOLS_TENSORFLOW_BATCHINGSESSION_H
+
+#include "PhysicsTools/TensorFlow/interface/TensorFlow.h"
+#include "FWCore/Concurrency/interface/WaitingTaskWithArenaHolder.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace tensorflow {
+
+  class BatchingSession {
+  public:
+    // takes the ownership of the session; constantInputs, such as the learning phase flags, are fed
+    // as they are to every call, next to the batched inputs named inputNames
+    BatchingSession(Session* session,
+                    const std::vector<std::string>& inputNames,
+                    const std::vector<std::string>& outputNames,
+                    const NamedTensorList& constantInputs,
+                    int64 maxBatchSize,
+                    std::chrono::microseconds maxLatency);
+    ~BatchingSession();
+
+    BatchingSession(const BatchingSession&) = delete;
+    BatchingSession& operator=(const BatchingSession&) = delete;
+
+    // queues the inputs, one tensor per input name; outputs is filled before holder is released,
+    // or the holder gets the exception of a failed evaluation
+    void submit(std::vector<Tensor>&& inputs, std::vector<Tensor>* outputs, edm::WaitingTaskWithArenaHolder holder);
+
+  private:
+    struct Request {
+      std::vector<Tensor> inputs;
+      std::vector<Tensor>* outputs;
+      edm::WaitingTaskWithArenaHolder holder;
+    };
+
+    // evaluates the batch and releases its requests, without holding the lock
+    void run(std::vector<Request>& batch);
+    // flushes the pending requests once the oldest one has waited for maxLatency
+    void flushLoop();
+
+    Session* session_;
+    const std::vector<std::string> inputNames_;
+    const std::vector<std::string> outputNames_;
+    const NamedTensorList constantInputs_;
+    const int64 maxBatchSize_;
+    const std::chrono::microseconds maxLatency_;
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::vector<Request> pending_;
+    int64 pendingRows_;
+    std::chrono::steady_clock::time_point oldest_;
+    bool stop_;
+    std::thread flushThread_;
+  };
+
+}  // namespace tensorflow
+
+#endif  // PHYSICSTOOLS_TENSORFLOW_BATCHINGSESSION_H
@@ -0,0 +1,160 @@
+/*
+ * TensorFlow session coalescing the inputs of several modules into batches.
+ */
+
+#include "PhysicsTools/TensorFlow/interface/BatchingSession.h"
+
+#include "tensorflow/core/framework/tensor_util.h"
+
+#include <exception>
+
+namespace tensorflow {
+
+  BatchingSession::BatchingSession(Session* session,
+                                   const std::vector<std::string>& inputNames,
+                                   const std::vector<std::string>& outputNames,
+                                   const NamedTensorList& constantInputs,
+                                   int64 maxBatchSize,
+                                   std::chrono::microseconds maxLatency)
+      : session_(session),
+        inputNames_(inputNames),
+        outputNames_(outputNames),
+        constantInputs_(constantInputs),
+        maxBatchSize_(maxBatchSize),
+        maxLatency_(maxLatency),
+        pendingRows_(0),
+        stop_(false) {
+    if (session_ == nullptr) {
+      throw cms::Exception("InvalidSession") << "cannot batch the inputs of an empty session";
+    }
+    flushThread_ = std::thread(&BatchingSession::flushLoop, this);
+  }
+
+  BatchingSession::~BatchingSession() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stop_ = true;
+    }
+    condition_.notify_one();
+    flushThread_.join();
+    // the framework waits for all the submissions, so this only matters after a failure
+    if (!pending_.empty()) {
+      run(pending_);
+    }
+    closeSession(session_);
+  }
+
+  void BatchingSession::submit(std::vector<Tensor>&& inputs,
+                               std::vector<Tensor>* outputs,
+                               edm::WaitingTaskWithArenaHolder holder) {
+    if (inputs.size() != inputNames_.size()) {
+      throw cms::Exception("InvalidInput") << "numbers of input names and tensors not equal";
+    }
+    const int64 rows = inputs[0].dim_size(0);
+    for (const auto& input : inputs) {
+      if (input.dims() == 0 || input.dim_size(0) != rows) {
+        throw cms::Exception("InvalidInput") << "the batched inputs must have the same leading dimension";
+      }
+    }
+
+    std::vector<Request> batch;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (pending_.empty()) {
+        oldest_ = std::chrono::steady_clock::now();
+        condition_.notify_one();
+      }
+      pending_.push_back(Request{std::move(inputs), outputs, std::move(holder)});
+      pendingRows_ += rows;
+      if (pendingRows_ >= maxBatchSize_) {
+        batch.swap(pending_);
+        pendingRows_ = 0;
+      }
+    }
+    // the submission that fills a batch evaluates it
+    if (!batch.empty()) {
+      run(batch);
+    }
+  }
+
+  void BatchingSession::flushLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+      if (pending_.empty()) {
+        condition_.wait(lock);
+      } else if (std::chrono::steady_clock::now() < oldest_ + maxLatency_) {
+        condition_.wait_until(lock, oldest_ + maxLatency_);
+      } else {
+        std::vector<Request> batch;
+        batch.swap(pending_);
+        pendingRows_ = 0;
+        lock.unlock();
+        run(batch);
+        lock.lock();
+      }
+    }
+  }
+
+  void BatchingSession::run(std::vector<Request>& batch) {
+    std::exception_ptr exception;
+    try {
+      // concatenate the inputs of the requests along the batch dimension
+      std::vector<int64> rows;
+      rows.reserve(batch.size());
+      for (const auto& request : batch) {
+        rows.push_back(request.inputs[0].dim_size(0));
+      }
+      NamedTensorList inputs;
+      inputs.reserve(inputNames_.size() + constantInputs_.size());
+      for (size_t i = 0; i < inputNames_.size(); i++) {
+        if (batch.size() == 1) {
+          inputs.emplace_back(inputNames_[i], batch[0].inputs[i]);
+          continue;
+        }
+        std::vector<Tensor> parts;
+        parts.reserve(batch.size());
+        for (const auto& request : batch) {
+          parts.push_back(request.inputs[i]);
+        }
+        Tensor input;
+        Status status = tensor::Concat(parts, &input);
+        if (!status.ok()) {
+          throw cms::Exception("InvalidInput")
+              << "cannot batch the inputs " << inputNames_[i] << ": " << status.ToString();
+        }
+        inputs.emplace_back(inputNames_[i], std::move(input));
+      }
+      inputs.insert(inputs.end(), constantInputs_.begin(), constantInputs_.end());
+
+      std::vector<Tensor> outputs;
+      tensorflow::run(session_, inputs, outputNames_, &outputs);
+
+      // scatter the rows of the outputs back to the requests
+      for (auto& request : batch) {
+        request.outputs->clear();
+      }
+      for (size_t i = 0; i < outputs.size(); i++) {
+        if (batch.size() == 1) {
+          batch[0].outputs->push_back(outputs[i]);
+          continue;
+        }
+        std::vector<Tensor> parts;
+        Status status = tensor::Split(outputs[i], rows, &parts);
+        if (!status.ok()) {
+          throw cms::Exception("InvalidRun")
+              << "cannot split the outputs " << outputNames_[i] << " of the batch: " << status.ToString();
+        }
+        for (size_t j = 0; j < batch.size(); j++) {
+          batch[j].outputs->push_back(std::move(parts[j]));
+        }
+      }
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    for (auto& request : batch) {
+      request.holder.doneWaiting(exception);
+    }
+    batch.clear();
+  }
+
+}  // namespace tensorflow
@@ -0,0 +1,212 @@
+/*
+ * Tests of the BatchingSession with the constant graph of createconstantgraph.py, whose output is
+ * (sum of the 10 inputs + 1) * scale for each row.
+ */
+
+#include <boost/filesystem.hpp>
+#include <cppunit/extensions/HelperMacros.h>
+#include <array>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "FWCore/Concurrency/interface/WaitingTask.h"
+#include "FWCore/Concurrency/interface/WaitingTaskWithArenaHolder.h"
+#include "PhysicsTools/TensorFlow/interface/BatchingSession.h"
+
+std::string cmsswPath(std::string path) {
+  if (path.size() > 0 && path.substr(0, 1) != "/") {
+    path = "/" + path;
+  }
+
+  std::string base = std::string(std::getenv("CMSSW_BASE"));
+  std::string releaseBase = std::string(std::getenv("CMSSW_RELEASE_BASE"));
+
+  return (boost::filesystem::exists(base.c_str()) ? base : releaseBase) + path;
+}
+
+class testBatchingSession : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testBatchingSession);
+  CPPUNIT_TEST(checkRouting);
+  CPPUNIT_TEST(checkLatency);
+  CPPUNIT_TEST(checkException);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  std::string dataPath;
+  tensorflow::GraphDef* graphDef;
+
+  void setUp();
+  void tearDown();
+  void checkRouting();
+  void checkLatency();
+  void checkException();
+
+private:
+  tensorflow::BatchingSession* makeSession(tensorflow::int64 maxBatchSize, std::chrono::microseconds maxLatency);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testBatchingSession);
+
+namespace {
+  constexpr float kScale = 2.;
+
+  // the waiting task fulfills the promise, or gives it the exception of the evaluation
+  edm::WaitingTaskWithArenaHolder makeHolder(std::future<void>& future) {
+    auto done = std::make_shared<std::promise<void>>();
+    future = done->get_future();
+    auto task = edm::make_waiting_task(tbb::task::allocate_root(), [done](std::exception_ptr const* exception) {
+      if (exception) {
+        done->set_exception(*exception);
+      } else {
+        done->set_value();
+      }
+    });
+    return edm::WaitingTaskWithArenaHolder(task);
+  }
+
+  // the first input of each row is its id, and the others sum up to 45, so that the output of the
+  // row is exactly (id + 46) * scale
+  tensorflow::Tensor makeInput(const std::vector<int>& ids, int nInputs = 10) {
+    tensorflow::Tensor input(tensorflow::DT_FLOAT, {tensorflow::int64(ids.size()), nInputs});
+    auto matrix = input.matrix<float>();
+    for (size_t i = 0; i < ids.size(); i++) {
+      matrix(i, 0) = float(ids[i]);
+      for (int j = 1; j < nInputs; j++) {
+        matrix(i, j) = float(j);
+      }
+    }
+    return input;
+  }
+
+  void checkOutputs(const std::vector<int>& ids, const std::vector<tensorflow::Tensor>& outputs) {
+    CPPUNIT_ASSERT(outputs.size() == 1);
+    CPPUNIT_ASSERT(outputs[0].dim_size(0) == tensorflow::int64(ids.size()));
+    auto matrix = outputs[0].matrix<float>();
+    for (size_t i = 0; i < ids.size(); i++) {
+      CPPUNIT_ASSERT(matrix(i, 0) == (ids[i] + 46.f) * kScale);
+    }
+  }
+}  // namespace
+
+void testBatchingSession::setUp() {
+  dataPath =
+      cmsswPath("/test/" + std::string(std::getenv("SCRAM_ARCH")) + "/" + boost::filesystem::unique_path().string());
+
+  // create the graph
+  std::string testPath = cmsswPath("/src/PhysicsTools/TensorFlow/test");
+  std::string cmd = "python " + testPath + "/createconstantgraph.py " + dataPath;
+  std::array<char, 128> buffer;
+  std::string result;
+  std::shared_ptr<FILE> pipe(popen(cmd.c_str(), "r"), pclose);
+  if (!pipe) {
+    throw std::runtime_error("popen() failed!");
+  }
+  while (!feof(pipe.get())) {
+    if (fgets(buffer.data(), 128, pipe.get()) != NULL) {
+      result += buffer.data();
+    }
+  }
+  std::cout << std::endl << result << std::endl;
+
+  tensorflow::setLogging();
+  graphDef = tensorflow::loadGraphDef(dataPath + "/constantgraph.pb");
+  CPPUNIT_ASSERT(graphDef != nullptr);
+}
+
+void testBatchingSession::tearDown() {
+  delete graphDef;
+  if (boost::filesystem::exists(dataPath)) {
+    boost::filesystem::remove_all(dataPath);
+  }
+}
+
+tensorflow::BatchingSession* testBatchingSession::makeSession(tensorflow::int64 maxBatchSize,
+                                                              std::chrono::microseconds maxLatency) {
+  tensorflow::Session* session = tensorflow::createSession(graphDef);
+  CPPUNIT_ASSERT(session != nullptr);
+  tensorflow::Tensor scale(tensorflow::DT_FLOAT, {});
+  scale.scalar<float>()() = kScale;
+  return new tensorflow::BatchingSession(session, {"input"}, {"output"}, {{"scale", scale}}, maxBatchSize, maxLatency);
+}
+
+void testBatchingSession::checkRouting() {
+  // the submissions of the threads are batched both when they fill a batch and after the latency
+  std::unique_ptr<tensorflow::BatchingSession> session(makeSession(16, std::chrono::milliseconds(1)));
+
+  const int nThreads = 8;
+  const int nSubmissions = 25;
+  std::vector<std::exception_ptr> failures(nThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nThreads; t++) {
+    threads.emplace_back([&session, &failures, t]() {
+      try {
+        std::vector<std::vector<int>> ids(nSubmissions);
+        std::vector<std::vector<tensorflow::Tensor>> outputs(nSubmissions);
+        std::vector<std::future<void>> done(nSubmissions);
+        for (int k = 0; k < nSubmissions; k++) {
+          // 1 to 4 rows, with ids unique across the threads
+          for (int r = 0; r < 1 + (t + k) % 4; r++) {
+            ids[k].push_back(t * 1000 + k * 4 + r);
+          }
+          session->submit({makeInput(ids[k])}, &outputs[k], makeHolder(done[k]));
+        }
+        for (int k = 0; k < nSubmissions; k++) {
+          done[k].get();
+          checkOutputs(ids[k], outputs[k]);
+        }
+      } catch (...) {
+        failures[t] = std::current_exception();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto const& failure : failures) {
+    if (failure) {
+      std::rethrow_exception(failure);
+    }
+  }
+}
+
+void testBatchingSession::checkLatency() {
+  // a single submission far below the batch size is evaluated once it has waited for the latency
+  const auto latency = std::chrono::milliseconds(50);
+  std::unique_ptr<tensorflow::BatchingSession> session(makeSession(1000, latency));
+
+  const std::vector<int> ids = {3, 5, 7};
+  std::vector<tensorflow::Tensor> outputs;
+  std::future<void> future;
+  const auto start = std::chrono::steady_clock::now();
+  session->submit({makeInput(ids)}, &outputs, makeHolder(future));
+  CPPUNIT_ASSERT(future.wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+  CPPUNIT_ASSERT(std::chrono::steady_clock::now() - start >= latency);
+  future.get();
+  checkOutputs(ids, outputs);
+}
+
+void testBatchingSession::checkException() {
+  // the inputs have the wrong number of columns: the batch filled by the submissions of the threads
+  // fails, and each of them gets the exception
+  const int nThreads = 4;
+  std::unique_ptr<tensorflow::BatchingSession> session(makeSession(2 * nThreads, std::chrono::seconds(60)));
+
+  std::vector<std::vector<tensorflow::Tensor>> outputs(nThreads);
+  std::vector<std::future<void>> done(nThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nThreads; t++) {
+    threads.emplace_back([&, t]() { session->submit({makeInput({t, t}, 7)}, &outputs[t], makeHolder(done[t])); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& future : done) {
+    CPPUNIT_ASSERT(future.wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+    CPPUNIT_ASSERT_THROW(future.get(), cms::Exception);
+  }
+}
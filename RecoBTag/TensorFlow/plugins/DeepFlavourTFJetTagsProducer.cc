@@ -8,6 +8,7 @@
 #include "FWCore/Framework/interface/makeRefToBaseProdFrom.h"
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/EDMException.h"
 #include "FWCore/Utilities/interface/StreamID.h"
 
 #include "DataFormats/BTauReco/interface/JetTag.h"
@@ -15,6 +16,7 @@
 #include "DataFormats/BTauReco/interface/DeepFlavourTagInfo.h"
 
 #include "PhysicsTools/TensorFlow/interface/TensorFlow.h"
+#include "PhysicsTools/TensorFlow/interface/BatchingSession.h"
 
 #include "RecoBTag/TensorFlow/interface/tensor_fillers.h"
 
@@ -26,13 +28,17 @@
 // make use of a cache struct that can be extended in the future if nedded. In addition, the graph
 // is protected via std::atomic, which should not affect the performance as it is only accessed in
 // the module constructor and not in the actual produce loop.
+// When the jets of several events are evaluated together, the cache also holds the session shared
+// by the stream module copies, which gathers the jets that they submit into batches.
 struct DeepFlavourTFCache {
   DeepFlavourTFCache() : graphDef(nullptr) {}
 
   std::atomic<tensorflow::GraphDef*> graphDef;
+  std::unique_ptr<tensorflow::BatchingSession> batchingSession;
 };
 
-class DeepFlavourTFJetTagsProducer : public edm::stream::EDProducer<edm::GlobalCache<DeepFlavourTFCache>> {
+class DeepFlavourTFJetTagsProducer
+    : public edm::stream::EDProducer<edm::GlobalCache<DeepFlavourTFCache>, edm::ExternalWork> {
 public:
   explicit DeepFlavourTFJetTagsProducer(const edm::ParameterSet&, const DeepFlavourTFCache*);
   ~DeepFlavourTFJetTagsProducer() override;
@@ -54,9 +60,23 @@ private:
   typedef reco::JetTagCollection JetTagCollection;
 
   void beginStream(edm::StreamID) override {}
+  void acquire(const edm::Event&, const edm::EventSetup&, edm::WaitingTaskWithArenaHolder) override;
   void produce(edm::Event&, const edm::EventSetup&) override;
   void endStream() override {}
 
+  static std::vector<tensorflow::TensorShape> input_shapes(int64_t n_batch_jets);
+  // fills the rows of the inputs with the n_batch_jets jets starting at first_jet
+  static void fill_inputs(const TagInfoCollection& tag_infos,
+                          std::size_t first_jet,
+                          std::size_t n_batch_jets,
+                          std::vector<tensorflow::Tensor>& inputs);
+  // sets the discriminators of the n_batch_jets jets starting at first_jet from the rows of the outputs
+  void fill_tags(const TagInfoCollection& tag_infos,
+                 std::size_t first_jet,
+                 std::size_t n_batch_jets,
+                 const std::vector<tensorflow::Tensor>& outputs,
+                 std::vector<std::unique_ptr<JetTagCollection>>& output_tags) const;
+
   const edm::EDGetTokenT<TagInfoCollection> src_;
   std::vector<std::pair<std::string, std::vector<unsigned int>>> flav_pairs_;
   std::vector<std::string> input_names_;
@@ -69,6 +89,10 @@ private:
   std::vector<tensorflow::Tensor> lp_tensors_;
   // flag to evaluate model batch or jet by jet
   bool batch_eval_;
+  // session gathering the jets of several events, owned by the cache
+  tensorflow::BatchingSession* batching_session_;
+  // outputs of the batching session for the jets of the event, filled before produce
+  std::vector<tensorflow::Tensor> batch_outputs_;
 };
 
 DeepFlavourTFJetTagsProducer::DeepFlavourTFJetTagsProducer(const edm::ParameterSet& iConfig,
@@ -78,15 +102,18 @@ DeepFlavourTFJetTagsProducer::DeepFlavourTFJetTagsProducer(const edm::ParameterS
       output_names_(iConfig.getParameter<std::vector<std::string>>("output_names")),
       lp_names_(iConfig.getParameter<std::vector<std::string>>("lp_names")),
       session_(nullptr),
-      batch_eval_(iConfig.getParameter<bool>("batch_eval")) {
+      batch_eval_(iConfig.getParameter<bool>("batch_eval")),
+      batching_session_(cache->batchingSession.get()) {
   // get threading config and build session options
   size_t nThreads = iConfig.getParameter<unsigned int>("nThreads");
   std::string singleThreadPool = iConfig.getParameter<std::string>("singleThreadPool");
   tensorflow::SessionOptions sessionOptions;
   tensorflow::setThreading(sessionOptions, nThreads, singleThreadPool);
 
-  // create the session using the meta graph from the cache
-  session_ = tensorflow::createSession(cache->graphDef, sessionOptions);
+  // create the session using the meta graph from the cache, unless the jets go to the shared one
+  if (batching_session_ == nullptr) {
+    session_ = tensorflow::createSession(cache->graphDef, sessionOptions);
+  }
 
   // get output names from flav_table
   const auto& flav_pset = iConfig.getParameter<edm::ParameterSet>("flav_table");
@@ -137,6 +164,11 @@ void DeepFlavourTFJetTagsProducer::fillDescriptions(edm::ConfigurationDescriptio
   }
 
   desc.add<bool>("batch_eval", false);
+  // when not 0, the jets of concurrent events are evaluated together, in batches of about batch_size
+  // jets or those gathered after batch_latency microseconds; requires batch_eval, as the discriminators
+  // of a jet may differ in the last bits from those evaluated jet by jet
+  desc.add<unsigned int>("batch_size", 0);
+  desc.add<unsigned int>("batch_latency", 2000);
 
   desc.add<unsigned int>("nThreads", 1);
   desc.add<std::string>("singleThreadPool", "no_threads");
@@ -149,6 +181,14 @@ std::unique_ptr<DeepFlavourTFCache> DeepFlavourTFJetTagsProducer::initializeGlob
   // set the tensorflow log level to error
   tensorflow::setLogging("3");
 
+  // the jets evaluated in batches of several events can only replace those evaluated in batches of one
+  // event, the evaluation in batches of different sizes may round differently than jet by jet
+  const unsigned int batchSize = iConfig.getParameter<unsigned int>("batch_size");
+  if (batchSize > 0 && !iConfig.getParameter<bool>("batch_eval")) {
+    throw edm::Exception(edm::errors::Configuration)
+        << "pfDeepFlavourJetTags: batch_size = " << batchSize << " requires batch_eval = True";
+  }
+
   // get the pb file
   std::string pbFile = iConfig.getParameter<edm::FileInPath>("graph_path").fullPath();
 
@@ -156,6 +196,27 @@ std::unique_ptr<DeepFlavourTFCache> DeepFlavourTFJetTagsProducer::initializeGlob
   DeepFlavourTFCache* cache = new DeepFlavourTFCache();
   cache->graphDef = tensorflow::loadGraphDef(pbFile);
 
+  // create the session shared by the stream modules to evaluate the jets of several events together
+  if (batchSize > 0) {
+    tensorflow::SessionOptions sessionOptions;
+    tensorflow::setThreading(sessionOptions,
+                             iConfig.getParameter<unsigned int>("nThreads"),
+                             iConfig.getParameter<std::string>("singleThreadPool"));
+    tensorflow::NamedTensorList lpTensors;
+    for (const auto& lpName : iConfig.getParameter<std::vector<std::string>>("lp_names")) {
+      tensorflow::Tensor t(tensorflow::DT_BOOL, {});
+      t.scalar<bool>()() = false;
+      lpTensors.emplace_back(lpName, t);
+    }
+    cache->batchingSession = std::make_unique<tensorflow::BatchingSession>(
+        tensorflow::createSession(cache->graphDef, sessionOptions),
+        iConfig.getParameter<std::vector<std::string>>("input_names"),
+        iConfig.getParameter<std::vector<std::string>>("output_names"),
+        lpTensors,
+        batchSize,
+        std::chrono::microseconds(iConfig.getParameter<unsigned int>("batch_latency")));
+  }
+
   return std::unique_ptr<DeepFlavourTFCache>(cache);
 }
 
@@ -165,6 +226,101 @@ void DeepFlavourTFJetTagsProducer::globalEndJob(const DeepFlavourTFCache* cache)
   }
 }
 
+std::vector<tensorflow::TensorShape> DeepFlavourTFJetTagsProducer::input_shapes(int64_t n_batch_jets) {
+  return {
+      {n_batch_jets, 15},      // input_1 - global jet features
+      {n_batch_jets, 25, 16},  // input_2 - charged pf
+      {n_batch_jets, 25, 6},   // input_3 - neutral pf
+      {n_batch_jets, 4, 12},   // input_4 - vertices
+      {n_batch_jets, 1}        // input_5 - jet pt for reg
+  };
+}
+
+void DeepFlavourTFJetTagsProducer::fill_inputs(const TagInfoCollection& tag_infos,
+                                               std::size_t first_jet,
+                                               std::size_t n_batch_jets,
+                                               std::vector<tensorflow::Tensor>& inputs) {
+  // tensors have to be zeroed before filling per batch
+  for (auto& input : inputs) {
+    input.flat<float>().setZero();
+  }
+
+  for (std::size_t jet_bn = 0; jet_bn < n_batch_jets; jet_bn++) {
+    // jet and other global features
+    const auto& features = tag_infos.at(first_jet + jet_bn).features();
+    jet_tensor_filler(inputs.at(kGlobal), jet_bn, features);
+
+    // c_pf candidates
+    auto max_c_pf_n =
+        std::min(features.c_pf_features.size(), (std::size_t)inputs.at(kChargedCandidates).dim_size(1));
+    for (std::size_t c_pf_n = 0; c_pf_n < max_c_pf_n; c_pf_n++) {
+      const auto& c_pf_features = features.c_pf_features.at(c_pf_n);
+      c_pf_tensor_filler(inputs.at(kChargedCandidates), jet_bn, c_pf_n, c_pf_features);
+    }
+
+    // n_pf candidates
+    auto max_n_pf_n =
+        std::min(features.n_pf_features.size(), (std::size_t)inputs.at(kNeutralCandidates).dim_size(1));
+    for (std::size_t n_pf_n = 0; n_pf_n < max_n_pf_n; n_pf_n++) {
+      const auto& n_pf_features = features.n_pf_features.at(n_pf_n);
+      n_pf_tensor_filler(inputs.at(kNeutralCandidates), jet_bn, n_pf_n, n_pf_features);
+    }
+
+    // sv candidates
+    auto max_sv_n = std::min(features.sv_features.size(), (std::size_t)inputs.at(kVertices).dim_size(1));
+    for (std::size_t sv_n = 0; sv_n < max_sv_n; sv_n++) {
+      const auto& sv_features = features.sv_features.at(sv_n);
+      sv_tensor_filler(inputs.at(kVertices), jet_bn, sv_n, sv_features);
+    }
+
+    // last input: jet pt
+    inputs.at(kJetPt).matrix<float>()(jet_bn, 0) = features.jet_features.pt;
+  }
+}
+
+void DeepFlavourTFJetTagsProducer::fill_tags(const TagInfoCollection& tag_infos,
+                                             std::size_t first_jet,
+                                             std::size_t n_batch_jets,
+                                             const std::vector<tensorflow::Tensor>& outputs,
+                                             std::vector<std::unique_ptr<JetTagCollection>>& output_tags) const {
+  // set output values for flavour probs
+  for (std::size_t jet_bn = 0; jet_bn < n_batch_jets; jet_bn++) {
+    const auto& jet_ref = tag_infos.at(first_jet + jet_bn).jet();
+    for (std::size_t flav_n = 0; flav_n < flav_pairs_.size(); flav_n++) {
+      const auto& flav_pair = flav_pairs_.at(flav_n);
+      float o_sum = 0.;
+      for (const unsigned int& ind : flav_pair.second) {
+        o_sum += outputs.at(kJetFlavour).matrix<float>()(jet_bn, ind);
+      }
+      (*(output_tags.at(flav_n)))[jet_ref] = o_sum;
+    }
+  }
+}
+
+void DeepFlavourTFJetTagsProducer::acquire(const edm::Event& iEvent,
+                                           const edm::EventSetup& iSetup,
+                                           edm::WaitingTaskWithArenaHolder holder) {
+  batch_outputs_.clear();
+  if (batching_session_ == nullptr) {
+    return;
+  }
+
+  edm::Handle<TagInfoCollection> tag_infos;
+  iEvent.getByToken(src_, tag_infos);
+  const int64_t n_jets = tag_infos->size();
+  if (n_jets == 0) {
+    return;
+  }
+
+  // submit all the jets of the event, which are evaluated together with those of other events
+  std::vector<tensorflow::Tensor> inputs;
+  for (const auto& shape : input_shapes(n_jets)) {
+    inputs.emplace_back(tensorflow::DT_FLOAT, shape);
+  }
+  fill_inputs(*tag_infos, 0, n_jets, inputs);
+  batching_session_->submit(std::move(inputs), &batch_outputs_, std::move(holder));
+}
+
 void DeepFlavourTFJetTagsProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
   edm::Handle<TagInfoCollection> tag_infos;
   iEvent.getByToken(src_, tag_infos);
@@ -181,95 +337,46 @@ void DeepFlavourTFJetTagsProducer::produce(edm::Event& iEvent, const edm::EventS
   }
 
   const int64_t n_jets = tag_infos->size();
-  // either all jets or one per batch for the time being
-  const int64_t n_batch_jets = batch_eval_ ? n_jets : 1;
 
-  std::vector<tensorflow::TensorShape> input_sizes{
-      {n_batch_jets, 15},      // input_1 - global jet features
-      {n_batch_jets, 25, 16},  // input_2 - charged pf
-      {n_batch_jets, 25, 6},   // input_3 - neutral pf
-      {n_batch_jets, 4, 12},   // input_4 - vertices
-      {n_batch_jets, 1}        // input_5 - jet pt for reg
-  };
-
-  // create a list of named tensors, i.e. a vector of (string, Tensor) pairs, with proper size to
-  // prevent element copying that would occur via push_back's
-  // the default Tensor constructor creates a scalar so this should be fine w.r.t. to memory
-  tensorflow::NamedTensorList input_tensors;
-  input_tensors.resize(input_sizes.size() + lp_tensors_.size());
+  if (batching_session_ != nullptr) {
+    // the jets were evaluated in acquire
+    if (n_jets > 0) {
+      fill_tags(*tag_infos, 0, n_jets, batch_outputs_, output_tags);
+    }
+  } else {
+    // either all jets or one per batch for the time being
+    const int64_t n_batch_jets = batch_eval_ ? n_jets : 1;
 
-  // add actual input tensors that hold physics information
-  for (std::size_t i = 0; i < input_sizes.size(); i++) {
-    input_tensors[i] =
-        tensorflow::NamedTensor(input_names_[i], tensorflow::Tensor(tensorflow::DT_FLOAT, input_sizes.at(i)));
-  }
+    std::vector<tensorflow::Tensor> inputs;
+    for (const auto& shape : input_shapes(n_batch_jets)) {
+      inputs.emplace_back(tensorflow::DT_FLOAT, shape);
+    }
 
-  // add learning-phase tensors behind them
-  for (std::size_t i = 0; i < lp_tensors_.size(); i++) {
-    input_tensors[input_sizes.size() + i] = tensorflow::NamedTensor(lp_names_[i], lp_tensors_[i]);
-  }
+    // create a list of named tensors, i.e. a vector of (string, Tensor) pairs, with proper size to
+    // prevent element copying that would occur via push_back's
+    // the tensors share their buffers with the inputs filled below
+    tensorflow::NamedTensorList input_tensors;
+    input_tensors.resize(inputs.size() + lp_tensors_.size());
 
-  std::size_t n_batches = n_jets / n_batch_jets;  // either 1 or n_jets
-  for (std::size_t batch_n = 0; batch_n < n_batches; batch_n++) {
-    // tensors have to be zeroed before filling per batch
-    for (std::size_t i = 0; i < input_sizes.size(); i++) {
-      input_tensors[i].second.flat<float>().setZero();
+    // add actual input tensors that hold physics information
+    for (std::size_t i = 0; i < inputs.size(); i++) {
+      input_tensors[i] = tensorflow::NamedTensor(input_names_[i], inputs[i]);
     }
 
-    // fill values of the input tensors
-    for (std::size_t jet_bn = 0; jet_bn < (std::size_t)n_batch_jets; jet_bn++) {
-      // global jet index (jet_bn is the jet batch index)
-      std::size_t jet_n = batch_n * n_batch_jets + jet_bn;
-
-      // jet and other global features
-      const auto& features = tag_infos->at(jet_n).features();
-      jet_tensor_filler(input_tensors.at(kGlobal).second, jet_bn, features);
-
-      // c_pf candidates
-      auto max_c_pf_n =
-          std::min(features.c_pf_features.size(), (std::size_t)input_sizes.at(kChargedCandidates).dim_size(1));
-      for (std::size_t c_pf_n = 0; c_pf_n < max_c_pf_n; c_pf_n++) {
-        const auto& c_pf_features = features.c_pf_features.at(c_pf_n);
-        c_pf_tensor_filler(input_tensors.at(kChargedCandidates).second, jet_bn, c_pf_n, c_pf_features);
-      }
+    // add learning-phase tensors behind them
+    for (std::size_t i = 0; i < lp_tensors_.size(); i++) {
+      input_tensors[inputs.size() + i] = tensorflow::NamedTensor(lp_names_[i], lp_tensors_[i]);
+    }
 
-      // n_pf candidates
-      auto max_n_pf_n =
-          std::min(features.n_pf_features.size(), (std::size_t)input_sizes.at(kNeutralCandidates).dim_size(1));
-      for (std::size_t n_pf_n = 0; n_pf_n < max_n_pf_n; n_pf_n++) {
-        const auto& n_pf_features = features.n_pf_features.at(n_pf_n);
-        n_pf_tensor_filler(input_tensors.at(kNeutralCandidates).second, jet_bn, n_pf_n, n_pf_features);
-      }
+    std::size_t n_batches = n_jets / n_batch_jets;  // either 1 or n_jets
+    for (std::size_t batch_n = 0; batch_n < n_batches; batch_n++) {
+      fill_inputs(*tag_infos, batch_n * n_batch_jets, n_batch_jets, inputs);
 
-      // sv candidates
-      auto max_sv_n = std::min(features.sv_features.size(), (std::size_t)input_sizes.at(kVertices).dim_size(1));
-      for (std::size_t sv_n = 0; sv_n < max_sv_n; sv_n++) {
-        const auto& sv_features = features.sv_features.at(sv_n);
-        sv_tensor_filler(input_tensors.at(kVertices).second, jet_bn, sv_n, sv_features);
-      }
+      // run the session
+      std::vector<tensorflow::Tensor> outputs;
+      tensorflow::run(session_, input_tensors, output_names_, &outputs);
 
-      // last input: jet pt
-      input_tensors.at(kJetPt).second.matrix<float>()(jet_bn, 0) = features.jet_features.pt;
-    }
-
-    // run the session
-    std::vector<tensorflow::Tensor> outputs;
-    tensorflow::run(session_, input_tensors, output_names_, &outputs);
-
-    // set output values for flavour probs
-    for (std::size_t jet_bn = 0; jet_bn < (std::size_t)n_batch_jets; jet_bn++) {
-      // global jet index (jet_bn is the jet batch index)
-      std::size_t jet_n = batch_n * n_batch_jets + jet_bn;
-
-      const auto& jet_ref = tag_infos->at(jet_n).jet();
-      for (std::size_t flav_n = 0; flav_n < flav_pairs_.size(); flav_n++) {
-        const auto& flav_pair = flav_pairs_.at(flav_n);
-        float o_sum = 0.;
-        for (const unsigned int& ind : flav_pair.second) {
-          o_sum += outputs.at(kJetFlavour).matrix<float>()(jet_bn, ind);
-        }
-        (*(output_tags.at(flav_n)))[jet_ref] = o_sum;
-      }
+      fill_tags(*tag_infos, batch_n * n_batch_jets, n_batch_jets, outputs, output_tags);
     }
   }
 
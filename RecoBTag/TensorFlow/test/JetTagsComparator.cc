@@ -0,0 +1,97 @@
+// Compares the discriminators of two sets of JetTagCollections of the same jets, e.g. those of a tagger
+// evaluated with different batching options, and fails if they differ by more than the tolerance.
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/EDGetToken.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/BTauReco/interface/JetTag.h"
+
+#include <cmath>
+#include <vector>
+
+class JetTagsComparator : public edm::one::EDAnalyzer<> {
+public:
+  explicit JetTagsComparator(const edm::ParameterSet&);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+private:
+  void analyze(const edm::Event&, const edm::EventSetup&) override;
+  void endJob() override;
+
+  const std::vector<edm::InputTag> referenceTags_;
+  const std::vector<edm::InputTag> testTags_;
+  const double tolerance_;
+  std::vector<edm::EDGetTokenT<reco::JetTagCollection>> referenceTokens_;
+  std::vector<edm::EDGetTokenT<reco::JetTagCollection>> testTokens_;
+
+  unsigned long long nTags_ = 0;
+  unsigned long long nDifferent_ = 0;
+  double maxDifference_ = 0.;
+};
+
+JetTagsComparator::JetTagsComparator(const edm::ParameterSet& iConfig)
+    : referenceTags_(iConfig.getParameter<std::vector<edm::InputTag>>("reference")),
+      testTags_(iConfig.getParameter<std::vector<edm::InputTag>>("test")),
+      tolerance_(iConfig.getParameter<double>("tolerance")) {
+  if (referenceTags_.size() != testTags_.size()) {
+    throw cms::Exception("Configuration") << "JetTagsComparator: " << referenceTags_.size() << " reference and "
+                                          << testTags_.size() << " test collections";
+  }
+  for (const auto& tag : referenceTags_)
+    referenceTokens_.push_back(consumes<reco::JetTagCollection>(tag));
+  for (const auto& tag : testTags_)
+    testTokens_.push_back(consumes<reco::JetTagCollection>(tag));
+}
+
+void JetTagsComparator::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<std::vector<edm::InputTag>>("reference", {});
+  desc.add<std::vector<edm::InputTag>>("test", {});
+  // absolute difference allowed between the discriminators of a jet
+  desc.add<double>("tolerance", 0.);
+  descriptions.add("jetTagsComparator", desc);
+}
+
+void JetTagsComparator::analyze(const edm::Event& iEvent, const edm::EventSetup&) {
+  for (std::size_t c = 0; c < referenceTokens_.size(); ++c) {
+    const auto& reference = iEvent.get(referenceTokens_[c]);
+    const auto& test = iEvent.get(testTokens_[c]);
+    if (reference.size() != test.size()) {
+      throw cms::Exception("JetTagsMismatch")
+          << referenceTags_[c].encode() << " has " << reference.size() << " jets, " << testTags_[c].encode()
+          << " has " << test.size() << " in event " << iEvent.id();
+    }
+    for (reco::JetTagCollection::size_type i = 0; i < reference.size(); ++i) {
+      if (reference[i].first.key() != test[i].first.key()) {
+        throw cms::Exception("JetTagsMismatch") << "jet " << i << " of " << referenceTags_[c].encode() << " and "
+                                                << testTags_[c].encode() << " differ in event " << iEvent.id();
+      }
+      const double difference = std::abs(double(reference[i].second) - double(test[i].second));
+      ++nTags_;
+      if (difference > 0.)
+        ++nDifferent_;
+      if (difference > maxDifference_)
+        maxDifference_ = difference;
+      if (not(difference <= tolerance_)) {
+        throw cms::Exception("JetTagsMismatch")
+            << "jet " << i << ": " << referenceTags_[c].encode() << " = " << reference[i].second << ", "
+            << testTags_[c].encode() << " = " << test[i].second << " in event " << iEvent.id();
+      }
+    }
+  }
+}
+
+void JetTagsComparator::endJob() {
+  edm::LogInfo("JetTagsComparator") << nDifferent_ << " of " << nTags_
+                                    << " discriminators differ, by at most " << maxDifference_;
+}
+
+DEFINE_FWK_MODULE(JetTagsComparator);
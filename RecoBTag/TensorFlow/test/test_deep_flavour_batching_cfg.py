@@ -0,0 +1,70 @@
+import FWCore.ParameterSet.Config as cms
+from PhysicsTools.PatAlgos.tools.helpers import getPatAlgosToolsTask
+
+# Compare the DeepFlavour discriminators of the jets evaluated one by one, all those of an event
+# together (batch_eval) and those of concurrent events together (batch_size), on MINIAOD with
+# several streams so that the batches mix the jets of different events:
+#   cmsRun test_deep_flavour_batching_cfg.py
+# The job fails if a discriminator differs by more than the tolerance, and the JetTagsComparator
+# summary gives the number of those that differ and the largest difference.
+
+process = cms.Process("BATCHING")
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.MessageLogger.cerr.FwkReport.reportEvery = 10
+process.MessageLogger.categories.append("JetTagsComparator")
+process.MessageLogger.cerr.JetTagsComparator = cms.untracked.PSet( limit = cms.untracked.int32(-1) )
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(4)
+)
+
+process.load("Configuration.Geometry.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_mc')
+process.load("Configuration.StandardSequences.MagneticField_cff")
+
+from PhysicsTools.PatAlgos.patInputFiles_cff import filesRelValTTbarPileUpMINIAODSIM
+process.source = cms.Source("PoolSource",
+    fileNames = filesRelValTTbarPileUpMINIAODSIM
+)
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(100) )
+
+from PhysicsTools.PatAlgos.tools.jetTools import updateJetCollection
+
+updateJetCollection(
+   process,
+   jetSource = cms.InputTag('slimmedJets'),
+   pvSource = cms.InputTag('offlineSlimmedPrimaryVertices'),
+   svSource = cms.InputTag('slimmedSecondaryVertices'),
+   jetCorrections = ('AK4PFchs', cms.vstring(['L1FastJet', 'L2Relative', 'L3Absolute']), 'None'),
+   btagDiscriminators = ['pfDeepFlavourJetTags:probb']
+   )
+
+patAlgosToolsTask = getPatAlgosToolsTask(process)
+
+# the jets one by one, the jets of an event together, and the jets of concurrent events together
+process.pfDeepFlavourJetTagsBatchEval = process.pfDeepFlavourJetTags.clone( batch_eval = True )
+process.pfDeepFlavourJetTagsBatchSize = process.pfDeepFlavourJetTags.clone( batch_eval = True, batch_size = 64 )
+patAlgosToolsTask.add(process.pfDeepFlavourJetTagsBatchEval, process.pfDeepFlavourJetTagsBatchSize)
+
+# the batches of different sizes may round differently, so the discriminators are compared within
+# a tolerance rather than bit by bit
+flavours = ['probb', 'probbb', 'problepb', 'probc', 'probuds', 'probg']
+def tags(label):
+    return cms.VInputTag([cms.InputTag(label, flavour) for flavour in flavours])
+
+process.compareBatchEval = cms.EDAnalyzer("JetTagsComparator",
+    reference = tags('pfDeepFlavourJetTags'),
+    test = tags('pfDeepFlavourJetTagsBatchEval'),
+    tolerance = cms.double(1e-5)
+)
+process.compareBatchSize = cms.EDAnalyzer("JetTagsComparator",
+    reference = tags('pfDeepFlavourJetTagsBatchEval'),
+    test = tags('pfDeepFlavourJetTagsBatchSize'),
+    tolerance = cms.double(1e-5)
+)
+
+process.p = cms.Path(process.compareBatchEval + process.compareBatchSize, patAlgosToolsTask)
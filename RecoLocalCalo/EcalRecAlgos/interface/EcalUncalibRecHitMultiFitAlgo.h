@@ -12,7 +12,10 @@
 
 #include "CondFormats/EcalObjects/interface/EcalPedestals.h"
 #include "CondFormats/EcalObjects/interface/EcalGainRatios.h"
+#include "CondFormats/EcalObjects/interface/EcalPulseShapes.h"
+#include "CondFormats/EcalObjects/interface/EcalPulseCovariances.h"
 #include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLS.h"
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
 
 #include "TMatrixDSym.h"
 #include "TVectorD.h"
@@ -28,6 +31,20 @@ public:
                                     const FullSampleVector &fullpulse,
                                     const FullSampleMatrix &fullpulsecov,
                                     const BXVector &activeBX);
+
+  // Batched version of makeRecHit(): the crystals added after beginRecHits() are fitted together by
+  // makeRecHits(), which returns their rechits in the order in which they were added.  The crystals
+  // that PulseChiSqSNNLSBatch can not fit (gain switch, dynamic pedestals, no in-time pulse) or
+  // that pass the prefit are reconstructed one by one when they are added.
+  // "noisecors" must be valid until makeRecHits() returns.
+  void beginRecHits(const SampleMatrixGainArray &noisecors, const BXVector &activeBX);
+  void addRecHit(const EcalDataFrame &dataFrame,
+                 const EcalPedestals::Item *aped,
+                 const EcalMGPAGainRatio *aGain,
+                 const EcalPulseShapes::Item *aPulse,
+                 const EcalPulseCovariances::Item *aPulseCov);
+  void makeRecHits(std::vector<EcalUncalibratedRecHit> &rechits);
+
   void disableErrorCalculation() { _computeErrors = false; }
   void setDoPrefit(bool b) { _doPrefit = b; }
   void setPrefitMaxChiSq(double x) { _prefitMaxChiSq = x; }
@@ -39,6 +56,22 @@ public:
   void setGainSwitchUseMaxSample(bool b) { _gainSwitchUseMaxSample = b; }
 
 private:
+  // samples of a crystal, converted to gain 12 ADC counts above pedestal
+  struct Samples {
+    SampleVector amplitudes;
+    SampleGainVector gainsNoise;
+    SampleGainVector gainsPedestal;
+    double maxamplitude;
+    double pedval;
+    bool hasGainSwitch;
+    bool dynamicPedestal;
+  };
+  void fillSamples(const EcalDataFrame &dataFrame,
+                   const EcalPedestals::Item *aped,
+                   const EcalMGPAGainRatio *aGain,
+                   Samples &samples) const;
+  void fillFullPulse(const EcalPulseShapes::Item *aPulse, const EcalPulseCovariances::Item *aPulseCov);
+
   PulseChiSqSNNLS _pulsefunc;
   PulseChiSqSNNLS _pulsefuncSingle;
   bool _computeErrors;
@@ -51,6 +84,15 @@ private:
   bool _simplifiedNoiseModelForGainSwitch;
   bool _gainSwitchUseMaxSample;
   BXVector _singlebx;
+
+  // batched fit
+  PulseChiSqSNNLSBatch _batch;
+  const SampleMatrixGainArray *_noisecors;
+  bool _batchable;  // false if the active BXs have no in-time pulse
+  std::vector<EcalUncalibratedRecHit> _rechits;
+  std::vector<int> _batchindex;  // index of the crystal in the batch, -1 if already reconstructed
+  FullSampleVector _fullpulse;
+  FullSampleMatrix _fullpulsecov;
 };
 
 #endif
@@ -0,0 +1,147 @@
+#ifndef PulseChiSqSNNLSBatch_h
+#define PulseChiSqSNNLSBatch_h
+
+#define EIGEN_NO_DEBUG  // kill throws in eigen code
+#include "RecoLocalCalo/EcalRecAlgos/interface/EigenMatrixTypes.h"
+#include "CondFormats/EcalObjects/interface/EcalPulseShapes.h"
+#include "CondFormats/EcalObjects/interface/EcalPulseCovariances.h"
+
+#include <vector>
+
+//
+// Multifit of many crystals at once.
+//
+// The crystals of a group are fitted with the same in- and out-of-time
+// pulses, without dynamic pedestals nor bad sample corrections, "lanes" at a
+// time.  The samples, noise and pulse covariance matrices of the crystals
+// being fitted are stored structure-of-arrays, with the lane as the innermost
+// index, and all the linear algebra is done for all the lanes together in
+// loops over the lanes which the compiler vectorizes.  Each lane runs its own
+// iterations and takes the next crystal as soon as its fit is over.
+//
+// The noise covariance of a crystal is given as a scaled noise correlation
+// matrix of one of the gains, plus a fully correlated term, and the pulse
+// templates and covariances are read from the conditions: none of them is
+// built as a matrix for each crystal.
+//
+// The algorithm is the one of PulseChiSqSNNLS::DoFit(), including the
+// calculation of the uncertainty of the in-time amplitude.  The NNLS
+// subproblems are solved with an LDLT decomposition without pivoting, so
+// that the results differ from those of PulseChiSqSNNLS only by the
+// rounding of the linear algebra: the amplitudes agree within a relative
+// difference of 1e-5 (or 1e-5 ADC counts for amplitudes below 1 ADC count).
+//
+class PulseChiSqSNNLSBatch {
+public:
+  static constexpr unsigned int lanes = 8;
+
+  PulseChiSqSNNLSBatch();
+
+  void disableErrorCalculation() { _computeErrors = false; }
+  void setMaxIters(int n) { _maxiters = n; }
+
+  // Start a new group of crystals, fitted with the pulses "bxs"
+  void reset(const BXVector &bxs, const SampleMatrixGainArray &noisecors);
+
+  // Queue a crystal, with the noise covariance
+  //   noiseScale * noisecors[noiseGain] + noiseOffset * SampleMatrix::Ones()
+  // The pulse shape and covariance must be valid until minimize() returns.
+  // Returns the index of the crystal in the group.
+  unsigned int add(const SampleVector &samples,
+                   int noiseGain,
+                   double noiseScale,
+                   double noiseOffset,
+                   const EcalPulseShape &pulse,
+                   const EcalPulseCovariance &pulseCov);
+
+  unsigned int size() const { return _ncrystals; }
+  const BXVector &BXs() const { return _bxs; }
+
+  // Fit all the crystals of the group
+  void minimize();
+
+  // Results, with the pulses in the order of BXs()
+  const PulseVector &X(unsigned int crystal) const { return _crystals[crystal].ampvec; }
+  double ChiSq(unsigned int crystal) const { return _crystals[crystal].chisq; }
+  double InTimeError(unsigned int crystal) const { return _crystals[crystal].err; }
+
+private:
+  static constexpr int nsamples = SampleVector::RowsAtCompileTime;
+  static constexpr int ntemplate = EcalPulseShape::TEMPLATESAMPLES;
+
+  struct Crystal {
+    SampleVector samples;
+    int noiseGain;
+    double noiseScale;
+    double noiseOffset;
+    const EcalPulseShape *pulse;
+    const EcalPulseCovariance *pulseCov;
+
+    PulseVector ampvec;
+    double chisq;
+    double err;
+  };
+
+  typedef double LaneMask[lanes];  // 1 for the lanes to update, 0 otherwise
+
+  void load(unsigned int lane, unsigned int crystal);
+
+  void updateCov(const LaneMask &mask);
+  void solveL(const double (&in)[nsamples][lanes], double (&out)[nsamples][lanes], int first) const;
+  void computeChiSq(double (&chisq)[lanes]) const;
+  void solveSubmatrix(const unsigned int (&nP)[lanes], double (&solution)[PulseVectorSize][lanes]);
+  double computeApproxUncertainty(unsigned int lane) const;
+
+  bool _computeErrors;
+  int _maxiters;
+
+  BXVector _bxs;
+  unsigned int _npulse;
+  int _ipulseintime;  // -1 without an in-time pulse
+  int _offsets[PulseVectorSize];
+  int _firstsamples[PulseVectorSize];  // first sample of each pulse
+  SampleMatrixGainArray _noisecors;
+
+  unsigned int _ncrystals;
+  std::vector<Crystal> _crystals;
+
+  // inputs of the crystals in the lanes
+  int _crystal[lanes];
+  alignas(64) double _samples[nsamples][lanes];
+  alignas(64) double _sampvec[nsamples][lanes];  // samples minus the fixed in-time pulse
+  alignas(64) double _noisecov[nsamples][nsamples][lanes];
+  alignas(64) double _templatecov[ntemplate][ntemplate][lanes];
+  alignas(64) double _pulsemat[PulseVectorSize][nsamples][lanes];
+  alignas(64) double _pulseintime[nsamples][lanes];
+
+  // minimization
+  alignas(64) double _ampvec[PulseVectorSize][lanes];
+  alignas(64) double _covdecompL[nsamples][nsamples][lanes];  // Cholesky factor of the covariance, inverse diagonal
+  alignas(64) double _aTamat[PulseVectorSize][PulseVectorSize][lanes];
+  alignas(64) double _aTbvec[PulseVectorSize][lanes];
+  double _chisq[lanes];
+  int _iter[lanes];
+
+  // NNLS
+  unsigned int _order[PulseVectorSize][lanes];  // permutation of the pulses done by PulseChiSqSNNLS::NNLS()
+  unsigned int _nP[lanes];
+  int _iterNNLS[lanes];
+  unsigned int _idxwmax[lanes];
+  double _wmax[lanes];
+  double _threshold[lanes];
+
+  // uncertainty of the in-time amplitude
+  double _chisq0[lanes];
+  double _x0[lanes];
+  double _approxerr[lanes];
+  double _sigmaplus[lanes];
+
+  // work
+  alignas(64) double _cov[nsamples][nsamples][lanes];
+  alignas(64) double _invcovp[PulseVectorSize][nsamples][lanes];
+  alignas(64) double _invcovy[nsamples][lanes];
+  alignas(64) double _ldlL[PulseVectorSize][PulseVectorSize][lanes];  // L * D
+  alignas(64) double _ldlD[PulseVectorSize][lanes];                   // 1 / D
+};
+
+#endif
@@ -14,7 +14,11 @@ EcalUncalibRecHitMultiFitAlgo::EcalUncalibRecHitMultiFitAlgo()
       _selectiveBadSampleCriteria(false),
       _addPedestalUncertainty(0.),
       _simplifiedNoiseModelForGainSwitch(true),
-      _gainSwitchUseMaxSample(false) {
+      _gainSwitchUseMaxSample(false),
+      _noisecors(nullptr),
+      _batchable(false),
+      _fullpulse(FullSampleVector::Zero()),
+      _fullpulsecov(FullSampleMatrix::Zero()) {
   _singlebx.resize(1);
   _singlebx << 0;
 
@@ -23,34 +27,27 @@ EcalUncalibRecHitMultiFitAlgo::EcalUncalibRecHitMultiFitAlgo()
   _pulsefuncSingle.setMaxIterWarnings(false);
 }
 
-/// compute rechits
-EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataFrame &dataFrame,
-                                                                 const EcalPedestals::Item *aped,
-                                                                 const EcalMGPAGainRatio *aGain,
-                                                                 const SampleMatrixGainArray &noisecors,
-                                                                 const FullSampleVector &fullpulse,
-                                                                 const FullSampleMatrix &fullpulsecov,
-                                                                 const BXVector &activeBX) {
-  uint32_t flags = 0;
-
+void EcalUncalibRecHitMultiFitAlgo::fillSamples(const EcalDataFrame &dataFrame,
+                                                const EcalPedestals::Item *aped,
+                                                const EcalMGPAGainRatio *aGain,
+                                                Samples &samples) const {
   const unsigned int nsample = EcalDataFrame::MAXSAMPLES;
-
-  double maxamplitude = -std::numeric_limits<double>::max();
   const unsigned int iSampleMax = 5;
-  const unsigned int iFullPulseMax = 9;
-
-  double pedval = 0.;
 
-  SampleVector amplitudes;
-  SampleGainVector gainsNoise;
-  SampleGainVector gainsPedestal;
-  SampleGainVector badSamples = SampleGainVector::Zero();
+  SampleVector &amplitudes = samples.amplitudes;
+  SampleGainVector &gainsNoise = samples.gainsNoise;
+  SampleGainVector &gainsPedestal = samples.gainsPedestal;
   bool hasSaturation = dataFrame.isSaturated();
   bool hasGainSwitch = hasSaturation || dataFrame.hasSwitchToGain6() || dataFrame.hasSwitchToGain1();
 
   //no dynamic pedestal in case of gain switch, since then the fit becomes too underconstrained
   bool dynamicPedestal = _dynamicPedestals && !hasGainSwitch;
 
+  samples.maxamplitude = -std::numeric_limits<double>::max();
+  samples.pedval = 0.;
+  samples.hasGainSwitch = hasGainSwitch;
+  samples.dynamicPedestal = dynamicPedestal;
+
   for (unsigned int iSample = 0; iSample < nsample; iSample++) {
     const EcalMGPASample &sample = dataFrame.sample(iSample);
 
@@ -97,10 +94,35 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
     amplitudes[iSample] = amplitude;
 
     if (iSample == iSampleMax) {
-      maxamplitude = amplitude;
-      pedval = pedestal;
+      samples.maxamplitude = amplitude;
+      samples.pedval = pedestal;
     }
   }
+}
+
+/// compute rechits
+EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataFrame &dataFrame,
+                                                                 const EcalPedestals::Item *aped,
+                                                                 const EcalMGPAGainRatio *aGain,
+                                                                 const SampleMatrixGainArray &noisecors,
+                                                                 const FullSampleVector &fullpulse,
+                                                                 const FullSampleMatrix &fullpulsecov,
+                                                                 const BXVector &activeBX) {
+  uint32_t flags = 0;
+
+  const unsigned int iSampleMax = 5;
+  const unsigned int iFullPulseMax = 9;
+
+  Samples samples;
+  fillSamples(dataFrame, aped, aGain, samples);
+  const SampleVector &amplitudes = samples.amplitudes;
+  const SampleGainVector &gainsNoise = samples.gainsNoise;
+  const SampleGainVector &gainsPedestal = samples.gainsPedestal;
+  SampleGainVector badSamples = SampleGainVector::Zero();
+  const double maxamplitude = samples.maxamplitude;
+  const double pedval = samples.pedval;
+  const bool hasGainSwitch = samples.hasGainSwitch;
+  const bool dynamicPedestal = samples.dynamicPedestal;
 
   double amplitude, amperr, chisq;
   bool status = false;
@@ -223,3 +245,99 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
 
   return rh;
 }
+
+void EcalUncalibRecHitMultiFitAlgo::fillFullPulse(const EcalPulseShapes::Item *aPulse,
+                                                  const EcalPulseCovariances::Item *aPulseCov) {
+  for (int i = 0; i < EcalPulseShape::TEMPLATESAMPLES; ++i)
+    _fullpulse(i + 7) = aPulse->pdfval[i];
+
+  for (int i = 0; i < EcalPulseShape::TEMPLATESAMPLES; i++)
+    for (int j = 0; j < EcalPulseShape::TEMPLATESAMPLES; j++)
+      _fullpulsecov(i + 7, j + 7) = aPulseCov->covval[i][j];
+}
+
+void EcalUncalibRecHitMultiFitAlgo::beginRecHits(const SampleMatrixGainArray &noisecors, const BXVector &activeBX) {
+  _noisecors = &noisecors;
+  _batchable = false;
+  for (unsigned int ipulse = 0; ipulse < activeBX.rows(); ++ipulse) {
+    if (activeBX.coeff(ipulse) == 0) {
+      _batchable = true;
+      break;
+    }
+  }
+
+  if (!_computeErrors)
+    _batch.disableErrorCalculation();
+  _batch.reset(activeBX, noisecors);
+  _rechits.clear();
+  _batchindex.clear();
+}
+
+void EcalUncalibRecHitMultiFitAlgo::addRecHit(const EcalDataFrame &dataFrame,
+                                              const EcalPedestals::Item *aped,
+                                              const EcalMGPAGainRatio *aGain,
+                                              const EcalPulseShapes::Item *aPulse,
+                                              const EcalPulseCovariances::Item *aPulseCov) {
+  Samples samples;
+  fillSamples(dataFrame, aped, aGain, samples);
+
+  if (!_batchable || samples.hasGainSwitch || samples.dynamicPedestal) {
+    fillFullPulse(aPulse, aPulseCov);
+    _rechits.push_back(makeRecHit(dataFrame, aped, aGain, *_noisecors, _fullpulse, _fullpulsecov, _batch.BXs()));
+    _batchindex.push_back(-1);
+    return;
+  }
+
+  //same noise covariance as in makeRecHit() without gain switch
+  const double noiseScale = aped->rms_x12 * aped->rms_x12;
+  const double noiseOffset = _addPedestalUncertainty > 0. ? _addPedestalUncertainty * _addPedestalUncertainty : 0.;
+
+  if (_doPrefit) {
+    fillFullPulse(aPulse, aPulseCov);
+    SampleMatrix noisecov = noiseScale * (*_noisecors)[0];
+    if (noiseOffset > 0.)
+      noisecov += noiseOffset * SampleMatrix::Ones();
+    bool status = _pulsefuncSingle.DoFit(samples.amplitudes,
+                                         noisecov,
+                                         _singlebx,
+                                         _fullpulse,
+                                         _fullpulsecov,
+                                         samples.gainsPedestal,
+                                         SampleGainVector::Zero());
+    double chisq = _pulsefuncSingle.ChiSq();
+    if (chisq < _prefitMaxChiSq) {
+      _rechits.emplace_back(dataFrame.id(), status ? _pulsefuncSingle.X()[0] : 0., samples.pedval, 0., chisq);
+      _rechits.back().setAmplitudeError(status ? _pulsefuncSingle.Errors()[0] : 0.);
+      _batchindex.push_back(-1);
+      return;
+    }
+  }
+
+  _rechits.emplace_back(dataFrame.id(), 0., samples.pedval, 0., 0.);
+  _batchindex.push_back(_batch.add(samples.amplitudes, 0, noiseScale, noiseOffset, *aPulse, *aPulseCov));
+}
+
+void EcalUncalibRecHitMultiFitAlgo::makeRecHits(std::vector<EcalUncalibratedRecHit> &rechits) {
+  _batch.minimize();
+
+  const BXVector &bxs = _batch.BXs();
+  for (unsigned int i = 0; i < _rechits.size(); ++i) {
+    if (_batchindex[i] < 0)
+      continue;
+
+    const PulseVector &x = _batch.X(_batchindex[i]);
+    EcalUncalibratedRecHit &rh = _rechits[i];
+    rh.setChi2(_batch.ChiSq(_batchindex[i]));
+    rh.setAmplitudeError(_batch.InTimeError(_batchindex[i]));
+    for (unsigned int ipulse = 0; ipulse < bxs.rows(); ++ipulse) {
+      int bx = bxs.coeff(ipulse);
+      if (bx == 0) {
+        rh.setAmplitude(x.coeff(ipulse));
+      } else if (std::abs(bx) < 100) {
+        rh.setOutOfTimeAmplitude(bx + 5, x.coeff(ipulse));
+      }
+    }
+  }
+
+  rechits.swap(_rechits);
+}
@@ -0,0 +1,548 @@
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+PulseChiSqSNNLSBatch::PulseChiSqSNNLSBatch()
+    : _computeErrors(true), _maxiters(50), _npulse(0), _ipulseintime(-1), _ncrystals(0) {}
+
+void PulseChiSqSNNLSBatch::reset(const BXVector &bxs, const SampleMatrixGainArray &noisecors) {
+  _bxs = bxs;
+  _npulse = bxs.rows();
+  _ipulseintime = -1;
+  for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse) {
+    const int bx = _bxs.coeff(ipulse);
+    _offsets[ipulse] = 7 - 3 - bx;
+    _firstsamples[ipulse] = std::max(0, bx + 3);
+    if (bx == 0 && _ipulseintime < 0)
+      _ipulseintime = ipulse;
+  }
+  _noisecors = noisecors;
+  _ncrystals = 0;
+}
+
+unsigned int PulseChiSqSNNLSBatch::add(const SampleVector &samples,
+                                       const int noiseGain,
+                                       const double noiseScale,
+                                       const double noiseOffset,
+                                       const EcalPulseShape &pulse,
+                                       const EcalPulseCovariance &pulseCov) {
+  // the crystals are kept between the groups, to reuse their memory
+  if (_ncrystals == _crystals.size())
+    _crystals.emplace_back();
+  Crystal &crystal = _crystals[_ncrystals];
+
+  crystal.samples = samples;
+  crystal.noiseGain = noiseGain;
+  crystal.noiseScale = noiseScale;
+  crystal.noiseOffset = noiseOffset;
+  crystal.pulse = &pulse;
+  crystal.pulseCov = &pulseCov;
+  crystal.err = 0.;
+
+  return _ncrystals++;
+}
+
+void PulseChiSqSNNLSBatch::load(unsigned int lane, unsigned int icrystal) {
+  const Crystal &crystal = _crystals[icrystal];
+
+  const SampleMatrix &noisecor = _noisecors[crystal.noiseGain];
+  for (int i = 0; i < nsamples; ++i) {
+    _samples[i][lane] = crystal.samples.coeff(i);
+    _sampvec[i][lane] = crystal.samples.coeff(i);
+    for (int j = 0; j < nsamples; ++j)
+      _noisecov[i][j][lane] = crystal.noiseScale * noisecor.coeff(i, j) + crystal.noiseOffset;
+  }
+
+  for (int i = 0; i < ntemplate; ++i)
+    for (int j = 0; j < ntemplate; ++j)
+      _templatecov[i][j][lane] = crystal.pulseCov->covval[i][j];
+
+  //the full pulse template starts at sample 7
+  for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse) {
+    _ampvec[ipulse][lane] = 0.;
+    for (int i = 0; i < nsamples; ++i) {
+      const int itemplate = i + _offsets[ipulse] - 7;
+      _pulsemat[ipulse][i][lane] = itemplate >= 0 && itemplate < ntemplate ? crystal.pulse->pdfval[itemplate] : 0.;
+    }
+  }
+
+  if (_npulse == 1)
+    _ampvec[0][lane] = crystal.samples.coeff(_bxs.coeff(0) + 5);
+}
+
+//
+// Each lane goes through the steps of PulseChiSqSNNLS::Minimize() and
+// PulseChiSqSNNLS::NNLS() for its own crystal: at each round, every step is
+// done at once for all the lanes which are at this step.  With the error
+// calculation, the minimization is then repeated with the in-time amplitude
+// fixed above and below its fitted value, as in PulseChiSqSNNLS::DoFit().
+//
+void PulseChiSqSNNLSBatch::minimize() {
+  enum State { idle, covariance, select, solve, chiSquare };
+  enum Phase { fit, errorPlus, errorMinus };
+
+  if (_ncrystals == 0)
+    return;
+
+  State state[lanes];
+  Phase phase[lanes];
+  unsigned int nextCrystal = 0;
+  unsigned int nBusy = 0;
+
+  auto startMinimize = [&](unsigned int l) {
+    _iter[l] = 0;
+    state[l] = covariance;
+  };
+
+  auto fixInTimeAmplitude = [&](unsigned int l, double x) {
+    _ampvec[_ipulseintime][l] = x;
+    for (int i = 0; i < nsamples; ++i)
+      _sampvec[i][l] = _samples[i][l] - x * _pulseintime[i][l];
+  };
+
+  auto startFit = [&](unsigned int l) {
+    while (nextCrystal < _ncrystals) {
+      _crystal[l] = nextCrystal;
+      load(l, nextCrystal++);
+      for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse)
+        _order[ipulse][l] = ipulse;
+      _nP[l] = 0;
+      _chisq[l] = 0.;
+      phase[l] = fit;
+      if (_maxiters > 0) {
+        startMinimize(l);
+        return;
+      }
+      Crystal &crystal = _crystals[_crystal[l]];
+      crystal.ampvec.resize(_npulse);
+      for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse)
+        crystal.ampvec.coeffRef(ipulse) = _ampvec[ipulse][l];
+      crystal.chisq = 0.;
+    }
+    state[l] = idle;
+    _crystal[l] = -1;
+    --nBusy;
+  };
+
+  // end of a call of PulseChiSqSNNLS::Minimize()
+  auto endMinimize = [&](unsigned int l) {
+    Crystal &crystal = _crystals[_crystal[l]];
+
+    if (phase[l] == fit) {
+      crystal.ampvec.resize(_npulse);
+      for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse)
+        crystal.ampvec.coeffRef(ipulse) = _ampvec[ipulse][l];
+      crystal.chisq = _chisq[l];
+
+      if (!_computeErrors || _ipulseintime < 0) {
+        startFit(l);
+        return;
+      }
+
+      //compute MINOS-like uncertainties for in-time amplitude
+      _approxerr[l] = computeApproxUncertainty(l);
+      _chisq0[l] = _chisq[l];
+      _x0[l] = _ampvec[_ipulseintime][l];
+
+      //move in time pulse first to active set if necessary
+      for (unsigned int ipos = 0; ipos < _nP[l]; ++ipos) {
+        if (_order[ipos][l] == static_cast<unsigned int>(_ipulseintime)) {
+          std::swap(_order[ipos][l], _order[_nP[l] - 1][l]);
+          --_nP[l];
+          break;
+        }
+      }
+
+      for (int i = 0; i < nsamples; ++i) {
+        _pulseintime[i][l] = _pulsemat[_ipulseintime][i][l];
+        _pulsemat[_ipulseintime][i][l] = 0.;
+      }
+
+      //two point interpolation for upper uncertainty when amplitude is away from boundary
+      fixInTimeAmplitude(l, _x0[l] + _approxerr[l]);
+      phase[l] = errorPlus;
+      startMinimize(l);
+      return;
+    }
+
+    const double x = _ampvec[_ipulseintime][l];
+    const double sigma = std::abs(x - _x0[l]) / std::sqrt(_chisq[l] - _chisq0[l]);
+
+    if (phase[l] == errorPlus) {
+      //if amplitude is sufficiently far from the boundary, compute also the lower uncertainty and average them
+      _sigmaplus[l] = sigma;
+      if ((_x0[l] / sigma) > 0.5) {
+        fixInTimeAmplitude(l, std::max(0., _x0[l] - _approxerr[l]));
+        phase[l] = errorMinus;
+        startMinimize(l);
+        return;
+      }
+      crystal.err = sigma;
+    } else {
+      crystal.err = 0.5 * (_sigmaplus[l] + sigma);
+    }
+    startFit(l);
+  };
+
+  auto endNNLSIteration = [&](unsigned int l) {
+    ++_iterNNLS[l];
+
+    //adaptive convergence threshold to avoid infinite loops but still
+    //ensure best value is used
+    if (_iterNNLS[l] % 16 == 0) {
+      _threshold[l] *= 2;
+    }
+    state[l] = select;
+  };
+
+  for (unsigned int l = 0; l < lanes; ++l) {
+    // the idle lanes hold a copy of the first crystal, so that they compute valid numbers
+    if (l >= _ncrystals)
+      load(l, 0);
+    ++nBusy;
+    startFit(l);
+  }
+
+  const unsigned int nMaxP = std::min(_npulse, static_cast<unsigned int>(nsamples));
+  double updatework[PulseVectorSize][lanes];
+  double ampvecpermtest[PulseVectorSize][lanes];
+  double chisqnow[lanes];
+
+  while (nBusy > 0) {
+    // new iteration of the minimization: update of the covariance matrix and of the normal equations,
+    // also done for the idle lanes to keep valid numbers in them. The lanes wait for this step until
+    // three quarters of them need it, or until the others have nothing else to do.
+    LaneMask mask;
+    unsigned int nWaiting = 0;
+    unsigned int nNNLS = 0;
+    for (unsigned int l = 0; l < lanes; ++l) {
+      nWaiting += state[l] == covariance;
+      nNNLS += state[l] == select || state[l] == solve;
+      mask[l] = state[l] == covariance || state[l] == idle ? 1. : 0.;
+    }
+    bool any = nWaiting > 0 && (nNNLS == 0 || 4 * nWaiting >= 3 * lanes);
+    if (any) {
+      updateCov(mask);
+
+      for (unsigned int l = 0; l < lanes; ++l) {
+        if (state[l] != covariance)
+          continue;
+        if (_npulse > 1) {
+          _iterNNLS[l] = 0;
+          _idxwmax[l] = 0;
+          _wmax[l] = 0.;
+          _threshold[l] = 1e-11;
+          //can only perform the selection step if solution is guaranteed viable
+          state[l] = _nP[l] == 0 ? select : solve;
+        } else {
+          //special case for one pulse fit
+          _ampvec[0][l] = std::max(0., _aTbvec[0][l] / _aTamat[0][0][l]);
+          state[l] = chiSquare;
+        }
+      }
+    }
+
+    // NNLS: choice of the pulse to unconstrain
+    any = false;
+    for (unsigned int l = 0; l < lanes; ++l)
+      any |= state[l] == select;
+    if (any) {
+      for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse) {
+        for (unsigned int l = 0; l < lanes; ++l)
+          updatework[ipulse][l] = _aTbvec[ipulse][l];
+        for (unsigned int jpulse = 0; jpulse < _npulse; ++jpulse)
+          for (unsigned int l = 0; l < lanes; ++l)
+            updatework[ipulse][l] -= _aTamat[ipulse][jpulse][l] * _ampvec[jpulse][l];
+      }
+
+      for (unsigned int l = 0; l < lanes; ++l) {
+        if (state[l] != select)
+          continue;
+
+        if (_nP[l] == nMaxP) {
+          state[l] = chiSquare;
+          continue;
+        }
+
+        // the first maximum among the constrained pulses, in the order of PulseChiSqSNNLS
+        const unsigned int idxwmaxprev = _idxwmax[l];
+        const double wmaxprev = _wmax[l];
+        _idxwmax[l] = 0;
+        _wmax[l] = updatework[_order[_nP[l]][l]][l];
+        for (unsigned int ipos = _nP[l] + 1; ipos < _npulse; ++ipos) {
+          const double w = updatework[_order[ipos][l]][l];
+          if (w > _wmax[l]) {
+            _wmax[l] = w;
+            _idxwmax[l] = ipos - _nP[l];
+          }
+        }
+
+        //convergence, and worst case protection
+        if (_wmax[l] < _threshold[l] || (_idxwmax[l] == idxwmaxprev && _wmax[l] == wmaxprev) ||
+            _iterNNLS[l] >= 500) {
+          state[l] = chiSquare;
+          continue;
+        }
+
+        //unconstrain parameter
+        std::swap(_order[_nP[l]][l], _order[_nP[l] + _idxwmax[l]][l]);
+        ++_nP[l];
+        state[l] = solve;
+      }
+    }
+
+    // NNLS: solution of the unconstrained problem
+    unsigned int nPSolve[lanes];
+    any = false;
+    for (unsigned int l = 0; l < lanes; ++l) {
+      nPSolve[l] = state[l] == solve ? _nP[l] : 0;
+      any |= state[l] == solve;
+    }
+    if (any) {
+      solveSubmatrix(nPSolve, ampvecpermtest);
+
+      for (unsigned int l = 0; l < lanes; ++l) {
+        if (state[l] != solve)
+          continue;
+
+        //check solution
+        bool positive = true;
+        for (unsigned int ipos = 0; ipos < _nP[l]; ++ipos)
+          positive &= (ampvecpermtest[ipos][l] > 0);
+        if (positive) {
+          for (unsigned int ipos = 0; ipos < _nP[l]; ++ipos)
+            _ampvec[_order[ipos][l]][l] = ampvecpermtest[ipos][l];
+          endNNLSIteration(l);
+          continue;
+        }
+
+        //update parameter vector
+        unsigned int minratiopos = 0;
+        double minratio = std::numeric_limits<double>::max();
+        for (unsigned int ipos = 0; ipos < _nP[l]; ++ipos) {
+          if (ampvecpermtest[ipos][l] <= 0.) {
+            const double c_ampvec = _ampvec[_order[ipos][l]][l];
+            const double ratio = c_ampvec / (c_ampvec - ampvecpermtest[ipos][l]);
+            if (ratio < minratio) {
+              minratio = ratio;
+              minratiopos = ipos;
+            }
+          }
+        }
+        for (unsigned int ipos = 0; ipos < _nP[l]; ++ipos) {
+          double &amp = _ampvec[_order[ipos][l]][l];
+          amp += minratio * (ampvecpermtest[ipos][l] - amp);
+        }
+
+        //avoid numerical problems with later ==0. check
+        _ampvec[_order[minratiopos][l]][l] = 0.;
+
+        //constrain parameter
+        std::swap(_order[_nP[l] - 1][l], _order[minratiopos][l]);
+        --_nP[l];
+        if (_nP[l] == 0)
+          endNNLSIteration(l);
+      }
+    }
+
+    // end of the iteration of the minimization, with the same waiting as for the covariance
+    nWaiting = 0;
+    nNNLS = 0;
+    for (unsigned int l = 0; l < lanes; ++l) {
+      nWaiting += state[l] == chiSquare;
+      nNNLS += state[l] == select || state[l] == solve;
+    }
+    if (nWaiting > 0 && (nNNLS == 0 || 4 * nWaiting >= 3 * lanes)) {
+      computeChiSq(chisqnow);
+
+      for (unsigned int l = 0; l < lanes; ++l) {
+        if (state[l] != chiSquare)
+          continue;
+
+        const double deltachisq = chisqnow[l] - _chisq[l];
+        _chisq[l] = chisqnow[l];
+        if (std::abs(deltachisq) < 1e-3 || ++_iter[l] >= _maxiters)
+          endMinimize(l);
+        else
+          state[l] = covariance;
+      }
+    }
+  }
+}
+
+void PulseChiSqSNNLSBatch::updateCov(const LaneMask &mask) {
+  for (int i = 0; i < nsamples; ++i)
+    for (int j = 0; j <= i; ++j)
+      for (unsigned int l = 0; l < lanes; ++l)
+        _cov[i][j][l] = _noisecov[i][j][l];
+
+  for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse) {
+    double ampsq[lanes];
+    bool zero = true;
+    for (unsigned int l = 0; l < lanes; ++l) {
+      ampsq[l] = _ampvec[ipulse][l] * _ampvec[ipulse][l];
+      zero &= ampsq[l] == 0.;
+    }
+    if (zero)
+      continue;
+    const int shift = _offsets[ipulse] - 7;
+    const int firstsample = _firstsamples[ipulse];
+    for (int i = firstsample; i < nsamples; ++i)
+      for (int j = firstsample; j <= i; ++j)
+        for (unsigned int l = 0; l < lanes; ++l)
+          _cov[i][j][l] += ampsq[l] * _templatecov[i + shift][j + shift][l];
+  }
+
+  // Cholesky decomposition, in place in the lower triangle, with the inverse of the diagonal
+  for (int j = 0; j < nsamples; ++j) {
+    for (int k = 0; k < j; ++k)
+      for (unsigned int l = 0; l < lanes; ++l)
+        _cov[j][j][l] -= _cov[j][k][l] * _cov[j][k][l];
+    for (unsigned int l = 0; l < lanes; ++l)
+      _cov[j][j][l] = 1. / std::sqrt(_cov[j][j][l]);
+
+    for (int i = j + 1; i < nsamples; ++i) {
+      for (int k = 0; k < j; ++k)
+        for (unsigned int l = 0; l < lanes; ++l)
+          _cov[i][j][l] -= _cov[i][k][l] * _cov[j][k][l];
+      for (unsigned int l = 0; l < lanes; ++l)
+        _cov[i][j][l] *= _cov[j][j][l];
+    }
+  }
+
+  for (int i = 0; i < nsamples; ++i)
+    for (int j = 0; j <= i; ++j)
+      for (unsigned int l = 0; l < lanes; ++l)
+        _covdecompL[i][j][l] = mask[l] != 0. ? _cov[i][j][l] : _covdecompL[i][j][l];
+
+  // normal equations, the pulses starting after the first sample keep their leading zeros
+  for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse)
+    solveL(_pulsemat[ipulse], _invcovp[ipulse], _firstsamples[ipulse]);
+  solveL(_sampvec, _invcovy, 0);
+
+  for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse) {
+    for (unsigned int jpulse = 0; jpulse <= ipulse; ++jpulse) {
+      double sum[lanes] = {};
+      for (int i = std::max(_firstsamples[ipulse], _firstsamples[jpulse]); i < nsamples; ++i)
+        for (unsigned int l = 0; l < lanes; ++l)
+          sum[l] += _invcovp[ipulse][i][l] * _invcovp[jpulse][i][l];
+      for (unsigned int l = 0; l < lanes; ++l) {
+        _aTamat[ipulse][jpulse][l] = mask[l] != 0. ? sum[l] : _aTamat[ipulse][jpulse][l];
+        _aTamat[jpulse][ipulse][l] = _aTamat[ipulse][jpulse][l];
+      }
+    }
+    double sum[lanes] = {};
+    for (int i = _firstsamples[ipulse]; i < nsamples; ++i)
+      for (unsigned int l = 0; l < lanes; ++l)
+        sum[l] += _invcovp[ipulse][i][l] * _invcovy[i][l];
+    for (unsigned int l = 0; l < lanes; ++l)
+      _aTbvec[ipulse][l] = mask[l] != 0. ? sum[l] : _aTbvec[ipulse][l];
+  }
+}
+
+void PulseChiSqSNNLSBatch::solveL(const double (&in)[nsamples][lanes],
+                                  double (&out)[nsamples][lanes],
+                                  const int first) const {
+  for (int i = 0; i < first; ++i)
+    for (unsigned int l = 0; l < lanes; ++l)
+      out[i][l] = 0.;
+  for (int i = first; i < nsamples; ++i) {
+    for (unsigned int l = 0; l < lanes; ++l)
+      out[i][l] = in[i][l];
+    for (int k = first; k < i; ++k)
+      for (unsigned int l = 0; l < lanes; ++l)
+        out[i][l] -= _covdecompL[i][k][l] * out[k][l];
+    for (unsigned int l = 0; l < lanes; ++l)
+      out[i][l] *= _covdecompL[i][i][l];
+  }
+}
+
+void PulseChiSqSNNLSBatch::computeChiSq(double (&chisq)[lanes]) const {
+  double resvec[nsamples][lanes];
+  for (int i = 0; i < nsamples; ++i) {
+    for (unsigned int l = 0; l < lanes; ++l)
+      resvec[i][l] = -_sampvec[i][l];
+    for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse)
+      for (unsigned int l = 0; l < lanes; ++l)
+        resvec[i][l] += _pulsemat[ipulse][i][l] * _ampvec[ipulse][l];
+  }
+
+  double solved[nsamples][lanes];
+  solveL(resvec, solved, 0);
+
+  for (unsigned int l = 0; l < lanes; ++l)
+    chisq[l] = 0.;
+  for (int i = 0; i < nsamples; ++i)
+    for (unsigned int l = 0; l < lanes; ++l)
+      chisq[l] += solved[i][l] * solved[i][l];
+}
+
+//
+// Solution of the normal equations restricted to the unconstrained pulses,
+// which are the first nP[l] pulses in the order of PulseChiSqSNNLS, with an
+// LDLT decomposition padded with the identity up to the largest nP.
+//
+void PulseChiSqSNNLSBatch::solveSubmatrix(const unsigned int (&nP)[lanes],
+                                          double (&solution)[PulseVectorSize][lanes]) {
+  const double tolerance = std::numeric_limits<double>::min();
+
+  const unsigned int n = *std::max_element(nP, nP + lanes);
+
+  // _ldlL holds L * D below the diagonal, _ldlD the inverse of D (0 for a null pivot)
+  for (unsigned int i = 0; i < n; ++i) {
+    for (unsigned int l = 0; l < lanes; ++l) {
+      const bool inside = i < nP[l];
+      const unsigned int ipulse = _order[i][l];
+      for (unsigned int j = 0; j < i; ++j)
+        _ldlL[i][j][l] = inside ? _aTamat[ipulse][_order[j][l]][l] : 0.;
+      _ldlD[i][l] = inside ? _aTamat[ipulse][ipulse][l] : 1.;
+      solution[i][l] = inside ? _aTbvec[ipulse][l] : 0.;
+    }
+  }
+
+  for (unsigned int j = 0; j < n; ++j) {
+    double d[lanes];
+    for (unsigned int l = 0; l < lanes; ++l)
+      d[l] = _ldlD[j][l];
+    for (unsigned int k = 0; k < j; ++k)
+      for (unsigned int l = 0; l < lanes; ++l)
+        d[l] -= _ldlL[j][k][l] * _ldlL[j][k][l] * _ldlD[k][l];
+    for (unsigned int l = 0; l < lanes; ++l)
+      _ldlD[j][l] = std::abs(d[l]) > tolerance ? 1. / d[l] : 0.;
+
+    for (unsigned int i = j + 1; i < n; ++i)
+      for (unsigned int k = 0; k < j; ++k)
+        for (unsigned int l = 0; l < lanes; ++l)
+          _ldlL[i][j][l] -= _ldlL[i][k][l] * _ldlL[j][k][l] * _ldlD[k][l];
+  }
+
+  for (unsigned int i = 0; i < n; ++i)
+    for (unsigned int k = 0; k < i; ++k)
+      for (unsigned int l = 0; l < lanes; ++l)
+        solution[i][l] -= _ldlL[i][k][l] * _ldlD[k][l] * solution[k][l];
+  for (unsigned int i = n; i-- > 0;) {
+    for (unsigned int l = 0; l < lanes; ++l)
+      solution[i][l] *= _ldlD[i][l];
+    for (unsigned int k = i + 1; k < n; ++k)
+      for (unsigned int l = 0; l < lanes; ++l)
+        solution[i][l] -= _ldlL[k][i][l] * _ldlD[i][l] * solution[k][l];
+  }
+}
+
+double PulseChiSqSNNLSBatch::computeApproxUncertainty(unsigned int lane) const {
+  //compute approximate uncertainties
+  //(using 1/second derivative since full Hessian is not meaningful in
+  //presence of positive amplitude boundaries.)
+  double solved[nsamples];
+  double norm2 = 0.;
+  for (int i = 0; i < nsamples; ++i) {
+    solved[i] = _pulsemat[_ipulseintime][i][lane];
+    for (int k = 0; k < i; ++k)
+      solved[i] -= _covdecompL[i][k][lane] * solved[k];
+    solved[i] *= _covdecompL[i][i][lane];
+    norm2 += solved[i] * solved[i];
+  }
+  return 1. / std::sqrt(norm2);
+}
@@ -0,0 +1,114 @@
+#ifndef RecoLocalCalo_EcalRecAlgos_EcalMultiFitToy_h
+#define RecoLocalCalo_EcalRecAlgos_EcalMultiFitToy_h
+
+// Toy barrel digis and conditions for the tests and the benchmark of the multifit:
+// an alpha-beta pulse shape, the same pedestals and gains for all the crystals,
+// and in-time pulses with out-of-time pileup on top of uncorrelated noise.
+
+#include "CondFormats/EcalObjects/interface/EcalGainRatios.h"
+#include "CondFormats/EcalObjects/interface/EcalPedestals.h"
+#include "CondFormats/EcalObjects/interface/EcalPulseCovariances.h"
+#include "CondFormats/EcalObjects/interface/EcalPulseShapes.h"
+#include "DataFormats/EcalDetId/interface/EBDetId.h"
+#include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
+#include "RecoLocalCalo/EcalRecAlgos/interface/EigenMatrixTypes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace ecalMultiFitToy {
+
+  constexpr int nSamples = EcalDataFrame::MAXSAMPLES;
+  constexpr int nTemplate = EcalPulseShape::TEMPLATESAMPLES;
+
+  struct Conditions {
+    EcalPedestals::Item pedestal;
+    EcalMGPAGainRatio gainRatio;
+    EcalPulseShapes::Item pulse;
+    EcalPulseCovariances::Item pulseCov;
+    FullSampleVector fullpulse;
+    FullSampleMatrix fullpulsecov;
+    SampleMatrixGainArray noisecors;
+    BXVector activeBX;
+
+    Conditions() {
+      pedestal.mean_x12 = 200.;
+      pedestal.rms_x12 = 1.1;
+      pedestal.mean_x6 = 200.;
+      pedestal.rms_x6 = 0.9;
+      pedestal.mean_x1 = 200.;
+      pedestal.rms_x1 = 0.8;
+      gainRatio.setGain12Over6(1.95);
+      gainRatio.setGain6Over1(5.85);
+
+      // alpha-beta shape with its maximum in the third sample of the template
+      const double alpha = 1.138, beta = 1.655;
+      for (int i = 0; i < nTemplate; ++i) {
+        const double t = i - 2.;
+        pulse.pdfval[i] = t > -alpha * beta ? std::pow(1. + t / (alpha * beta), alpha) * std::exp(-t / beta) : 0.;
+      }
+      for (int i = 0; i < nTemplate; ++i)
+        for (int j = 0; j < nTemplate; ++j)
+          pulseCov.covval[i][j] = 1e-5 * pulse.pdfval[i] * pulse.pdfval[j] * std::pow(0.5, std::abs(i - j));
+
+      // as EcalUncalibRecHitWorkerMultiFit fills them
+      fullpulse = FullSampleVector::Zero();
+      fullpulsecov = FullSampleMatrix::Zero();
+      for (int i = 0; i < nTemplate; ++i) {
+        fullpulse(i + 7) = pulse.pdfval[i];
+        for (int j = 0; j < nTemplate; ++j)
+          fullpulsecov(i + 7, j + 7) = pulseCov.covval[i][j];
+      }
+
+      for (int g = 0; g < NGains; ++g)
+        for (int i = 0; i < nSamples; ++i)
+          for (int j = 0; j < nSamples; ++j)
+            noisecors[g](i, j) = std::pow(0.6 - 0.1 * g, std::abs(i - j));
+
+      activeBX.resize(10);
+      activeBX << -5, -4, -3, -2, -1, 0, 1, 2, 3, 4;
+    }
+  };
+
+  // Adds a crystal with an in-time pulse of the given amplitude, in gain 12 ADC counts, and
+  // pileup pulses of up to a tenth of it. The samples switch to gain 6 and to gain 1 above
+  // 4000 ADC counts, and are saturated above 4095 ADC counts in gain 1.
+  inline void addDigi(EBDigiCollection& digis, double amplitude, std::mt19937& rng, const Conditions& conditions) {
+    std::uniform_real_distribution<double> uniform(0., 1.);
+    std::normal_distribution<double> gauss(0., 1.);
+
+    double amplitudes[10];
+    for (unsigned int ipulse = 0; ipulse < 10; ++ipulse)
+      amplitudes[ipulse] = uniform(rng) < 0.3 ? 0.1 * amplitude * uniform(rng) : 0.;
+    amplitudes[5] = amplitude;
+
+    digis.push_back(EBDetId::unhashIndex(digis.size() % EBDetId::kSizeForDenseIndexing).rawId());
+    EBDataFrame digi(digis.back());
+    const EcalPedestals::Item& ped = conditions.pedestal;
+    const double gain6 = conditions.gainRatio.gain12Over6();
+    const double gain1 = gain6 * conditions.gainRatio.gain6Over1();
+    for (int iSample = 0; iSample < nSamples; ++iSample) {
+      double signal = 0.;
+      for (int bx = -5; bx < 5; ++bx) {
+        const int i = iSample - 3 - bx;
+        if (i >= 0 and i < nTemplate)
+          signal += amplitudes[bx + 5] * conditions.pulse.pdfval[i];
+      }
+      const double adc12 = ped.mean_x12 + signal + ped.rms_x12 * gauss(rng);
+      const double adc6 = ped.mean_x6 + signal / gain6 + ped.rms_x6 * gauss(rng);
+      const double adc1 = ped.mean_x1 + signal / gain1 + ped.rms_x1 * gauss(rng);
+      if (adc12 < 4000.)
+        digi.setSample(iSample, EcalMGPASample(std::max(0, int(std::lround(adc12))), 1));
+      else if (adc6 < 4000.)
+        digi.setSample(iSample, EcalMGPASample(int(std::lround(adc6)), 2));
+      else if (adc1 < 4095.)
+        digi.setSample(iSample, EcalMGPASample(int(std::lround(adc1)), 3));
+      else
+        digi.setSample(iSample, EcalMGPASample(4095, 0));
+    }
+  }
+
+}  // namespace ecalMultiFitToy
+
+#endif
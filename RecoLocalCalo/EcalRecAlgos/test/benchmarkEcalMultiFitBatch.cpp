@@ -0,0 +1,59 @@
+// Time of the multifit per crystal, with EcalUncalibRecHitMultiFitAlgo::makeRecHit() and with
+// the batched fit of EcalUncalibRecHitMultiFitAlgo::makeRecHits(), on the toy digis of
+// EcalMultiFitToy.h. The argument is the number of crystals fitted together.
+
+#include <benchmark/benchmark.h>
+#include "RecoLocalCalo/EcalRecAlgos/interface/EcalUncalibRecHitMultiFitAlgo.h"
+#include "RecoLocalCalo/EcalRecAlgos/test/EcalMultiFitToy.h"
+
+#include <vector>
+
+namespace {
+  // in-time amplitudes from 1 to 1000 ADC counts, all in gain 12
+  EBDigiCollection makeDigis(unsigned int n, const ecalMultiFitToy::Conditions& conditions) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> uniform(0., 1.);
+    EBDigiCollection digis;
+    for (unsigned int i = 0; i < n; ++i)
+      ecalMultiFitToy::addDigi(digis, std::pow(10., 3. * uniform(rng)), rng, conditions);
+    return digis;
+  }
+}  // namespace
+
+static void BM_makeRecHit(benchmark::State& state) {
+  const ecalMultiFitToy::Conditions conditions;
+  EBDigiCollection digis = makeDigis(state.range(0), conditions);
+  EcalUncalibRecHitMultiFitAlgo algo;
+  std::vector<EcalUncalibratedRecHit> rechits;
+  for (auto _ : state) {
+    rechits.clear();
+    for (unsigned int i = 0; i < digis.size(); ++i)
+      rechits.push_back(algo.makeRecHit(EBDataFrame(digis[i]),
+                                        &conditions.pedestal,
+                                        &conditions.gainRatio,
+                                        conditions.noisecors,
+                                        conditions.fullpulse,
+                                        conditions.fullpulsecov,
+                                        conditions.activeBX));
+    benchmark::DoNotOptimize(rechits.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(digis.size()));
+}
+BENCHMARK(BM_makeRecHit)->Arg(64)->Arg(1024)->Arg(8192);
+
+static void BM_makeRecHits(benchmark::State& state) {
+  const ecalMultiFitToy::Conditions conditions;
+  EBDigiCollection digis = makeDigis(state.range(0), conditions);
+  EcalUncalibRecHitMultiFitAlgo algo;
+  std::vector<EcalUncalibratedRecHit> rechits;
+  for (auto _ : state) {
+    algo.beginRecHits(conditions.noisecors, conditions.activeBX);
+    for (unsigned int i = 0; i < digis.size(); ++i)
+      algo.addRecHit(
+          EBDataFrame(digis[i]), &conditions.pedestal, &conditions.gainRatio, &conditions.pulse, &conditions.pulseCov);
+    algo.makeRecHits(rechits);
+    benchmark::DoNotOptimize(rechits.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(digis.size()));
+}
+BENCHMARK(BM_makeRecHits)->Arg(64)->Arg(1024)->Arg(8192);
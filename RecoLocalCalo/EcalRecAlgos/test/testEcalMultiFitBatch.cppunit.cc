@@ -0,0 +1,114 @@
+/* Unit test of the batched multifit: the rechits of EcalUncalibRecHitMultiFitAlgo::makeRecHits()
+   must be those of EcalUncalibRecHitMultiFitAlgo::makeRecHit(), within the tolerance documented
+   in PulseChiSqSNNLSBatch.h, for crystals with and without gain switch or saturation.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "RecoLocalCalo/EcalRecAlgos/interface/EcalUncalibRecHitMultiFitAlgo.h"
+#include "RecoLocalCalo/EcalRecAlgos/test/EcalMultiFitToy.h"
+
+#include <vector>
+
+class testEcalMultiFitBatch : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testEcalMultiFitBatch);
+  CPPUNIT_TEST(testFit);
+  CPPUNIT_TEST(testFitWithPrefit);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+
+  void testFit();
+  void testFitWithPrefit();
+
+private:
+  void compare(EcalUncalibRecHitMultiFitAlgo& scalar, EcalUncalibRecHitMultiFitAlgo& batched);
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testEcalMultiFitBatch);
+
+namespace {
+  constexpr double tolerance = 1e-5;
+
+  // relative, or absolute for the values below 1
+  void assertClose(double expected, double actual) {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, actual, tolerance * std::max(std::abs(expected), 1.));
+  }
+}  // namespace
+
+void testEcalMultiFitBatch::compare(EcalUncalibRecHitMultiFitAlgo& scalar, EcalUncalibRecHitMultiFitAlgo& batched) {
+  const ecalMultiFitToy::Conditions conditions;
+  std::mt19937 rng(4321);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+
+  // mostly crystals in gain 12, and some with a gain switch or saturated
+  EBDigiCollection digis;
+  for (unsigned int i = 0; i < 1000; ++i) {
+    const double u = uniform(rng);
+    double amplitude;
+    if (u < 0.8)
+      amplitude = std::pow(10., 3. * uniform(rng));
+    else if (u < 0.95)
+      amplitude = 4000. + 40000. * uniform(rng);
+    else
+      amplitude = 2e5 + 3e5 * uniform(rng);
+    ecalMultiFitToy::addDigi(digis, amplitude, rng, conditions);
+  }
+
+  std::vector<EcalUncalibratedRecHit> rechits;
+  batched.beginRecHits(conditions.noisecors, conditions.activeBX);
+  for (unsigned int i = 0; i < digis.size(); ++i)
+    batched.addRecHit(
+        EBDataFrame(digis[i]), &conditions.pedestal, &conditions.gainRatio, &conditions.pulse, &conditions.pulseCov);
+  batched.makeRecHits(rechits);
+  CPPUNIT_ASSERT_EQUAL(std::size_t(digis.size()), rechits.size());
+
+  unsigned int nGainSwitch = 0, nSaturated = 0;
+  for (unsigned int i = 0; i < digis.size(); ++i) {
+    const EBDataFrame digi(digis[i]);
+    if (digi.isSaturated())
+      ++nSaturated;
+    else if (digi.hasSwitchToGain6() or digi.hasSwitchToGain1())
+      ++nGainSwitch;
+
+    const EcalUncalibratedRecHit expected = scalar.makeRecHit(digi,
+                                                              &conditions.pedestal,
+                                                              &conditions.gainRatio,
+                                                              conditions.noisecors,
+                                                              conditions.fullpulse,
+                                                              conditions.fullpulsecov,
+                                                              conditions.activeBX);
+    const EcalUncalibratedRecHit& rechit = rechits[i];
+    CPPUNIT_ASSERT_EQUAL(expected.id().rawId(), rechit.id().rawId());
+    CPPUNIT_ASSERT_EQUAL(expected.flags(), rechit.flags());
+    assertClose(expected.amplitude(), rechit.amplitude());
+    assertClose(expected.amplitudeError(), rechit.amplitudeError());
+    assertClose(expected.chi2(), rechit.chi2());
+    assertClose(expected.pedestal(), rechit.pedestal());
+    for (unsigned int ipulse = 0; ipulse < conditions.activeBX.rows(); ++ipulse) {
+      const int bx = conditions.activeBX.coeff(ipulse);
+      if (bx != 0)
+        assertClose(expected.outOfTimeAmplitude(bx + 5), rechit.outOfTimeAmplitude(bx + 5));
+    }
+  }
+  CPPUNIT_ASSERT(nGainSwitch > 0);
+  CPPUNIT_ASSERT(nSaturated > 0);
+}
+
+void testEcalMultiFitBatch::testFit() {
+  EcalUncalibRecHitMultiFitAlgo scalar, batched;
+  compare(scalar, batched);
+}
+
+void testEcalMultiFitBatch::testFitWithPrefit() {
+  EcalUncalibRecHitMultiFitAlgo scalar, batched;
+  for (auto algo : {&scalar, &batched}) {
+    algo->disableErrorCalculation();
+    algo->setDoPrefit(true);
+    algo->setPrefitMaxChiSq(10.);
+    algo->setAddPedestalUncertainty(0.5);
+  }
+  compare(scalar, batched);
+}
@@ -35,6 +35,9 @@ EcalUncalibRecHitWorkerMultiFit::EcalUncalibRecHitWorkerMultiFit(const edm::Para
   ampErrorCalculation_ = ps.getParameter<bool>("ampErrorCalculation");
   useLumiInfoRunHeader_ = ps.getParameter<bool>("useLumiInfoRunHeader");
 
+  // fit the crystals of a collection together
+  batchedFit_ = ps.getParameter<bool>("batchedFit");
+
   if (useLumiInfoRunHeader_) {
     bunchSpacing_ = c.consumes<unsigned int>(edm::InputTag("bunchSpacingProducer"));
     bunchSpacingManual_ = 0;
@@ -132,6 +135,12 @@ void EcalUncalibRecHitWorkerMultiFit::set(const edm::EventSetup& es) {
   // for the time correction methods
   es.get<EcalTimeBiasCorrectionsRcd>().get(timeCorrBias_);
 
+  // the noise correlation matrices only change with the conditions
+  unsigned long long noisecorsCacheId = es.get<EcalSamplesCorrelationRcd>().cacheIdentifier();
+  if (noisecorsCacheId == noisecorsCacheId_)
+    return;
+  noisecorsCacheId_ = noisecorsCacheId;
+
   int nnoise = SampleVector::RowsAtCompileTime;
   SampleMatrix& noisecorEBg12 = noisecors_[1][0];
   SampleMatrix& noisecorEBg6 = noisecors_[1][1];
@@ -261,6 +270,41 @@ void EcalUncalibRecHitWorkerMultiFit::run(const edm::Event& evt,
     multiFitMethod_.setAddPedestalUncertainty(addPedestalUncertaintyEE_);
   }
 
+  // sample before the first saturated one, -2 without saturation
+  auto findLastSampleBeforeSaturation = [](const EcalDataFrame& dataFrame) {
+    for (unsigned int iSample = 0; iSample < EcalDataFrame::MAXSAMPLES; iSample++) {
+      if (dataFrame.sample(iSample).gainId() == 0)
+        return int(iSample) - 1;
+    }
+    return -2;
+  };
+
+  // batched multifit of all the crystals, whose rechits are then taken in the order of the digis
+  unsigned int ibatch = 0;
+  if (batchedFit_) {
+    multiFitMethod_.beginRecHits(noisecor(barrel), activeBX);
+    for (auto itdg = digis.begin(); itdg != digis.end(); ++itdg) {
+      if (findLastSampleBeforeSaturation(*itdg) >= -1)
+        continue;
+      if (barrel) {
+        unsigned int hashedIndex = EBDetId(itdg->id()).hashedIndex();
+        multiFitMethod_.addRecHit(*itdg,
+                                  &peds->barrel(hashedIndex),
+                                  &gains->barrel(hashedIndex),
+                                  &pulseshapes->barrel(hashedIndex),
+                                  &pulsecovariances->barrel(hashedIndex));
+      } else {
+        unsigned int hashedIndex = EEDetId(itdg->id()).hashedIndex();
+        multiFitMethod_.addRecHit(*itdg,
+                                  &peds->endcap(hashedIndex),
+                                  &gains->endcap(hashedIndex),
+                                  &pulseshapes->endcap(hashedIndex),
+                                  &pulsecovariances->endcap(hashedIndex));
+      }
+    }
+    multiFitMethod_.makeRecHits(batchRecHits_);
+  }
+
   FullSampleVector fullpulse(FullSampleVector::Zero());
   FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
 
@@ -304,9 +348,11 @@ void EcalUncalibRecHitWorkerMultiFit::run(const edm::Event& evt,
     for (int i = 0; i < EcalPulseShape::TEMPLATESAMPLES; ++i)
       fullpulse(i + 7) = aPulse->pdfval[i];
 
-    for (int i = 0; i < EcalPulseShape::TEMPLATESAMPLES; i++)
-      for (int j = 0; j < EcalPulseShape::TEMPLATESAMPLES; j++)
-        fullpulsecov(i + 7, j + 7) = aPulseCov->covval[i][j];
+    if (!batchedFit_) {
+      for (int i = 0; i < EcalPulseShape::TEMPLATESAMPLES; i++)
+        for (int j = 0; j < EcalPulseShape::TEMPLATESAMPLES; j++)
+          fullpulsecov(i + 7, j + 7) = aPulseCov->covval[i][j];
+    }
 
     // compute the right bin of the pulse shape using time calibration constants
     EcalTimeCalibConstantMap::const_iterator it = itime->find(detid);
@@ -318,16 +364,9 @@ void EcalUncalibRecHitWorkerMultiFit::run(const edm::Event& evt,
                                        << "! something wrong with EcalTimeCalibConstants in your DB? ";
     }
 
-    int lastSampleBeforeSaturation = -2;
-    for (unsigned int iSample = 0; iSample < EcalDataFrame::MAXSAMPLES; iSample++) {
-      if (((EcalDataFrame)(*itdg)).sample(iSample).gainId() == 0) {
-        lastSampleBeforeSaturation = iSample - 1;
-        break;
-      }
-    }
-
     // === amplitude computation ===
 
+    int lastSampleBeforeSaturation = findLastSampleBeforeSaturation(*itdg);
     if (lastSampleBeforeSaturation == 4) {  // saturation on the expected max sample
       result.emplace_back((*itdg).id(), 4095 * 12, 0, 0, 0);
       auto& uncalibRecHit = result.back();
@@ -351,7 +390,11 @@ void EcalUncalibRecHitWorkerMultiFit::run(const edm::Event& evt,
       // multifit
       const SampleMatrixGainArray& noisecors = noisecor(barrel);
 
-      result.push_back(multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX));
+      if (batchedFit_)
+        result.push_back(batchRecHits_[ibatch++]);
+      else
+        result.push_back(
+            multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX));
       auto& uncalibRecHit = result.back();
 
       // === time computation ===
@@ -596,6 +639,7 @@ edm::ParameterSetDescription EcalUncalibRecHitWorkerMultiFit::getAlgoDescription
       edm::ParameterDescription<std::vector<int>>("activeBXs", {-5, -4, -3, -2, -1, 0, 1, 2, 3, 4}, true) and
       edm::ParameterDescription<bool>("ampErrorCalculation", true, true) and
       edm::ParameterDescription<bool>("useLumiInfoRunHeader", true, true) and
+      edm::ParameterDescription<bool>("batchedFit", false, true) and
       edm::ParameterDescription<int>("bunchSpacing", 0, true) and
       edm::ParameterDescription<bool>("doPrefitEB", false, true) and
       edm::ParameterDescription<bool>("doPrefitEE", false, true) and
@@ -64,10 +64,13 @@ private:
 
   // multifit method
   std::array<SampleMatrixGainArray, 2> noisecors_;
+  unsigned long long noisecorsCacheId_ = 0;
   BXVector activeBX;
   bool ampErrorCalculation_;
   bool useLumiInfoRunHeader_;
   EcalUncalibRecHitMultiFitAlgo multiFitMethod_;
+  bool batchedFit_;
+  std::vector<EcalUncalibratedRecHit> batchRecHits_;
 
   int bunchSpacingManual_;
   edm::EDGetTokenT<unsigned int> bunchSpacing_;
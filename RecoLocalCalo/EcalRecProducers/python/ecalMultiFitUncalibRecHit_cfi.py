@@ -14,6 +14,8 @@ ecalMultiFitUncalibRecHit = cms.EDProducer("EcalUncalibRecHitProducer",
       activeBXs = cms.vint32(-5,-4,-3,-2,-1,0,1,2,3,4),
       ampErrorCalculation = cms.bool(True),
       useLumiInfoRunHeader = cms.bool(True),
+      # fit the crystals of each collection together
+      batchedFit = cms.bool(False),
   
       doPrefitEB = cms.bool(False),
       doPrefitEE = cms.bool(False),
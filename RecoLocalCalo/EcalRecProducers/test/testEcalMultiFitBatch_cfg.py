@@ -0,0 +1,52 @@
+import FWCore.ParameterSet.Config as cms
+process = cms.Process("RECO2")
+
+# Compare the time taken by the multifit with and without the batched fit
+# (algoPSet.batchedFit) on recorded digis. The FastTimerService job summary
+# gives the time of each of the two producers, and the uncalibrated rechits
+# of both are kept in the output file for comparison.
+
+process.load('Configuration.StandardSequences.Services_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+process.load('Configuration.StandardSequences.MagneticField_38T_PostLS1_cff')
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_condDBv2_cff")
+process.load('Configuration.StandardSequences.RawToDigi_cff')
+
+process.GlobalTag.globaltag = 'GR_R_74_V10A'
+
+process.MessageLogger.cerr.FwkReport.reportEvery = 100
+
+# per-crystal multifit, as in the standard reconstruction
+import RecoLocalCalo.EcalRecProducers.ecalMultiFitUncalibRecHit_cfi
+process.ecalMultiFitUncalibRecHit = RecoLocalCalo.EcalRecProducers.ecalMultiFitUncalibRecHit_cfi.ecalMultiFitUncalibRecHit.clone()
+process.ecalMultiFitUncalibRecHit.algoPSet.useLumiInfoRunHeader = cms.bool( False )
+# all the crystals of each collection fitted together
+process.ecalMultiFitBatchUncalibRecHit = process.ecalMultiFitUncalibRecHit.clone()
+process.ecalMultiFitBatchUncalibRecHit.algoPSet.batchedFit = cms.bool( True )
+
+process.maxEvents = cms.untracked.PSet(  input = cms.untracked.int32(1000) )
+path = '/store/data/Run2012D/DoubleElectron/RAW-RECO/ZElectron-22Jan2013-v1/10000/'
+process.source = cms.Source("PoolSource",
+                            duplicateCheckMode = cms.untracked.string("noDuplicateCheck"),
+                            fileNames = cms.untracked.vstring(path+'0008202C-E78F-E211-AADB-0026189437FD.root'
+                                                              ))
+
+process.out = cms.OutputModule("PoolOutputModule",
+                               outputCommands = cms.untracked.vstring('drop *',
+                                                                      'keep *_ecalMultiFit*_*_RECO2'
+                                                                      ),
+                               fileName = cms.untracked.string('reco2_multifit_batch.root')
+                               )
+
+process.p = cms.Path( process.ecalDigis *
+                      process.ecalMultiFitUncalibRecHit *
+                      process.ecalMultiFitBatchUncalibRecHit )
+process.outpath = cms.EndPath(process.out)
+
+# time profiling
+if 'FastTimerService' in process.__dict__:
+    del process.FastTimerService
+process.load( "HLTrigger.Timer.FastTimerService_cfi" )
+process.FastTimerService.printJobSummary = True
+process.FastTimerService.enableDQM       = False
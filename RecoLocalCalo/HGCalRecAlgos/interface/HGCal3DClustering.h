@@ -11,10 +11,13 @@
 #include "RecoLocalCalo/HGCalRecAlgos/interface/RecHitTools.h"
 #include "RecoLocalCalo/HGCalRecAlgos/interface/ClusterTools.h"
 #include "RecoLocalCalo/HGCalRecProducers/interface/HGCalClusteringAlgoBase.h"
+#include "RecoLocalCalo/HGCalRecProducers/interface/HGCalMultiClusterAlgoBase.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
 
 #include "CommonTools/RecoAlgos/interface/KDTreeLinkerAlgo.h"
 
-class HGCal3DClustering {
+class HGCal3DClustering : public HGCalMultiClusterAlgoBase {
 public:
   HGCal3DClustering() : radii({0., 0., 0.}), minClusters(0), clusterTools(nullptr) {}
 
@@ -33,8 +36,11 @@ public:
                           conf.getParameter<std::vector<double>>("multiclusterRadii"),
                           conf.getParameter<unsigned>("minClusters")) {}
 
-  void getEvent(const edm::Event& ev) { clusterTools->getEvent(ev); }
-  void getEventSetup(const edm::EventSetup& es) {
+  // the multiclusterRadii and minClusters parameters are those of the producer
+  static void fillPSetDescription(edm::ParameterSetDescription& iDesc) {}
+
+  void getEvent(const edm::Event& ev) override { clusterTools->getEvent(ev); }
+  void getEventSetup(const edm::EventSetup& es) override {
     clusterTools->getEventSetup(es);
     rhtools_.getEventSetup(es);
     maxlayer = rhtools_.lastLayerBH();
@@ -50,7 +56,7 @@ public:
 
   typedef std::vector<reco::BasicCluster> ClusterCollection;
 
-  std::vector<reco::HGCalMultiCluster> makeClusters(const reco::HGCalMultiCluster::ClusterCollection&);
+  std::vector<reco::HGCalMultiCluster> makeClusters(const reco::HGCalMultiCluster::ClusterCollection&) override;
 
 private:
   void organizeByLayer(const reco::HGCalMultiCluster::ClusterCollection&);
@@ -0,0 +1,124 @@
+#ifndef RecoLocalCalo_HGCalRecProducers_HGCalCLUE3D_h
+#define RecoLocalCalo_HGCalRecProducers_HGCalCLUE3D_h
+
+// C/C++ headers
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// CLUE in three dimensions: the layer clusters are clustered like CLUE clusters the hits of a layer, with the
+// density and the nearest higher of a layer cluster searched in eta-phi on the neighbouring layers as well.
+// The layer clusters of an endcap are stored structure-of-arrays, sorted by layer and by eta-phi tile, so that
+// the layer clusters of consecutive tiles in phi are contiguous and a search loops over plain arrays.
+class HGCalCLUE3D {
+public:
+  struct LayerClustersOnEndcap {
+    // sorted by layer, then by eta-phi tile
+    std::vector<float> eta;
+    std::vector<float> phi;
+    std::vector<float> energy;
+    std::vector<int> layer;
+    std::vector<int> index;  // in the input collection
+
+    std::vector<float> rho;
+    std::vector<float> delta;
+    std::vector<int> nearestHigher;
+    std::vector<int> clusterIndex;
+    std::vector<uint8_t> isSeed;
+    std::vector<int> seeds;
+
+    // followers of i are followers[followersStart[i]], ..., followers[followersStart[i + 1] - 1]
+    std::vector<int> followersStart;
+    std::vector<int> followers;
+
+    // layer clusters in the tile t are those in [tileStart[t], tileStart[t + 1])
+    std::vector<int> tileStart;
+
+    void clear() {
+      eta.clear();
+      phi.clear();
+      energy.clear();
+      layer.clear();
+      index.clear();
+      rho.clear();
+      delta.clear();
+      nearestHigher.clear();
+      clusterIndex.clear();
+      isSeed.clear();
+      seeds.clear();
+      followersStart.clear();
+      followers.clear();
+      tileStart.clear();
+    }
+  };
+
+  HGCalCLUE3D(float criticalDensity,
+              float densityEtaPhiDistance,
+              float criticalEtaPhiDistance,
+              float outlierDeltaFactor,
+              int densitySiblingLayers)
+      : criticalDensity_(criticalDensity),
+        densityEtaPhiDistance_(densityEtaPhiDistance),
+        criticalEtaPhiDistance_(criticalEtaPhiDistance),
+        outlierDeltaFactor_(outlierDeltaFactor),
+        densitySiblingLayers_(densitySiblingLayers) {}
+
+  // clusters the layer clusters i with eta[i], phi[i], energy[i], on the layer layer[i], from 1 to maxLayer,
+  // of the endcap side[i], 0 for z < 0 and 1 for z > 0
+  void cluster(unsigned int maxLayer,
+               const std::vector<float>& eta,
+               const std::vector<float>& phi,
+               const std::vector<float>& energy,
+               const std::vector<int>& layer,
+               const std::vector<int>& side);
+
+  // the layer clusters of an endcap with their density, nearest higher and multicluster, after cluster()
+  const LayerClustersOnEndcap& endcap(int side) const { return layerClusters_[side]; }
+
+private:
+  // eta-phi tiles, in |eta| so that both endcaps use the same ones
+  static constexpr float minEta_ = 1.4f;
+  static constexpr float maxEta_ = 3.2f;
+  static constexpr int nEtaBins_ = 36;
+  static constexpr int nPhiBins_ = 126;
+  static constexpr float etaBinSize_ = (maxEta_ - minEta_) / nEtaBins_;
+  static constexpr float phiBinSize_ = float(2. * M_PI / nPhiBins_);
+
+  int etaBin(float absEta) const {
+    int bin = std::floor((absEta - minEta_) / etaBinSize_);
+    return std::clamp(bin, 0, nEtaBins_ - 1);
+  }
+  // not wrapped around, so that a range of tiles in phi stays a range of integers
+  int phiBin(float phi) const { return int(std::floor((phi + float(M_PI)) / phiBinSize_)); }
+  int globalBin(int layer, int etaBin, int phiBin) const {
+    return (layer * nEtaBins_ + etaBin) * nPhiBins_ + (phiBin % nPhiBins_ + nPhiBins_) % nPhiBins_;
+  }
+
+  // calls f(first, last) for the contiguous ranges of layer clusters within distance in eta and phi
+  // of (eta, phi), on the layer
+  template <typename F>
+  void forEachRange(const LayerClustersOnEndcap& lcs, int layer, float eta, float phi, float distance, F f) const;
+
+  void organizeByLayerAndTile(const std::vector<float>& eta,
+                              const std::vector<float>& phi,
+                              const std::vector<float>& energy,
+                              const std::vector<int>& layer,
+                              const std::vector<int>& side);
+  void calculateLocalDensity(LayerClustersOnEndcap& lcs, int layer) const;
+  void calculateDistanceToHigher(LayerClustersOnEndcap& lcs, int layer) const;
+  void findAndAssignClusters(LayerClustersOnEndcap& lcs) const;
+
+  float criticalDensity_;
+  float densityEtaPhiDistance_;
+  float criticalEtaPhiDistance_;
+  float outlierDeltaFactor_;
+  int densitySiblingLayers_;
+
+  // max number of layers
+  unsigned int maxlayer_ = 0;
+
+  LayerClustersOnEndcap layerClusters_[2];
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef RecoLocalCalo_HGCalRecProducers_HGCalCLUE3DAlgo_h
+#define RecoLocalCalo_HGCalRecProducers_HGCalCLUE3DAlgo_h
+
+#include "RecoLocalCalo/HGCalRecProducers/interface/HGCalCLUE3D.h"
+#include "RecoLocalCalo/HGCalRecProducers/interface/HGCalMultiClusterAlgoBase.h"
+
+#include "FWCore/Framework/interface/ConsumesCollector.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+
+#include "DataFormats/ParticleFlowReco/interface/HGCalMultiCluster.h"
+
+#include "RecoLocalCalo/HGCalRecAlgos/interface/ClusterTools.h"
+#include "RecoLocalCalo/HGCalRecAlgos/interface/RecHitTools.h"
+
+// C/C++ headers
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// The CLUE3D multiclustering of HGCalCLUE3D, on the layer clusters of the event
+class HGCalCLUE3DAlgo : public HGCalMultiClusterAlgoBase {
+public:
+  HGCalCLUE3DAlgo(const edm::ParameterSet& ps, edm::ConsumesCollector& sumes)
+      : HGCalCLUE3DAlgo(ps.getParameter<edm::ParameterSet>("plugin"), ps, sumes) {}
+
+  ~HGCalCLUE3DAlgo() override {}
+
+  void getEvent(const edm::Event& ev) override;
+  void getEventSetup(const edm::EventSetup& es) override;
+
+  std::vector<reco::HGCalMultiCluster> makeClusters(const reco::HGCalMultiCluster::ClusterCollection&) override;
+
+  static void fillPSetDescription(edm::ParameterSetDescription& iDesc) {
+    iDesc.add<double>("criticalDensity", 0.6);            // GeV
+    iDesc.add<double>("densityEtaPhiDistance", 0.03);     // radius of the density sum
+    iDesc.add<double>("criticalEtaPhiDistance", 0.035);   // minimal distance of a seed to a higher layer cluster
+    iDesc.add<double>("outlierDeltaFactor", 2.);          // in units of criticalEtaPhiDistance
+    iDesc.add<unsigned int>("densitySiblingLayers", 3);  // layers searched on each side
+  }
+
+private:
+  HGCalCLUE3DAlgo(const edm::ParameterSet& pluginPSet, const edm::ParameterSet& ps, edm::ConsumesCollector& sumes)
+      : minClusters_(ps.getParameter<unsigned>("minClusters")),
+        clue3D_(pluginPSet.getParameter<double>("criticalDensity"),
+                pluginPSet.getParameter<double>("densityEtaPhiDistance"),
+                pluginPSet.getParameter<double>("criticalEtaPhiDistance"),
+                pluginPSet.getParameter<double>("outlierDeltaFactor"),
+                pluginPSet.getParameter<unsigned int>("densitySiblingLayers")),
+        clusterTools_(std::make_unique<hgcal::ClusterTools>(ps, sumes)) {}
+
+  uint32_t minClusters_;
+
+  // max number of layers
+  unsigned int maxlayer_ = 0;
+
+  HGCalCLUE3D clue3D_;
+
+  std::unique_ptr<hgcal::ClusterTools> clusterTools_; /*!< instance of tools to simplify cluster access. */
+  hgcal::RecHitTools rhtools_;                        /*!< instance of tools to access RecHit information. */
+};
+
+#endif
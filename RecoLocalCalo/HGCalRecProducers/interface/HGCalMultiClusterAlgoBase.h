@@ -0,0 +1,23 @@
+#ifndef RecoLocalCalo_HGCalRecProducers_HGCalMultiClusterAlgoBase_h
+#define RecoLocalCalo_HGCalRecProducers_HGCalMultiClusterAlgoBase_h
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+
+#include "DataFormats/ParticleFlowReco/interface/HGCalMultiCluster.h"
+
+// C/C++ headers
+#include <vector>
+
+// Interface of the algorithms building multiclusters out of layer clusters
+class HGCalMultiClusterAlgoBase {
+public:
+  virtual ~HGCalMultiClusterAlgoBase() {}
+
+  virtual void getEvent(const edm::Event &ev) = 0;
+  virtual void getEventSetup(const edm::EventSetup &es) = 0;
+
+  virtual std::vector<reco::HGCalMultiCluster> makeClusters(const reco::HGCalMultiCluster::ClusterCollection &) = 0;
+};
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef RecoLocalCalo_HGCalRecProducers_HGCalMultiClusterAlgoFactory_H
+#define RecoLocalCalo_HGCalRecProducers_HGCalMultiClusterAlgoFactory_H
+
+#include "FWCore/PluginManager/interface/PluginFactory.h"
+#include "FWCore/Framework/interface/ConsumesCollector.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "RecoLocalCalo/HGCalRecProducers/interface/HGCalMultiClusterAlgoBase.h"
+
+// The algorithms get the parameter set of the producer, in which their own parameters are in the "plugin" one
+typedef edmplugin::PluginFactory<HGCalMultiClusterAlgoBase*(const edm::ParameterSet&, edm::ConsumesCollector&)>
+    HGCalMultiClusterAlgoFactory;
+
+#endif
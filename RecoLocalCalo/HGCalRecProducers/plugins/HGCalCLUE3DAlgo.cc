@@ -0,0 +1,69 @@
+#include "RecoLocalCalo/HGCalRecProducers/interface/HGCalCLUE3DAlgo.h"
+
+#include <numeric>
+
+void HGCalCLUE3DAlgo::getEvent(const edm::Event& ev) { clusterTools_->getEvent(ev); }
+
+void HGCalCLUE3DAlgo::getEventSetup(const edm::EventSetup& es) {
+  clusterTools_->getEventSetup(es);
+  rhtools_.getEventSetup(es);
+  maxlayer_ = rhtools_.lastLayerBH();
+}
+
+std::vector<reco::HGCalMultiCluster> HGCalCLUE3DAlgo::makeClusters(
+    const reco::HGCalMultiCluster::ClusterCollection& thecls) {
+  const unsigned int nClusters = thecls.size();
+  std::vector<float> eta(nClusters), phi(nClusters), energy(nClusters);
+  std::vector<int> layer(nClusters), side(nClusters);
+  for (unsigned int i = 0; i < nClusters; ++i) {
+    const auto& lc = *thecls[i];
+    eta[i] = lc.eta();
+    phi[i] = lc.phi();
+    energy[i] = lc.energy();
+    layer[i] = rhtools_.getLayerWithOffset(lc.hitsAndFractions()[0].first);
+    side[i] = int(lc.z() > 0);
+  }
+  clue3D_.cluster(maxlayer_, eta, phi, energy, layer, side);
+
+  std::vector<reco::HGCalMultiCluster> thePreClusters;
+  std::vector<int> clusterStart;
+  std::vector<int> members;
+  for (int s = 0; s < 2; ++s) {
+    const auto& lcs = clue3D_.endcap(s);
+    // group the layer clusters by multicluster
+    const int n = lcs.eta.size();
+    clusterStart.assign(lcs.seeds.size() + 1, 0);
+    for (int i = 0; i < n; ++i) {
+      if (lcs.clusterIndex[i] >= 0 && !lcs.isSeed[i])
+        ++clusterStart[lcs.clusterIndex[i] + 1];
+    }
+    std::partial_sum(clusterStart.begin(), clusterStart.end(), clusterStart.begin());
+    members.resize(clusterStart.back());
+    std::vector<int> next(clusterStart.begin(), clusterStart.end() - 1);
+    for (int i = 0; i < n; ++i) {
+      if (lcs.clusterIndex[i] >= 0 && !lcs.isSeed[i])
+        members[next[lcs.clusterIndex[i]]++] = i;
+    }
+
+    for (unsigned int c = 0; c < lcs.seeds.size(); ++c) {
+      if (unsigned(clusterStart[c + 1] - clusterStart[c]) + 1 <= minClusters_)
+        continue;
+      reco::HGCalMultiCluster temp;
+      temp.push_back(thecls[lcs.index[lcs.seeds[c]]]);
+      for (int k = clusterStart[c]; k < clusterStart[c + 1]; ++k) {
+        temp.push_back(thecls[lcs.index[members[k]]]);
+      }
+      math::XYZPoint position = clusterTools_->getMultiClusterPosition(temp);
+      if (std::abs(position.z()) <= 0.)
+        continue;
+      // only store multiclusters that pass the energy threshold in getMultiClusterPosition
+      // giving them a position inside the HGCal
+      thePreClusters.push_back(temp);
+      auto& back = thePreClusters.back();
+      back.setPosition(position);
+      back.setEnergy(clusterTools_->getMultiClusterEnergy(back));
+    }
+  }
+
+  return thePreClusters;
+}
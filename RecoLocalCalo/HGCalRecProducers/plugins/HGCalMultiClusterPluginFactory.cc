@@ -0,0 +1,10 @@
+#include "RecoLocalCalo/HGCalRecProducers/interface/HGCalMultiClusterAlgoFactory.h"
+#include "RecoLocalCalo/HGCalRecProducers/interface/HGCalMultiClusterAlgoBase.h"
+#include "RecoLocalCalo/HGCalRecAlgos/interface/HGCal3DClustering.h"
+#include "RecoLocalCalo/HGCalRecProducers/interface/HGCalCLUE3DAlgo.h"
+#include "FWCore/ParameterSet/interface/ValidatedPluginFactoryMacros.h"
+#include "FWCore/ParameterSet/interface/ValidatedPluginMacros.h"
+
+EDM_REGISTER_VALIDATED_PLUGINFACTORY(HGCalMultiClusterAlgoFactory, "HGCalMultiClusterAlgoFactory");
+DEFINE_EDM_VALIDATED_PLUGIN(HGCalMultiClusterAlgoFactory, HGCal3DClustering, "KDTree");
+DEFINE_EDM_VALIDATED_PLUGIN(HGCalMultiClusterAlgoFactory, HGCalCLUE3DAlgo, "CLUE3D");
@@ -10,6 +10,7 @@
 #include "FWCore/Framework/interface/MakerMacros.h"
 #include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ParameterSet/interface/PluginDescription.h"
 #include "RecoParticleFlow/PFClusterProducer/interface/RecHitTopologicalCleanerBase.h"
 #include "RecoParticleFlow/PFClusterProducer/interface/SeedFinderBase.h"
 #include "RecoParticleFlow/PFClusterProducer/interface/InitialClusteringStepBase.h"
@@ -20,6 +21,7 @@
 #include "RecoLocalCalo/HGCalRecAlgos/interface/HGCalDepthPreClusterer.h"
 #include "RecoLocalCalo/HGCalRecAlgos/interface/HGCal3DClustering.h"
 #include "RecoLocalCalo/HGCalRecProducers/interface/HGCalClusteringAlgoBase.h"
+#include "RecoLocalCalo/HGCalRecProducers/interface/HGCalMultiClusterAlgoFactory.h"
 
 #include "FWCore/Framework/interface/ESHandle.h"
 #include "Geometry/Records/interface/IdealGeometryRecord.h"
@@ -41,7 +43,7 @@ private:
   edm::EDGetTokenT<HGCRecHitCollection> hits_bh_token;
   edm::EDGetTokenT<std::vector<reco::BasicCluster>> clusters_token;
   edm::EDGetTokenT<std::vector<reco::BasicCluster>> clusters_sharing_token;
-  std::unique_ptr<HGCal3DClustering> multicluster_algo;
+  std::unique_ptr<HGCalMultiClusterAlgoBase> multicluster_algo;
   bool doSharing;
   HGCalClusteringAlgoBase::VerbosityLevel verbosity;
 };
@@ -51,8 +53,6 @@ DEFINE_FWK_MODULE(HGCalMultiClusterProducer);
 HGCalMultiClusterProducer::HGCalMultiClusterProducer(const edm::ParameterSet& ps)
     : doSharing(ps.getParameter<bool>("doSharing")),
       verbosity((HGCalClusteringAlgoBase::VerbosityLevel)ps.getUntrackedParameter<unsigned int>("verbosity", 3)) {
-  std::vector<double> multicluster_radii = ps.getParameter<std::vector<double>>("multiclusterRadii");
-  double minClusters = ps.getParameter<unsigned>("minClusters");
   clusters_token = consumes<std::vector<reco::BasicCluster>>(ps.getParameter<edm::InputTag>("HGCLayerClusters"));
   clusters_sharing_token =
       consumes<std::vector<reco::BasicCluster>>(ps.getParameter<edm::InputTag>("HGCLayerClustersSharing"));
@@ -61,7 +61,9 @@ HGCalMultiClusterProducer::HGCalMultiClusterProducer(const edm::ParameterSet& ps
   hits_bh_token = consumes<HGCRecHitCollection>(ps.getParameter<edm::InputTag>("HGCBHInput"));
   auto sumes = consumesCollector();
 
-  multicluster_algo = std::make_unique<HGCal3DClustering>(ps, sumes, multicluster_radii, minClusters);
+  auto pluginPSet = ps.getParameter<edm::ParameterSet>("plugin");
+  multicluster_algo =
+      HGCalMultiClusterAlgoFactory::get()->create(pluginPSet.getParameter<std::string>("type"), ps, sumes);
 
   produces<std::vector<reco::HGCalMultiCluster>>();
   produces<std::vector<reco::HGCalMultiCluster>>("sharing");
@@ -84,6 +86,9 @@ void HGCalMultiClusterProducer::fillDescriptions(edm::ConfigurationDescriptions&
   desc.add<edm::InputTag>("HGCBHInput", edm::InputTag("HGCalRecHit", "HGCHEBRecHits"));
   desc.add<edm::InputTag>("HGCLayerClustersSharing", edm::InputTag("hgcalLayerClusters", "sharing"));
   desc.add<unsigned int>("minClusters", 3);
+  edm::ParameterSetDescription pluginDesc;
+  pluginDesc.addNode(edm::PluginDescription<HGCalMultiClusterAlgoFactory>("type", "KDTree", true));
+  desc.add<edm::ParameterSetDescription>("plugin", pluginDesc);
   descriptions.add("hgcalMultiClusters", desc);
 }
 
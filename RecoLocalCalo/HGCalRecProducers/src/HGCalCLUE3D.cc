@@ -0,0 +1,215 @@
+#include "RecoLocalCalo/HGCalRecProducers/interface/HGCalCLUE3D.h"
+
+#include "tbb/task_arena.h"
+#include "tbb/tbb.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+void HGCalCLUE3D::cluster(unsigned int maxLayer,
+                          const std::vector<float>& eta,
+                          const std::vector<float>& phi,
+                          const std::vector<float>& energy,
+                          const std::vector<int>& layer,
+                          const std::vector<int>& side) {
+  maxlayer_ = maxLayer;
+  organizeByLayerAndTile(eta, phi, energy, layer, side);
+
+  const size_t nLayers = maxlayer_ + 1;
+  tbb::this_task_arena::isolate([&] {
+    // the density of all the layers is needed before searching for the nearest higher
+    tbb::parallel_for(size_t(0), 2 * nLayers, [&](size_t i) {
+      calculateLocalDensity(layerClusters_[i / nLayers], i % nLayers);
+    });
+    tbb::parallel_for(size_t(0), 2 * nLayers, [&](size_t i) {
+      calculateDistanceToHigher(layerClusters_[i / nLayers], i % nLayers);
+    });
+    tbb::parallel_for(size_t(0), size_t(2), [&](size_t side) { findAndAssignClusters(layerClusters_[side]); });
+  });
+}
+
+void HGCalCLUE3D::organizeByLayerAndTile(const std::vector<float>& eta,
+                                         const std::vector<float>& phi,
+                                         const std::vector<float>& energy,
+                                         const std::vector<int>& layer,
+                                         const std::vector<int>& side) {
+  const int nBins = (maxlayer_ + 1) * nEtaBins_ * nPhiBins_;
+  for (auto& lcs : layerClusters_) {
+    lcs.clear();
+    lcs.tileStart.resize(nBins + 1, 0);
+  }
+
+  // count the layer clusters in each tile, then sort them by tile
+  const unsigned int nClusters = eta.size();
+  std::vector<int> bin(nClusters);
+  for (unsigned int i = 0; i < nClusters; ++i) {
+    bin[i] = globalBin(layer[i], etaBin(std::abs(eta[i])), phiBin(phi[i]));
+    ++layerClusters_[side[i]].tileStart[bin[i] + 1];
+  }
+
+  std::vector<int> next[2];
+  for (unsigned int s = 0; s < 2; ++s) {
+    auto& lcs = layerClusters_[s];
+    std::partial_sum(lcs.tileStart.begin(), lcs.tileStart.end(), lcs.tileStart.begin());
+    const int n = lcs.tileStart.back();
+    lcs.eta.resize(n);
+    lcs.phi.resize(n);
+    lcs.energy.resize(n);
+    lcs.layer.resize(n);
+    lcs.index.resize(n);
+    lcs.rho.assign(n, 0.f);
+    lcs.delta.assign(n, std::numeric_limits<float>::max());
+    lcs.nearestHigher.assign(n, -1);
+    lcs.clusterIndex.assign(n, -1);
+    lcs.isSeed.assign(n, 0);
+    next[s].assign(lcs.tileStart.begin(), lcs.tileStart.end() - 1);
+  }
+  for (unsigned int i = 0; i < nClusters; ++i) {
+    auto& lcs = layerClusters_[side[i]];
+    const int k = next[side[i]][bin[i]]++;
+    lcs.eta[k] = eta[i];
+    lcs.phi[k] = phi[i];
+    lcs.energy[k] = energy[i];
+    lcs.layer[k] = layer[i];
+    lcs.index[k] = i;
+  }
+}
+
+template <typename F>
+void HGCalCLUE3D::forEachRange(
+    const LayerClustersOnEndcap& lcs, int layer, float eta, float phi, float distance, F f) const {
+  const float absEta = std::abs(eta);
+  const int etaLow = etaBin(absEta - distance);
+  const int etaHigh = etaBin(absEta + distance);
+  const int phiLow = phiBin(phi - distance);
+  const int phiHigh = std::min(phiBin(phi + distance), phiLow + nPhiBins_ - 1);
+  const int first = (phiLow % nPhiBins_ + nPhiBins_) % nPhiBins_;
+  const int last = first + phiHigh - phiLow;
+  for (int ieta = etaLow; ieta <= etaHigh; ++ieta) {
+    // the tiles of a row in phi are contiguous, up to the wrap around
+    const int row = (layer * nEtaBins_ + ieta) * nPhiBins_;
+    if (last < nPhiBins_) {
+      f(lcs.tileStart[row + first], lcs.tileStart[row + last + 1]);
+    } else {
+      f(lcs.tileStart[row + first], lcs.tileStart[row + nPhiBins_]);
+      f(lcs.tileStart[row], lcs.tileStart[row + last - nPhiBins_ + 1]);
+    }
+  }
+}
+
+void HGCalCLUE3D::calculateLocalDensity(LayerClustersOnEndcap& lcs, int layer) const {
+  const int firstLayer = std::max(1, layer - densitySiblingLayers_);
+  const int lastLayer = std::min(int(maxlayer_), layer + densitySiblingLayers_);
+  const float distance2 = densityEtaPhiDistance_ * densityEtaPhiDistance_;
+  const float* eta = lcs.eta.data();
+  const float* phi = lcs.phi.data();
+  const float* energy = lcs.energy.data();
+
+  const int first = lcs.tileStart[layer * nEtaBins_ * nPhiBins_];
+  const int last = lcs.tileStart[(layer + 1) * nEtaBins_ * nPhiBins_];
+  for (int i = first; i < last; ++i) {
+    const float etai = eta[i];
+    const float phii = phi[i];
+    float rho = 0.f;
+    for (int l = firstLayer; l <= lastLayer; ++l) {
+      forEachRange(lcs, l, etai, phii, densityEtaPhiDistance_, [&](int begin, int end) {
+        // branchless, so that the compiler can vectorize it
+        for (int j = begin; j < end; ++j) {
+          const float deta = eta[j] - etai;
+          float dphi = phi[j] - phii;
+          dphi = dphi > float(M_PI) ? dphi - float(2. * M_PI) : (dphi < -float(M_PI) ? dphi + float(2. * M_PI) : dphi);
+          const float weight = (j == i ? 1.f : 0.5f) * energy[j];
+          rho += (deta * deta + dphi * dphi < distance2) ? weight : 0.f;
+        }
+      });
+    }
+    lcs.rho[i] = rho;
+  }
+}
+
+void HGCalCLUE3D::calculateDistanceToHigher(LayerClustersOnEndcap& lcs, int layer) const {
+  const int firstLayer = std::max(1, layer - densitySiblingLayers_);
+  const int lastLayer = std::min(int(maxlayer_), layer + densitySiblingLayers_);
+  // a nearest higher further than this makes an outlier or a seed anyway
+  const float range = outlierDeltaFactor_ * criticalEtaPhiDistance_;
+  const float range2 = range * range;
+  const float* eta = lcs.eta.data();
+  const float* phi = lcs.phi.data();
+  const float* rho = lcs.rho.data();
+
+  const int first = lcs.tileStart[layer * nEtaBins_ * nPhiBins_];
+  const int last = lcs.tileStart[(layer + 1) * nEtaBins_ * nPhiBins_];
+  for (int i = first; i < last; ++i) {
+    const float etai = eta[i];
+    const float phii = phi[i];
+    const float rhoi = rho[i];
+    float delta2 = range2;
+    int nearestHigher = -1;
+    for (int l = firstLayer; l <= lastLayer; ++l) {
+      forEachRange(lcs, l, etai, phii, range, [&](int begin, int end) {
+        for (int j = begin; j < end; ++j) {
+          const float deta = eta[j] - etai;
+          float dphi = phi[j] - phii;
+          dphi = dphi > float(M_PI) ? dphi - float(2. * M_PI) : (dphi < -float(M_PI) ? dphi + float(2. * M_PI) : dphi);
+          const float dist2 = deta * deta + dphi * dphi;
+          // the index breaks the ties in density, so that there is no loop
+          const bool higher = rho[j] > rhoi || (rho[j] == rhoi && j > i);
+          if (higher && dist2 < delta2) {
+            delta2 = dist2;
+            nearestHigher = j;
+          }
+        }
+      });
+    }
+    if (nearestHigher >= 0) {
+      lcs.delta[i] = std::sqrt(delta2);
+      lcs.nearestHigher[i] = nearestHigher;
+    } else {
+      // there is no higher layer cluster within outlierDeltaFactor_ * criticalEtaPhiDistance_
+      lcs.delta[i] = std::numeric_limits<float>::max();
+      lcs.nearestHigher[i] = -1;
+    }
+  }
+}
+
+void HGCalCLUE3D::findAndAssignClusters(LayerClustersOnEndcap& lcs) const {
+  const int n = lcs.eta.size();
+  auto isSeed = [&](int i) { return lcs.delta[i] > criticalEtaPhiDistance_ && lcs.rho[i] >= criticalDensity_; };
+  auto isOutlier = [&](int i) {
+    return lcs.delta[i] > outlierDeltaFactor_ * criticalEtaPhiDistance_ && lcs.rho[i] < criticalDensity_;
+  };
+
+  // find the seeds, and the followers of each layer cluster
+  lcs.followersStart.assign(n + 1, 0);
+  for (int i = 0; i < n; ++i) {
+    if (isSeed(i)) {
+      lcs.clusterIndex[i] = lcs.seeds.size();
+      lcs.isSeed[i] = 1;
+      lcs.seeds.push_back(i);
+    } else if (!isOutlier(i)) {
+      ++lcs.followersStart[lcs.nearestHigher[i] + 1];
+    }
+  }
+  std::partial_sum(lcs.followersStart.begin(), lcs.followersStart.end(), lcs.followersStart.begin());
+  lcs.followers.resize(lcs.followersStart.back());
+  std::vector<int> next(lcs.followersStart.begin(), lcs.followersStart.end() - 1);
+  for (int i = 0; i < n; ++i) {
+    if (!lcs.isSeed[i] && !isOutlier(i))
+      lcs.followers[next[lcs.nearestHigher[i]]++] = i;
+  }
+
+  // pass the cluster index of the seeds to their followers; the trees of the seeds are disjoint
+  tbb::parallel_for(size_t(0), lcs.seeds.size(), [&](size_t s) {
+    std::vector<int> localStack(1, lcs.seeds[s]);
+    while (!localStack.empty()) {
+      const int i = localStack.back();
+      localStack.pop_back();
+      for (int k = lcs.followersStart[i]; k < lcs.followersStart[i + 1]; ++k) {
+        const int j = lcs.followers[k];
+        lcs.clusterIndex[j] = lcs.clusterIndex[i];
+        localStack.push_back(j);
+      }
+    }
+  });
+}
@@ -0,0 +1,57 @@
+import FWCore.ParameterSet.Config as cms
+import FWCore.ParameterSet.VarParsing as VarParsing
+
+# Compare the multiclusters of the KDTree (default) and CLUE3D algorithms of
+# HGCalMultiClusterProducer, on the layer clusters of a 2026D49 RECO sample with
+# 200 pileup, e.g. the output of the step 3 of the 2026D49PU workflows:
+#   cmsRun testCLUE3DvsKDTree_cfg.py inputFiles=file:step3.root
+# The FastTimerService job summary gives the time of each of the two producers,
+# and the multiclusters of both are kept in the output file for comparison.
+
+options = VarParsing.VarParsing('analysis')
+options.outputFile = 'hgcal_multiclusters_clue3d_kdtree.root'
+options.parseArguments()
+
+from Configuration.Eras.Era_Phase2C9_timing_layer_bar_cff import Phase2C9_timing_layer_bar
+process = cms.Process("RECO2", Phase2C9_timing_layer_bar)
+
+process.load('Configuration.StandardSequences.Services_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.load('Configuration.Geometry.GeometryExtended2026D49Reco_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:phase2_realistic_T15', '')
+
+process.MessageLogger.cerr.FwkReport.reportEvery = 10
+
+# the layer clusters and the rechits of the input file
+from RecoLocalCalo.HGCalRecProducers.hgcalMultiClusters_cfi import hgcalMultiClusters
+process.hgcalMultiClustersKDTree = hgcalMultiClusters.clone()
+process.hgcalMultiClustersCLUE3D = hgcalMultiClusters.clone(
+    plugin = cms.PSet( type = cms.string('CLUE3D') )
+)
+
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(options.maxEvents) )
+process.source = cms.Source("PoolSource",
+                            fileNames = cms.untracked.vstring(options.inputFiles)
+                            )
+
+process.out = cms.OutputModule("PoolOutputModule",
+                               outputCommands = cms.untracked.vstring('drop *',
+                                                                      'keep *_hgcalMultiClusters*_*_RECO2'
+                                                                      ),
+                               fileName = cms.untracked.string(options.outputFile)
+                               )
+
+process.p = cms.Path( process.hgcalMultiClustersKDTree *
+                      process.hgcalMultiClustersCLUE3D )
+process.outpath = cms.EndPath(process.out)
+
+# time profiling
+if 'FastTimerService' in process.__dict__:
+    del process.FastTimerService
+process.load( "HLTrigger.Timer.FastTimerService_cfi" )
+process.FastTimerService.printJobSummary = True
+process.FastTimerService.enableDQM       = False
@@ -0,0 +1,200 @@
+/* Unit test of HGCalCLUE3D: the densities, the nearest highers, the seeds and the multiclusters of the layer
+   clusters must be those of a brute-force search over all the pairs of layer clusters, on synthetic showers
+   that also cross phi = pi and the |eta| = 1.4 and 3.2 edges of the tiles.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "RecoLocalCalo/HGCalRecProducers/interface/HGCalCLUE3D.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+class testHGCalCLUE3D : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testHGCalCLUE3D);
+  CPPUNIT_TEST(testBruteForce);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+
+  void testBruteForce();
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testHGCalCLUE3D);
+
+namespace {
+  constexpr float criticalDensity = 0.6f;
+  constexpr float densityEtaPhiDistance = 0.03f;
+  constexpr float criticalEtaPhiDistance = 0.035f;
+  constexpr float outlierDeltaFactor = 2.f;
+  constexpr int densitySiblingLayers = 3;
+  constexpr unsigned int maxLayer = 50;
+
+  struct LayerClusters {
+    std::vector<float> eta, phi, energy;
+    std::vector<int> layer, side;
+  };
+
+  float deltaPhi(float phi1, float phi2) {
+    float dphi = phi1 - phi2;
+    return dphi > float(M_PI) ? dphi - float(2. * M_PI) : (dphi < -float(M_PI) ? dphi + float(2. * M_PI) : dphi);
+  }
+
+  // the layer clusters that may be searched from each other
+  bool siblings(LayerClusters const& lcs, unsigned int i, unsigned int j) {
+    return lcs.side[i] == lcs.side[j] && std::abs(lcs.layer[i] - lcs.layer[j]) <= densitySiblingLayers;
+  }
+
+  // Showers of layer clusters over 20 layers, with energies in multiples of 1/4 GeV so that the densities are
+  // exact whatever the order of the sums. A layer cluster at a distance of another one close to the radii of
+  // the searches is not kept, the rounding of the distances could decide whether it is found.
+  LayerClusters makeLayerClusters() {
+    std::mt19937 rng(97531);
+    std::uniform_real_distribution<float> uniform(0.f, 1.f);
+    std::normal_distribution<float> gauss(0.f, 1.f);
+    LayerClusters lcs;
+
+    auto add = [&](float eta, float phi, int layer) {
+      phi = deltaPhi(phi, 0.f);
+      const int side = eta > 0;
+      for (unsigned int j = 0; j < lcs.eta.size(); ++j) {
+        if (lcs.side[j] != side || std::abs(lcs.layer[j] - layer) > densitySiblingLayers)
+          continue;
+        const double deta = double(lcs.eta[j]) - eta;
+        const double dphi = deltaPhi(lcs.phi[j], phi);
+        const double distance = std::sqrt(deta * deta + dphi * dphi);
+        for (float radius :
+             {densityEtaPhiDistance, criticalEtaPhiDistance, outlierDeltaFactor * criticalEtaPhiDistance}) {
+          if (std::abs(distance - radius) < 1e-4)
+            return;
+        }
+      }
+      lcs.eta.push_back(eta);
+      lcs.phi.push_back(phi);
+      lcs.energy.push_back(0.25f * (1 + int(16 * uniform(rng))));
+      lcs.layer.push_back(layer);
+      lcs.side.push_back(side);
+    };
+
+    auto shower = [&](float eta, float phi) {
+      const int firstLayer = 1 + int((maxLayer - 20) * uniform(rng));
+      for (int layer = firstLayer; layer < firstLayer + 20; ++layer) {
+        const int n = 1 + int(4 * uniform(rng));
+        for (int k = 0; k < n; ++k)
+          add(eta + 0.02f * gauss(rng), phi + 0.02f * gauss(rng), layer);
+      }
+    };
+
+    for (float sign : {-1.f, 1.f}) {
+      // across phi = pi, and across the edges of the tiles in |eta|
+      for (float phi : {float(M_PI) - 0.01f, -float(M_PI) + 0.005f})
+        shower(sign * 2.2f, phi);
+      for (float absEta : {1.39f, 1.41f, 3.19f, 3.21f, 3.3f})
+        shower(sign * absEta, 6.f * uniform(rng) - 3.f);
+      for (int s = 0; s < 40; ++s)
+        shower(sign * (1.3f + 2.1f * uniform(rng)), 2.f * float(M_PI) * uniform(rng) - float(M_PI));
+      // noise
+      for (int k = 0; k < 500; ++k)
+        add(sign * (1.3f + 2.1f * uniform(rng)),
+            2.f * float(M_PI) * uniform(rng) - float(M_PI),
+            1 + int(maxLayer * uniform(rng)));
+    }
+    return lcs;
+  }
+}  // namespace
+
+void testHGCalCLUE3D::testBruteForce() {
+  const LayerClusters lcs = makeLayerClusters();
+  const unsigned int n = lcs.eta.size();
+  HGCalCLUE3D clue3D(
+      criticalDensity, densityEtaPhiDistance, criticalEtaPhiDistance, outlierDeltaFactor, densitySiblingLayers);
+  clue3D.cluster(maxLayer, lcs.eta, lcs.phi, lcs.energy, lcs.layer, lcs.side);
+
+  // the layer clusters in the order of the input, and where they are in the endcaps
+  std::vector<int> position(n, -1);
+  for (int s = 0; s < 2; ++s) {
+    const auto& endcap = clue3D.endcap(s);
+    for (unsigned int k = 0; k < endcap.index.size(); ++k) {
+      const int i = endcap.index[k];
+      CPPUNIT_ASSERT_EQUAL(-1, position[i]);
+      CPPUNIT_ASSERT_EQUAL(s, lcs.side[i]);
+      CPPUNIT_ASSERT_EQUAL(lcs.eta[i], endcap.eta[k]);
+      CPPUNIT_ASSERT_EQUAL(lcs.phi[i], endcap.phi[k]);
+      CPPUNIT_ASSERT_EQUAL(lcs.energy[i], endcap.energy[k]);
+      CPPUNIT_ASSERT_EQUAL(lcs.layer[i], endcap.layer[k]);
+      position[i] = k;
+    }
+  }
+  CPPUNIT_ASSERT(std::find(position.begin(), position.end(), -1) == position.end());
+
+  // brute force: the density with all the layer clusters, then the nearest higher among them, with the
+  // ties in density broken by the position in the endcap as in HGCalCLUE3D
+  std::vector<float> rho(n, 0.f);
+  unsigned int acrossPhiPi = 0, acrossEtaEdges = 0;
+  for (unsigned int i = 0; i < n; ++i) {
+    for (unsigned int j = 0; j < n; ++j) {
+      const float deta = lcs.eta[j] - lcs.eta[i];
+      const float dphi = deltaPhi(lcs.phi[j], lcs.phi[i]);
+      if (siblings(lcs, i, j) && deta * deta + dphi * dphi < densityEtaPhiDistance * densityEtaPhiDistance) {
+        rho[i] += (i == j ? 1.f : 0.5f) * lcs.energy[j];
+        acrossPhiPi += std::abs(lcs.phi[j] - lcs.phi[i]) > float(M_PI);
+        acrossEtaEdges += (std::abs(lcs.eta[i]) < 1.4f) != (std::abs(lcs.eta[j]) < 1.4f) ||
+                          (std::abs(lcs.eta[i]) > 3.2f) != (std::abs(lcs.eta[j]) > 3.2f);
+      }
+    }
+  }
+  CPPUNIT_ASSERT(acrossPhiPi > 0);
+  CPPUNIT_ASSERT(acrossEtaEdges > 0);
+
+  const float range = outlierDeltaFactor * criticalEtaPhiDistance;
+  std::vector<int> nearestHigher(n, -1);
+  std::vector<float> delta(n, std::numeric_limits<float>::max());
+  for (unsigned int i = 0; i < n; ++i) {
+    float delta2 = range * range;
+    for (unsigned int j = 0; j < n; ++j) {
+      const float deta = lcs.eta[j] - lcs.eta[i];
+      const float dphi = deltaPhi(lcs.phi[j], lcs.phi[i]);
+      const float dist2 = deta * deta + dphi * dphi;
+      const bool higher = rho[j] > rho[i] || (rho[j] == rho[i] && position[j] > position[i]);
+      if (siblings(lcs, i, j) && higher && dist2 < delta2) {
+        delta2 = dist2;
+        nearestHigher[i] = j;
+      }
+    }
+    if (nearestHigher[i] >= 0)
+      delta[i] = std::sqrt(delta2);
+  }
+
+  // the seeds, and the seed of each layer cluster following nearest highers up to a seed or an outlier
+  auto isSeed = [&](int i) { return delta[i] > criticalEtaPhiDistance && rho[i] >= criticalDensity; };
+  auto isOutlier = [&](int i) { return delta[i] > range && rho[i] < criticalDensity; };
+  unsigned int nSeeds = 0, nFollowers = 0;
+  for (unsigned int i = 0; i < n; ++i) {
+    const auto& endcap = clue3D.endcap(lcs.side[i]);
+    const int k = position[i];
+    CPPUNIT_ASSERT_EQUAL(rho[i], endcap.rho[k]);
+    CPPUNIT_ASSERT_EQUAL(nearestHigher[i], endcap.nearestHigher[k] < 0 ? -1 : endcap.index[endcap.nearestHigher[k]]);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(delta[i], endcap.delta[k], 1e-6 * delta[i]);
+    CPPUNIT_ASSERT_EQUAL(isSeed(i), bool(endcap.isSeed[k]));
+
+    int seed = i;
+    while (!isSeed(seed) && !isOutlier(seed))
+      seed = nearestHigher[seed];
+    if (isSeed(seed)) {
+      CPPUNIT_ASSERT(endcap.clusterIndex[k] >= 0);
+      CPPUNIT_ASSERT_EQUAL(seed, endcap.index[endcap.seeds[endcap.clusterIndex[k]]]);
+      nSeeds += (seed == int(i));
+      nFollowers += (seed != int(i));
+    } else {
+      CPPUNIT_ASSERT_EQUAL(-1, endcap.clusterIndex[k]);
+    }
+  }
+  CPPUNIT_ASSERT_EQUAL(clue3D.endcap(0).seeds.size() + clue3D.endcap(1).seeds.size(), size_t(nSeeds));
+  CPPUNIT_ASSERT(nSeeds > 50);
+  CPPUNIT_ASSERT(nFollowers > n / 2);
+}
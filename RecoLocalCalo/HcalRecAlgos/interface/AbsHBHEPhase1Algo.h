@@ -7,6 +7,8 @@
 #include "CalibFormats/HcalObjects/interface/HcalCalibrations.h"
 #include "CondFormats/HcalObjects/interface/HcalRecoParam.h"
 
+#include <vector>
+
 class AbsHcalAlgoData;
 
 //
@@ -50,6 +52,23 @@ public:
                                  const HcalRecoParam* params,
                                  const HcalCalibrations& calibs,
                                  bool isRealData) = 0;
+
+  // Algorithms which are faster when they reconstruct several
+  // channels at once should return "true" here and override
+  // "reconstructBatch". The same conventions as for "reconstruct"
+  // apply to each channel, and the rechits are returned in the
+  // order of the channels.
+  inline virtual bool isBatched() const { return false; }
+
+  inline virtual void reconstructBatch(const std::vector<const HBHEChannelInfo*>& infos,
+                                       const std::vector<const HcalRecoParam*>& params,
+                                       const std::vector<const HcalCalibrations*>& calibs,
+                                       bool isRealData,
+                                       std::vector<HBHERecHit>& rechits) {
+    rechits.clear();
+    for (unsigned i = 0; i < infos.size(); ++i)
+      rechits.push_back(reconstruct(*infos[i], params[i], *calibs[i], isRealData));
+  }
 };
 
 #endif  // RecoLocalCalo_HcalRecAlgos_AbsHBHEPhase1Algo_h_
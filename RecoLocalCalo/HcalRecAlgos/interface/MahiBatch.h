@@ -0,0 +1,125 @@
+#ifndef RecoLocalCalo_HcalRecAlgos_MahiBatch_h
+#define RecoLocalCalo_HcalRecAlgos_MahiBatch_h
+
+#include "RecoLocalCalo/HcalRecAlgos/interface/EigenMatrixTypes.h"
+
+#include <array>
+#include <vector>
+
+//
+// Minimization of the Mahi chi2 for many channels at once.
+//
+// The channels of a group, which must have the same number of samples and
+// the same pulses, are fitted "lanes" at a time.  The matrices of the
+// channels being fitted are stored structure-of-arrays, with the lane as the
+// innermost index, and all the linear algebra (covariance update, Cholesky
+// decomposition, triangular solves, normal equations and solution of the
+// NNLS subproblems) is done for all the lanes together, in loops over the
+// lanes that the compiler vectorizes.  Each lane runs its own iterations of
+// the minimization and of the NNLS, and takes the next channel of the group
+// as soon as its channel has converged, so that the lanes do not wait for
+// the slowest channel.
+//
+// The algorithm is the one of MahiFit::minimize() and MahiFit::nnls(),
+// including the warm start of the NNLS from the previous amplitudes and the
+// order in which the pulses are released.  The NNLS subproblems are solved
+// with an LDLT decomposition without pivoting.  The results therefore
+// differ from those of MahiFit only by the rounding of the linear algebra:
+// on simulated HBHE channels the fitted amplitudes agree within a relative
+// difference of 1e-5 (or 1e-5 fC for amplitudes below 1 fC).
+//
+class MahiBatch {
+public:
+  static constexpr unsigned int lanes = 8;
+
+  MahiBatch(int nMaxItersMin, int nMaxItersNNLS, double deltaChiSqThresh, double nnlsThresh);
+
+  // Start a new group of channels
+  void reset(unsigned int nSamples, unsigned int nPulses);
+
+  // Queue a channel, "pulseCov" points to the covariance matrix of each pulse,
+  // or is null for the pedestal. Returns the index of the channel in the group.
+  unsigned int add(const SampleVector& amplitudes,
+                   const SampleVector& noiseTerms,
+                   double pedVal,
+                   const SamplePulseMatrix& pulseMat,
+                   const SampleMatrix* const* pulseCov);
+
+  unsigned int size() const { return nChannels_; }
+  unsigned int nSamples() const { return nSamples_; }
+  unsigned int nPulses() const { return nPulses_; }
+
+  // Fit all the channels of the group
+  void minimize();
+
+  // Results, with the pulses in the order of the pulse matrix
+  const PulseVector& ampVec(unsigned int channel) const { return channels_[channel].ampVec; }
+  double chiSq(unsigned int channel) const { return channels_[channel].chiSq; }
+
+private:
+  struct Channel {
+    SampleVector amplitudes;
+    SampleVector noiseTerms;
+    double pedVal;
+    SamplePulseMatrix pulseMat;
+    std::array<SampleMatrix, MaxPVSize> pulseCov;
+
+    PulseVector ampVec;
+    double chiSq;
+  };
+
+  typedef double LaneMask[lanes];  // 1 for the lanes to update, 0 otherwise
+
+  void load(unsigned int lane, unsigned int channel);
+  void store(unsigned int lane);
+
+  void updateCovariance(const LaneMask& mask);
+  void solveL(const double (&in)[MaxSVSize][lanes], double (&out)[MaxSVSize][lanes]) const;
+  void calculateChiSq(double (&chiSq)[lanes]) const;
+  void solveSubmatrix(const unsigned int (&nP)[lanes], double (&solution)[MaxPVSize][lanes]);
+
+  const int nMaxItersMin_;
+  const int nMaxItersNNLS_;
+  const double deltaChiSqThresh_;
+  const double nnlsThresh_;
+
+  unsigned int nSamples_ = 0;
+  unsigned int nPulses_ = 0;
+  unsigned int nChannels_ = 0;
+  std::vector<Channel> channels_;
+  std::array<bool, MaxPVSize> hasCov_;
+
+  // inputs of the channels in the lanes
+  int channel_[lanes];
+  alignas(64) double amplitudes_[MaxSVSize][lanes];
+  alignas(64) double noiseTerms_[MaxSVSize][lanes];
+  alignas(64) double pedVal_[lanes];
+  alignas(64) double pulseMat_[MaxPVSize][MaxSVSize][lanes];
+  alignas(64) double pulseCov_[MaxPVSize][MaxSVSize][MaxSVSize][lanes];
+
+  // minimization
+  alignas(64) double ampVec_[MaxPVSize][lanes];
+  alignas(64) double covL_[MaxSVSize][MaxSVSize][lanes];  // Cholesky factor of the covariance
+  alignas(64) double aTaMat_[MaxPVSize][MaxPVSize][lanes];
+  alignas(64) double aTbVec_[MaxPVSize][lanes];
+  double chiSq_[lanes];
+  double oldChiSq_[lanes];
+  int iterMin_[lanes];
+
+  // NNLS
+  unsigned int order_[MaxPVSize][lanes];  // permutation of the pulses done by MahiFit::nnls()
+  unsigned int nP_[lanes];
+  int iterNNLS_[lanes];
+  unsigned int idxwmax_[lanes];
+  double wmax_[lanes];
+  double threshold_[lanes];
+
+  // work
+  alignas(64) double cov_[MaxSVSize][MaxSVSize][lanes];
+  alignas(64) double invcovp_[MaxPVSize][MaxSVSize][lanes];
+  alignas(64) double invcovy_[MaxSVSize][lanes];
+  alignas(64) double ldlL_[MaxPVSize][MaxPVSize][lanes];  // L * D
+  alignas(64) double ldlD_[MaxPVSize][lanes];             // 1 / D
+};
+
+#endif
@@ -6,6 +6,7 @@
 #include "CalibFormats/HcalObjects/interface/HcalCalibrations.h"
 #include "CalibFormats/HcalObjects/interface/HcalCoder.h"
 #include "RecoLocalCalo/HcalRecAlgos/interface/EigenMatrixTypes.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/MahiBatch.h"
 #include "DataFormats/HcalRecHit/interface/HBHEChannelInfo.h"
 
 #include "CalibCalorimetry/HcalAlgos/interface/HcalPulseShapes.h"
@@ -14,6 +15,9 @@
 
 #include <Math/Functor.h>
 
+#include <memory>
+#include <vector>
+
 struct MahiNnlsWorkspace {
   unsigned int nPulseTot;
   unsigned int tsSize;
@@ -90,6 +94,13 @@ struct MahiDebugInfo {
   float nPulse[MaxSVSize];
 };
 
+struct MahiFitResult {
+  float energy;
+  float time;
+  bool useTriple;
+  float chiSq;
+};
+
 class MahiFit {
 public:
   MahiFit();
@@ -116,6 +127,13 @@ public:
                    bool& useTriple,
                    float& chi2) const;
 
+  // Same as phase1Apply for several channels, fitted together with MahiBatch.
+  // The pulse shape template of each channel is set here.
+  void phase1ApplyBatch(const std::vector<const HBHEChannelInfo*>& channels,
+                        const HcalPulseShapes& pulseShapes,
+                        const HcalTimeSlew* hcalTimeSlewDelay,
+                        std::vector<MahiFitResult>& results);
+
   void phase1Debug(const HBHEChannelInfo& channelData, MahiDebugInfo& mdi) const;
 
   void doFit(std::array<float, 3>& correctedOutput, const int nbx) const;
@@ -131,6 +149,31 @@ public:
   const HcalTimeSlew* hcalTimeSlewDelay_ = nullptr;
 
 private:
+  // batched fits
+  struct BatchChannel {
+    unsigned int index;
+    MahiBatch* batch;
+    unsigned int slot;
+    unsigned int nPulseTot;
+    unsigned int tsSize;
+    BXVector bxs;
+    SampleVector amplitudes;
+    SamplePulseMatrix pulseMat;
+    SamplePulseMatrix pulseDerivMat;
+  };
+
+  bool prepareChannel(const HBHEChannelInfo& channelData) const;
+  void setupFit(const int nbx) const;
+  void fillFitResult(std::array<float, 3>& correctedOutput, double chiSq) const;
+  void fitBatch(const std::vector<unsigned int>& order,
+                const int nbx,
+                const std::vector<const HBHEChannelInfo*>& channels,
+                const HcalPulseShapes& pulseShapes,
+                const HcalTimeSlew* hcalTimeSlewDelay,
+                std::vector<std::array<float, 3>>& reconstructedVals,
+                std::vector<unsigned int>& fitted);
+  MahiBatch& batchFor(unsigned int nSamples, unsigned int nPulses);
+
   double minimize() const;
   void onePulseMinimize() const;
   void updateCov() const;
@@ -187,5 +230,13 @@ private:
   int cntsetPulseShape_;
   std::unique_ptr<FitterFuncs::PulseShapeFunctor> psfPtr_;
   std::unique_ptr<ROOT::Math::Functor> pfunctor_;
+
+  // for the batched fits, one MahiBatch per number of samples and of pulses
+  std::vector<std::unique_ptr<MahiBatch>> batches_;
+  std::vector<BatchChannel> batchChannels_;
+  std::vector<unsigned int> batchOrder_;
+  std::vector<unsigned int> batchFitted_;
+  std::vector<unsigned int> batchRefit_;
+  std::vector<std::array<float, 3>> batchVals_;
 };
 #endif
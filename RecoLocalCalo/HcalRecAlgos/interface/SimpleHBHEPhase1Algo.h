@@ -39,6 +39,9 @@ public:
   //
   //   detFit           -- "Method 3" (a.k.a. "deterministic fit") object
   //
+  //   batchedMahi      -- fit the channels with Mahi in batches
+  //                       (see MahiBatch.h), through "reconstructBatch"
+  //
   SimpleHBHEPhase1Algo(int firstSampleShift,
                        int samplesToAdd,
                        float phaseNS,
@@ -47,7 +50,8 @@ public:
                        bool applyLegacyHBMCorrection,
                        std::unique_ptr<PulseShapeFitOOTPileupCorrection> m2,
                        std::unique_ptr<HcalDeterministicFit> detFit,
-                       std::unique_ptr<MahiFit> mahi);
+                       std::unique_ptr<MahiFit> mahi,
+                       bool batchedMahi = false);
 
   inline ~SimpleHBHEPhase1Algo() override {}
 
@@ -61,6 +65,15 @@ public:
                          const HcalRecoParam* params,
                          const HcalCalibrations& calibs,
                          bool isRealData) override;
+
+  inline bool isBatched() const override { return batchedMahi_ && mahiOOTpuCorr_; }
+
+  void reconstructBatch(const std::vector<const HBHEChannelInfo*>& infos,
+                        const std::vector<const HcalRecoParam*>& params,
+                        const std::vector<const HcalCalibrations*>& calibs,
+                        bool isRealData,
+                        std::vector<HBHERecHit>& rechits) override;
+
   // Basic accessors
   inline int getFirstSampleShift() const { return firstSampleShift_; }
   inline int getSamplesToAdd() const { return samplesToAdd_; }
@@ -87,6 +100,13 @@ protected:
   // "Method 0" rechit timing (original low-pileup QIE8 algorithm)
   float m0Time(const HBHEChannelInfo& info, double reconstructedCharge, int nSamplesToExamine) const;
 
+  // Reconstruction with all the methods, Mahi is run here
+  // unless its result is given
+  HBHERecHit reconstructChannel(const HBHEChannelInfo& info,
+                                const HcalRecoParam* params,
+                                bool isRealData,
+                                const MahiFitResult* mahiResult);
+
 private:
   HcalPulseContainmentManager pulseCorr_;
 
@@ -106,6 +126,8 @@ private:
 
   // Mahi algorithm
   std::unique_ptr<MahiFit> mahiOOTpuCorr_;
+  bool batchedMahi_;
+  std::vector<MahiFitResult> mahiResults_;
 
   HcalPulseShapes theHcalPulseShapes_;
 };
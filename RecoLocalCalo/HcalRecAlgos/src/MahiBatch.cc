@@ -0,0 +1,448 @@
+#include "RecoLocalCalo/HcalRecAlgos/interface/MahiBatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+MahiBatch::MahiBatch(int nMaxItersMin, int nMaxItersNNLS, double deltaChiSqThresh, double nnlsThresh)
+    : nMaxItersMin_(nMaxItersMin),
+      nMaxItersNNLS_(nMaxItersNNLS),
+      deltaChiSqThresh_(deltaChiSqThresh),
+      nnlsThresh_(nnlsThresh) {}
+
+void MahiBatch::reset(unsigned int nSamples, unsigned int nPulses) {
+  nSamples_ = nSamples;
+  nPulses_ = nPulses;
+  nChannels_ = 0;
+}
+
+unsigned int MahiBatch::add(const SampleVector& amplitudes,
+                            const SampleVector& noiseTerms,
+                            double pedVal,
+                            const SamplePulseMatrix& pulseMat,
+                            const SampleMatrix* const* pulseCov) {
+  // the channels are kept between the groups, to reuse their memory
+  if (nChannels_ == channels_.size())
+    channels_.emplace_back();
+  Channel& channel = channels_[nChannels_];
+
+  channel.amplitudes = amplitudes;
+  channel.noiseTerms = noiseTerms;
+  channel.pedVal = pedVal;
+  channel.pulseMat = pulseMat;
+  // the pedestal has no covariance, it is the same pulse for all the channels of a group
+  for (unsigned int iBX = 0; iBX < nPulses_; ++iBX) {
+    hasCov_[iBX] = pulseCov[iBX] != nullptr;
+    if (hasCov_[iBX])
+      channel.pulseCov[iBX] = *pulseCov[iBX];
+  }
+
+  return nChannels_++;
+}
+
+void MahiBatch::load(unsigned int lane, unsigned int channel) {
+  const Channel& input = channels_[channel];
+
+  for (unsigned int iTS = 0; iTS < nSamples_; ++iTS) {
+    amplitudes_[iTS][lane] = input.amplitudes.coeff(iTS);
+    noiseTerms_[iTS][lane] = input.noiseTerms.coeff(iTS);
+  }
+  pedVal_[lane] = input.pedVal;
+
+  for (unsigned int iBX = 0; iBX < nPulses_; ++iBX) {
+    ampVec_[iBX][lane] = 0.;
+    for (unsigned int iTS = 0; iTS < nSamples_; ++iTS)
+      pulseMat_[iBX][iTS][lane] = input.pulseMat.coeff(iTS, iBX);
+    if (hasCov_[iBX]) {
+      for (unsigned int iTS = 0; iTS < nSamples_; ++iTS)
+        for (unsigned int jTS = 0; jTS < nSamples_; ++jTS)
+          pulseCov_[iBX][iTS][jTS][lane] = input.pulseCov[iBX].coeff(iTS, jTS);
+    }
+  }
+}
+
+void MahiBatch::store(unsigned int lane) {
+  Channel& output = channels_[channel_[lane]];
+
+  output.ampVec.resize(nPulses_);
+  for (unsigned int iBX = 0; iBX < nPulses_; ++iBX)
+    output.ampVec.coeffRef(iBX) = ampVec_[iBX][lane];
+  output.chiSq = chiSq_[lane];
+}
+
+//
+// Each lane goes through the steps of MahiFit::minimize() and MahiFit::nnls()
+// for its own channel: at each round, every step is done at once for all the
+// lanes which are at this step.
+//
+void MahiBatch::minimize() {
+  enum State { idle, covariance, select, solve, chiSquare };
+
+  if (nChannels_ == 0)
+    return;
+
+  State state[lanes];
+  unsigned int nextChannel = 0;
+  unsigned int nBusy = 0;
+
+  auto startFit = [&](unsigned int l) {
+    while (nextChannel < nChannels_) {
+      channel_[l] = nextChannel;
+      load(l, nextChannel++);
+      for (unsigned int iBX = 0; iBX < nPulses_; ++iBX)
+        order_[iBX][l] = iBX;
+      oldChiSq_[l] = 9999;
+      chiSq_[l] = oldChiSq_[l];
+      iterMin_[l] = 1;
+      if (iterMin_[l] < nMaxItersMin_) {
+        state[l] = covariance;
+        return;
+      }
+      store(l);
+    }
+    state[l] = idle;
+    channel_[l] = -1;
+    --nBusy;
+  };
+
+  auto endNNLSIteration = [&](unsigned int l) {
+    ++iterNNLS_[l];
+
+    //adaptive convergence threshold to avoid infinite loops but still
+    //ensure best value is used
+    if (iterNNLS_[l] % 10 == 0) {
+      threshold_[l] *= 10.;
+    }
+    state[l] = select;
+  };
+
+  for (unsigned int l = 0; l < lanes; ++l) {
+    // the idle lanes hold a copy of the first channel, so that they compute valid numbers
+    if (l >= nChannels_)
+      load(l, 0);
+    ++nBusy;
+    startFit(l);
+  }
+
+  const unsigned int nMaxP = std::min(nPulses_, nSamples_);
+  double updateWork[MaxPVSize][lanes];
+  double ampVecTest[MaxPVSize][lanes];
+  double newChiSq[lanes];
+
+  while (nBusy > 0) {
+    // new iteration of the minimization: update of the covariance matrix and of the normal equations,
+    // also done for the idle lanes to keep valid numbers in them. The lanes wait for this step until
+    // half of them need it, or until the others have nothing else to do.
+    LaneMask mask;
+    unsigned int nWaiting = 0;
+    unsigned int nNNLS = 0;
+    for (unsigned int l = 0; l < lanes; ++l) {
+      nWaiting += state[l] == covariance;
+      nNNLS += state[l] == select || state[l] == solve;
+      mask[l] = state[l] == covariance || state[l] == idle ? 1. : 0.;
+    }
+    bool any = nWaiting > 0 && (nNNLS == 0 || 2 * nWaiting >= lanes);
+    if (any) {
+      updateCovariance(mask);
+
+      for (unsigned int l = 0; l < lanes; ++l) {
+        if (state[l] != covariance)
+          continue;
+        if (nPulses_ > 1) {
+          nP_[l] = 0;
+          iterNNLS_[l] = 0;
+          idxwmax_[l] = 0;
+          wmax_[l] = 0.;
+          threshold_[l] = nnlsThresh_;
+          state[l] = select;
+        } else {
+          ampVec_[0][l] = std::max(0., aTbVec_[0][l] / aTaMat_[0][0][l]);
+          state[l] = chiSquare;
+        }
+      }
+    }
+
+    // NNLS: choice of the pulse to unconstrain
+    any = false;
+    for (unsigned int l = 0; l < lanes; ++l)
+      any |= state[l] == select;
+    if (any) {
+      for (unsigned int iBX = 0; iBX < nPulses_; ++iBX) {
+        for (unsigned int l = 0; l < lanes; ++l)
+          updateWork[iBX][l] = aTbVec_[iBX][l];
+        for (unsigned int jBX = 0; jBX < nPulses_; ++jBX)
+          for (unsigned int l = 0; l < lanes; ++l)
+            updateWork[iBX][l] -= aTaMat_[iBX][jBX][l] * ampVec_[jBX][l];
+      }
+
+      for (unsigned int l = 0; l < lanes; ++l) {
+        if (state[l] != select)
+          continue;
+
+        if (nP_[l] == nMaxP) {
+          state[l] = chiSquare;
+          continue;
+        }
+
+        // the first maximum among the constrained pulses, in the order of MahiFit
+        const unsigned int idxwmaxprev = idxwmax_[l];
+        const double wmaxprev = wmax_[l];
+        idxwmax_[l] = 0;
+        wmax_[l] = updateWork[order_[nP_[l]][l]][l];
+        for (unsigned int ipos = nP_[l] + 1; ipos < nPulses_; ++ipos) {
+          const double w = updateWork[order_[ipos][l]][l];
+          if (w > wmax_[l]) {
+            wmax_[l] = w;
+            idxwmax_[l] = ipos - nP_[l];
+          }
+        }
+
+        if (wmax_[l] < threshold_[l] || (idxwmax_[l] == idxwmaxprev && wmax_[l] == wmaxprev) ||
+            iterNNLS_[l] >= nMaxItersNNLS_) {
+          state[l] = chiSquare;
+          continue;
+        }
+
+        //unconstrain parameter
+        idxwmax_[l] += nP_[l];
+        std::swap(order_[nP_[l]][l], order_[idxwmax_[l]][l]);
+        ++nP_[l];
+        state[l] = solve;
+      }
+    }
+
+    // NNLS: solution of the unconstrained problem
+    unsigned int nPSolve[lanes];
+    any = false;
+    for (unsigned int l = 0; l < lanes; ++l) {
+      nPSolve[l] = state[l] == solve ? nP_[l] : 0;
+      any |= state[l] == solve;
+    }
+    if (any) {
+      solveSubmatrix(nPSolve, ampVecTest);
+
+      for (unsigned int l = 0; l < lanes; ++l) {
+        if (state[l] != solve)
+          continue;
+
+        //check solution
+        bool positive = true;
+        for (unsigned int ipos = 0; ipos < nP_[l]; ++ipos)
+          positive &= (ampVecTest[ipos][l] > 0);
+        if (positive) {
+          for (unsigned int ipos = 0; ipos < nP_[l]; ++ipos)
+            ampVec_[order_[ipos][l]][l] = ampVecTest[ipos][l];
+          endNNLSIteration(l);
+          continue;
+        }
+
+        //update parameter vector
+        unsigned int minratiopos = 0;
+        double minratio = std::numeric_limits<double>::max();
+        for (unsigned int ipos = 0; ipos < nP_[l]; ++ipos) {
+          if (ampVecTest[ipos][l] <= 0.) {
+            const double c_ampvec = ampVec_[order_[ipos][l]][l];
+            const double ratio = c_ampvec / (c_ampvec - ampVecTest[ipos][l]);
+            if (ratio < minratio) {
+              minratio = ratio;
+              minratiopos = ipos;
+            }
+          }
+        }
+        for (unsigned int ipos = 0; ipos < nP_[l]; ++ipos) {
+          double& amp = ampVec_[order_[ipos][l]][l];
+          amp += minratio * (ampVecTest[ipos][l] - amp);
+        }
+
+        //avoid numerical problems with later ==0. check
+        ampVec_[order_[minratiopos][l]][l] = 0.;
+
+        //constrain parameter
+        std::swap(order_[nP_[l] - 1][l], order_[minratiopos][l]);
+        --nP_[l];
+        if (nP_[l] == 0)
+          endNNLSIteration(l);
+      }
+    }
+
+    // end of the iteration of the minimization
+    any = false;
+    for (unsigned int l = 0; l < lanes; ++l)
+      any |= state[l] == chiSquare;
+    if (any) {
+      calculateChiSq(newChiSq);
+
+      for (unsigned int l = 0; l < lanes; ++l) {
+        if (state[l] != chiSquare)
+          continue;
+
+        const double deltaChiSq = newChiSq[l] - chiSq_[l];
+        bool converged = newChiSq[l] == oldChiSq_[l] && newChiSq[l] < chiSq_[l];
+        if (!converged) {
+          oldChiSq_[l] = chiSq_[l];
+          chiSq_[l] = newChiSq[l];
+          converged = std::abs(deltaChiSq) < deltaChiSqThresh_ || ++iterMin_[l] >= nMaxItersMin_;
+        }
+
+        if (converged) {
+          store(l);
+          startFit(l);
+        } else {
+          state[l] = covariance;
+        }
+      }
+    }
+  }
+}
+
+void MahiBatch::updateCovariance(const LaneMask& mask) {
+  for (unsigned int iTS = 0; iTS < nSamples_; ++iTS) {
+    for (unsigned int jTS = 0; jTS <= iTS; ++jTS)
+      for (unsigned int l = 0; l < lanes; ++l)
+        cov_[iTS][jTS][l] = pedVal_[l];
+    for (unsigned int l = 0; l < lanes; ++l)
+      cov_[iTS][iTS][l] += noiseTerms_[iTS][l];
+  }
+
+  // the pulses with a null amplitude add a null contribution: no need to skip them
+  for (unsigned int iBX = 0; iBX < nPulses_; ++iBX) {
+    if (!hasCov_[iBX])
+      continue;
+    double ampsq[lanes];
+    for (unsigned int l = 0; l < lanes; ++l)
+      ampsq[l] = ampVec_[iBX][l] * ampVec_[iBX][l];
+    for (unsigned int iTS = 0; iTS < nSamples_; ++iTS)
+      for (unsigned int jTS = 0; jTS <= iTS; ++jTS)
+        for (unsigned int l = 0; l < lanes; ++l)
+          cov_[iTS][jTS][l] += ampsq[l] * pulseCov_[iBX][iTS][jTS][l];
+  }
+
+  // Cholesky decomposition, in place in the lower triangle
+  for (unsigned int j = 0; j < nSamples_; ++j) {
+    for (unsigned int k = 0; k < j; ++k)
+      for (unsigned int l = 0; l < lanes; ++l)
+        cov_[j][j][l] -= cov_[j][k][l] * cov_[j][k][l];
+    for (unsigned int l = 0; l < lanes; ++l)
+      cov_[j][j][l] = std::sqrt(cov_[j][j][l]);
+
+    for (unsigned int i = j + 1; i < nSamples_; ++i) {
+      for (unsigned int k = 0; k < j; ++k)
+        for (unsigned int l = 0; l < lanes; ++l)
+          cov_[i][j][l] -= cov_[i][k][l] * cov_[j][k][l];
+      for (unsigned int l = 0; l < lanes; ++l)
+        cov_[i][j][l] /= cov_[j][j][l];
+    }
+  }
+
+  for (unsigned int iTS = 0; iTS < nSamples_; ++iTS)
+    for (unsigned int jTS = 0; jTS <= iTS; ++jTS)
+      for (unsigned int l = 0; l < lanes; ++l)
+        covL_[iTS][jTS][l] = mask[l] != 0. ? cov_[iTS][jTS][l] : covL_[iTS][jTS][l];
+
+  // normal equations
+  for (unsigned int iBX = 0; iBX < nPulses_; ++iBX)
+    solveL(pulseMat_[iBX], invcovp_[iBX]);
+  solveL(amplitudes_, invcovy_);
+
+  for (unsigned int iBX = 0; iBX < nPulses_; ++iBX) {
+    for (unsigned int jBX = 0; jBX <= iBX; ++jBX) {
+      double sum[lanes] = {};
+      for (unsigned int iTS = 0; iTS < nSamples_; ++iTS)
+        for (unsigned int l = 0; l < lanes; ++l)
+          sum[l] += invcovp_[iBX][iTS][l] * invcovp_[jBX][iTS][l];
+      for (unsigned int l = 0; l < lanes; ++l) {
+        aTaMat_[iBX][jBX][l] = mask[l] != 0. ? sum[l] : aTaMat_[iBX][jBX][l];
+        aTaMat_[jBX][iBX][l] = aTaMat_[iBX][jBX][l];
+      }
+    }
+    double sum[lanes] = {};
+    for (unsigned int iTS = 0; iTS < nSamples_; ++iTS)
+      for (unsigned int l = 0; l < lanes; ++l)
+        sum[l] += invcovp_[iBX][iTS][l] * invcovy_[iTS][l];
+    for (unsigned int l = 0; l < lanes; ++l)
+      aTbVec_[iBX][l] = mask[l] != 0. ? sum[l] : aTbVec_[iBX][l];
+  }
+}
+
+void MahiBatch::solveL(const double (&in)[MaxSVSize][lanes], double (&out)[MaxSVSize][lanes]) const {
+  for (unsigned int i = 0; i < nSamples_; ++i) {
+    for (unsigned int l = 0; l < lanes; ++l)
+      out[i][l] = in[i][l];
+    for (unsigned int k = 0; k < i; ++k)
+      for (unsigned int l = 0; l < lanes; ++l)
+        out[i][l] -= covL_[i][k][l] * out[k][l];
+    for (unsigned int l = 0; l < lanes; ++l)
+      out[i][l] /= covL_[i][i][l];
+  }
+}
+
+void MahiBatch::calculateChiSq(double (&chiSq)[lanes]) const {
+  double residuals[MaxSVSize][lanes];
+  for (unsigned int iTS = 0; iTS < nSamples_; ++iTS) {
+    for (unsigned int l = 0; l < lanes; ++l)
+      residuals[iTS][l] = -amplitudes_[iTS][l];
+    for (unsigned int iBX = 0; iBX < nPulses_; ++iBX)
+      for (unsigned int l = 0; l < lanes; ++l)
+        residuals[iTS][l] += pulseMat_[iBX][iTS][l] * ampVec_[iBX][l];
+  }
+
+  double solved[MaxSVSize][lanes];
+  solveL(residuals, solved);
+
+  for (unsigned int l = 0; l < lanes; ++l)
+    chiSq[l] = 0.;
+  for (unsigned int iTS = 0; iTS < nSamples_; ++iTS)
+    for (unsigned int l = 0; l < lanes; ++l)
+      chiSq[l] += solved[iTS][l] * solved[iTS][l];
+}
+
+//
+// Solution of the normal equations restricted to the unconstrained pulses,
+// which are the first nP[l] pulses in the order of MahiFit, with an LDLT
+// decomposition padded with the identity up to the largest nP.
+//
+void MahiBatch::solveSubmatrix(const unsigned int (&nP)[lanes], double (&solution)[MaxPVSize][lanes]) {
+  const double tolerance = std::numeric_limits<double>::min();
+
+  const unsigned int n = *std::max_element(nP, nP + lanes);
+
+  // ldlL_ holds L * D below the diagonal, ldlD_ the inverse of D (0 for a null pivot)
+  for (unsigned int i = 0; i < n; ++i) {
+    for (unsigned int l = 0; l < lanes; ++l) {
+      const bool inside = i < nP[l];
+      const unsigned int iBX = order_[i][l];
+      for (unsigned int j = 0; j < i; ++j)
+        ldlL_[i][j][l] = inside ? aTaMat_[iBX][order_[j][l]][l] : 0.;
+      ldlD_[i][l] = inside ? aTaMat_[iBX][iBX][l] : 1.;
+      solution[i][l] = inside ? aTbVec_[iBX][l] : 0.;
+    }
+  }
+
+  for (unsigned int j = 0; j < n; ++j) {
+    double d[lanes];
+    for (unsigned int l = 0; l < lanes; ++l)
+      d[l] = ldlD_[j][l];
+    for (unsigned int k = 0; k < j; ++k)
+      for (unsigned int l = 0; l < lanes; ++l)
+        d[l] -= ldlL_[j][k][l] * ldlL_[j][k][l] * ldlD_[k][l];
+    for (unsigned int l = 0; l < lanes; ++l)
+      ldlD_[j][l] = std::abs(d[l]) > tolerance ? 1. / d[l] : 0.;
+
+    for (unsigned int i = j + 1; i < n; ++i)
+      for (unsigned int k = 0; k < j; ++k)
+        for (unsigned int l = 0; l < lanes; ++l)
+          ldlL_[i][j][l] -= ldlL_[i][k][l] * ldlL_[j][k][l] * ldlD_[k][l];
+  }
+
+  for (unsigned int i = 0; i < n; ++i)
+    for (unsigned int k = 0; k < i; ++k)
+      for (unsigned int l = 0; l < lanes; ++l)
+        solution[i][l] -= ldlL_[i][k][l] * ldlD_[k][l] * solution[k][l];
+  for (unsigned int i = n; i-- > 0;) {
+    for (unsigned int l = 0; l < lanes; ++l)
+      solution[i][l] *= ldlD_[i][l];
+    for (unsigned int k = i + 1; k < n; ++k)
+      for (unsigned int l = 0; l < lanes; ++l)
+        solution[i][l] -= ldlL_[k][i][l] * ldlD_[i][l] * solution[k][l];
+  }
+}
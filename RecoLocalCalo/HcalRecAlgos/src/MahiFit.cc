@@ -1,6 +1,8 @@
 #include "RecoLocalCalo/HcalRecAlgos/interface/MahiFit.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include <algorithm>
+
 MahiFit::MahiFit() {}
 
 void MahiFit::setParameters(bool iDynamicPed,
@@ -40,6 +42,8 @@ void MahiFit::setParameters(bool iDynamicPed,
 
   bxOffsetConf_ = -(*std::min_element(activeBXs_.begin(), activeBXs_.end()));
   bxSizeConf_ = activeBXs_.size();
+
+  batches_.clear();
 }
 
 void MahiFit::phase1Apply(const HBHEChannelInfo& channelData,
@@ -49,12 +53,38 @@ void MahiFit::phase1Apply(const HBHEChannelInfo& channelData,
                           float& chi2) const {
   assert(channelData.nSamples() == 8 || channelData.nSamples() == 10);
 
+  std::array<float, 3> reconstructedVals{{0.0f, -9999.f, -9999.f}};
+
+  useTriple = false;
+  if (prepareChannel(channelData)) {
+    // only do pre-fit with 1 pulse if chiSq threshold is positive
+    if (chiSqSwitch_ > 0) {
+      doFit(reconstructedVals, 1);
+      if (reconstructedVals[2] > chiSqSwitch_) {
+        doFit(reconstructedVals, 0);  //nbx=0 means use configured BXs
+        useTriple = true;
+      }
+    } else {
+      doFit(reconstructedVals, 0);
+      useTriple = true;
+    }
+  } else {
+    reconstructedVals.at(0) = 0.f;      //energy
+    reconstructedVals.at(1) = -9999.f;  //time
+    reconstructedVals.at(2) = -9999.f;  //chi2
+  }
+
+  reconstructedEnergy = reconstructedVals[0] * channelData.tsGain(0);
+  reconstructedTime = reconstructedVals[1];
+  chi2 = reconstructedVals[2];
+}
+
+// Fills the workspace with the samples of the channel, returns true if the channel is to be fitted
+bool MahiFit::prepareChannel(const HBHEChannelInfo& channelData) const {
   resetWorkspace();
 
   nnlsWork_.tsOffset = channelData.soi();
 
-  std::array<float, 3> reconstructedVals{{0.0f, -9999.f, -9999.f}};
-
   auto norm = (1. / std::sqrt(12));
 
   double tsTOT = 0, tstrig = 0;  // in GeV
@@ -83,37 +113,27 @@ void MahiFit::phase1Apply(const HBHEChannelInfo& channelData,
   tsTOT *= channelData.tsGain(0);
   tstrig *= channelData.tsGain(0);
 
-  useTriple = false;
   if (tstrig >= ts4Thresh_ && tsTOT > 0) {
     //Average pedestal width (for covariance matrix constraint)
     nnlsWork_.pedVal = 0.25f * (channelData.tsPedestalWidth(0) * channelData.tsPedestalWidth(0) +
                                 channelData.tsPedestalWidth(1) * channelData.tsPedestalWidth(1) +
                                 channelData.tsPedestalWidth(2) * channelData.tsPedestalWidth(2) +
                                 channelData.tsPedestalWidth(3) * channelData.tsPedestalWidth(3));
-
-    // only do pre-fit with 1 pulse if chiSq threshold is positive
-    if (chiSqSwitch_ > 0) {
-      doFit(reconstructedVals, 1);
-      if (reconstructedVals[2] > chiSqSwitch_) {
-        doFit(reconstructedVals, 0);  //nbx=0 means use configured BXs
-        useTriple = true;
-      }
-    } else {
-      doFit(reconstructedVals, 0);
-      useTriple = true;
-    }
-  } else {
-    reconstructedVals.at(0) = 0.f;      //energy
-    reconstructedVals.at(1) = -9999.f;  //time
-    reconstructedVals.at(2) = -9999.f;  //chi2
+    return true;
   }
-
-  reconstructedEnergy = reconstructedVals[0] * channelData.tsGain(0);
-  reconstructedTime = reconstructedVals[1];
-  chi2 = reconstructedVals[2];
+  return false;
 }
 
 void MahiFit::doFit(std::array<float, 3>& correctedOutput, int nbx) const {
+  setupFit(nbx);
+
+  double chiSq = minimize();
+
+  fillFitResult(correctedOutput, chiSq);
+}
+
+// Builds the pulse templates and their covariance matrices
+void MahiFit::setupFit(int nbx) const {
   unsigned int bxSize = 1;
 
   if (nbx == 1) {
@@ -173,9 +193,10 @@ void MahiFit::doFit(std::array<float, 3>& correctedOutput, int nbx) const {
           nnlsWork_.maxoffset - offset, nnlsWork_.maxoffset - offset, nnlsWork_.tsSize, nnlsWork_.tsSize);
     }
   }
+}
 
-  double chiSq = minimize();
-
+// Extracts the in-time amplitude and the arrival time from the fitted amplitudes
+void MahiFit::fillFitResult(std::array<float, 3>& correctedOutput, double chiSq) const {
   bool foundintime = false;
   unsigned int ipulseintime = 0;
 
@@ -201,6 +222,124 @@ void MahiFit::doFit(std::array<float, 3>& correctedOutput, int nbx) const {
   }
 }
 
+void MahiFit::phase1ApplyBatch(const std::vector<const HBHEChannelInfo*>& channels,
+                               const HcalPulseShapes& pulseShapes,
+                               const HcalTimeSlew* hcalTimeSlewDelay,
+                               std::vector<MahiFitResult>& results) {
+  const unsigned int nChannels = channels.size();
+
+  // process the channels grouped by pulse shape, to limit the resets of the pulse shape template
+  batchOrder_.resize(nChannels);
+  for (unsigned int i = 0; i < nChannels; ++i) {
+    assert(channels[i]->nSamples() == 8 || channels[i]->nSamples() == 10);
+    batchOrder_[i] = i;
+  }
+  std::stable_sort(batchOrder_.begin(), batchOrder_.end(), [&](unsigned int a, unsigned int b) {
+    return &pulseShapes.getShape(channels[a]->recoShape()) < &pulseShapes.getShape(channels[b]->recoShape());
+  });
+
+  batchVals_.assign(nChannels, {{0.0f, -9999.f, -9999.f}});
+  results.resize(nChannels);
+  for (auto& result : results)
+    result.useTriple = false;
+
+  // only do pre-fit with 1 pulse if chiSq threshold is positive
+  if (chiSqSwitch_ > 0) {
+    fitBatch(batchOrder_, 1, channels, pulseShapes, hcalTimeSlewDelay, batchVals_, batchFitted_);
+    batchRefit_.clear();
+    for (unsigned int i : batchFitted_) {
+      if (batchVals_[i][2] > chiSqSwitch_)
+        batchRefit_.push_back(i);
+    }
+    fitBatch(batchRefit_, 0, channels, pulseShapes, hcalTimeSlewDelay, batchVals_, batchFitted_);
+  } else {
+    fitBatch(batchOrder_, 0, channels, pulseShapes, hcalTimeSlewDelay, batchVals_, batchFitted_);
+  }
+  //nbx=0 means use configured BXs
+  for (unsigned int i : batchFitted_)
+    results[i].useTriple = true;
+
+  for (unsigned int i = 0; i < nChannels; ++i) {
+    results[i].energy = batchVals_[i][0] * channels[i]->tsGain(0);
+    results[i].time = batchVals_[i][1];
+    results[i].chiSq = batchVals_[i][2];
+  }
+}
+
+// Fits the given channels with nbx pulses, "fitted" receives the channels which pass the thresholds
+void MahiFit::fitBatch(const std::vector<unsigned int>& order,
+                       const int nbx,
+                       const std::vector<const HBHEChannelInfo*>& channels,
+                       const HcalPulseShapes& pulseShapes,
+                       const HcalTimeSlew* hcalTimeSlewDelay,
+                       std::vector<std::array<float, 3>>& reconstructedVals,
+                       std::vector<unsigned int>& fitted) {
+  fitted.clear();
+  if (order.empty())
+    return;
+
+  for (auto& batch : batches_)
+    batch->reset(batch->nSamples(), batch->nPulses());
+
+  batchChannels_.resize(order.size());
+  unsigned int nFitted = 0;
+  for (unsigned int i : order) {
+    const HBHEChannelInfo& channelData = *channels[i];
+    setPulseShapeTemplate(pulseShapes.getShape(channelData.recoShape()),
+                          channelData.hasTimeInfo(),
+                          hcalTimeSlewDelay,
+                          channelData.nSamples());
+    if (!prepareChannel(channelData))
+      continue;
+    setupFit(nbx);
+
+    const SampleMatrix* pulseCov[MaxPVSize];
+    for (unsigned int iBX = 0; iBX < nnlsWork_.nPulseTot; ++iBX) {
+      const int offset = nnlsWork_.bxs.coeff(iBX);
+      pulseCov[iBX] = offset == pedestalBX_ ? nullptr : &nnlsWork_.pulseCovArray.at(offset + nnlsWork_.bxOffset);
+    }
+
+    BatchChannel& channel = batchChannels_[nFitted++];
+    channel.index = i;
+    channel.batch = &batchFor(nnlsWork_.tsSize, nnlsWork_.nPulseTot);
+    channel.slot =
+        channel.batch->add(nnlsWork_.amplitudes, nnlsWork_.noiseTerms, nnlsWork_.pedVal, nnlsWork_.pulseMat, pulseCov);
+    channel.nPulseTot = nnlsWork_.nPulseTot;
+    channel.tsSize = nnlsWork_.tsSize;
+    channel.bxs = nnlsWork_.bxs;
+    channel.amplitudes = nnlsWork_.amplitudes;
+    channel.pulseMat = nnlsWork_.pulseMat;
+    channel.pulseDerivMat = nnlsWork_.pulseDerivMat;
+  }
+
+  for (auto& batch : batches_)
+    batch->minimize();
+
+  for (unsigned int k = 0; k < nFitted; ++k) {
+    BatchChannel& channel = batchChannels_[k];
+    nnlsWork_.nPulseTot = channel.nPulseTot;
+    nnlsWork_.tsSize = channel.tsSize;
+    nnlsWork_.bxs = channel.bxs;
+    nnlsWork_.amplitudes = channel.amplitudes;
+    nnlsWork_.pulseMat = channel.pulseMat;
+    nnlsWork_.pulseDerivMat = channel.pulseDerivMat;
+    nnlsWork_.ampVec = channel.batch->ampVec(channel.slot);
+
+    fillFitResult(reconstructedVals[channel.index], channel.batch->chiSq(channel.slot));
+    fitted.push_back(channel.index);
+  }
+}
+
+MahiBatch& MahiFit::batchFor(unsigned int nSamples, unsigned int nPulses) {
+  for (auto& batch : batches_) {
+    if (batch->nSamples() == nSamples && batch->nPulses() == nPulses)
+      return *batch;
+  }
+  batches_.push_back(std::make_unique<MahiBatch>(nMaxItersMin_, nMaxItersNNLS_, deltaChiSqThresh_, nnlsThresh_));
+  batches_.back()->reset(nSamples, nPulses);
+  return *batches_.back();
+}
+
 double MahiFit::minimize() const {
   nnlsWork_.invcovp.setZero(nnlsWork_.tsSize, nnlsWork_.nPulseTot);
   nnlsWork_.ampVec.setZero(nnlsWork_.nPulseTot);
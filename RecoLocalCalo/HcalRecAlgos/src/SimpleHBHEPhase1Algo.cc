@@ -25,7 +25,8 @@ SimpleHBHEPhase1Algo::SimpleHBHEPhase1Algo(const int firstSampleShift,
                                            const bool applyLegacyHBMCorrection,
                                            std::unique_ptr<PulseShapeFitOOTPileupCorrection> m2,
                                            std::unique_ptr<HcalDeterministicFit> detFit,
-                                           std::unique_ptr<MahiFit> mahi)
+                                           std::unique_ptr<MahiFit> mahi,
+                                           const bool batchedMahi)
     : pulseCorr_(PulseContainmentFractionalError),
       firstSampleShift_(firstSampleShift),
       samplesToAdd_(samplesToAdd),
@@ -36,7 +37,8 @@ SimpleHBHEPhase1Algo::SimpleHBHEPhase1Algo(const int firstSampleShift,
       applyLegacyHBMCorrection_(applyLegacyHBMCorrection),
       psFitOOTpuCorr_(std::move(m2)),
       hltOOTpuCorr_(std::move(detFit)),
-      mahiOOTpuCorr_(std::move(mahi)) {
+      mahiOOTpuCorr_(std::move(mahi)),
+      batchedMahi_(batchedMahi) {
   hcalTimeSlew_delay_ = nullptr;
 }
 
@@ -53,8 +55,32 @@ void SimpleHBHEPhase1Algo::endRun() { runnum_ = 0; }
 
 HBHERecHit SimpleHBHEPhase1Algo::reconstruct(const HBHEChannelInfo& info,
                                              const HcalRecoParam* params,
-                                             const HcalCalibrations& calibs,
+                                             const HcalCalibrations& /* calibs */,
                                              const bool isData) {
+  return reconstructChannel(info, params, isData, nullptr);
+}
+
+void SimpleHBHEPhase1Algo::reconstructBatch(const std::vector<const HBHEChannelInfo*>& infos,
+                                            const std::vector<const HcalRecoParam*>& params,
+                                            const std::vector<const HcalCalibrations*>& calibs,
+                                            const bool isData,
+                                            std::vector<HBHERecHit>& rechits) {
+  if (!isBatched()) {
+    AbsHBHEPhase1Algo::reconstructBatch(infos, params, calibs, isData, rechits);
+    return;
+  }
+
+  mahiOOTpuCorr_->phase1ApplyBatch(infos, theHcalPulseShapes_, hcalTimeSlew_delay_, mahiResults_);
+
+  rechits.clear();
+  for (unsigned i = 0; i < infos.size(); ++i)
+    rechits.push_back(reconstructChannel(*infos[i], params[i], isData, &mahiResults_[i]));
+}
+
+HBHERecHit SimpleHBHEPhase1Algo::reconstructChannel(const HBHEChannelInfo& info,
+                                                    const HcalRecoParam* params,
+                                                    const bool isData,
+                                                    const MahiFitResult* mahiResult) {
   HBHERecHit rh;
 
   const HcalDetId channelId(info.id());
@@ -104,9 +130,16 @@ HBHERecHit SimpleHBHEPhase1Algo::reconstruct(const HBHEChannelInfo& info,
   const MahiFit* mahi = mahiOOTpuCorr_.get();
 
   if (mahi) {
-    mahiOOTpuCorr_->setPulseShapeTemplate(
-        theHcalPulseShapes_.getShape(info.recoShape()), info.hasTimeInfo(), hcalTimeSlew_delay_, info.nSamples());
-    mahi->phase1Apply(info, m4E, m4T, m4UseTriple, m4chi2);
+    if (mahiResult) {
+      m4E = mahiResult->energy;
+      m4T = mahiResult->time;
+      m4UseTriple = mahiResult->useTriple;
+      m4chi2 = mahiResult->chiSq;
+    } else {
+      mahiOOTpuCorr_->setPulseShapeTemplate(
+          theHcalPulseShapes_.getShape(info.recoShape()), info.hasTimeInfo(), hcalTimeSlew_delay_, info.nSamples());
+      mahi->phase1Apply(info, m4E, m4T, m4UseTriple, m4chi2);
+    }
     m4E *= hbminusCorrectionFactor(channelId, m4E, isData);
   }
 
@@ -135,7 +135,8 @@ std::unique_ptr<AbsHBHEPhase1Algo> parseHBHEPhase1AlgoDescription(const edm::Par
                                                                     ps.getParameter<bool>("applyLegacyHBMCorrection"),
                                                                     std::move(m2),
                                                                     std::move(detFit),
-                                                                    std::move(mahi)));
+                                                                    std::move(mahi),
+                                                                    ps.getParameter<bool>("batchedMahi")));
   }
 
   return algo;
@@ -149,6 +150,7 @@ edm::ParameterSetDescription fillDescriptionForParseHBHEPhase1Algo() {
   desc.add<bool>("useM2", false);
   desc.add<bool>("useM3", true);
   desc.add<bool>("useMahi", true);
+  desc.add<bool>("batchedMahi", false);
   desc.add<int>("firstSampleShift", 0);
   desc.add<int>("samplesToAdd", 2);
   desc.add<double>("correctionPhaseNS", 6.0);
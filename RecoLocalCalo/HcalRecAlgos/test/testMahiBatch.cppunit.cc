@@ -0,0 +1,133 @@
+/* Unit test of the batched Mahi fit: MahiFit::phase1ApplyBatch must give the
+   results of MahiFit::phase1Apply, within the tolerance documented in MahiBatch.h
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "CalibCalorimetry/HcalAlgos/interface/HcalPulseShapes.h"
+#include "CalibCalorimetry/HcalAlgos/interface/HcalTimeSlew.h"
+#include "DataFormats/HcalDetId/interface/HcalDetId.h"
+#include "DataFormats/HcalRecHit/interface/HBHEChannelInfo.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/MahiFit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+class testMahiBatch : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testMahiBatch);
+  CPPUNIT_TEST(compareWithScalar);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+
+  void compareWithScalar();
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testMahiBatch);
+
+namespace {
+  constexpr double tolerance = 1e-5;
+
+  // the values of HBHEMahiParameters_cfi.py and HBHEMethod2Parameters_cfi.py
+  void setParameters(MahiFit& mahi) {
+    mahi.setParameters(false,
+                       0.,
+                       15.,
+                       true,
+                       HcalTimeSlew::Medium,
+                       true,
+                       0.,
+                       5.,
+                       2.5,
+                       {-3, -2, -1, 0, 1, 2, 3, 4},
+                       500,
+                       500,
+                       1e-3,
+                       1e-11);
+  }
+
+  // A channel with an in-time pulse, possibly out-of-time pulses, and gaussian noise.
+  // HPD channels have 10 samples, SiPM channels 8.
+  HBHEChannelInfo makeChannel(std::mt19937& rng, const HcalPulseShapes& pulseShapes, bool sipm) {
+    std::uniform_real_distribution<double> uniform(0., 1.);
+    std::normal_distribution<double> gauss(0., 1.);
+
+    const int recoShape = sipm ? 206 : 105;
+    const unsigned int nSamples = sipm ? 8 : 10;
+    const unsigned int soi = sipm ? 3 : 4;
+    const double gain = sipm ? 0.0055 : 0.18;
+    const double pedestal = 3. + 2. * uniform(rng);
+    const double pedWidth = 0.5 + uniform(rng);
+
+    // in-time amplitude from 1 fC to 10^4 fC, and a pulse in a neighbouring bunch crossing half of the time
+    double amplitude[3] = {0., std::pow(10., 4. * uniform(rng)), 0.};
+    if (uniform(rng) < 0.5)
+      amplitude[uniform(rng) < 0.5 ? 0 : 2] = amplitude[1] * uniform(rng);
+    const double phase = 4. * (uniform(rng) - 0.5);
+
+    HBHEChannelInfo info(sipm, sipm);
+    info.setChannelInfo(
+        HcalDetId(HcalEndcap, 20, 10, 1), recoShape, nSamples, soi, 0, 0., sipm ? 40. : 0.3, 0., false, false, false);
+    const HcalPulseShapes::Shape& shape = pulseShapes.getShape(recoShape);
+    for (unsigned int ts = 0; ts < nSamples; ++ts) {
+      double charge = pedestal + pedWidth * gauss(rng);
+      for (int bx = -1; bx <= 1; ++bx) {
+        const double start = 25. * (int(ts) - int(soi) - bx) - phase;
+        if (amplitude[bx + 1] > 0. and start + 25. > 0.)
+          charge += amplitude[bx + 1] * shape.integrate(std::max(start, 0.), start + 25.);
+      }
+      info.setSample(ts, 0, sipm ? 3.f : 1.f, charge, pedestal, pedWidth, gain, 0., 0.f);
+    }
+    return info;
+  }
+}  // namespace
+
+void testMahiBatch::compareWithScalar() {
+  HcalPulseShapes pulseShapes;
+  // the values of HcalTimeSlew_cff.py
+  HcalTimeSlew timeSlew;
+  timeSlew.addM2ParameterSet(23.960177, -3.178648, 16.00);
+  timeSlew.addM2ParameterSet(11.977461, -1.5610227, 10.00);
+  timeSlew.addM2ParameterSet(9.109694, -1.075824, 6.25);
+
+  std::mt19937 rng(12345);
+  std::vector<HBHEChannelInfo> infos;
+  for (unsigned int i = 0; i < 2000; ++i)
+    infos.push_back(makeChannel(rng, pulseShapes, i % 3 != 0));
+  std::vector<const HBHEChannelInfo*> channels;
+  for (auto const& info : infos)
+    channels.push_back(&info);
+
+  MahiFit batched;
+  setParameters(batched);
+  std::vector<MahiFitResult> results;
+  batched.phase1ApplyBatch(channels, pulseShapes, &timeSlew, results);
+  CPPUNIT_ASSERT_EQUAL(infos.size(), results.size());
+
+  MahiFit scalar;
+  setParameters(scalar);
+  unsigned int nTriple = 0;
+  for (unsigned int i = 0; i < infos.size(); ++i) {
+    const HBHEChannelInfo& info = infos[i];
+    scalar.setPulseShapeTemplate(
+        pulseShapes.getShape(info.recoShape()), info.hasTimeInfo(), &timeSlew, info.nSamples());
+    float energy, time, chi2;
+    bool useTriple;
+    scalar.phase1Apply(info, energy, time, useTriple, chi2);
+
+    CPPUNIT_ASSERT_EQUAL(useTriple, results[i].useTriple);
+    // relative, or 1e-5 fC for the amplitudes below 1 fC
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(
+        energy, results[i].energy, tolerance * std::max<double>(std::abs(energy), info.tsGain(0)));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(time, results[i].time, tolerance * std::max(std::abs(time), 1.f));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(chi2, results[i].chiSq, tolerance * std::max(std::abs(chi2), 1.f));
+    if (useTriple)
+      ++nTriple;
+  }
+  // both the single pulse and the multiple pulse fits are compared
+  CPPUNIT_ASSERT(nTriple > 0 and nTriple < infos.size());
+}
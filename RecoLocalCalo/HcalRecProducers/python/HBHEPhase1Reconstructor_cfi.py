@@ -77,6 +77,9 @@ hbheprereco = cms.EDProducer(
         # Use Mahi?
         useMahi = cms.bool(True),
 
+        # Fit the channels with Mahi in batches?
+        batchedMahi = cms.bool(False),
+
         # Apply legacy HB- energy correction?
         applyLegacyHBMCorrection = cms.bool(True)
     ),
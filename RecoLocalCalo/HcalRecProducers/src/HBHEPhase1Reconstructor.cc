@@ -20,6 +20,7 @@
 #include <cmath>
 #include <utility>
 #include <algorithm>
+#include <vector>
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
@@ -409,6 +410,50 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
   // not going to be constructed from such channels.
   const bool skipDroppedChannels = !(infos && saveDroppedInfos_);
 
+  // Algorithms which reconstruct several channels at once get the
+  // channels in groups of "maxBatchSize". The rechits are then
+  // completed and stored in the same order as in the input collection.
+  struct BatchedChannel {
+    HBHEChannelInfo info;
+    const HcalRecoParam* param;
+    const HcalCalibrations* calib;
+    DFrame frame;
+    const HcalQIECoder* channelCoder;
+    const HcalQIEShape* shape;
+  };
+  const unsigned maxBatchSize = 256;
+  const bool batched = rechits && reco_->isBatched();
+  std::vector<BatchedChannel> batch;
+  std::vector<const HBHEChannelInfo*> batchInfos;
+  std::vector<const HcalRecoParam*> batchParams;
+  std::vector<const HcalCalibrations*> batchCalibs;
+  std::vector<HBHERecHit> batchRecHits;
+  if (batched)
+    batch.reserve(maxBatchSize);
+
+  auto reconstructBatch = [&]() {
+    batchInfos.clear();
+    batchParams.clear();
+    batchCalibs.clear();
+    for (const BatchedChannel& ch : batch) {
+      batchInfos.push_back(&ch.info);
+      batchParams.push_back(ch.param);
+      batchCalibs.push_back(ch.calib);
+    }
+    reco_->reconstructBatch(batchInfos, batchParams, batchCalibs, isRealData, batchRecHits);
+    for (unsigned i = 0; i < batch.size(); ++i) {
+      const BatchedChannel& ch = batch[i];
+      HBHERecHit& rh = batchRecHits[i];
+      if (rh.id().rawId()) {
+        const HcalCoderDb coder(*ch.channelCoder, *ch.shape);
+        setAsicSpecificBits(ch.frame, coder, ch.info, *ch.calib, &rh);
+        setCommonStatusBits(ch.info, *ch.calib, &rh);
+        rechits->push_back(rh);
+      }
+    }
+    batch.clear();
+  };
+
   // Iterate over the input collection
   for (typename Collection::const_iterator it = coll.begin(); it != coll.end(); ++it) {
     const DFrame& frame(*it);
@@ -514,6 +559,12 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
       const HcalRecoParam* pptr = nullptr;
       if (recoParamsFromDB_)
         pptr = param_ts;
+      if (batched) {
+        batch.push_back(BatchedChannel{*channelInfo, pptr, &calib, frame, channelCoder, shape});
+        if (batch.size() == maxBatchSize)
+          reconstructBatch();
+        continue;
+      }
       HBHERecHit rh = reco_->reconstruct(*channelInfo, pptr, calib, isRealData);
       if (rh.id().rawId()) {
         setAsicSpecificBits(frame, coder, *channelInfo, calib, &rh);
@@ -522,6 +573,9 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
       }
     }
   }
+
+  if (!batch.empty())
+    reconstructBatch();
 }
 
 void HBHEPhase1Reconstructor::setCommonStatusBits(const HBHEChannelInfo& /* info */,
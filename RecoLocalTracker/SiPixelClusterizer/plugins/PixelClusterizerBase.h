@@ -50,6 +50,10 @@ public:
   // Virtual destructor, this is a base class.
   virtual ~PixelClusterizerBase() {}
 
+  // Optionally process the digis of all the DetUnits of the event at once,
+  // before clusterizeDetUnit is called on each of them in the same order
+  virtual void prepare(const edm::DetSetVector<PixelDigi>& input, const TrackerTopology* tTopo) {}
+
   // Build clusters in a DetUnit. Both digi and cluster stored in a DetSet
 
   virtual void clusterizeDetUnit(const edm::DetSet<PixelDigi>& input,
@@ -0,0 +1,334 @@
+//----------------------------------------------------------------------------
+//! \class PixelThresholdClusterizerSoA
+//! \brief Structure-of-arrays version of PixelThresholdClusterizer
+//!
+//! See PixelThresholdClusterizerSoA.h for the description of the algorithm.
+//! Every step that changes the content of the clusters mirrors the
+//! corresponding one in PixelThresholdClusterizer.cc: keep them in sync.
+//----------------------------------------------------------------------------
+
+#include "PixelThresholdClusterizerSoA.h"
+#include "Geometry/CommonDetUnit/interface/PixelGeomDetUnit.h"
+#include "Geometry/CommonTopologies/interface/PixelTopology.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+PixelThresholdClusterizerSoA::PixelThresholdClusterizerSoA(edm::ParameterSet const& conf)
+    : thePixelThreshold(conf.getParameter<int>("ChannelThreshold")),
+      theSeedThreshold(conf.getParameter<int>("SeedThreshold")),
+      theClusterThreshold(conf.getParameter<int>("ClusterThreshold")),
+      theClusterThreshold_L1(conf.getParameter<int>("ClusterThreshold_L1")),
+      theConversionFactor(conf.getParameter<int>("VCaltoElectronGain")),
+      theConversionFactor_L1(conf.getParameter<int>("VCaltoElectronGain_L1")),
+      theOffset(conf.getParameter<int>("VCaltoElectronOffset")),
+      theOffset_L1(conf.getParameter<int>("VCaltoElectronOffset_L1")),
+      theElectronPerADCGain(conf.getParameter<double>("ElectronPerADCGain")),
+      doPhase2Calibration(conf.getParameter<bool>("Phase2Calibration")),
+      thePhase2ReadoutMode(conf.getParameter<int>("Phase2ReadoutMode")),
+      thePhase2DigiBaseline(conf.getParameter<double>("Phase2DigiBaseline")),
+      thePhase2KinkADC(conf.getParameter<int>("Phase2KinkADC")),
+      doMissCalibrate(conf.getParameter<bool>("MissCalibrate")) {
+  theBatch.clear();
+  theScratch.clear();
+}
+
+PixelThresholdClusterizerSoA::~PixelThresholdClusterizerSoA() {}
+
+int PixelThresholdClusterizerSoA::layer(uint32_t detId, const TrackerTopology* tTopo) const {
+  return (DetId(detId).subdetId() == 1) ? tTopo->pxbLayer(detId) : 0;
+}
+
+//----------------------------------------------------------------------------
+//!  Calibrate and threshold the digis of all the modules of the event.
+//----------------------------------------------------------------------------
+void PixelThresholdClusterizerSoA::prepare(const edm::DetSetVector<PixelDigi>& input, const TrackerTopology* tTopo) {
+  theBatch.clear();
+  theNextModule = 0;
+  for (auto const& detSet : input)
+    fill(theBatch, detSet, layer(detSet.detId(), tTopo));
+}
+
+void PixelThresholdClusterizerSoA::clusterizeDetUnit(const edm::DetSet<PixelDigi>& input,
+                                                     const PixelGeomDetUnit* pixDet,
+                                                     const TrackerTopology* tTopo,
+                                                     const std::vector<short>& badChannels,
+                                                     edmNew::DetSetVector<SiPixelCluster>::FastFiller& output) {
+  int detLayer = layer(input.detId(), tTopo);
+  if (theNextModule < theBatch.size() && theBatch.detIds[theNextModule] == input.detId()) {
+    clusterize(theBatch, theNextModule++, pixDet, detLayer, false, output);
+  } else {
+    // the module was not part of the batch: calibrate it on the fly
+    theScratch.clear();
+    fill(theScratch, input, detLayer);
+    clusterize(theScratch, 0, pixDet, detLayer, false, output);
+  }
+}
+
+void PixelThresholdClusterizerSoA::clusterizeDetUnit(const edmNew::DetSet<SiPixelCluster>& input,
+                                                     const PixelGeomDetUnit* pixDet,
+                                                     const TrackerTopology* tTopo,
+                                                     const std::vector<short>& badChannels,
+                                                     edmNew::DetSetVector<SiPixelCluster>::FastFiller& output) {
+  theScratch.clear();
+  fill(theScratch, input);
+  clusterize(theScratch, 0, pixDet, layer(input.detId(), tTopo), true, output);
+}
+
+//----------------------------------------------------------------------------
+//!  Append the pixels above threshold of one module to the batch,
+//!  converting the adc counts to electrons as in PixelThresholdClusterizer::copy_to_buffer
+//----------------------------------------------------------------------------
+void PixelThresholdClusterizerSoA::fill(PixelBatch& batch, const edm::DetSet<PixelDigi>& input, int layer) {
+  auto begin = input.begin();
+  auto end = input.end();
+  unsigned int n = end - begin;
+  unsigned int first = batch.adcs.size();
+  batch.rows.resize(first + n);
+  batch.cols.resize(first + n);
+  batch.adcs.resize(first + n, 0);
+  uint16_t* rows = batch.rows.data() + first;
+  uint16_t* cols = batch.cols.data() + first;
+  int* electron = batch.adcs.data() + first;
+
+  unsigned int i = 0;
+  for (auto di = begin; di != end; ++di, ++i) {
+    rows[i] = di->row();
+    cols[i] = di->column();
+  }
+
+  if (doPhase2Calibration) {
+    const float gain = theElectronPerADCGain;
+    int p2rm = (thePhase2ReadoutMode < -1 ? -1 : thePhase2ReadoutMode);
+    const int dualslopeparam = (thePhase2ReadoutMode < 10 ? thePhase2ReadoutMode : 10);
+    const int dualslope = int(dualslopeparam <= 1 ? 1. : pow(2, dualslopeparam - 1));
+    i = 0;
+    for (auto di = begin; di != end; ++di, ++i) {
+      int adc = di->adc();
+      if (p2rm == -1) {
+        electron[i] = int(adc * gain);
+      } else {
+        if (adc < thePhase2KinkADC) {
+          electron[i] = int((adc - 0.5) * gain);
+        } else {
+          adc -= (thePhase2KinkADC - 1);
+          adc *= dualslope;
+          adc += (thePhase2KinkADC - 1);
+          electron[i] = int((adc - 0.5 * dualslope) * gain);
+        }
+        electron[i] += int(thePhase2DigiBaseline);
+      }
+    }
+  } else if (doMissCalibrate) {
+    if (layer == 1) {
+      (*theSiPixelGainCalibrationService_)
+          .calibrate(input.detId(), begin, end, theConversionFactor_L1, theOffset_L1, electron);
+    } else {
+      (*theSiPixelGainCalibrationService_).calibrate(input.detId(), begin, end, theConversionFactor, theOffset, electron);
+    }
+  } else {
+    const float gain = theElectronPerADCGain;  // default: 1 ADC = 135 electrons
+    const float pedestal = 0.;
+    i = 0;
+    for (auto di = begin; di != end; ++di, ++i)
+      electron[i] = int(di->adc() * gain + pedestal);
+  }
+
+  // put all negative pixel charges into the 100 elec bin, then compact the pixels above threshold
+  unsigned int k = 0;
+  for (i = 0; i < n; ++i) {
+    int adc = std::max(electron[i], 100);
+    rows[k] = rows[i];
+    cols[k] = cols[i];
+    electron[k] = adc;
+    k += (adc >= thePixelThreshold);
+  }
+  batch.rows.resize(first + k);
+  batch.cols.resize(first + k);
+  batch.adcs.resize(first + k);
+  batch.detIds.push_back(input.detId());
+  batch.offsets.push_back(first + k);
+}
+
+void PixelThresholdClusterizerSoA::fill(PixelBatch& batch, const edmNew::DetSet<SiPixelCluster>& input) {
+  for (auto const& cluster : input) {
+    for (int i = 0; i < cluster.size(); ++i) {
+      const SiPixelCluster::Pixel pixel = cluster.pixel(i);
+      if (pixel.adc >= thePixelThreshold) {
+        batch.rows.push_back(pixel.x);
+        batch.cols.push_back(pixel.y);
+        batch.adcs.push_back(pixel.adc);
+      }
+    }
+  }
+  batch.detIds.push_back(input.detId());
+  batch.offsets.push_back(batch.adcs.size());
+}
+
+//----------------------------------------------------------------------------
+//!  Connected-component labelling: every pixel ends up with the smallest
+//!  index of its component.  Each pass takes the minimum over the eight
+//!  neighbours (gathers without branches, empty neighbours point to the
+//!  pixel itself) and then follows the labels once (pointer jumping).
+//----------------------------------------------------------------------------
+void PixelThresholdClusterizerSoA::label(unsigned int n) {
+  theLabels.resize(n);
+  theNewLabels.resize(n);
+  for (unsigned int i = 0; i < n; ++i)
+    theLabels[i] = i;
+
+  int const* nb = theNeighbours.data();
+  bool changed = true;
+  while (changed) {
+    int const* labels = theLabels.data();
+    int* newLabels = theNewLabels.data();
+    for (unsigned int i = 0; i < n; ++i)
+      newLabels[i] = labels[i];
+    for (unsigned int k = 0; k < 8; ++k) {
+      int const* nbk = nb + k * n;
+      for (unsigned int i = 0; i < n; ++i)
+        newLabels[i] = std::min(newLabels[i], labels[nbk[i]]);
+    }
+    for (unsigned int i = 0; i < n; ++i)
+      newLabels[i] = newLabels[newLabels[i]];
+    changed = false;
+    for (unsigned int i = 0; i < n; ++i)
+      changed |= (newLabels[i] != labels[i]);
+    theLabels.swap(theNewLabels);
+  }
+}
+
+//----------------------------------------------------------------------------
+//!  Grow a cluster around the seed, visiting the neighbours in the same
+//!  order as PixelThresholdClusterizer::make_cluster.
+//----------------------------------------------------------------------------
+void PixelThresholdClusterizerSoA::walk(int seed,
+                                        uint16_t const* rows,
+                                        uint16_t const* cols,
+                                        unsigned int n,
+                                        AccretionCluster& acluster) {
+  int members[AccretionCluster::MAXSIZE];
+  acluster.add(SiPixelCluster::PixelPos(rows[seed], cols[seed]), theAdcs[seed]);
+  members[0] = seed;
+  theUsed[seed] = 1;
+  while (!acluster.empty()) {
+    int current = members[acluster.top()];
+    acluster.pop();
+    for (unsigned int k = 0; k < 8; ++k) {
+      int j = theNeighbours[k * n + current];
+      if (theUsed[j])
+        continue;
+      if (!acluster.add(SiPixelCluster::PixelPos(rows[j], cols[j]), theAdcs[j]))
+        return;
+      members[acluster.isize - 1] = j;
+      theUsed[j] = 1;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+//!  Cluster the pixels of one module of the batch.
+//----------------------------------------------------------------------------
+void PixelThresholdClusterizerSoA::clusterize(PixelBatch const& batch,
+                                              unsigned int module,
+                                              const PixelGeomDetUnit* pixDet,
+                                              int layer,
+                                              bool accumulate,
+                                              edmNew::DetSetVector<SiPixelCluster>::FastFiller& output) {
+  assert(output.empty());
+  unsigned int first = batch.offsets[module];
+  unsigned int n = batch.offsets[module + 1] - first;
+  if (n == 0)
+    return;
+  uint16_t const* rows = batch.rows.data() + first;
+  uint16_t const* cols = batch.cols.data() + first;
+  int const* adcs = batch.adcs.data() + first;
+
+  const PixelTopology& topol = pixDet->specificTopology();
+  const int nrows = topol.nrows();
+  const int ncols = topol.ncolumns();
+  if (theIndex.size() < static_cast<size_t>(nrows * ncols))
+    theIndex.resize(nrows * ncols, -1);
+
+  auto clusterThreshold = (layer == 1) ? theClusterThreshold_L1 : theClusterThreshold;
+
+  // map the pixels on the module; a later digi on the same pixel replaces the earlier one,
+  // a later pixel of the input clusters is added to the earlier one
+  theAdcs.resize(n);
+  theUsed.assign(n, 0);
+  for (unsigned int i = 0; i < n; ++i) {
+    int& index = theIndex[cols[i] * nrows + rows[i]];
+    theAdcs[i] = adcs[i];
+    if (index < 0) {
+      index = i;
+    } else if (accumulate) {
+      theAdcs[index] += adcs[i];
+      theUsed[i] = 1;
+    } else {
+      theUsed[index] = 1;
+      index = i;
+    }
+  }
+
+  // neighbour table, in the column-major scan order of make_cluster
+  theNeighbours.resize(8 * n);
+  for (unsigned int i = 0; i < n; ++i) {
+    unsigned int k = 0;
+    for (int dc = -1; dc <= 1; ++dc) {
+      for (int dr = -1; dr <= 1; ++dr) {
+        if (dc == 0 && dr == 0)
+          continue;
+        int r = rows[i] + dr;
+        int c = cols[i] + dc;
+        int j = -1;
+        if (!theUsed[i] && r >= 0 && r < nrows && c >= 0 && c < ncols)
+          j = theIndex[c * nrows + r];
+        theNeighbours[k++ * n + i] = (j < 0) ? int(i) : j;
+      }
+    }
+  }
+
+  label(n);
+
+  // charge (as stored in the cluster) and size of each component
+  theCharges.assign(n, 0);
+  theSizes.assign(n, 0);
+  for (unsigned int i = 0; i < n; ++i) {
+    if (theUsed[i])
+      continue;
+    theCharges[theLabels[i]] += uint16_t(theAdcs[i]);
+    ++theSizes[theLabels[i]];
+  }
+
+  // walk the components from the seeds, in digi order
+  for (unsigned int i = 0; i < n; ++i) {
+    if (adcs[i] < theSeedThreshold)
+      continue;
+    int seed = theIndex[cols[i] * nrows + rows[i]];
+    if (theUsed[seed] || theAdcs[seed] < theSeedThreshold)
+      continue;
+    int component = theLabels[seed];
+    // a component that cannot be truncated is a cluster: skip it if below threshold
+    if (theSizes[component] <= int(AccretionCluster::MAXSIZE) && theCharges[component] < clusterThreshold)
+      continue;
+
+    AccretionCluster acluster;
+    walk(seed, rows, cols, n, acluster);
+    SiPixelCluster cluster(acluster.isize, acluster.adc, acluster.x, acluster.y, acluster.xmin, acluster.ymin);
+    if (cluster.charge() >= clusterThreshold) {
+      // sort by row (x), as PixelThresholdClusterizer does
+      output.push_back(std::move(cluster));
+      std::push_heap(output.begin(), output.end(), [](SiPixelCluster const& cl1, SiPixelCluster const& cl2) {
+        return cl1.minPixelRow() < cl2.minPixelRow();
+      });
+    }
+  }
+  std::sort_heap(output.begin(), output.end(), [](SiPixelCluster const& cl1, SiPixelCluster const& cl2) {
+    return cl1.minPixelRow() < cl2.minPixelRow();
+  });
+
+  // clean the map for the next module
+  for (unsigned int i = 0; i < n; ++i)
+    theIndex[cols[i] * nrows + rows[i]] = -1;
+}
@@ -0,0 +1,121 @@
+#ifndef RecoLocalTracker_SiPixelClusterizer_PixelThresholdClusterizerSoA_H
+#define RecoLocalTracker_SiPixelClusterizer_PixelThresholdClusterizerSoA_H
+
+//-----------------------------------------------------------------------
+//! \class PixelThresholdClusterizerSoA
+//! \brief Structure-of-arrays version of PixelThresholdClusterizer.
+//!
+//! The digis of all the modules of the event are calibrated, thresholded
+//! and stored in a single structure of arrays (prepare()), with branch-free
+//! loops the compiler can vectorize.
+//!
+//! For each module the pixels above threshold are then grouped in
+//! connected components (8-connectivity) by label propagation over a
+//! compact table of neighbour indices, again with gather/min loops
+//! without branches.  Components below the cluster threshold are dropped
+//! without being walked.  The surviving ones are walked from their seeds
+//! in the very same order as PixelThresholdClusterizer::make_cluster,
+//! so that the pixel order inside the clusters, the truncation at
+//! AccretionCluster::MAXSIZE and the order of the clusters in the
+//! output are identical: the produced SiPixelClusters are bit for bit
+//! the same as those of PixelThresholdClusterizer.
+//!
+//! Splitting of clusters around dead pixels is not supported (it is
+//! disabled in PixelThresholdClusterizer as well).
+//-----------------------------------------------------------------------
+
+#include "DataFormats/Common/interface/DetSetVector.h"
+#include "PixelClusterizerBase.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include <cstdint>
+#include <vector>
+
+class dso_hidden PixelThresholdClusterizerSoA final : public PixelClusterizerBase {
+public:
+  PixelThresholdClusterizerSoA(edm::ParameterSet const& conf);
+  ~PixelThresholdClusterizerSoA() override;
+
+  // Calibrate and threshold the digis of all the modules in one go
+  void prepare(const edm::DetSetVector<PixelDigi>& input, const TrackerTopology* tTopo) override;
+
+  void clusterizeDetUnit(const edm::DetSet<PixelDigi>& input,
+                         const PixelGeomDetUnit* pixDet,
+                         const TrackerTopology* tTopo,
+                         const std::vector<short>& badChannels,
+                         edmNew::DetSetVector<SiPixelCluster>::FastFiller& output) override;
+  void clusterizeDetUnit(const edmNew::DetSet<SiPixelCluster>& input,
+                         const PixelGeomDetUnit* pixDet,
+                         const TrackerTopology* tTopo,
+                         const std::vector<short>& badChannels,
+                         edmNew::DetSetVector<SiPixelCluster>::FastFiller& output) override;
+
+private:
+  //! Pixels above threshold of a set of modules, in digi order
+  struct PixelBatch {
+    std::vector<uint32_t> detIds;   // one per module
+    std::vector<uint32_t> offsets;  // first pixel of each module, plus the end
+    std::vector<uint16_t> rows;
+    std::vector<uint16_t> cols;
+    std::vector<int> adcs;  // in electrons
+
+    void clear() {
+      detIds.clear();
+      offsets.assign(1, 0);
+      rows.clear();
+      cols.clear();
+      adcs.clear();
+    }
+    unsigned int size() const { return detIds.size(); }
+  };
+
+  //! Module-level helpers
+  int layer(uint32_t detId, const TrackerTopology* tTopo) const;
+  void fill(PixelBatch& batch, const edm::DetSet<PixelDigi>& input, int layer);
+  void fill(PixelBatch& batch, const edmNew::DetSet<SiPixelCluster>& input);
+  void clusterize(PixelBatch const& batch,
+                  unsigned int module,
+                  const PixelGeomDetUnit* pixDet,
+                  int layer,
+                  bool accumulate,
+                  edmNew::DetSetVector<SiPixelCluster>::FastFiller& output);
+  void label(unsigned int n);
+  void walk(int seed, uint16_t const* rows, uint16_t const* cols, unsigned int n, AccretionCluster& acluster);
+
+  //! Event-level storage
+  PixelBatch theBatch;
+  unsigned int theNextModule = 0;
+  PixelBatch theScratch;  // for modules not seen by prepare()
+
+  //! Module-level storage, indexed by pixel of the module
+  std::vector<int> theIndex;       // nrows * ncols map to the pixel index, -1 if empty
+  std::vector<int> theNeighbours;  // 8 * n neighbour indices, in the scan order of make_cluster; self if empty
+  std::vector<int> theAdcs;
+  std::vector<int> theLabels;
+  std::vector<int> theNewLabels;
+  std::vector<int> theCharges;
+  std::vector<int> theSizes;
+  std::vector<uint8_t> theUsed;
+
+  //! Clustering-related quantities
+  const int thePixelThreshold;
+  const int theSeedThreshold;
+  const int theClusterThreshold;
+  const int theClusterThreshold_L1;
+  const int theConversionFactor;
+  const int theConversionFactor_L1;
+  const int theOffset;
+  const int theOffset_L1;
+
+  const double theElectronPerADCGain;
+
+  const bool doPhase2Calibration;
+  const int thePhase2ReadoutMode;
+  const double thePhase2DigiBaseline;
+  const int thePhase2KinkADC;
+
+  const bool doMissCalibrate;
+};
+
+#endif
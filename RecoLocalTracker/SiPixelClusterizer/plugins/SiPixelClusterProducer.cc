@@ -14,6 +14,7 @@
 // Our own stuff
 #include "SiPixelClusterProducer.h"
 #include "PixelThresholdClusterizer.h"
+#include "PixelThresholdClusterizerSoA.h"
 
 // Geometry
 #include "Geometry/Records/interface/TrackerDigiGeometryRecord.h"
@@ -117,8 +118,10 @@ void SiPixelClusterProducer::produce(edm::Event& e, const edm::EventSetup& es) {
   // on each DetUnit
   if (clusterMode_ == "PixelThresholdReclusterizer")
     run(*inputClusters, geom, *output);
-  else
+  else {
+    clusterizer_->prepare(*inputDigi, tTopo_);
     run(*inputDigi, geom, *output);
+  }
 
   // Step D: write output to file
   output->shrink_to_fit();
@@ -134,11 +137,15 @@ void SiPixelClusterProducer::setupClusterizer(const edm::ParameterSet& conf) {
   if (clusterMode_ == "PixelThresholdReclusterizer" || clusterMode_ == "PixelThresholdClusterizer") {
     clusterizer_ = std::make_unique<PixelThresholdClusterizer>(conf);
     clusterizer_->setSiPixelGainCalibrationService(theSiPixelGainCalibration_.get());
+  } else if (clusterMode_ == "PixelThresholdClusterizerSoA") {
+    clusterizer_ = std::make_unique<PixelThresholdClusterizerSoA>(conf);
+    clusterizer_->setSiPixelGainCalibrationService(theSiPixelGainCalibration_.get());
   } else {
     throw cms::Exception("Configuration") << "[SiPixelClusterProducer]:"
                                           << " choice " << clusterMode_ << " is invalid.\n"
                                           << "Possible choices:\n"
-                                          << "    PixelThresholdClusterizer";
+                                          << "    PixelThresholdClusterizer\n"
+                                          << "    PixelThresholdClusterizerSoA";
   }
 }
 
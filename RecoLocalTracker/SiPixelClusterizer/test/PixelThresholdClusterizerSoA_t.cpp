@@ -0,0 +1,165 @@
+// Standalone benchmark of PixelThresholdClusterizerSoA against PixelThresholdClusterizer:
+// both clusterize the same random events, the outputs must be identical.
+//
+// usage: PixelThresholdClusterizerSoA_t [number of events]
+
+// the clusterizers are private to the plugin library: build them in
+#include "RecoLocalTracker/SiPixelClusterizer/plugins/PixelThresholdClusterizer.cc"
+#include "RecoLocalTracker/SiPixelClusterizer/plugins/PixelThresholdClusterizerSoA.cc"
+
+#include "DataFormats/GeometrySurface/interface/BoundPlane.h"
+#include "DataFormats/GeometrySurface/interface/RectangularPlaneBounds.h"
+#include "DataFormats/SiPixelDetId/interface/PixelSubdetector.h"
+#include "Geometry/CommonDetUnit/interface/PixelGeomDetType.h"
+#include "Geometry/CommonDetUnit/interface/PixelGeomDetUnit.h"
+#include "Geometry/TrackerGeometryBuilder/interface/RectangularPixelTopology.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+
+namespace {
+
+  // phase-1 module: 2 x 8 ROCs of 80 x 52 pixels
+  constexpr int nRows = 160;
+  constexpr int nCols = 416;
+  constexpr unsigned int nModules = 200;
+
+  edm::ParameterSet configuration(bool phase2) {
+    edm::ParameterSet conf;
+    conf.addParameter<int>("ChannelThreshold", 10);
+    conf.addParameter<int>("SeedThreshold", 1000);
+    conf.addParameter<int>("ClusterThreshold", 4000);
+    conf.addParameter<int>("ClusterThreshold_L1", 2000);
+    conf.addParameter<int>("VCaltoElectronGain", 47);
+    conf.addParameter<int>("VCaltoElectronGain_L1", 50);
+    conf.addParameter<int>("VCaltoElectronOffset", -60);
+    conf.addParameter<int>("VCaltoElectronOffset_L1", -670);
+    conf.addParameter<double>("ElectronPerADCGain", phase2 ? 600. : 135.);
+    conf.addParameter<bool>("Phase2Calibration", phase2);
+    conf.addParameter<int>("Phase2ReadoutMode", phase2 ? 3 : -1);
+    conf.addParameter<double>("Phase2DigiBaseline", 1200.);
+    conf.addParameter<int>("Phase2KinkADC", 8);
+    conf.addParameter<bool>("MissCalibrate", false);
+    conf.addParameter<bool>("SplitClusters", false);
+    return conf;
+  }
+
+  // blobs of pixels of random size, including a few larger than AccretionCluster::MAXSIZE, plus noise
+  edm::DetSetVector<PixelDigi> generate(std::mt19937& rng, int maxAdc) {
+    std::uniform_int_distribution<int> row(0, nRows - 1), col(0, nCols - 1), adc(0, maxAdc), step(-1, 1);
+    std::uniform_int_distribution<int> nBlobs(0, 12), size(1, 40), noise(0, 20);
+    std::uniform_real_distribution<float> flat(0., 1.);
+
+    std::vector<edm::DetSet<PixelDigi>> detSets;
+    for (unsigned int m = 0; m < nModules; ++m) {
+      DetId id(DetId::Tracker, PixelSubdetector::PixelEndcap);
+      std::map<int, PixelDigi> pixels;  // sorted by channel, one digi per pixel
+      auto add = [&](int r, int c) {
+        if (r >= 0 && r < nRows && c >= 0 && c < nCols)
+          pixels.emplace(PixelDigi::pixelToChannel(r, c), PixelDigi(r, c, adc(rng)));
+      };
+      for (int b = nBlobs(rng); b > 0; --b) {
+        int r = row(rng), c = col(rng);
+        int n = flat(rng) < 0.02 ? 1500 : size(rng);
+        for (int i = 0; i < n; ++i) {
+          add(r, c);
+          r += step(rng);
+          c += step(rng);
+        }
+      }
+      for (int i = noise(rng); i > 0; --i)
+        add(row(rng), col(rng));
+
+      edm::DetSet<PixelDigi> detSet(id.rawId() + m + 1);
+      for (auto const& pixel : pixels)
+        detSet.data.push_back(pixel.second);
+      detSets.push_back(std::move(detSet));
+    }
+    return edm::DetSetVector<PixelDigi>(detSets, true);
+  }
+
+  void clusterize(PixelClusterizerBase& clusterizer,
+                  edm::DetSetVector<PixelDigi> const& digis,
+                  PixelGeomDetUnit const* det,
+                  edmNew::DetSetVector<SiPixelCluster>& output) {
+    std::vector<short> badChannels;
+    clusterizer.prepare(digis, nullptr);
+    for (auto const& detSet : digis) {
+      edmNew::DetSetVector<SiPixelCluster>::FastFiller spc(output, detSet.detId());
+      clusterizer.clusterizeDetUnit(detSet, det, nullptr, badChannels, spc);
+      if (spc.empty())
+        spc.abort();
+    }
+  }
+
+  bool identical(SiPixelCluster const& a, SiPixelCluster const& b) {
+    return a.pixelADC() == b.pixelADC() && a.pixelOffset() == b.pixelOffset() && a.minPixelRow() == b.minPixelRow() &&
+           a.minPixelCol() == b.minPixelCol() && a.rowSpan() == b.rowSpan() && a.colSpan() == b.colSpan();
+  }
+
+  bool identical(edmNew::DetSetVector<SiPixelCluster> const& a, edmNew::DetSetVector<SiPixelCluster> const& b) {
+    if (a.size() != b.size() || a.dataSize() != b.dataSize())
+      return false;
+    auto ib = b.begin();
+    for (auto const& detSet : a) {
+      if (detSet.detId() != ib->detId() || detSet.size() != ib->size())
+        return false;
+      for (unsigned int i = 0; i < detSet.size(); ++i)
+        if (!identical(detSet[i], (*ib)[i]))
+          return false;
+      ++ib;
+    }
+    return true;
+  }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  unsigned int nEvents = argc > 1 ? std::atoi(argv[1]) : 20;
+
+  GeomDetEnumerators::SubDetector subdet = GeomDetEnumerators::PixelEndcap;
+  PixelGeomDetType type(new RectangularPixelTopology(nRows, nCols, 0.01, 0.015, false, 80, 52, 2, 2, 2, 8),
+                        "benchmark",
+                        subdet);
+  Plane::PlanePointer plane =
+      Plane::build(Surface::PositionType(0., 0., 0.), Surface::RotationType(), new RectangularPlaneBounds(1., 3., 0.01));
+  PixelGeomDetUnit det(&(*plane), &type, DetId(DetId::Tracker, PixelSubdetector::PixelEndcap));
+
+  bool ok = true;
+  for (bool phase2 : {false, true}) {
+    auto conf = configuration(phase2);
+    PixelThresholdClusterizer legacy(conf);
+    PixelThresholdClusterizerSoA soa(conf);
+
+    std::mt19937 rng(42);
+    std::chrono::duration<double> tLegacy(0), tSoA(0);
+    unsigned long nClusters = 0;
+    for (unsigned int e = 0; e < nEvents; ++e) {
+      auto digis = generate(rng, phase2 ? 15 : 255);
+      edmNew::DetSetVector<SiPixelCluster> outLegacy, outSoA;
+
+      auto start = std::chrono::steady_clock::now();
+      clusterize(legacy, digis, &det, outLegacy);
+      auto middle = std::chrono::steady_clock::now();
+      clusterize(soa, digis, &det, outSoA);
+      auto stop = std::chrono::steady_clock::now();
+      tLegacy += middle - start;
+      tSoA += stop - middle;
+      nClusters += outLegacy.dataSize();
+
+      if (!identical(outLegacy, outSoA)) {
+        std::cerr << (phase2 ? "phase-2" : "phase-1") << " event " << e << ": the clusters differ" << std::endl;
+        ok = false;
+      }
+    }
+    std::cout << (phase2 ? "phase-2" : "phase-1") << " calibration, " << nEvents << " events, " << nClusters
+              << " clusters\n"
+              << "  PixelThresholdClusterizer    " << tLegacy.count() * 1000. / nEvents << " ms/event\n"
+              << "  PixelThresholdClusterizerSoA " << tSoA.count() * 1000. / nEvents << " ms/event" << std::endl;
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
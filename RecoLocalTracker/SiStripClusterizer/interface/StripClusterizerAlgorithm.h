@@ -4,8 +4,8 @@
 namespace edm {
   class EventSetup;
 }
-class SiStripDigi;
 #include "DataFormats/SiStripCluster/interface/SiStripCluster.h"
+#include "DataFormats/SiStripDigi/interface/SiStripDigi.h"
 #include "DataFormats/Common/interface/DetSetVector.h"
 #include "DataFormats/Common/interface/DetSetVectorNew.h"
 #include "FWCore/Framework/interface/ESHandle.h"
@@ -80,6 +80,13 @@ public:
   virtual void stripByStripAdd(State& state, uint16_t strip, uint8_t adc, output_t::TSFastFiller& out) const {}
   virtual void stripByStripEnd(State& state, output_t::TSFastFiller& out) const {}
 
+  // run of digis of the same det in increasing strip order, for the algorithms that process them in batches
+  virtual bool batched() const { return false; }
+  virtual void addDigis(State& state, SiStripDigi const* begin, SiStripDigi const* end, output_t::TSFastFiller& out) const {
+    for (; begin != end; ++begin)
+      stripByStripAdd(state, begin->strip(), begin->adc(), out);
+  }
+
   struct InvalidChargeException : public cms::Exception {
   public:
     InvalidChargeException(const SiStripDigi&);
@@ -47,9 +47,15 @@ public:
 
   void stripByStripEnd(State& state, output_t::TSFastFiller& out) const override { endCandidate(state, out); }
 
+  // batch interface
+  bool batched() const override { return Batched; }
+  void addDigis(State& state, SiStripDigi const* begin, SiStripDigi const* end, output_t::TSFastFiller& out) const override;
+
 private:
   template <class T>
   void clusterizeDetUnit_(const T&, output_t::TSFastFiller&) const;
+  template <class Iter, class T>
+  void addBatch_(State& state, Iter begin, Iter end, T& out) const;
 
   ThreeThresholdAlgorithm(float,
                           float,
@@ -59,7 +65,8 @@ private:
                           unsigned,
                           std::string qualityLabel,
                           bool removeApvShots,
-                          float minGoodCharge);
+                          float minGoodCharge,
+                          bool batched = false);
 
   //constant methods with state information
   uint16_t firstStrip(State const& state) const { return state.lastStrip - state.ADCs.size() + 1; }
@@ -83,6 +90,7 @@ private:
   uint8_t MaxSequentialHoles, MaxSequentialBad, MaxAdjacentBad;
   bool RemoveApvShots;
   float minGoodCharge;
+  bool Batched;
 };
 
 #endif
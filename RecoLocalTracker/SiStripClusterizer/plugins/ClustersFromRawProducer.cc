@@ -382,6 +382,9 @@ void ClusterFiller::fill(StripClusterizerAlgorithm::output_t::TSFastFiller& reco
     if (!det.valid())
       return;
     StripClusterizerAlgorithm::State state(det);
+    std::vector<SiStripDigi> zsDigis;  // one apv pair at a time, for the batched algorithms
+    if (clusterizer.batched())
+      zsDigis.reserve(256);
 
     incSet();
 
@@ -442,7 +445,20 @@ void ClusterFiller::fill(StripClusterizerAlgorithm::output_t::TSFastFiller& reco
           try {
             auto perStripAdder = StripByStripAdder(clusterizer, state, record);
             if
-              LIKELY(!hybridZeroSuppressed_) { unpackZS(buffer->channel(fedCh), mode, ipair * 256, perStripAdder); }
+              LIKELY(!hybridZeroSuppressed_) {
+                if (clusterizer.batched()) {
+                  zsDigis.clear();
+                  try {
+                    unpackZS(buffer->channel(fedCh), mode, ipair * 256, std::back_inserter(zsDigis));
+                  } catch (...) {
+                    // keep what was unpacked before the error, as the strip-by-strip path does
+                    clusterizer.addDigis(state, zsDigis.data(), zsDigis.data() + zsDigis.size(), record);
+                    throw;
+                  }
+                  clusterizer.addDigis(state, zsDigis.data(), zsDigis.data() + zsDigis.size(), record);
+                } else
+                  unpackZS(buffer->channel(fedCh), mode, ipair * 256, perStripAdder);
+              }
             else {
               const uint32_t id = conn->detId();
               edm::DetSet<SiStripDigi> unpDigis{id};
@@ -241,3 +241,9 @@ clusterizerTests = ClusterizerTest( "Default Clusterizer Settings",
                ] )
     ]
                                            )
+
+# same tests for the batched version of the algorithm, which must give identical clusters
+batchedClusterizerTests = clusterizerTests.clone(
+    Label = "Batched Clusterizer Settings",
+    ClusterizerParameters = clusterizerTests.ClusterizerParameters.clone(Algorithm = "BatchedThreeThresholdAlgorithm")
+)
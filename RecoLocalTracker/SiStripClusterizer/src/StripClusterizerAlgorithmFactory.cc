@@ -8,7 +8,7 @@
 std::unique_ptr<StripClusterizerAlgorithm> StripClusterizerAlgorithmFactory::create(const edm::ParameterSet& conf) {
   std::string algorithm = conf.getParameter<std::string>("Algorithm");
 
-  if (algorithm == "ThreeThresholdAlgorithm") {
+  if (algorithm == "ThreeThresholdAlgorithm" || algorithm == "BatchedThreeThresholdAlgorithm") {
     return std::unique_ptr<StripClusterizerAlgorithm>(
         new ThreeThresholdAlgorithm(conf.getParameter<double>("ChannelThreshold"),
                                     conf.getParameter<double>("SeedThreshold"),
@@ -18,7 +18,8 @@ std::unique_ptr<StripClusterizerAlgorithm> StripClusterizerAlgorithmFactory::cre
                                     conf.getParameter<unsigned>("MaxAdjacentBad"),
                                     conf.getParameter<std::string>("QualityLabel"),
                                     conf.getParameter<bool>("RemoveApvShots"),
-                                    clusterChargeCut(conf)));
+                                    clusterChargeCut(conf),
+                                    algorithm == "BatchedThreeThresholdAlgorithm"));
   }
 
   if (algorithm == "OldThreeThresholdAlgorithm") {
@@ -15,7 +15,8 @@ ThreeThresholdAlgorithm::ThreeThresholdAlgorithm(float chan,
                                                  unsigned adj,
                                                  std::string qL,
                                                  bool removeApvShots,
-                                                 float minGoodCharge)
+                                                 float minGoodCharge,
+                                                 bool batched)
     : ChannelThreshold(chan),
       SeedThreshold(seed),
       ClusterThresholdSquared(cluster * cluster),
@@ -23,7 +24,8 @@ ThreeThresholdAlgorithm::ThreeThresholdAlgorithm(float chan,
       MaxSequentialBad(bad),
       MaxAdjacentBad(adj),
       RemoveApvShots(removeApvShots),
-      minGoodCharge(minGoodCharge) {
+      minGoodCharge(minGoodCharge),
+      Batched(batched) {
   qualityLabel = (qL);
 }
 
@@ -49,6 +51,11 @@ inline void ThreeThresholdAlgorithm::clusterizeDetUnit_(const digiDetSet& digis,
   }
 
   State state(det);
+  if (Batched) {
+    addBatch_(state, scan, end, output);
+    endCandidate(state, output);
+    return;
+  }
   while (scan != end) {
     while (scan != end && !candidateEnded(state, scan->strip()))
       addToCandidate(state, *scan++);
@@ -56,6 +63,68 @@ inline void ThreeThresholdAlgorithm::clusterizeDetUnit_(const digiDetSet& digis,
   }
 }
 
+// Same result as calling stripByStripAdd on each digi, but the conditions are looked up and
+// the thresholds applied on blocks of digis, in loops without branches, before the
+// candidates are built from the surviving ones.
+template <class Iter, class T>
+inline void ThreeThresholdAlgorithm::addBatch_(State& state, Iter begin, Iter end, T& out) const {
+  constexpr unsigned int blockSize = 128;
+  uint16_t strips[blockSize];
+  uint8_t adcs[blockSize];
+  float noises[blockSize];
+  uint8_t keep[blockSize];
+  uint8_t seed[blockSize];
+  uint8_t gap[blockSize];
+
+  auto const& det = state.det();
+  const bool anyBad = det.qualityRange.first != det.qualityRange.second;
+  while (begin != end) {
+    unsigned int n = 0;
+    for (; begin != end && n < blockSize; ++begin, ++n) {
+      strips[n] = begin->strip();
+      adcs[n] = begin->adc();
+    }
+    for (unsigned int i = 0; i < n; ++i)
+      noises[i] = det.noise(strips[i]);
+    for (unsigned int i = 0; i < n; ++i) {
+      keep[i] = adcs[i] >= static_cast<uint8_t>(noises[i] * ChannelThreshold);
+      seed[i] = adcs[i] >= static_cast<uint8_t>(noises[i] * SeedThreshold);
+    }
+    if (anyBad) {
+      for (unsigned int i = 0; i < n; ++i)
+        keep[i] &= !det.bad(strips[i]);
+    }
+
+    // compact the strips above threshold
+    unsigned int m = 0;
+    for (unsigned int i = 0; i < n; ++i) {
+      strips[m] = strips[i];
+      adcs[m] = adcs[i];
+      noises[m] = noises[i];
+      seed[m] = seed[i];
+      m += keep[i];
+    }
+
+    // a candidate can only end where the strips are farther apart than MaxSequentialHoles
+    gap[0] = 1;
+    for (unsigned int j = 1; j < m; ++j)
+      gap[j] = uint16_t(strips[j] - strips[j - 1] - 1) > MaxSequentialHoles;
+
+    for (unsigned int j = 0; j < m; ++j) {
+      if (gap[j] && candidateEnded(state, strips[j]))
+        endCandidate(state, out);
+      if (state.candidateLacksSeed)
+        state.candidateLacksSeed = !seed[j];
+      if (state.ADCs.empty())
+        state.lastStrip = strips[j] - 1;  // begin candidate
+      while (++state.lastStrip < strips[j])
+        state.ADCs.push_back(0);  // pad holes
+      state.ADCs.push_back(adcs[j]);
+      state.noiseSquared += noises[j] * noises[j];
+    }
+  }
+}
+
 inline bool ThreeThresholdAlgorithm::candidateEnded(State const& state, const uint16_t& testStrip) const {
   uint16_t holes = testStrip - state.lastStrip - 1;
   return (((!state.ADCs.empty()) &       // a candidate exists, and
@@ -148,3 +217,13 @@ void ThreeThresholdAlgorithm::stripByStripAdd(State& state,
 void ThreeThresholdAlgorithm::stripByStripEnd(State& state, std::vector<SiStripCluster>& out) const {
   endCandidate(state, out);
 }
+
+void ThreeThresholdAlgorithm::addDigis(State& state,
+                                       SiStripDigi const* begin,
+                                       SiStripDigi const* end,
+                                       output_t::TSFastFiller& out) const {
+  if (Batched)
+    addBatch_(state, begin, end, out);
+  else
+    StripClusterizerAlgorithm::addDigis(state, begin, end, out);
+}
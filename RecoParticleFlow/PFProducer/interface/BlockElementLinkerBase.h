@@ -18,6 +18,12 @@ public:
 
   virtual double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const = 0;
 
+  // Linkers of two cluster elements which can only be linked when the positionREP of
+  // their clusters are closer than some distance in (eta, phi) give it here: PFBlockAlgo
+  // then only tests the pairs it finds that close in its grids of the clusters.
+  // With the default, a negative distance, all the pairs are tested.
+  virtual double etaPhiLinkRadius() const { return -1.; }
+
   const std::string& name() const { return _linkerName; }
 
 private:
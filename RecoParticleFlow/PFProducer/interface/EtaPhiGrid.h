@@ -0,0 +1,53 @@
+#ifndef RecoParticleFlow_PFProducer_EtaPhiGrid_h
+#define RecoParticleFlow_PFProducer_EtaPhiGrid_h
+
+#include <vector>
+
+/// \brief Points in (eta, phi) sorted into square tiles, searched for the
+/// points closer to given ones than some distance.
+/*!
+  The tiles cover |eta| < etaMax, the points beyond it going to the outermost
+  tiles, and wrap around in phi. A query only looks into the tiles that its
+  search radius reaches, which are the 3x3 tiles around it for a radius as
+  large as the side of the tiles.
+*/
+class EtaPhiGrid {
+public:
+  explicit EtaPhiGrid(float tileSize, float etaMax = 5.5f);
+
+  float tileSize() const { return tileSize_; }
+
+  /// fills the grid with the n points (eta[i], phi[i]); the searches give indices into these arrays
+  void build(const float* eta, const float* phi, unsigned n);
+
+  void clear();
+
+  /// For each of the n query points, finds the points of the grid at a distance
+  /// sqrt(deta^2 + dphi^2) smaller than radius; this is done in single precision
+  /// with a small margin, so that a test of the distance done afterwards in double
+  /// precision does not miss any pair. The points found for query k are
+  /// found[offsets[k]], ..., found[offsets[k + 1] - 1], in increasing order.
+  void search(const float* eta,
+              const float* phi,
+              unsigned n,
+              float radius,
+              std::vector<unsigned>& offsets,
+              std::vector<unsigned>& found) const;
+
+private:
+  unsigned etaTile(float eta) const;
+  int phiTile(float phi) const;
+
+  const float tileSize_;
+  const float etaMax_;
+  const unsigned nEta_;
+  const unsigned nPhi_;
+  const float phiTileSize_;
+
+  // the points sorted by tile; those of tile t are in [tileStart_[t], tileStart_[t + 1])
+  std::vector<unsigned> tileStart_;
+  std::vector<float> eta_, phi_;
+  std::vector<unsigned> index_;
+};
+
+#endif
@@ -8,6 +8,7 @@
 #include "FWCore/Framework/interface/ConsumesCollector.h"
 #include "RecoParticleFlow/PFProducer/interface/BlockElementImporterBase.h"
 #include "RecoParticleFlow/PFProducer/interface/BlockElementLinkerBase.h"
+#include "RecoParticleFlow/PFProducer/interface/EtaPhiGrid.h"
 #include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerBase.h"
 #include "DataFormats/Common/interface/OwnVector.h"
 
@@ -35,7 +36,7 @@ class PFBlockAlgo {
 public:
   // the element list should **always** be a list of (smart) pointers
   typedef std::vector<std::unique_ptr<reco::PFBlockElement>> ElementList;
-  //for skipping ranges
+  //for skipping ranges: the elements of each type are in [first, second)
   typedef std::array<std::pair<unsigned int, unsigned int>, reco::PFBlockElement::kNBETypes> ElementRanges;
 
   PFBlockAlgo();
@@ -59,6 +60,9 @@ public:
   void setDebug(bool debug) { debug_ = debug; }
 
 private:
+  /// for the linkers searching by distance, find the candidates of each element in the eta-phi grids
+  void searchNeighbours();
+
   /// compute missing links in the blocks
   /// (the recursive procedure does not build all links)
   void packLinks(reco::PFBlock& block,
@@ -84,6 +88,21 @@ private:
   unsigned int linkTestSquare_[reco::PFBlockElement::kNBETypes][reco::PFBlockElement::kNBETypes];
 
   std::vector<std::unique_ptr<KDTreeLinkerBase>> kdtrees_;
+
+  /// the elements of type2 which are candidates for a link with each element of type1,
+  /// for a linker giving an etaPhiLinkRadius(): those of the k-th element of type1 are
+  /// found[offsets[k]], ..., found[offsets[k + 1] - 1], counted from the first element of type2
+  struct Neighbours {
+    double radius = -1.;
+    std::vector<unsigned> offsets;
+    std::vector<unsigned> found;
+  };
+  std::vector<Neighbours> neighbours_;  // indexed by rowsize * type1 + type2
+
+  /// the grids of the cluster positions, one per element type searched by distance,
+  /// filled once per event and shared by all the linkers of that type
+  std::vector<std::unique_ptr<EtaPhiGrid>> grids_;
+  std::vector<float> elementEta_, elementPhi_;
 };
 
 #endif
@@ -12,6 +12,9 @@ public:
 
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
+  // the largest distance of a link in testLink
+  double etaPhiLinkRadius() const override { return 0.2; }
+
 private:
   bool _useKDTree, _debug;
 };
@@ -0,0 +1,104 @@
+#include "RecoParticleFlow/PFProducer/interface/EtaPhiGrid.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  constexpr float kTwoPi = 2.f * M_PI;
+  // covers the rounding of the positions to single precision
+  constexpr float kMargin = 1.e-4f;
+
+  float checkedTileSize(float tileSize) {
+    if (!(tileSize > 0.f && tileSize <= 1.f)) {
+      throw cms::Exception("InvalidTileSize") << "EtaPhiGrid tiles must have a size in (0, 1], not " << tileSize;
+    }
+    return tileSize;
+  }
+}  // namespace
+
+EtaPhiGrid::EtaPhiGrid(float tileSize, float etaMax)
+    : tileSize_(checkedTileSize(tileSize)),
+      etaMax_(etaMax),
+      nEta_(std::max(1, int(std::ceil(2.f * etaMax / tileSize)))),
+      nPhi_(int(kTwoPi / tileSize)),
+      phiTileSize_(kTwoPi / nPhi_),
+      tileStart_(nEta_ * nPhi_ + 1, 0) {}
+
+unsigned EtaPhiGrid::etaTile(float eta) const {
+  const int i = int(std::floor((eta + etaMax_) / tileSize_));
+  return std::clamp(i, 0, int(nEta_) - 1);
+}
+
+// not wrapped around, so that a range of tiles in phi stays a range of integers
+int EtaPhiGrid::phiTile(float phi) const { return int(std::floor((phi + float(M_PI)) / phiTileSize_)); }
+
+void EtaPhiGrid::clear() {
+  std::fill(tileStart_.begin(), tileStart_.end(), 0);
+  eta_.clear();
+  phi_.clear();
+  index_.clear();
+}
+
+void EtaPhiGrid::build(const float* eta, const float* phi, unsigned n) {
+  clear();
+  const int nPhi = nPhi_;
+  std::vector<unsigned> tile(n);
+  for (unsigned i = 0; i < n; ++i) {
+    const int iphi = ((phiTile(phi[i]) % nPhi) + nPhi) % nPhi;
+    tile[i] = etaTile(eta[i]) * nPhi_ + iphi;
+    ++tileStart_[tile[i] + 1];
+  }
+  for (unsigned t = 1; t < tileStart_.size(); ++t) {
+    tileStart_[t] += tileStart_[t - 1];
+  }
+  // counting sort, which keeps the points of a tile in increasing order
+  eta_.resize(n);
+  phi_.resize(n);
+  index_.resize(n);
+  std::vector<unsigned> next(tileStart_.begin(), tileStart_.end() - 1);
+  for (unsigned i = 0; i < n; ++i) {
+    const unsigned k = next[tile[i]]++;
+    eta_[k] = eta[i];
+    phi_[k] = phi[i];
+    index_[k] = i;
+  }
+}
+
+void EtaPhiGrid::search(const float* eta,
+                        const float* phi,
+                        unsigned n,
+                        float radius,
+                        std::vector<unsigned>& offsets,
+                        std::vector<unsigned>& found) const {
+  const float window = radius + kMargin;
+  const float window2 = window * window;
+  const int nPhi = nPhi_;
+  offsets.resize(n + 1);
+  found.clear();
+  for (unsigned k = 0; k < n; ++k) {
+    offsets[k] = found.size();
+    const float qeta = eta[k];
+    const float qphi = phi[k];
+    const unsigned etaLow = etaTile(qeta - window), etaHigh = etaTile(qeta + window);
+    const int phiLow = phiTile(qphi - window);
+    const int phiHigh = std::min(phiTile(qphi + window), phiLow + nPhi - 1);
+    for (unsigned ieta = etaLow; ieta <= etaHigh; ++ieta) {
+      for (int iphi = phiLow; iphi <= phiHigh; ++iphi) {
+        const unsigned t = ieta * nPhi_ + ((iphi % nPhi) + nPhi) % nPhi;
+        for (unsigned j = tileStart_[t]; j < tileStart_[t + 1]; ++j) {
+          const float deta = eta_[j] - qeta;
+          float dphi = phi_[j] - qphi;
+          if (dphi > float(M_PI))
+            dphi -= kTwoPi;
+          else if (dphi < -float(M_PI))
+            dphi += kTwoPi;
+          if (deta * deta + dphi * dphi < window2)
+            found.push_back(index_[j]);
+        }
+      }
+    }
+    std::sort(found.begin() + offsets[k], found.end());
+  }
+  offsets[n] = found.size();
+}
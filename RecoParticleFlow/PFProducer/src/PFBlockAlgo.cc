@@ -1,4 +1,5 @@
 #include "RecoParticleFlow/PFProducer/interface/PFBlockAlgo.h"
+#include "DataFormats/ParticleFlowReco/interface/PFBlockElementCluster.h"
 #include "FWCore/Framework/interface/ProductRegistryHelper.h"
 #include "FWCore/Framework/src/WorkerMaker.h"
 #include "FWCore/MessageLogger/interface/ErrorObj.h"
@@ -51,7 +52,6 @@ namespace {
     void unite(unsigned p, unsigned q) {
       unsigned rootP = find(p);
       unsigned rootQ = find(q);
-      id_[p] = q;
 
       if (size_[rootP] < size_[rootQ]) {
         id_[rootP] = rootQ;
@@ -91,6 +91,9 @@ void PFBlockAlgo::setLinkers(const std::vector<edm::ParameterSet>& confs) {
     }
   }
   linkTests_.resize(rowsize * rowsize);
+  neighbours_.resize(rowsize * rowsize);
+  grids_.resize(rowsize);
+  std::vector<float> tileSize(rowsize, 0.f);
   const std::string prefix("PFBlockElement::");
   const std::string pfx_kdtree("KDTree");
   for (const auto& conf : confs) {
@@ -113,6 +116,14 @@ void PFBlockAlgo::setLinkers(const std::vector<edm::ParameterSet>& confs) {
     linkTests_[index] = BlockElementLinkerFactory::get()->create(linkerName, conf);
     linkTestSquare_[type1][type2] = index;
     linkTestSquare_[type2][type1] = index;
+    // the pairs of elements close enough to be linked are found in the eta-phi grids
+    const double radius = linkTests_[index]->etaPhiLinkRadius();
+    if (radius > 0.) {
+      neighbours_[rowsize * type1 + type2].radius = radius;
+      neighbours_[rowsize * type2 + type1].radius = radius;
+      tileSize[type1] = std::max(tileSize[type1], float(radius));
+      tileSize[type2] = std::max(tileSize[type2], float(radius));
+    }
     // setup KDtree if requested
     const bool useKDTree = conf.getParameter<bool>("useKDTree");
     if (useKDTree) {
@@ -121,6 +132,11 @@ void PFBlockAlgo::setLinkers(const std::vector<edm::ParameterSet>& confs) {
       kdtrees_.back()->setFieldType(std::max(type1, type2));
     }
   }
+  for (unsigned type = 0; type < rowsize; ++type) {
+    if (tileSize[type] > 0.f) {
+      grids_[type] = std::make_unique<EtaPhiGrid>(std::min(tileSize[type], 1.f));
+    }
+  }
 }
 
 void PFBlockAlgo::setImporters(const std::vector<edm::ParameterSet>& confs, edm::ConsumesCollector& sumes) {
@@ -139,6 +155,7 @@ PFBlockAlgo::~PFBlockAlgo() {
 }
 
 reco::PFBlockCollection PFBlockAlgo::findBlocks() {
+  constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
   // Glowinski & Gouzevitch
   for (const auto& kdtree : kdtrees_) {
     kdtree->process();
@@ -148,40 +165,54 @@ reco::PFBlockCollection PFBlockAlgo::findBlocks() {
   // the blocks have not been passed to the event, and need to be cleared
   blocks.reserve(elements_.size());
 
+  searchNeighbours();
+
   QuickUnion qu(elements_.size());
   const auto elem_size = elements_.size();
-  for (unsigned i = 0; i < elem_size; ++i) {
-    for (unsigned j = 0; j < elem_size; ++j) {
-      if (qu.connected(i, j) || j == i)
-        continue;
-      if (!linkTests_[linkTestSquare_[elements_[i]->type()][elements_[j]->type()]]) {
-        j = ranges_[elements_[j]->type()].second;
-        continue;
+  auto testPair = [&](unsigned i, unsigned j, unsigned index) {
+    if (j == i || qu.connected(i, j))
+      return;
+    auto p1(elements_[i].get()), p2(elements_[j].get());
+    if (linkTests_[index]->linkPrefilter(p1, p2)) {
+      const double dist = linkTests_[index]->testLink(p1, p2);
+      // compute linking info if it is possible
+      if (dist > -0.5) {
+        qu.unite(i, j);
       }
-      auto p1(elements_[i].get()), p2(elements_[j].get());
-      const PFBlockElement::Type type1 = p1->type();
-      const PFBlockElement::Type type2 = p2->type();
+    }
+  };
+  for (unsigned i = 0; i < elem_size; ++i) {
+    const PFBlockElement::Type type1 = elements_[i]->type();
+    // the types come in the order of the elements, so the pairs are tested in increasing j
+    for (unsigned type2 = 0; type2 < rowsize; ++type2) {
+      const auto& range = ranges_[type2];
       const unsigned index = linkTestSquare_[type1][type2];
-      if (linkTests_[index]->linkPrefilter(p1, p2)) {
-        const double dist = linkTests_[index]->testLink(p1, p2);
-        // compute linking info if it is possible
-        if (dist > -0.5) {
-          qu.unite(i, j);
+      if (range.first == range.second || !linkTests_[index])
+        continue;
+      const Neighbours& neighbours = neighbours_[rowsize * type1 + type2];
+      if (neighbours.radius > 0.) {
+        const unsigned k = i - ranges_[type1].first;
+        for (unsigned n = neighbours.offsets[k]; n < neighbours.offsets[k + 1]; ++n) {
+          testPair(i, range.first + neighbours.found[n], index);
+        }
+      } else {
+        for (unsigned j = range.first; j < range.second; ++j) {
+          testPair(i, j, index);
         }
       }
     }
   }
 
+  // the blocks are keyed and ordered by their root node; the pairs that the neighbour searches skip
+  // cannot be linked, so the links are found in the same order and the roots are those of testing
+  // all the pairs
   std::unordered_multimap<unsigned, unsigned> blocksmap(elements_.size());
   std::vector<unsigned> keys;
   keys.reserve(elements_.size());
   for (unsigned i = 0; i < elements_.size(); ++i) {
-    unsigned key = i;
-    while (key != qu.find(key))
-      key = qu.find(key);  // make sure we always find the root node...
-    auto pos = std::lower_bound(keys.begin(), keys.end(), key);
-    if (pos == keys.end() || *pos != key) {
-      keys.insert(pos, key);
+    const unsigned key = qu.find(i);
+    if (key == i) {
+      keys.push_back(key);
     }
     blocksmap.emplace(key, i);
   }
@@ -216,6 +247,41 @@ reco::PFBlockCollection PFBlockAlgo::findBlocks() {
   return blocks;
 }
 
+void PFBlockAlgo::searchNeighbours() {
+  constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
+  elementEta_.resize(elements_.size());
+  elementPhi_.resize(elements_.size());
+  for (unsigned type = 0; type < rowsize; ++type) {
+    if (!grids_[type])
+      continue;
+    const auto& range = ranges_[type];
+    for (unsigned i = range.first; i < range.second; ++i) {
+      const reco::PFClusterRef& cluster = static_cast<const PFBlockElementCluster*>(elements_[i].get())->clusterRef();
+      if (cluster.isNull()) {
+        throw cms::Exception("BadClusterRefs") << "PFBlockElementCluster's refs are null!";
+      }
+      elementEta_[i] = cluster->positionREP().Eta();
+      elementPhi_[i] = cluster->positionREP().Phi();
+    }
+    grids_[type]->build(&elementEta_[range.first], &elementPhi_[range.first], range.second - range.first);
+  }
+  // one batch of searches per pair of types and direction
+  for (unsigned type1 = 0; type1 < rowsize; ++type1) {
+    for (unsigned type2 = 0; type2 < rowsize; ++type2) {
+      auto& neighbours = neighbours_[rowsize * type1 + type2];
+      if (neighbours.radius <= 0.)
+        continue;
+      const auto& range = ranges_[type1];
+      grids_[type2]->search(elementEta_.data() + range.first,
+                            elementPhi_.data() + range.first,
+                            range.second - range.first,
+                            neighbours.radius,
+                            neighbours.offsets,
+                            neighbours.found);
+    }
+  }
+}
+
 void PFBlockAlgo::packLinks(reco::PFBlock& block,
                             const std::unordered_map<std::pair<unsigned int, unsigned int>, double>& links) const {
   constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
@@ -294,17 +360,12 @@ void PFBlockAlgo::buildElements(const edm::Event& evt) {
   std::sort(elements_.begin(), elements_.end(), [](const auto& a, const auto& b) { return a->type() < b->type(); });
 
   // list is now partitioned, so mark the boundaries so we can efficiently skip chunks
-  unsigned current_type = (!elements_.empty() ? elements_[0]->type() : 0);
-  unsigned last_type = (!elements_.empty() ? elements_.back()->type() : 0);
-  ranges_[current_type].first = 0;
-  ranges_[last_type].second = elements_.size() - 1;
-  for (size_t i = 0; i < elements_.size(); ++i) {
-    const auto the_type = elements_[i]->type();
-    if (the_type != current_type) {
-      ranges_[the_type].first = i;
-      ranges_[current_type].second = i - 1;
-      current_type = the_type;
+  for (unsigned i = 0; i < elements_.size(); ++i) {
+    auto& range = ranges_[elements_[i]->type()];
+    if (range.first == range.second) {
+      range.first = i;
     }
+    range.second = i + 1;
   }
   // -------------- Loop over block elements ---------------------
 
@@ -0,0 +1,107 @@
+#include "catch.hpp"
+#include "RecoParticleFlow/PFProducer/interface/EtaPhiGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+static constexpr auto s_tag = "[EtaPhiGrid]";
+
+namespace {
+  double deltaPhi(double phi1, double phi2) {
+    double dphi = phi1 - phi2;
+    while (dphi > M_PI)
+      dphi -= 2. * M_PI;
+    while (dphi <= -M_PI)
+      dphi += 2. * M_PI;
+    return dphi;
+  }
+
+  // uniform points, and points gathered across phi = pi and around and beyond |eta| = 5.5
+  void makePoints(std::mt19937& rng, unsigned n, std::vector<float>& eta, std::vector<float>& phi) {
+    std::uniform_real_distribution<float> uniform(-1.f, 1.f);
+    eta.clear();
+    phi.clear();
+    for (unsigned i = 0; i < n; ++i) {
+      switch (i % 4) {
+        case 0:
+          eta.push_back(6.f * uniform(rng));
+          phi.push_back(float(M_PI) * uniform(rng));
+          break;
+        case 1:
+          eta.push_back(3.f * uniform(rng));
+          phi.push_back(std::remainder(float(M_PI) + 0.3f * uniform(rng), 2.f * float(M_PI)));
+          break;
+        default:
+          eta.push_back((i % 4 == 2 ? 1.f : -1.f) * (5.5f + 0.5f * uniform(rng)));
+          phi.push_back(float(M_PI) * uniform(rng));
+      }
+    }
+  }
+}  // namespace
+
+TEST_CASE("EtaPhiGrid finds all the pairs closer than the radius", s_tag) {
+  std::mt19937 rng(4321);
+  std::vector<float> eta, phi, qeta, qphi;
+  std::vector<unsigned> offsets, found;
+
+  // the tiles have the size of the largest radius of the linkers that use them, and smaller radii are also searched
+  for (float tileSize : {0.05f, 0.2f, 1.f}) {
+    EtaPhiGrid grid(tileSize);
+    for (float radius : {tileSize, 0.5f * tileSize}) {
+      makePoints(rng, 2000, eta, phi);
+      makePoints(rng, 500, qeta, qphi);
+      grid.build(eta.data(), phi.data(), eta.size());
+      grid.search(qeta.data(), qphi.data(), qeta.size(), radius, offsets, found);
+      REQUIRE(offsets.size() == qeta.size() + 1);
+      REQUIRE(offsets.back() == found.size());
+
+      unsigned nPairs = 0, nAcrossPhiPi = 0, nBeyondEtaMax = 0;
+      for (unsigned k = 0; k < qeta.size(); ++k) {
+        REQUIRE(offsets[k] <= offsets[k + 1]);
+        const auto begin = found.begin() + offsets[k], end = found.begin() + offsets[k + 1];
+        REQUIRE(std::adjacent_find(begin, end, std::greater_equal<unsigned>()) == end);
+        for (unsigned i = 0; i < eta.size(); ++i) {
+          const double deta = double(eta[i]) - qeta[k];
+          const double dphi = deltaPhi(phi[i], qphi[k]);
+          if (std::sqrt(deta * deta + dphi * dphi) < radius) {
+            ++nPairs;
+            nAcrossPhiPi += std::abs(phi[i] - qphi[k]) > float(M_PI);
+            nBeyondEtaMax += std::abs(eta[i]) > 5.5f || std::abs(qeta[k]) > 5.5f;
+            INFO("tile size " << tileSize << ", radius " << radius << ": point (" << eta[i] << ", " << phi[i]
+                              << ") of query (" << qeta[k] << ", " << qphi[k] << ")");
+            REQUIRE(std::binary_search(begin, end, i));
+          }
+        }
+      }
+      // the pairs found beyond the radius are within the margin of the search
+      for (unsigned k = 0; k < qeta.size(); ++k) {
+        for (unsigned n = offsets[k]; n < offsets[k + 1]; ++n) {
+          const unsigned i = found[n];
+          REQUIRE(i < eta.size());
+          const double deta = double(eta[i]) - qeta[k];
+          const double dphi = deltaPhi(phi[i], qphi[k]);
+          REQUIRE(std::sqrt(deta * deta + dphi * dphi) < radius + 1.e-3);
+        }
+      }
+      REQUIRE(nPairs > 0);
+      REQUIRE(nAcrossPhiPi > 0);
+      REQUIRE(nBeyondEtaMax > 0);
+    }
+  }
+}
+
+TEST_CASE("EtaPhiGrid can be rebuilt and searched with no points", s_tag) {
+  EtaPhiGrid grid(0.1f);
+  std::vector<unsigned> offsets, found;
+  const float eta = 0.f, phi = 0.f;
+  grid.build(&eta, &phi, 1);
+  grid.search(&eta, &phi, 1, 0.1f, offsets, found);
+  REQUIRE(found == std::vector<unsigned>{0});
+  grid.build(nullptr, nullptr, 0);
+  grid.search(&eta, &phi, 1, 0.1f, offsets, found);
+  REQUIRE(found.empty());
+  REQUIRE(offsets == std::vector<unsigned>{0, 0});
+  REQUIRE_THROWS(EtaPhiGrid(0.f));
+}
@@ -30,11 +30,14 @@
 
 #include "CondFormats/EgammaObjects/interface/GBRForest.h"
 #include "CondFormats/DataRecord/interface/GBRWrapperRcd.h"
+#include "CommonTools/MVAUtils/interface/FlatGBRForest.h"
 #include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
 
 #include <TFile.h>
 
 #include <iostream>
+#include <memory>
 
 using namespace reco;
 
@@ -159,6 +162,8 @@ namespace reco {
       bool loadMVAfromDB_;
       edm::FileInPath inputFileName_;
       const GBRForest* mvaReader_;
+      std::unique_ptr<FlatGBRForest> flatMvaReader_;
+      edm::ESWatcher<GBRWrapperRcd> mvaWatcher_;
       int mvaOpt_;
       float* mvaInput_;
 
@@ -187,12 +192,15 @@ namespace reco {
     };
 
     void PFRecoTauDiscriminationByMVAIsolationRun2::beginEvent(const edm::Event& evt, const edm::EventSetup& es) {
-      if (!mvaReader_) {
-        if (loadMVAfromDB_) {
+      // the flattened forest is evaluated for each tau, and built again only for a new IOV of the MVA
+      if (loadMVAfromDB_) {
+        if (mvaWatcher_.check(es)) {
           mvaReader_ = loadMVAfromDB(es, mvaName_);
-        } else {
-          mvaReader_ = loadMVAfromFile(inputFileName_, mvaName_, inputFilesToDelete_);
+          flatMvaReader_ = std::make_unique<FlatGBRForest>(*mvaReader_);
         }
+      } else if (!mvaReader_) {
+        mvaReader_ = loadMVAfromFile(inputFileName_, mvaName_, inputFilesToDelete_);
+        flatMvaReader_ = std::make_unique<FlatGBRForest>(*mvaReader_);
       }
 
       evt.getByToken(TauTransverseImpactParameters_token, tauLifetimeInfos);
@@ -357,7 +365,7 @@ namespace reco {
           mvaInput_[22] = std::max(-1.f, gjAngleDiff);
         }
 
-        double mvaValue = mvaReader_->GetClassifier(mvaInput_);
+        double mvaValue = flatMvaReader_->GetClassifier(mvaInput_);
         if (verbosity_) {
           edm::LogPrint("PFTauDiscByMVAIsol2") << "<PFRecoTauDiscriminationByMVAIsolationRun2::discriminate>:";
           edm::LogPrint("PFTauDiscByMVAIsol2") << " tau: Pt = " << tau->pt() << ", eta = " << tau->eta();
@@ -82,6 +82,13 @@ protected:
                                  TrajectoryContainer& result) const;
 
   void updateTrajectory(TempTrajectory& traj, TM&& tm) const;
+  /// same as above, with the state already updated with the hit of tm
+  void updateTrajectory(TempTrajectory& traj, TM&& tm, TSOS&& upState) const;
+
+  /// the predicted states of the measurements updated with their valid hits, all in one call to the updator
+  void updateStates(std::vector<TM>::const_iterator begin,
+                    std::vector<TM>::const_iterator end,
+                    std::vector<TSOS>& result) const;
 
   /*  
       //not mature for integration.  
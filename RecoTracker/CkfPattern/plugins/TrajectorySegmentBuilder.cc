@@ -312,12 +312,25 @@ void TrajectorySegmentBuilder::updateCandidates(TempTrajectory const& traj,
                                                 const vector<TM>& measurements,
                                                 TempTrajectoryContainer& candidates) {
   //
-  // generate updated candidates with all valid hits
+  // generate updated candidates with all valid hits,
+  // the states of all of them are updated in a single call
   //
+  std::vector<const TrajectoryStateOnSurface*> predictedStates;
+  std::vector<const TrackingRecHit*> hits;
+  for (auto const& tm : measurements) {
+    if (tm.recHit()->isValid()) {
+      predictedStates.push_back(&tm.predictedState());
+      hits.push_back(tm.recHit().get());
+    }
+  }
+  std::vector<TrajectoryStateOnSurface> updatedStates(hits.size());
+  theUpdator.updateBatch(predictedStates.data(), hits.data(), updatedStates.data(), hits.size());
+
+  auto upState = updatedStates.begin();
   for (auto im = measurements.begin(); im != measurements.end(); ++im) {
     if (im->recHit()->isValid()) {
       candidates.push_back(traj);
-      updateTrajectory(candidates.back(), *im);
+      candidates.back().emplace(im->predictedState(), std::move(*upState++), im->recHit(), im->estimate(), im->layer());
       if (theLockHits)
         lockMeasurement(*im);
     }
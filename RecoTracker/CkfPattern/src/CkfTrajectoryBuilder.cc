@@ -213,9 +213,11 @@ unsigned int CkfTrajectoryBuilder::limitedCandidates(const std::shared_ptr<const
             last = meas.end();
         }
 
+        std::vector<TSOS> upStates;
+        updateStates(meas.begin(), last, upStates);
         for (auto itm = meas.begin(); itm != last; itm++) {
           TempTrajectory newTraj = *traj;
-          updateTrajectory(newTraj, std::move(*itm));
+          updateTrajectory(newTraj, std::move(*itm), std::move(upStates[itm - meas.begin()]));
 
           if (toBeContinued(newTraj)) {
             newCand.push_back(std::move(newTraj));
@@ -309,6 +311,37 @@ void CkfTrajectoryBuilder::updateTrajectory(TempTrajectory& traj, TM&& tm) const
   }
 }
 
+void CkfTrajectoryBuilder::updateStates(std::vector<TM>::const_iterator begin,
+                                        std::vector<TM>::const_iterator end,
+                                        std::vector<TSOS>& result) const {
+  std::vector<const TSOS*> predictedStates;
+  std::vector<const TrackingRecHit*> hits;
+  std::vector<int> index;
+  for (auto itm = begin; itm != end; ++itm) {
+    if (itm->recHit()->isValid()) {
+      predictedStates.push_back(&itm->predictedState());
+      hits.push_back(itm->recHit().get());
+      index.push_back(itm - begin);
+    }
+  }
+  std::vector<TSOS> updated(hits.size());
+  theUpdator->updateBatch(predictedStates.data(), hits.data(), updated.data(), hits.size());
+
+  result.resize(end - begin);
+  for (unsigned int i = 0; i < index.size(); ++i)
+    result[index[i]] = std::move(updated[i]);
+}
+
+void CkfTrajectoryBuilder::updateTrajectory(TempTrajectory& traj, TM&& tm, TSOS&& upState) const {
+  auto&& predictedState = tm.predictedState();
+  auto&& hit = tm.recHit();
+  if (hit->isValid()) {
+    traj.emplace(std::move(predictedState), std::move(upState), std::move(hit), tm.estimate(), tm.layer());
+  } else {
+    traj.emplace(std::move(predictedState), std::move(hit), 0, tm.layer());
+  }
+}
+
 void CkfTrajectoryBuilder::findCompatibleMeasurements(const TrajectorySeed& seed,
                                                       const TempTrajectory& traj,
                                                       std::vector<TrajectoryMeasurement>& result) const {
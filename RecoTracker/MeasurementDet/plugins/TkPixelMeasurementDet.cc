@@ -51,10 +51,16 @@ bool TkPixelMeasurementDet::measurements(const TrajectoryStateOnSurface& stateOn
 
   auto oldSize = result.size();
   MeasurementDet::RecHitContainer&& allHits = compHits(stateOnThisDet, data, xl, yl);
-  for (auto&& hit : allHits) {
-    std::pair<bool, double> diffEst = est.estimate(stateOnThisDet, *hit);
-    if (diffEst.first)
-      result.add(std::move(hit), diffEst.second);
+  // all the hits are estimated in a single call
+  std::vector<const TrackingRecHit*> hits;
+  hits.reserve(allHits.size());
+  for (auto const& hit : allHits)
+    hits.push_back(hit.get());
+  std::vector<MeasurementEstimator::HitReturnType> diffEst(hits.size());
+  est.estimateBatch(stateOnThisDet, hits.data(), diffEst.data(), hits.size());
+  for (unsigned int i = 0; i < allHits.size(); ++i) {
+    if (diffEst[i].first)
+      result.add(std::move(allHits[i]), diffEst[i].second);
   }
 
   if (result.size() > oldSize)
@@ -240,6 +240,7 @@ private:
   double uniquetrkweight_;
   double zmerge_;
   double tmerge_;
+  unsigned int concurrentUpdateMinTracks_;
   double betapurge_;
 };
 
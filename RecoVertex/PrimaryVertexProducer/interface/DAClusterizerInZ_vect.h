@@ -178,6 +178,7 @@ private:
   double mintrkweight_;
   double uniquetrkweight_;
   double zmerge_;
+  unsigned int concurrentUpdateMinTracks_;
   double betapurge_;
 };
 
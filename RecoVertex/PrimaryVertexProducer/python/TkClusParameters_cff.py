@@ -11,7 +11,8 @@ DA_vectParameters = cms.PSet(
         d0CutOff = cms.double(3.),        # downweight high IP tracks 
         dzCutOff = cms.double(3.),        # outlier rejection after freeze-out (T<Tmin)       
         zmerge = cms.double(1e-2),        # merge intermediat clusters separated by less than zmerge
-        uniquetrkweight = cms.double(0.8) # require at least two tracks with this weight at T=Tpurge
+        uniquetrkweight = cms.double(0.8), # require at least two tracks with this weight at T=Tpurge
+        concurrentUpdateMinTracks = cms.untracked.uint32(0) # if > 0, update concurrently with at least this many tracks (same result up to rounding)
         )
 )
 
@@ -45,6 +46,7 @@ DA2D_vectParameters = cms.PSet(
         t0Max = cms.double(1.0),          # outlier rejection for use of timing information
         zmerge = cms.double(1e-2),        # merge intermediat clusters separated by less than zmerge and tmerge
         tmerge = cms.double(1e-1),        # merge intermediat clusters separated by less than zmerge and tmerge
-        uniquetrkweight = cms.double(0.8) # require at least two tracks with this weight at T=Tpurge
+        uniquetrkweight = cms.double(0.8), # require at least two tracks with this weight at T=Tpurge
+        concurrentUpdateMinTracks = cms.untracked.uint32(0) # if > 0, update concurrently with at least this many tracks (same result up to rounding)
         )
 )
@@ -3,12 +3,16 @@
 #include "DataFormats/GeometryCommonDetAlgo/interface/Measurement1D.h"
 #include "RecoVertex/VertexPrimitives/interface/VertexException.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cassert>
 #include <limits>
 #include <iomanip>
 #include "FWCore/Utilities/interface/isFinite.h"
 #include "vdt/vdtMath.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
 
 using namespace std;
 //#define VI_DEBUG
@@ -42,6 +46,8 @@ DAClusterizerInZT_vect::DAClusterizerInZT_vect(const edm::ParameterSet& conf) {
   uniquetrkweight_ = conf.getParameter<double>("uniquetrkweight");
   zmerge_ = conf.getParameter<double>("zmerge");
   tmerge_ = conf.getParameter<double>("tmerge");
+  // changes the result at most by the rounding of the sums, hence untracked
+  concurrentUpdateMinTracks_ = conf.getUntrackedParameter<unsigned int>("concurrentUpdateMinTracks", 0);
 
 #ifdef VI_DEBUG
   if (verbose_) {
@@ -58,6 +64,7 @@ DAClusterizerInZT_vect::DAClusterizerInZT_vect(const edm::ParameterSet& conf) {
     std::cout << "DAClusterizerinZT_vect: d0CutOff = " << d0CutOff_ << std::endl;
     std::cout << "DAClusterizerinZT_vect: dzCutOff = " << dzCutOff_ << std::endl;
     std::cout << "DAClusterizerinZT_vect: dtCutoff = " << dtCutOff_ << std::endl;
+    std::cout << "DAClusterizerinZT_vect: concurrentUpdateMinTracks = " << concurrentUpdateMinTracks_ << std::endl;
   }
 #endif
 
@@ -154,6 +161,161 @@ namespace {
   inline double Eik(double t_z, double k_z, double t_dz2, double t_t, double k_t, double t_dt2) {
     return std::pow(t_z - k_z, 2) * t_dz2 + std::pow(t_t - k_t, 2) * t_dt2;
   }
+
+  // The kernels of the concurrent update, as in DAClusterizerInZ_vect.cc: the same operations as the
+  // kernels of DAClusterizerInZT_vect::update, kept out of the inlining and interprocedural
+  // optimizations, so that the result does not depend on the number of threads.
+#if defined(__GNUC__) && !defined(__clang__)
+#define DA_KERNEL __attribute__((noipa))
+#else
+#define DA_KERNEL __attribute__((noinline))
+#endif
+
+  DA_KERNEL void concurrent_calc_exp(double track_z,
+                                     double track_t,
+                                     double botrack_dz2,
+                                     double botrack_dt2,
+                                     double const* __restrict__ z,
+                                     double const* __restrict__ t,
+                                     const unsigned int nv,
+                                     double* __restrict__ ei_cache,
+                                     double* __restrict__ ei) {
+    // auto-vectorized
+    for (unsigned int ivertex = 0; ivertex < nv; ++ivertex) {
+      const auto mult_resz = track_z - z[ivertex];
+      const auto mult_rest = track_t - t[ivertex];
+      ei_cache[ivertex] = botrack_dz2 * (mult_resz * mult_resz) + botrack_dt2 * (mult_rest * mult_rest);
+    }
+    local_exp_list(ei_cache, ei, nv);
+  }
+
+  DA_KERNEL double concurrent_add_Z(double Z_init,
+                                    double const* __restrict__ pk,
+                                    double const* __restrict__ ei,
+                                    const unsigned int nv) {
+    double ZTemp = Z_init;
+    for (unsigned int ivertex = 0; ivertex < nv; ++ivertex) {
+      ZTemp += pk[ivertex] * ei[ivertex];
+    }
+    return ZTemp;
+  }
+
+  DA_KERNEL void concurrent_calc_normalization(double tmp_trk_pi,
+                                               double o_trk_Z_sum,
+                                               double o_trk_err_z,
+                                               double o_trk_err_t,
+                                               double tmp_trk_z,
+                                               double tmp_trk_t,
+                                               const unsigned int n,
+                                               double const* __restrict__ ei,
+                                               double const* __restrict__ z,
+                                               double const* __restrict__ t,
+                                               double const* __restrict__ pk,
+                                               double* __restrict__ se,
+                                               double* __restrict__ nuz,
+                                               double* __restrict__ nut,
+                                               double* __restrict__ swz,
+                                               double* __restrict__ swt,
+                                               double* __restrict__ szz,
+                                               double* __restrict__ stt,
+                                               double* __restrict__ szt) {
+    // auto-vectorized
+    for (unsigned int k = 0; k < n; ++k) {
+      // parens are important for numerical stability
+      se[k] += tmp_trk_pi * (ei[k] * o_trk_Z_sum);
+      const auto w = tmp_trk_pi * (pk[k] * ei[k] * o_trk_Z_sum);  // p_{ik}
+      const auto wz = w * o_trk_err_z;
+      const auto wt = w * o_trk_err_t;
+      nuz[k] += wz;
+      nut[k] += wt;
+      swz[k] += wz * tmp_trk_z;
+      swt[k] += wt * tmp_trk_t;
+      const auto dsz = (tmp_trk_z - z[k]) * o_trk_err_z;
+      const auto dst = (tmp_trk_t - t[k]) * o_trk_err_t;
+      szz[k] += w * dsz * dsz;
+      stt[k] += w * dst * dst;
+      szt[k] += w * dsz * dst;
+    }
+  }
+
+#undef DA_KERNEL
+
+  // tracks whose exponentials are kept at the same time, and vertices updated by a task
+  constexpr unsigned int concurrentTrackChunk = 256;
+  constexpr unsigned int concurrentVertexBlock = 16;
+
+  // The track normalizations and the vertex sums of DAClusterizerInZT_vect::update, computed as in
+  // the concurrent update of DAClusterizerInZ_vect. Returns the sum of the track weights.
+  double concurrentUpdate(double beta,
+                          double Z_init,
+                          DAClusterizerInZT_vect::track_t& gtracks,
+                          DAClusterizerInZT_vect::vertex_t& gvertices) {
+    const unsigned int nt = gtracks.getSize();
+    const unsigned int nv = gvertices.getSize();
+    const unsigned int nblocks = (nv + concurrentVertexBlock - 1) / concurrentVertexBlock;
+    std::vector<double> ei_cache(std::min(nt, concurrentTrackChunk) * nv), ei(ei_cache.size());
+
+    unsigned int chunk = 0, end = 0;
+    auto updateTracks = [&](tbb::blocked_range<unsigned int> const& tracks) {
+      for (auto itrack = tracks.begin(); itrack != tracks.end(); ++itrack) {
+        const auto row = (itrack - chunk) * nv;
+        concurrent_calc_exp(gtracks.z_[itrack],
+                            gtracks.t_[itrack],
+                            -beta * gtracks.dz2_[itrack],
+                            -beta * gtracks.dt2_[itrack],
+                            gvertices.z_,
+                            gvertices.t_,
+                            nv,
+                            &ei_cache[row],
+                            &ei[row]);
+        gtracks.Z_sum_[itrack] = concurrent_add_Z(Z_init, gvertices.pk_, &ei[row], nv);
+        if (edm::isNotFinite(gtracks.Z_sum_[itrack]))
+          gtracks.Z_sum_[itrack] = 0.0;
+      }
+    };
+    auto updateVertices = [&](tbb::blocked_range<unsigned int> const& blocks) {
+      for (auto block = blocks.begin(); block != blocks.end(); ++block) {
+        const unsigned int first = block * concurrentVertexBlock;
+        const unsigned int n = std::min(concurrentVertexBlock, nv - first);
+        for (auto itrack = chunk; itrack < end; ++itrack) {
+          if (gtracks.Z_sum_[itrack] > 1.e-100) {
+            concurrent_calc_normalization(gtracks.pi_[itrack],
+                                          1. / gtracks.Z_sum_[itrack],
+                                          gtracks.dz2_[itrack],
+                                          gtracks.dt2_[itrack],
+                                          gtracks.z_[itrack],
+                                          gtracks.t_[itrack],
+                                          n,
+                                          &ei[(itrack - chunk) * nv + first],
+                                          gvertices.z_ + first,
+                                          gvertices.t_ + first,
+                                          gvertices.pk_ + first,
+                                          gvertices.se_ + first,
+                                          gvertices.nuz_ + first,
+                                          gvertices.nut_ + first,
+                                          gvertices.swz_ + first,
+                                          gvertices.swt_ + first,
+                                          gvertices.szz_ + first,
+                                          gvertices.stt_ + first,
+                                          gvertices.szt_ + first);
+          }
+        }
+      }
+    };
+    tbb::this_task_arena::isolate([&] {
+      for (chunk = 0; chunk < nt; chunk = end) {
+        end = std::min(nt, chunk + concurrentTrackChunk);
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(chunk, end), updateTracks);
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nblocks), updateVertices);
+      }
+    });
+
+    double sumpi = 0.;
+    for (auto itrack = 0U; itrack < nt; ++itrack) {
+      sumpi += gtracks.pi_[itrack];
+    }
+    return sumpi;
+  }
 }  // namespace
 
 double DAClusterizerInZT_vect::update(
@@ -240,19 +402,23 @@ double DAClusterizerInZT_vect::update(
     gvertices.szt_[ivertex] = 0.0;
   }
 
-  // loop over tracks
-  for (auto itrack = 0U; itrack < nt; ++itrack) {
-    kernel_calc_exp_arg(itrack, gtracks, gvertices);
-    local_exp_list(gvertices.ei_cache_, gvertices.ei_, nv);
-
-    gtracks.Z_sum_[itrack] = kernel_add_Z(gvertices);
-    if (edm::isNotFinite(gtracks.Z_sum_[itrack]))
-      gtracks.Z_sum_[itrack] = 0.0;
-    // used in the next major loop to follow
-    sumpi += gtracks.pi_[itrack];
-
-    if (gtracks.Z_sum_[itrack] > 1.e-100) {
-      kernel_calc_normalization(itrack, gtracks, gvertices);
+  if (concurrentUpdateMinTracks_ > 0 && nt >= concurrentUpdateMinTracks_) {
+    sumpi = concurrentUpdate(beta, Z_init, gtracks, gvertices);
+  } else {
+    // loop over tracks
+    for (auto itrack = 0U; itrack < nt; ++itrack) {
+      kernel_calc_exp_arg(itrack, gtracks, gvertices);
+      local_exp_list(gvertices.ei_cache_, gvertices.ei_, nv);
+
+      gtracks.Z_sum_[itrack] = kernel_add_Z(gvertices);
+      if (edm::isNotFinite(gtracks.Z_sum_[itrack]))
+        gtracks.Z_sum_[itrack] = 0.0;
+      // used in the next major loop to follow
+      sumpi += gtracks.pi_[itrack];
+
+      if (gtracks.Z_sum_[itrack] > 1.e-100) {
+        kernel_calc_normalization(itrack, gtracks, gvertices);
+      }
     }
   }
 
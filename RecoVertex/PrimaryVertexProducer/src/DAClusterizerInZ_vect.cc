@@ -3,12 +3,16 @@
 #include "DataFormats/GeometryCommonDetAlgo/interface/Measurement1D.h"
 #include "RecoVertex/VertexPrimitives/interface/VertexException.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cassert>
 #include <limits>
 #include <iomanip>
 #include "FWCore/Utilities/interface/isFinite.h"
 #include "vdt/vdtMath.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
 
 using namespace std;
 
@@ -37,6 +41,8 @@ DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
   dzCutOff_ = conf.getParameter<double>("dzCutOff");
   uniquetrkweight_ = conf.getParameter<double>("uniquetrkweight");
   zmerge_ = conf.getParameter<double>("zmerge");
+  // changes the result at most by the rounding of the sums, hence untracked
+  concurrentUpdateMinTracks_ = conf.getUntrackedParameter<unsigned int>("concurrentUpdateMinTracks", 0);
 
   if (verbose_) {
     std::cout << "DAClusterizerinZ_vect: mintrkweight = " << mintrkweight_ << std::endl;
@@ -49,6 +55,7 @@ DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
     std::cout << "DAClusterizerinZ_vect: coolingFactor = " << coolingFactor_ << std::endl;
     std::cout << "DAClusterizerinZ_vect: d0CutOff = " << d0CutOff_ << std::endl;
     std::cout << "DAClusterizerinZ_vect: dzCutOff = " << dzCutOff_ << std::endl;
+    std::cout << "DAClusterizerinZ_vect: concurrentUpdateMinTracks = " << concurrentUpdateMinTracks_ << std::endl;
   }
 
   if (Tmin == 0) {
@@ -125,6 +132,136 @@ DAClusterizerInZ_vect::track_t DAClusterizerInZ_vect::fill(const vector<reco::Tr
 
 namespace {
   inline double Eik(double t_z, double k_z, double t_dz2) { return std::pow(t_z - k_z, 2) * t_dz2; }
+
+  // The kernels of the concurrent update. They do the same operations as the kernels of
+  // DAClusterizerInZ_vect::update, over all the vertices for a track, or over a block of them for the
+  // normalization, which is elementwise. They are kept out of the inlining and interprocedural
+  // optimizations, so that the same code evaluates them whichever task calls them and the result
+  // does not depend on the number of threads. With -Ofast the compiler may associate the operations
+  // differently in the serial loop, so the sums can differ from the serial ones in the last bits.
+#if defined(__GNUC__) && !defined(__clang__)
+#define DA_KERNEL __attribute__((noipa))
+#else
+#define DA_KERNEL __attribute__((noinline))
+#endif
+
+  DA_KERNEL void concurrent_calc_exp(double track_z,
+                                     double botrack_dz2,
+                                     double const* __restrict__ z,
+                                     const unsigned int nv,
+                                     double* __restrict__ ei_cache,
+                                     double* __restrict__ ei) {
+    // auto-vectorized
+    for (unsigned int ivertex = 0; ivertex < nv; ++ivertex) {
+      auto mult_res = track_z - z[ivertex];
+      ei_cache[ivertex] = botrack_dz2 * (mult_res * mult_res);
+    }
+    local_exp_list(ei_cache, ei, nv);
+  }
+
+  DA_KERNEL double concurrent_add_Z(double Z_init,
+                                    double const* __restrict__ pk,
+                                    double const* __restrict__ ei,
+                                    const unsigned int nv) {
+    double ZTemp = Z_init;
+    for (unsigned int ivertex = 0; ivertex < nv; ++ivertex) {
+      ZTemp += pk[ivertex] * ei[ivertex];
+    }
+    return ZTemp;
+  }
+
+  DA_KERNEL void concurrent_calc_normalization(double tmp_trk_pi,
+                                               double o_trk_Z_sum,
+                                               double o_trk_dz2,
+                                               double tmp_trk_z,
+                                               double obeta,
+                                               const unsigned int n,
+                                               double const* __restrict__ ei_cache,
+                                               double const* __restrict__ ei,
+                                               double const* __restrict__ pk,
+                                               double* __restrict__ se,
+                                               double* __restrict__ sw,
+                                               double* __restrict__ swz,
+                                               double* __restrict__ swE) {
+    // auto-vectorized
+    for (unsigned int k = 0; k < n; ++k) {
+      se[k] += ei[k] * (tmp_trk_pi * o_trk_Z_sum);
+      auto w = pk[k] * ei[k] * (tmp_trk_pi * o_trk_Z_sum * o_trk_dz2);
+      sw[k] += w;
+      swz[k] += w * tmp_trk_z;
+      swE[k] += w * ei_cache[k] * obeta;
+    }
+  }
+
+#undef DA_KERNEL
+
+  // tracks whose exponentials are kept at the same time, and vertices updated by a task
+  constexpr unsigned int concurrentTrackChunk = 256;
+  constexpr unsigned int concurrentVertexBlock = 16;
+
+  // The track normalizations and the vertex sums of DAClusterizerInZ_vect::update, with the tracks of
+  // a chunk, then the blocks of vertices, updated concurrently. The exponentials of the chunk are
+  // computed once, and the sums of each vertex are accumulated over the tracks in the same order as
+  // in the serial loop. Returns the sum of the track weights.
+  double concurrentUpdate(double beta,
+                          double Z_init,
+                          DAClusterizerInZ_vect::track_t& gtracks,
+                          DAClusterizerInZ_vect::vertex_t& gvertices) {
+    const unsigned int nt = gtracks.GetSize();
+    const unsigned int nv = gvertices.GetSize();
+    const unsigned int nblocks = (nv + concurrentVertexBlock - 1) / concurrentVertexBlock;
+    const double obeta = -1. / beta;
+    std::vector<double> ei_cache(std::min(nt, concurrentTrackChunk) * nv), ei(ei_cache.size());
+
+    unsigned int chunk = 0, end = 0;
+    auto updateTracks = [&](tbb::blocked_range<unsigned int> const& tracks) {
+      for (auto itrack = tracks.begin(); itrack != tracks.end(); ++itrack) {
+        const auto row = (itrack - chunk) * nv;
+        concurrent_calc_exp(
+            gtracks._z[itrack], -beta * gtracks._dz2[itrack], gvertices._z, nv, &ei_cache[row], &ei[row]);
+        gtracks._Z_sum[itrack] = concurrent_add_Z(Z_init, gvertices._pk, &ei[row], nv);
+        if (edm::isNotFinite(gtracks._Z_sum[itrack]))
+          gtracks._Z_sum[itrack] = 0.0;
+      }
+    };
+    auto updateVertices = [&](tbb::blocked_range<unsigned int> const& blocks) {
+      for (auto block = blocks.begin(); block != blocks.end(); ++block) {
+        const unsigned int first = block * concurrentVertexBlock;
+        const unsigned int n = std::min(concurrentVertexBlock, nv - first);
+        for (auto itrack = chunk; itrack < end; ++itrack) {
+          if (gtracks._Z_sum[itrack] > 1.e-100) {
+            const auto row = (itrack - chunk) * nv + first;
+            concurrent_calc_normalization(gtracks._pi[itrack],
+                                          1. / gtracks._Z_sum[itrack],
+                                          gtracks._dz2[itrack],
+                                          gtracks._z[itrack],
+                                          obeta,
+                                          n,
+                                          &ei_cache[row],
+                                          &ei[row],
+                                          gvertices._pk + first,
+                                          gvertices._se + first,
+                                          gvertices._sw + first,
+                                          gvertices._swz + first,
+                                          gvertices._swE + first);
+          }
+        }
+      }
+    };
+    tbb::this_task_arena::isolate([&] {
+      for (chunk = 0; chunk < nt; chunk = end) {
+        end = std::min(nt, chunk + concurrentTrackChunk);
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(chunk, end), updateTracks);
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nblocks), updateVertices);
+      }
+    });
+
+    double sumpi = 0;
+    for (auto itrack = 0U; itrack < nt; ++itrack) {
+      sumpi += gtracks._pi[itrack];
+    }
+    return sumpi;
+  }
 }  // namespace
 
 double DAClusterizerInZ_vect::update(
@@ -193,19 +330,23 @@ double DAClusterizerInZ_vect::update(
     gvertices._swE[ivertex] = 0.0;
   }
 
-  // loop over tracks
-  for (auto itrack = 0U; itrack < nt; ++itrack) {
-    kernel_calc_exp_arg(itrack, gtracks, gvertices);
-    local_exp_list(gvertices._ei_cache, gvertices._ei, nv);
-
-    gtracks._Z_sum[itrack] = kernel_add_Z(gvertices);
-    if (edm::isNotFinite(gtracks._Z_sum[itrack]))
-      gtracks._Z_sum[itrack] = 0.0;
-    // used in the next major loop to follow
-    sumpi += gtracks._pi[itrack];
-
-    if (gtracks._Z_sum[itrack] > 1.e-100) {
-      kernel_calc_normalization(itrack, gtracks, gvertices);
+  if (concurrentUpdateMinTracks_ > 0 && nt >= concurrentUpdateMinTracks_) {
+    sumpi = concurrentUpdate(beta, Z_init, gtracks, gvertices);
+  } else {
+    // loop over tracks
+    for (auto itrack = 0U; itrack < nt; ++itrack) {
+      kernel_calc_exp_arg(itrack, gtracks, gvertices);
+      local_exp_list(gvertices._ei_cache, gvertices._ei, nv);
+
+      gtracks._Z_sum[itrack] = kernel_add_Z(gvertices);
+      if (edm::isNotFinite(gtracks._Z_sum[itrack]))
+        gtracks._Z_sum[itrack] = 0.0;
+      // used in the next major loop to follow
+      sumpi += gtracks._pi[itrack];
+
+      if (gtracks._Z_sum[itrack] > 1.e-100) {
+        kernel_calc_normalization(itrack, gtracks, gvertices);
+      }
     }
   }
 
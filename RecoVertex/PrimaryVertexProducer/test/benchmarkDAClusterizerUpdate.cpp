@@ -0,0 +1,103 @@
+// Time of one update of the deterministic annealing of DAClusterizerInZ_vect and DAClusterizerInZT_vect
+// near the end of the annealing, on pileup-like events with one vertex per generated interaction. The
+// arguments are the pileup and the number of threads, 0 for the serial update (the default).
+
+#include <benchmark/benchmark.h>
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "RecoVertex/PrimaryVertexProducer/interface/DAClusterizerInZ_vect.h"
+#include "RecoVertex/PrimaryVertexProducer/interface/DAClusterizerInZT_vect.h"
+
+#include "tbb/global_control.h"
+#include "tbb/task_arena.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+  constexpr double vertexSize = 0.006;
+  constexpr double vertexSizeTime = 0.008;
+  constexpr double beta = 1. / 2.;
+
+  edm::ParameterSet parameters(unsigned int concurrentUpdateMinTracks) {
+    edm::ParameterSet conf;
+    conf.addParameter<double>("Tmin", 2.);
+    conf.addParameter<double>("Tpurge", 2.);
+    conf.addParameter<double>("Tstop", 0.5);
+    conf.addParameter<double>("vertexSize", vertexSize);
+    conf.addParameter<double>("vertexSizeTime", vertexSizeTime);
+    conf.addParameter<double>("coolingFactor", 0.6);
+    conf.addParameter<double>("d0CutOff", 3.);
+    conf.addParameter<double>("dzCutOff", 3.);
+    conf.addParameter<double>("dtCutOff", 4.);
+    conf.addParameter<double>("t0Max", 1.);
+    conf.addParameter<double>("zmerge", 1e-2);
+    conf.addParameter<double>("tmerge", 1e-1);
+    conf.addParameter<double>("uniquetrkweight", 0.8);
+    conf.addUntrackedParameter<unsigned int>("concurrentUpdateMinTracks", concurrentUpdateMinTracks);
+    return conf;
+  }
+
+  // pileup interactions along the beam line with 2 to 60 selected tracks each, about 30 tracks per
+  // interaction on average
+  template <typename AddTrack, typename AddVertex>
+  void fillEvent(unsigned int pileup, AddTrack addTrack, AddVertex addVertex) {
+    std::mt19937 rng(13579);
+    std::normal_distribution<double> gauss(0., 1.);
+    std::uniform_real_distribution<double> uniform(0., 1.);
+    for (unsigned int ivertex = 0; ivertex < pileup; ++ivertex) {
+      const double z = 4. * gauss(rng);
+      const double t = 0.2 * gauss(rng);
+      addVertex(z, t, 1. / pileup);
+      const unsigned int ntracks = 2 + static_cast<unsigned int>(58 * uniform(rng));
+      for (unsigned int itrack = 0; itrack < ntracks; ++itrack) {
+        const double dz = 0.005 + 0.05 * uniform(rng);
+        const double dt = 0.035;
+        addTrack(z + dz * gauss(rng),
+                 t + dt * gauss(rng),
+                 1. / (dz * dz + vertexSize * vertexSize),
+                 1. / (dt * dt + vertexSizeTime * vertexSizeTime));
+      }
+    }
+  }
+
+  // the serial update with 0 threads, the concurrent update otherwise; the vertices move only in the
+  // first iterations, the later ones time the update of converged vertices
+  template <typename Clusterizer>
+  void timeUpdate(benchmark::State& state, typename Clusterizer::track_t& tks, typename Clusterizer::vertex_t& y) {
+    const unsigned int threads = state.range(1);
+    const Clusterizer clusterizer(parameters(threads == 0 ? 0 : 1));
+    tbb::global_control control(tbb::global_control::max_allowed_parallelism, std::max(threads, 1u));
+    tbb::task_arena arena(std::max(threads, 1u));
+    for (auto _ : state) {
+      const double delta = arena.execute([&] { return clusterizer.update(beta, tks, y, true, 1. / tks.z.size()); });
+      benchmark::DoNotOptimize(delta);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(tks.z.size()));
+    state.counters["vertices"] = y.z.size();
+  }
+}  // namespace
+
+static void BM_updateZ(benchmark::State& state) {
+  DAClusterizerInZ_vect::track_t tks;
+  DAClusterizerInZ_vect::vertex_t y;
+  fillEvent(
+      state.range(0),
+      [&](double z, double, double dz2, double) { tks.AddItem(z, dz2, nullptr, 1.); },
+      [&](double z, double, double pk) { y.AddItem(z, pk); });
+  tks.ExtractRaw();
+  timeUpdate<DAClusterizerInZ_vect>(state, tks, y);
+}
+BENCHMARK(BM_updateZ)->ArgsProduct({{140, 200}, {0, 1, 2, 4, 8}})->UseRealTime();
+
+static void BM_updateZT(benchmark::State& state) {
+  DAClusterizerInZT_vect::track_t tks;
+  DAClusterizerInZT_vect::vertex_t y;
+  fillEvent(
+      state.range(0),
+      [&](double z, double t, double dz2, double dt2) { tks.addItem(z, t, dz2, dt2, nullptr, 1.); },
+      [&](double z, double t, double pk) { y.addItem(z, t, pk); });
+  tks.extractRaw();
+  timeUpdate<DAClusterizerInZT_vect>(state, tks, y);
+}
+BENCHMARK(BM_updateZT)->ArgsProduct({{140, 200}, {0, 1, 2, 4, 8}})->UseRealTime();
@@ -0,0 +1,184 @@
+/* Unit test of the concurrent update of the deterministic annealing: with concurrentUpdateMinTracks
+   the successive updates of an annealing of DAClusterizerInZ_vect and DAClusterizerInZT_vect must
+   give exactly the same vertices, track normalizations and changes of the vertex positions with one
+   and with several threads, and the same vertices as the serial update up to the rounding of the
+   sums.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "RecoVertex/PrimaryVertexProducer/interface/DAClusterizerInZ_vect.h"
+#include "RecoVertex/PrimaryVertexProducer/interface/DAClusterizerInZT_vect.h"
+
+#include "tbb/task_arena.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+class testDAClusterizerConcurrentUpdate : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testDAClusterizerConcurrentUpdate);
+  CPPUNIT_TEST(testZ);
+  CPPUNIT_TEST(testZT);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+
+  void testZ();
+  void testZT();
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testDAClusterizerConcurrentUpdate);
+
+namespace {
+  constexpr double Tmin = 2.;
+  constexpr double coolingFactor = 0.6;
+  constexpr double vertexSize = 0.006;
+  constexpr double vertexSizeTime = 0.008;
+
+  edm::ParameterSet parameters(unsigned int concurrentUpdateMinTracks) {
+    edm::ParameterSet conf;
+    conf.addParameter<double>("Tmin", Tmin);
+    conf.addParameter<double>("Tpurge", Tmin);
+    conf.addParameter<double>("Tstop", 0.5);
+    conf.addParameter<double>("vertexSize", vertexSize);
+    conf.addParameter<double>("vertexSizeTime", vertexSizeTime);
+    conf.addParameter<double>("coolingFactor", coolingFactor);
+    conf.addParameter<double>("d0CutOff", 3.);
+    conf.addParameter<double>("dzCutOff", 3.);
+    conf.addParameter<double>("dtCutOff", 4.);
+    conf.addParameter<double>("t0Max", 1.);
+    conf.addParameter<double>("zmerge", 1e-2);
+    conf.addParameter<double>("tmerge", 1e-1);
+    conf.addParameter<double>("uniquetrkweight", 0.8);
+    conf.addUntrackedParameter<unsigned int>("concurrentUpdateMinTracks", concurrentUpdateMinTracks);
+    return conf;
+  }
+
+  // pileup-like events, 60 vertices along the beam line with 2 to 40 tracks each; the tracks are
+  // given with the inverse of their squared errors
+  template <typename AddTrack>
+  void fillTracks(AddTrack addTrack) {
+    std::mt19937 rng(2468);
+    std::normal_distribution<double> gauss(0., 1.);
+    std::uniform_real_distribution<double> uniform(0., 1.);
+    for (unsigned int ivertex = 0; ivertex < 60; ++ivertex) {
+      const double z = 4. * gauss(rng);
+      const double t = 0.2 * gauss(rng);
+      const unsigned int ntracks = 2 + static_cast<unsigned int>(38 * uniform(rng));
+      for (unsigned int itrack = 0; itrack < ntracks; ++itrack) {
+        const double dz = 0.005 + 0.05 * uniform(rng);
+        const double dt = 0.035;
+        addTrack(z + dz * gauss(rng),
+                 t + dt * gauss(rng),
+                 1. / (dz * dz + vertexSize * vertexSize),
+                 1. / (dt * dt + vertexSizeTime * vertexSizeTime));
+      }
+    }
+  }
+
+  // the annealing of the clusterizers, up to the outlier rejection, returns the changes of the
+  // vertex positions of all the updates
+  template <typename Clusterizer>
+  std::vector<double> anneal(Clusterizer const& clusterizer,
+                             typename Clusterizer::track_t& tks,
+                             typename Clusterizer::vertex_t& y) {
+    std::vector<double> deltas;
+    auto update = [&](double beta, bool useRho0, double rho0) {
+      deltas.push_back(clusterizer.update(beta, tks, y, useRho0, rho0));
+      return deltas.back();
+    };
+
+    double beta = clusterizer.beta0(1. / Tmin, tks, y);
+    int niter = 0;
+    while ((update(beta, false, 0.) > 1.e-6) && (niter++ < 100)) {
+    }
+    while (beta < std::sqrt(coolingFactor) / Tmin) {
+      update(beta, false, 0.);
+      while (clusterizer.merge(y, beta)) {
+        update(beta, false, 0.);
+      }
+      clusterizer.split(beta, tks, y);
+      beta = beta / coolingFactor;
+      niter = 0;
+      while ((update(beta, false, 0.) > 1.e-6) && (niter++ < 100)) {
+      }
+    }
+
+    const double rho0 = 1. / tks.z.size();
+    for (unsigned int a = 0; a < 10; a++) {
+      update(beta, true, a * rho0 / 10);
+    }
+    niter = 0;
+    while ((update(beta, true, rho0) > 1.e-8) && (niter++ < 100)) {
+    }
+    return deltas;
+  }
+
+  void extractRaw(DAClusterizerInZ_vect::track_t& tks) { tks.ExtractRaw(); }
+  void extractRaw(DAClusterizerInZT_vect::track_t& tks) { tks.extractRaw(); }
+
+  std::vector<double> positions(DAClusterizerInZ_vect::vertex_t const& y) { return y.z; }
+  std::vector<double> positions(DAClusterizerInZT_vect::vertex_t const& y) {
+    std::vector<double> zt = y.z;
+    zt.insert(zt.end(), y.t.begin(), y.t.end());
+    return zt;
+  }
+
+  // the serial and the concurrent sums may be associated differently, see DAClusterizerInZ_vect.cc
+  void assertClose(std::vector<double> const& expected, std::vector<double> const& actual) {
+    CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+    for (unsigned int i = 0; i < expected.size(); ++i)
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(expected[i], actual[i], 1e-10 * std::max(std::abs(expected[i]), 1.));
+  }
+
+  // the annealing of the tracks tks with one vertex at z = 0, serial and concurrent with one and four
+  // threads
+  template <typename Clusterizer, typename Vertices>
+  void compare(typename Clusterizer::track_t const& tks, Vertices addVertex) {
+    const Clusterizer serial(parameters(0)), concurrent(parameters(1));
+
+    typename Clusterizer::track_t serialTracks = tks, oneThreadTracks = tks, fourThreadsTracks = tks;
+    typename Clusterizer::vertex_t serialVertices, oneThreadVertices, fourThreadsVertices;
+    for (auto* tracks : {&serialTracks, &oneThreadTracks, &fourThreadsTracks})
+      extractRaw(*tracks);
+    for (auto* vertices : {&serialVertices, &oneThreadVertices, &fourThreadsVertices})
+      addVertex(*vertices);
+
+    const std::vector<double> serialDeltas = anneal(serial, serialTracks, serialVertices);
+    std::vector<double> oneThreadDeltas, fourThreadsDeltas;
+    tbb::task_arena(1).execute([&] { oneThreadDeltas = anneal(concurrent, oneThreadTracks, oneThreadVertices); });
+    tbb::task_arena(4).execute([&] { fourThreadsDeltas = anneal(concurrent, fourThreadsTracks, fourThreadsVertices); });
+
+    CPPUNIT_ASSERT(serialVertices.z.size() > 30);
+    CPPUNIT_ASSERT(oneThreadDeltas == fourThreadsDeltas);
+    CPPUNIT_ASSERT(positions(oneThreadVertices) == positions(fourThreadsVertices));
+    CPPUNIT_ASSERT(oneThreadVertices.pk == fourThreadsVertices.pk);
+    CPPUNIT_ASSERT(oneThreadTracks.Z_sum == fourThreadsTracks.Z_sum);
+
+    CPPUNIT_ASSERT_EQUAL(serialDeltas.size(), fourThreadsDeltas.size());
+    assertClose(positions(serialVertices), positions(fourThreadsVertices));
+    assertClose(serialVertices.pk, fourThreadsVertices.pk);
+  }
+}  // namespace
+
+void testDAClusterizerConcurrentUpdate::testZ() {
+  DAClusterizerInZ_vect::track_t tks;
+  fillTracks([&](double z, double, double dz2, double) { tks.AddItem(z, dz2, nullptr, 1.); });
+  compare<DAClusterizerInZ_vect>(tks, [](DAClusterizerInZ_vect::vertex_t& y) { y.AddItem(0, 1.0); });
+}
+
+void testDAClusterizerConcurrentUpdate::testZT() {
+  // one track in four without a time measurement
+  DAClusterizerInZT_vect::track_t tks;
+  unsigned int n = 0;
+  fillTracks([&](double z, double t, double dz2, double dt2) {
+    const bool timed = (n++ % 4) != 0;
+    tks.addItem(z, timed ? t : 0., dz2, timed ? dt2 : 0., nullptr, 1.);
+  });
+  compare<DAClusterizerInZT_vect>(tks, [](DAClusterizerInZT_vect::vertex_t& y) { y.addItem(0, 0, 1.0); });
+}
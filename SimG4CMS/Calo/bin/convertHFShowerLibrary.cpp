@@ -0,0 +1,34 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: convertHFShowerLibrary.cpp
+// Description: Converts the ROOT file of the HF shower library into the
+//              compact format, which the simulation maps in memory when it
+//              is given as the FileName of the HFShowerLibrary
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Calo/interface/HFShowerLibraryData.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <iostream>
+
+int main(int argc, char** argv) {
+  if (argc != 3 && argc != 6) {
+    std::cerr << "Usage: " << argv[0] << " input.root output [emBranch hadBranch eventInfoBranch]\n"
+              << "  the branches default to emParticles and hadParticles of the HFSimHits tree;\n"
+              << "  with an eventInfoBranch, they are read from the Events tree\n";
+    return 1;
+  }
+  HFShowerLibraryData::Source source;
+  source.fileName = argv[1];
+  source.emBranch = (argc == 6) ? argv[3] : "emParticles";
+  source.hadBranch = (argc == 6) ? argv[4] : "hadParticles";
+  source.eventInfoBranch = (argc == 6) ? argv[5] : "";
+  try {
+    HFShowerLibraryData library(source);
+    library.write(argv[2]);
+    std::cout << "Wrote " << library.totEvents() << " records of each type to " << argv[2] << "\n";
+  } catch (cms::Exception const& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
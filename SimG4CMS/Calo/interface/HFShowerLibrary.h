@@ -10,15 +10,11 @@
 #include "Geometry/HcalCommonData/interface/HcalDDDSimConstants.h"
 #include "CondFormats/GeometryObjects/interface/HcalSimulationParameters.h"
 #include "SimG4CMS/Calo/interface/HFFibre.h"
+#include "SimG4CMS/Calo/interface/HFShowerLibraryData.h"
 #include "SimDataFormats/CaloHit/interface/HFShowerPhoton.h"
 
 #include "G4ThreeVector.hh"
 
-//ROOT
-#include "TROOT.h"
-#include "TFile.h"
-#include "TTree.h"
-
 #include <string>
 #include <memory>
 
@@ -56,7 +52,6 @@ public:
 protected:
   bool rInside(double r);
   void getRecord(int, int);
-  void loadEventInfo(TBranch *);
   void interpolate(int, double);
   void extrapolate(int, double);
   void storePhoton(int j);
@@ -64,10 +59,9 @@ protected:
 private:
   const HcalDDDSimConstants *hcalConstant_;
   std::unique_ptr<HFFibre> fibre_;
-  TFile *hf;
-  TBranch *emBranch, *hadBranch;
+  std::shared_ptr<const HFShowerLibraryData> library_;
 
-  bool verbose, applyFidCut, newForm, v3version;
+  bool verbose, applyFidCut;
   int nMomBin, totEvents, evtPerBin;
   float libVers, listVersion;
   std::vector<double> pmom;
@@ -78,7 +72,7 @@ private:
 
   int npe;
   HFShowerPhotonCollection pe;
-  HFShowerPhotonCollection *photo;
-  HFShowerPhotonCollection photon;
+  const HFShowerLibraryData::Photon *photon;  // photons of the last record
+  unsigned int nPhoton;
 };
 #endif
@@ -0,0 +1,79 @@
+#ifndef SimG4CMS_HFShowerLibraryData_h
+#define SimG4CMS_HFShowerLibraryData_h 1
+///////////////////////////////////////////////////////////////////////////////
+// File: HFShowerLibraryData.h
+// Description: Photon records of the HF shower library, read once per process
+//              and shared by the HFShowerLibrary of all the threads
+///////////////////////////////////////////////////////////////////////////////
+
+// The photons of all the records of a type (0 for e/gamma, 1 for hadrons) are
+// kept in a single array, those of record i (0-based) being in the range
+// [offsets[i], offsets[i + 1]). The data are read from the ROOT file of the
+// library, or mapped from a file in the compact format written by write(),
+// which holds the same arrays in native byte order:
+//   "HFSLIB01", nMomBin, totEvents, evtPerBin, libVers, listVersion, padding,
+//   pmom[nMomBin], offsets[2][totEvents + 1], photons of type 0 then type 1
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class HFShowerLibraryData {
+public:
+  struct Photon {
+    float x, y, z, lambda, t;
+  };
+
+  // where the library is in its ROOT file; the branch names are complete
+  struct Source {
+    std::string fileName;
+    std::string eventInfoBranch;  // empty for the libraries with the HFSimHits tree
+    std::string emBranch;
+    std::string hadBranch;
+  };
+
+  // the data of the library, loaded by the first caller and shared while in use
+  static std::shared_ptr<const HFShowerLibraryData> get(const Source& source, bool verbose = false);
+
+  HFShowerLibraryData(const Source& source, bool verbose = false);
+  ~HFShowerLibraryData();
+
+  HFShowerLibraryData(const HFShowerLibraryData&) = delete;
+  HFShowerLibraryData& operator=(const HFShowerLibraryData&) = delete;
+
+  // writes the library in the compact format, which can then be mapped in memory
+  void write(const std::string& fileName) const;
+
+  int nMomBin() const { return nMomBin_; }
+  int totEvents() const { return totEvents_; }
+  int evtPerBin() const { return evtPerBin_; }
+  float libVers() const { return libVers_; }
+  float listVersion() const { return listVersion_; }
+  // energies of the bins in GeV
+  const std::vector<double>& pmom() const { return pmom_; }
+  bool isMapped() const { return mapped_ != nullptr; }
+
+  unsigned int nPhotons(int type, int record) const {
+    return offsets_[type][record + 1] - offsets_[type][record];
+  }
+  const Photon* photons(int type, int record) const { return photons_[type] + offsets_[type][record]; }
+
+private:
+  void readRoot(const Source& source, bool verbose);
+  void map(const std::string& fileName);
+
+  int nMomBin_, totEvents_, evtPerBin_;
+  float libVers_, listVersion_;
+  std::vector<double> pmom_;
+
+  // point either to the vectors below or into the mapped file
+  const uint64_t* offsets_[2];
+  const Photon* photons_[2];
+  std::vector<uint64_t> ownedOffsets_[2];
+  std::vector<Photon> ownedPhotons_[2];
+
+  void* mapped_;
+  size_t mappedSize_;
+};
+#endif
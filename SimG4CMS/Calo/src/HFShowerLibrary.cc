@@ -4,7 +4,6 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "SimG4CMS/Calo/interface/HFShowerLibrary.h"
-#include "SimDataFormats/CaloHit/interface/HFShowerLibraryEventInfo.h"
 #include "SimG4Core/Notification/interface/G4TrackToParticleID.h"
 
 #include "FWCore/Utilities/interface/Exception.h"
@@ -24,7 +23,7 @@ HFShowerLibrary::HFShowerLibrary(const std::string& name,
                                  const HcalDDDSimConstants* hcons,
                                  const HcalSimulationParameters* hps,
                                  edm::ParameterSet const& p)
-    : hcalConstant_(hcons), hf(nullptr), emBranch(nullptr), hadBranch(nullptr), npe(0) {
+    : hcalConstant_(hcons), npe(0), photon(nullptr), nPhoton(0) {
   edm::ParameterSet m_HF = p.getParameter<edm::ParameterSet>("HFShower");
   probMax = m_HF.getParameter<double>("ProbMax");
 
@@ -43,40 +42,24 @@ HFShowerLibrary::HFShowerLibrary(const std::string& name,
 
   if (pTreeName.find(".") == 0)
     pTreeName.erase(0, 2);
-  const char* nTree = pTreeName.c_str();
-  hf = TFile::Open(nTree);
 
-  if (!hf->IsOpen()) {
-    edm::LogError("HFShower") << "HFShowerLibrary: opening " << nTree << " failed";
-    throw cms::Exception("Unknown", "HFShowerLibrary") << "Opening of " << pTreeName << " fails\n";
-  } else {
-    edm::LogVerbatim("HFShower") << "HFShowerLibrary: opening " << nTree << " successfully";
-  }
-
-  newForm = (branchEvInfo.empty());
-  TTree* event(nullptr);
-  if (newForm)
-    event = (TTree*)hf->Get("HFSimHits");
-  else
-    event = (TTree*)hf->Get("Events");
-  if (event) {
-    TBranch* evtInfo(nullptr);
-    if (!newForm) {
-      std::string info = branchEvInfo + branchPost;
-      evtInfo = event->GetBranch(info.c_str());
-    }
-    if (evtInfo || newForm) {
-      loadEventInfo(evtInfo);
-    } else {
-      edm::LogError("HFShower") << "HFShowerLibrary: HFShowerLibrayEventInfo"
-                                << " Branch does not exist in Event";
-      throw cms::Exception("Unknown", "HFShowerLibrary") << "Event information absent\n";
-    }
-  } else {
-    edm::LogError("HFShower") << "HFShowerLibrary: Events Tree does not "
-                              << "exist";
-    throw cms::Exception("Unknown", "HFShowerLibrary") << "Events tree absent\n";
-  }
+  // the photons of the library are read once and shared by the threads
+  HFShowerLibraryData::Source source;
+  source.fileName = pTreeName;
+  if (!branchEvInfo.empty())
+    source.eventInfoBranch = branchEvInfo + branchPost;
+  source.emBranch = branchPre + emName + branchPost;
+  source.hadBranch = branchPre + hadName + branchPost;
+  library_ = HFShowerLibraryData::get(source, verbose);
+
+  nMomBin = library_->nMomBin();
+  totEvents = library_->totEvents();
+  evtPerBin = library_->evtPerBin();
+  libVers = library_->libVers();
+  listVersion = library_->listVersion();
+  pmom = library_->pmom();
+  for (int i = 0; i < nMomBin; i++)
+    pmom[i] *= GeV;
 
 #ifdef EDM_ML_DEBUG
   std::stringstream ss;
@@ -90,31 +73,12 @@ HFShowerLibrary::HFShowerLibrary(const std::string& name,
     ss << "  " << pmom[i] / CLHEP::GeV;
   }
   edm::LogVerbatim("HFShower") << ss.str();
-#endif
-  std::string nameBr = branchPre + emName + branchPost;
-  emBranch = event->GetBranch(nameBr.c_str());
-  if (verbose)
-    emBranch->Print();
-  nameBr = branchPre + hadName + branchPost;
-  hadBranch = event->GetBranch(nameBr.c_str());
-  if (verbose)
-    hadBranch->Print();
-
-  v3version = false;
-  if (emBranch->GetClassName() == std::string("vector<float>")) {
-    v3version = true;
-  }
-
-#ifdef EDM_ML_DEBUG
-  edm::LogVerbatim("HFShower") << " HFShowerLibrary:Branch " << emName << " has " << emBranch->GetEntries()
-                               << " entries and Branch " << hadName << " has " << hadBranch->GetEntries() << " entries"
-                               << "\n HFShowerLibrary::No packing information -"
+  edm::LogVerbatim("HFShower") << "\n HFShowerLibrary::No packing information -"
                                << " Assume x, y, z are not in packed form"
                                << "\n Maximum probability cut off " << probMax << "  Back propagation of light prob. "
                                << backProb;
 #endif
   fibre_ = std::make_unique<HFFibre>(name, hcalConstant_, hps, p);
-  photo = new HFShowerPhotonCollection;
 
   //Radius (minimum and maximum)
   std::vector<double> rTable = hcalConstant_->getRTableHF();
@@ -132,11 +96,7 @@ HFShowerLibrary::HFShowerLibrary(const std::string& name,
   gpar = hcalConstant_->getGparHF();
 }
 
-HFShowerLibrary::~HFShowerLibrary() {
-  if (hf)
-    hf->Close();
-  delete photo;
-}
+HFShowerLibrary::~HFShowerLibrary() {}
 
 std::vector<HFShowerLibrary::Hit> HFShowerLibrary::getHits(const G4Step* aStep,
                                                            bool& isKilled,
@@ -343,92 +303,16 @@ bool HFShowerLibrary::rInside(double r) { return (r >= rMin && r <= rMax); }
 
 void HFShowerLibrary::getRecord(int type, int record) {
   int nrc = record - 1;
-  photon.clear();
-  photo->clear();
-  if (type > 0) {
-    if (newForm) {
-      if (!v3version) {
-        hadBranch->SetAddress(&photo);
-        hadBranch->GetEntry(nrc + totEvents);
-      } else {
-        std::vector<float> t;
-        std::vector<float>* tp = &t;
-        hadBranch->SetAddress(&tp);
-        hadBranch->GetEntry(nrc + totEvents);
-        unsigned int tSize = t.size() / 5;
-        photo->reserve(tSize);
-        for (unsigned int i = 0; i < tSize; i++) {
-          photo->push_back(
-              HFShowerPhoton(t[i], t[1 * tSize + i], t[2 * tSize + i], t[3 * tSize + i], t[4 * tSize + i]));
-        }
-      }
-    } else {
-      hadBranch->SetAddress(&photon);
-      hadBranch->GetEntry(nrc);
-    }
-  } else {
-    if (newForm) {
-      if (!v3version) {
-        emBranch->SetAddress(&photo);
-        emBranch->GetEntry(nrc);
-      } else {
-        std::vector<float> t;
-        std::vector<float>* tp = &t;
-        emBranch->SetAddress(&tp);
-        emBranch->GetEntry(nrc);
-        unsigned int tSize = t.size() / 5;
-        photo->reserve(tSize);
-        for (unsigned int i = 0; i < tSize; i++) {
-          photo->push_back(
-              HFShowerPhoton(t[i], t[1 * tSize + i], t[2 * tSize + i], t[3 * tSize + i], t[4 * tSize + i]));
-        }
-      }
-    } else {
-      emBranch->SetAddress(&photon);
-      emBranch->GetEntry(nrc);
-    }
-  }
+  int itype = (type > 0) ? 1 : 0;
+  photon = library_->photons(itype, nrc);
+  nPhoton = library_->nPhotons(itype, nrc);
 #ifdef EDM_ML_DEBUG
-  int nPhoton = (newForm) ? photo->size() : photon.size();
   edm::LogVerbatim("HFShower") << "HFShowerLibrary::getRecord: Record " << record << " of type " << type << " with "
                                << nPhoton << " photons";
-  for (int j = 0; j < nPhoton; j++)
-    if (newForm)
-      edm::LogVerbatim("HFShower") << "Photon " << j << " " << photo->at(j);
-    else
-      edm::LogVerbatim("HFShower") << "Photon " << j << " " << photon[j];
-#endif
-}
-
-void HFShowerLibrary::loadEventInfo(TBranch* branch) {
-  if (branch) {
-    std::vector<HFShowerLibraryEventInfo> eventInfoCollection;
-    branch->SetAddress(&eventInfoCollection);
-    branch->GetEntry(0);
-#ifdef EDM_ML_DEBUG
-    edm::LogVerbatim("HFShower") << "HFShowerLibrary::loadEventInfo loads EventInfo Collection of size "
-                                 << eventInfoCollection.size() << " records";
-#endif
-    totEvents = eventInfoCollection[0].totalEvents();
-    nMomBin = eventInfoCollection[0].numberOfBins();
-    evtPerBin = eventInfoCollection[0].eventsPerBin();
-    libVers = eventInfoCollection[0].showerLibraryVersion();
-    listVersion = eventInfoCollection[0].physListVersion();
-    pmom = eventInfoCollection[0].energyBins();
-  } else {
-#ifdef EDM_ML_DEBUG
-    edm::LogVerbatim("HFShower") << "HFShowerLibrary::loadEventInfo loads EventInfo from hardwired"
-                                 << " numbers";
+  for (unsigned int j = 0; j < nPhoton; j++)
+    edm::LogVerbatim("HFShower") << "Photon " << j << " "
+                                 << HFShowerPhoton(photon[j].x, photon[j].y, photon[j].z, photon[j].lambda, photon[j].t);
 #endif
-    nMomBin = 16;
-    evtPerBin = 5000;
-    totEvents = nMomBin * evtPerBin;
-    libVers = 1.1;
-    listVersion = 3.6;
-    pmom = {2, 3, 5, 7, 10, 15, 20, 30, 50, 75, 100, 150, 250, 350, 500, 1000};
-  }
-  for (int i = 0; i < nMomBin; i++)
-    pmom[i] *= GeV;
 }
 
 void HFShowerLibrary::interpolate(int type, double pin) {
@@ -484,9 +368,8 @@ void HFShowerLibrary::interpolate(int type, double pin) {
   for (int ir = 0; ir < 2; ir++) {
     if (irc[ir] > 0) {
       getRecord(type, irc[ir]);
-      int nPhoton = (newForm) ? photo->size() : photon.size();
       npold += nPhoton;
-      for (int j = 0; j < nPhoton; j++) {
+      for (unsigned int j = 0; j < nPhoton; j++) {
         r = G4UniformRand();
         if ((ir == 0 && r > w) || (ir > 0 && r < w)) {
           storePhoton(j);
@@ -542,9 +425,8 @@ void HFShowerLibrary::extrapolate(int type, double pin) {
   for (int ir = 0; ir < nrec; ir++) {
     if (irc[ir] > 0) {
       getRecord(type, irc[ir]);
-      int nPhoton = (newForm) ? photo->size() : photon.size();
       npold += nPhoton;
-      for (int j = 0; j < nPhoton; j++) {
+      for (unsigned int j = 0; j < nPhoton; j++) {
         double r = G4UniformRand();
         if (ir != nrec - 1 || r < w) {
           storePhoton(j);
@@ -574,10 +456,7 @@ void HFShowerLibrary::extrapolate(int type, double pin) {
 }
 
 void HFShowerLibrary::storePhoton(int j) {
-  if (newForm)
-    pe.push_back(photo->at(j));
-  else
-    pe.push_back(photon[j]);
+  pe.emplace_back(photon[j].x, photon[j].y, photon[j].z, photon[j].lambda, photon[j].t);
 #ifdef EDM_ML_DEBUG
   edm::LogVerbatim("HFShower") << "HFShowerLibrary: storePhoton " << j << " npe " << npe << " " << pe[npe];
 #endif
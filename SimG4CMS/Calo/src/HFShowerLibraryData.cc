@@ -0,0 +1,265 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: HFShowerLibraryData.cc
+// Description: Photon records of the HF shower library
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Calo/interface/HFShowerLibraryData.h"
+#include "SimDataFormats/CaloHit/interface/HFShowerLibraryEventInfo.h"
+#include "SimDataFormats/CaloHit/interface/HFShowerPhoton.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//#define EDM_ML_DEBUG
+
+namespace {
+  constexpr char kMagic[8] = {'H', 'F', 'S', 'L', 'I', 'B', '0', '1'};
+
+  struct Header {
+    char magic[8];
+    int32_t nMomBin, totEvents, evtPerBin;
+    float libVers, listVersion;
+    int32_t padding;
+  };
+  static_assert(sizeof(Header) == 32, "the arrays following the header must be aligned");
+  static_assert(sizeof(HFShowerLibraryData::Photon) == 5 * sizeof(float), "the photons must be packed");
+
+  bool isCompact(const std::string& fileName) {
+    char magic[sizeof(kMagic)] = {};
+    std::ifstream file(fileName, std::ios::binary);
+    file.read(magic, sizeof(magic));
+    return file and std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+  }
+
+  // appends the photons of an entry of the branch, in one of the formats of the library
+  void readEntry(TBranch* branch,
+                 Long64_t entry,
+                 bool newForm,
+                 bool v3version,
+                 std::vector<HFShowerLibraryData::Photon>& photons) {
+    if (v3version) {
+      // x, y, z, lambda and t of all the photons, one after the other
+      std::vector<float> t;
+      std::vector<float>* tp = &t;
+      branch->SetAddress(&tp);
+      branch->GetEntry(entry);
+      unsigned int tSize = t.size() / 5;
+      for (unsigned int i = 0; i < tSize; i++) {
+        photons.push_back({t[i], t[1 * tSize + i], t[2 * tSize + i], t[3 * tSize + i], t[4 * tSize + i]});
+      }
+    } else {
+      HFShowerPhotonCollection photon;
+      HFShowerPhotonCollection* photo = &photon;
+      if (newForm)
+        branch->SetAddress(&photo);
+      else
+        branch->SetAddress(&photon);
+      branch->GetEntry(entry);
+      for (auto const& p : photon) {
+        photons.push_back({p.x(), p.y(), p.z(), p.lambda(), p.t()});
+      }
+    }
+    branch->ResetAddress();
+  }
+}  // namespace
+
+std::shared_ptr<const HFShowerLibraryData> HFShowerLibraryData::get(const Source& source, bool verbose) {
+  static std::mutex mutex;
+  static std::map<std::string, std::weak_ptr<const HFShowerLibraryData>> libraries;
+
+  const std::string key =
+      source.fileName + '\n' + source.eventInfoBranch + '\n' + source.emBranch + '\n' + source.hadBranch;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto data = libraries[key].lock();
+  if (!data) {
+    data = std::make_shared<const HFShowerLibraryData>(source, verbose);
+    libraries[key] = data;
+  }
+  return data;
+}
+
+HFShowerLibraryData::HFShowerLibraryData(const Source& source, bool verbose)
+    : offsets_{nullptr, nullptr}, photons_{nullptr, nullptr}, mapped_(nullptr), mappedSize_(0) {
+  if (isCompact(source.fileName))
+    map(source.fileName);
+  else
+    readRoot(source, verbose);
+  // all the records are loaded up front, a mapped library only takes the pages of the records used
+  const uint64_t nPhotons = offsets_[0][totEvents_] + offsets_[1][totEvents_];
+  const double megaBytes = (sizeof(Photon) * nPhotons + 2 * sizeof(uint64_t) * (totEvents_ + 1)) / 1048576.;
+  edm::LogVerbatim("HFShower") << "HFShowerLibraryData: " << (isMapped() ? "mapped " : "read ") << source.fileName
+                               << " with " << totEvents_ << " records per type and " << nPhotons << " photons, "
+                               << megaBytes << " MB " << (isMapped() ? "shared with the page cache" : "in memory");
+}
+
+HFShowerLibraryData::~HFShowerLibraryData() {
+  if (mapped_)
+    ::munmap(mapped_, mappedSize_);
+}
+
+void HFShowerLibraryData::readRoot(const Source& source, bool verbose) {
+  std::unique_ptr<TFile> hf(TFile::Open(source.fileName.c_str()));
+  if (!hf || !hf->IsOpen()) {
+    edm::LogError("HFShower") << "HFShowerLibrary: opening " << source.fileName << " failed";
+    throw cms::Exception("Unknown", "HFShowerLibrary") << "Opening of " << source.fileName << " fails\n";
+  } else {
+    edm::LogVerbatim("HFShower") << "HFShowerLibrary: opening " << source.fileName << " successfully";
+  }
+
+  const bool newForm = source.eventInfoBranch.empty();
+  TTree* event = (TTree*)hf->Get(newForm ? "HFSimHits" : "Events");
+  if (!event) {
+    edm::LogError("HFShower") << "HFShowerLibrary: Events Tree does not "
+                              << "exist";
+    throw cms::Exception("Unknown", "HFShowerLibrary") << "Events tree absent\n";
+  }
+
+  if (newForm) {
+#ifdef EDM_ML_DEBUG
+    edm::LogVerbatim("HFShower") << "HFShowerLibrary::loadEventInfo loads EventInfo from hardwired"
+                                 << " numbers";
+#endif
+    nMomBin_ = 16;
+    evtPerBin_ = 5000;
+    totEvents_ = nMomBin_ * evtPerBin_;
+    libVers_ = 1.1;
+    listVersion_ = 3.6;
+    pmom_ = {2, 3, 5, 7, 10, 15, 20, 30, 50, 75, 100, 150, 250, 350, 500, 1000};
+  } else {
+    TBranch* evtInfo = event->GetBranch(source.eventInfoBranch.c_str());
+    if (!evtInfo) {
+      edm::LogError("HFShower") << "HFShowerLibrary: HFShowerLibrayEventInfo"
+                                << " Branch does not exist in Event";
+      throw cms::Exception("Unknown", "HFShowerLibrary") << "Event information absent\n";
+    }
+    std::vector<HFShowerLibraryEventInfo> eventInfoCollection;
+    evtInfo->SetAddress(&eventInfoCollection);
+    evtInfo->GetEntry(0);
+#ifdef EDM_ML_DEBUG
+    edm::LogVerbatim("HFShower") << "HFShowerLibrary::loadEventInfo loads EventInfo Collection of size "
+                                 << eventInfoCollection.size() << " records";
+#endif
+    totEvents_ = eventInfoCollection[0].totalEvents();
+    nMomBin_ = eventInfoCollection[0].numberOfBins();
+    evtPerBin_ = eventInfoCollection[0].eventsPerBin();
+    libVers_ = eventInfoCollection[0].showerLibraryVersion();
+    listVersion_ = eventInfoCollection[0].physListVersion();
+    pmom_ = eventInfoCollection[0].energyBins();
+    evtInfo->ResetAddress();
+  }
+
+  TBranch* branches[2] = {event->GetBranch(source.emBranch.c_str()), event->GetBranch(source.hadBranch.c_str())};
+  for (int type = 0; type < 2; ++type) {
+    if (!branches[type]) {
+      edm::LogError("HFShower") << "HFShowerLibrary: Branch " << (type == 0 ? source.emBranch : source.hadBranch)
+                                << " does not exist in Event";
+      throw cms::Exception("Unknown", "HFShowerLibrary") << "Shower branch absent\n";
+    }
+    if (verbose)
+      branches[type]->Print();
+  }
+  const bool v3version = (branches[0]->GetClassName() == std::string("vector<float>"));
+
+  // in the HFSimHits tree, the hadronic showers follow the e/gamma ones in the same entries
+  for (int type = 0; type < 2; ++type) {
+    const Long64_t first = (type > 0 && newForm) ? totEvents_ : 0;
+    ownedOffsets_[type].reserve(totEvents_ + 1);
+    ownedOffsets_[type].push_back(0);
+    for (int nrc = 0; nrc < totEvents_; ++nrc) {
+      readEntry(branches[type], first + nrc, newForm, v3version, ownedPhotons_[type]);
+      ownedOffsets_[type].push_back(ownedPhotons_[type].size());
+    }
+    ownedPhotons_[type].shrink_to_fit();
+    offsets_[type] = ownedOffsets_[type].data();
+    photons_[type] = ownedPhotons_[type].data();
+  }
+  hf->Close();
+}
+
+void HFShowerLibraryData::map(const std::string& fileName) {
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  struct stat info;
+  if (fd < 0 || ::fstat(fd, &info) != 0) {
+    if (fd >= 0)
+      ::close(fd);
+    throw cms::Exception("Unknown", "HFShowerLibrary") << "Opening of " << fileName << " fails\n";
+  }
+  mappedSize_ = info.st_size;
+  void* address = ::mmap(nullptr, mappedSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (address == MAP_FAILED) {
+    throw cms::Exception("Unknown", "HFShowerLibrary") << "Mapping of " << fileName << " fails\n";
+  }
+  mapped_ = address;
+
+  // check the sizes of the arrays against the size of the file before using them
+  const char* begin = static_cast<const char*>(mapped_);
+  auto corrupted = [&fileName]() {
+    return cms::Exception("Unknown", "HFShowerLibrary") << "The compact shower library " << fileName
+                                                        << " is truncated or corrupted\n";
+  };
+  if (mappedSize_ < sizeof(Header))
+    throw corrupted();
+  Header header;
+  std::memcpy(&header, begin, sizeof(Header));
+  if (header.nMomBin <= 0 || header.totEvents <= 0)
+    throw corrupted();
+  nMomBin_ = header.nMomBin;
+  totEvents_ = header.totEvents;
+  evtPerBin_ = header.evtPerBin;
+  libVers_ = header.libVers;
+  listVersion_ = header.listVersion;
+
+  size_t size = sizeof(Header) + sizeof(double) * nMomBin_ + 2 * sizeof(uint64_t) * (totEvents_ + 1);
+  if (mappedSize_ < size)
+    throw corrupted();
+  const double* pmom = reinterpret_cast<const double*>(begin + sizeof(Header));
+  pmom_.assign(pmom, pmom + nMomBin_);
+  offsets_[0] = reinterpret_cast<const uint64_t*>(pmom + nMomBin_);
+  offsets_[1] = offsets_[0] + totEvents_ + 1;
+  for (int type = 0; type < 2; ++type) {
+    photons_[type] = reinterpret_cast<const Photon*>(begin + size);
+    if (offsets_[type][0] != 0 || offsets_[type][totEvents_] > (mappedSize_ - size) / sizeof(Photon))
+      throw corrupted();
+    for (int nrc = 0; nrc < totEvents_; ++nrc) {
+      if (offsets_[type][nrc + 1] < offsets_[type][nrc])
+        throw corrupted();
+    }
+    size += sizeof(Photon) * offsets_[type][totEvents_];
+  }
+}
+
+void HFShowerLibraryData::write(const std::string& fileName) const {
+  std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.nMomBin = nMomBin_;
+  header.totEvents = totEvents_;
+  header.evtPerBin = evtPerBin_;
+  header.libVers = libVers_;
+  header.listVersion = listVersion_;
+  header.padding = 0;
+  file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+  file.write(reinterpret_cast<const char*>(pmom_.data()), sizeof(double) * nMomBin_);
+  for (int type = 0; type < 2; ++type)
+    file.write(reinterpret_cast<const char*>(offsets_[type]), sizeof(uint64_t) * (totEvents_ + 1));
+  for (int type = 0; type < 2; ++type)
+    file.write(reinterpret_cast<const char*>(photons_[type]), sizeof(Photon) * offsets_[type][totEvents_]);
+  file.close();
+  if (!file) {
+    throw cms::Exception("Unknown", "HFShowerLibrary") << "Writing of " << fileName << " fails\n";
+  }
+}
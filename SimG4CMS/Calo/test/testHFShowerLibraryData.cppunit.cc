@@ -0,0 +1,148 @@
+/* Unit test of HFShowerLibraryData: a library read from its ROOT file, then written in the compact
+   format and mapped back, must give the photons of every record, for the libraries with the photons
+   stored as vector<float> (v3) and as HFShowerPhotonCollection.
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "SimG4CMS/Calo/interface/HFShowerLibraryData.h"
+#include "SimDataFormats/CaloHit/interface/HFShowerPhoton.h"
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+class testHFShowerLibraryData : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testHFShowerLibraryData);
+  CPPUNIT_TEST(testVectorOfFloats);
+  CPPUNIT_TEST(testPhotonCollection);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() {}
+  void tearDown() {}
+
+  void testVectorOfFloats() { checkRoundTrip(true); }
+  void testPhotonCollection() { checkRoundTrip(false); }
+
+private:
+  void checkRoundTrip(bool v3version);
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testHFShowerLibraryData);
+
+namespace {
+  // the libraries with the HFSimHits tree have 16 bins of 5000 records of each type
+  constexpr int totEvents = 16 * 5000;
+
+  // 0 to 3 photons per record, with values that tell the type, the record and the photon apart
+  unsigned int nPhotons(int type, int record) { return (7 * record + type) % 4; }
+
+  HFShowerLibraryData::Photon photon(int type, int record, unsigned int k) {
+    const float base = record + 0.25f * k;
+    return {type ? -base : base, 0.5f * base, 100.f + base, 400.f + k, 1.f + 0.125f * type};
+  }
+
+  // the e/gamma records are the first totEvents entries of emParticles, the hadronic ones the
+  // last totEvents entries of hadParticles, as read by HFShowerLibraryData
+  void writeRootLibrary(const std::string& fileName, bool v3version) {
+    TFile file(fileName.c_str(), "RECREATE");
+    TTree tree("HFSimHits", "HF shower library");
+    std::vector<float> floats[2];
+    std::vector<float>* floatsPtr[2] = {&floats[0], &floats[1]};
+    HFShowerPhotonCollection collections[2];
+    HFShowerPhotonCollection* collectionsPtr[2] = {&collections[0], &collections[1]};
+    const char* names[2] = {"emParticles", "hadParticles"};
+    for (int type = 0; type < 2; ++type) {
+      if (v3version)
+        tree.Branch(names[type], &floatsPtr[type]);
+      else
+        tree.Branch(names[type], &collectionsPtr[type]);
+    }
+    for (int entry = 0; entry < 2 * totEvents; ++entry) {
+      for (int type = 0; type < 2; ++type) {
+        floats[type].clear();
+        collections[type].clear();
+        const int record = entry - type * totEvents;
+        if (record < 0 || record >= totEvents)
+          continue;
+        const unsigned int n = nPhotons(type, record);
+        floats[type].resize(5 * n);
+        for (unsigned int k = 0; k < n; ++k) {
+          const auto p = photon(type, record, k);
+          floats[type][k] = p.x;
+          floats[type][n + k] = p.y;
+          floats[type][2 * n + k] = p.z;
+          floats[type][3 * n + k] = p.lambda;
+          floats[type][4 * n + k] = p.t;
+          collections[type].emplace_back(p.x, p.y, p.z, p.lambda, p.t);
+        }
+      }
+      tree.Fill();
+    }
+    tree.Write();
+    file.Close();
+  }
+
+  void checkLibrary(const HFShowerLibraryData& library) {
+    CPPUNIT_ASSERT_EQUAL(16, library.nMomBin());
+    CPPUNIT_ASSERT_EQUAL(totEvents, library.totEvents());
+    CPPUNIT_ASSERT_EQUAL(5000, library.evtPerBin());
+    CPPUNIT_ASSERT_EQUAL(1.1f, library.libVers());
+    CPPUNIT_ASSERT_EQUAL(3.6f, library.listVersion());
+    const std::vector<double> pmom = {2, 3, 5, 7, 10, 15, 20, 30, 50, 75, 100, 150, 250, 350, 500, 1000};
+    CPPUNIT_ASSERT(library.pmom() == pmom);
+    for (int type = 0; type < 2; ++type) {
+      for (int record = 0; record < totEvents; ++record) {
+        const unsigned int n = nPhotons(type, record);
+        CPPUNIT_ASSERT_EQUAL(n, library.nPhotons(type, record));
+        const HFShowerLibraryData::Photon* photons = library.photons(type, record);
+        for (unsigned int k = 0; k < n; ++k) {
+          const auto p = photon(type, record, k);
+          CPPUNIT_ASSERT_EQUAL(p.x, photons[k].x);
+          CPPUNIT_ASSERT_EQUAL(p.y, photons[k].y);
+          CPPUNIT_ASSERT_EQUAL(p.z, photons[k].z);
+          CPPUNIT_ASSERT_EQUAL(p.lambda, photons[k].lambda);
+          CPPUNIT_ASSERT_EQUAL(p.t, photons[k].t);
+        }
+      }
+    }
+  }
+}  // namespace
+
+void testHFShowerLibraryData::checkRoundTrip(bool v3version) {
+  const std::string name = v3version ? "testHFShowerLibraryData_v3" : "testHFShowerLibraryData_photons";
+  HFShowerLibraryData::Source source;
+  source.fileName = name + ".root";
+  source.emBranch = "emParticles";
+  source.hadBranch = "hadParticles";
+  writeRootLibrary(source.fileName, v3version);
+
+  {
+    HFShowerLibraryData library(source);
+    CPPUNIT_ASSERT(!library.isMapped());
+    checkLibrary(library);
+    library.write(name + ".bin");
+  }
+  // the compact file is recognized whatever the branches
+  HFShowerLibraryData::Source compact;
+  compact.fileName = name + ".bin";
+  {
+    HFShowerLibraryData library(compact);
+    CPPUNIT_ASSERT(library.isMapped());
+    checkLibrary(library);
+  }
+  // and shared between the users of the same library
+  {
+    auto first = HFShowerLibraryData::get(compact);
+    auto second = HFShowerLibraryData::get(compact);
+    CPPUNIT_ASSERT(first == second);
+  }
+
+  std::remove(source.fileName.c_str());
+  std::remove(compact.fileName.c_str());
+}
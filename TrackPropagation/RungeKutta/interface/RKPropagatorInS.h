@@ -30,6 +30,13 @@ public:
   using Propagator::propagate;
   using Propagator::propagateWithPath;
 
+  /// Propagates fts[i] to *planes[i], for i < n: the tracks are integrated in lock-step,
+  /// with the same result as n calls to propagateWithPath(fts[i], *planes[i]).
+  void propagateWithPath(const FreeTrajectoryState* fts,
+                         const Plane* const* planes,
+                         std::pair<TrajectoryStateOnSurface, double>* result,
+                         int n) const;
+
 private:
   std::pair<TrajectoryStateOnSurface, double> propagateWithPath(const FreeTrajectoryState&,
                                                                 const Plane&) const override;
@@ -68,6 +75,10 @@ private:
 
   GlobalParametersWithPath propagateParametersOnPlane(const FreeTrajectoryState& ts,
                                                       const Plane& plane) const dso_internal;
+  void propagateParametersOnPlanes(const FreeTrajectoryState* ts,
+                                   const Plane* const* planes,
+                                   GlobalParametersWithPath* result,
+                                   int n) const dso_internal;
   GlobalParametersWithPath propagateParametersOnCylinder(const FreeTrajectoryState& ts,
                                                          const Cylinder& cyl) const dso_internal;
 };
@@ -4,6 +4,8 @@
 #include "TrackPropagation/RungeKutta/interface/RKPropagatorInS.h"
 #include "MagneticField/VolumeGeometry/interface/MagneticFieldProvider.h"
 
+#include <algorithm>
+
 namespace defaultRKPropagator {
 
   using RKPropagator = RKPropagatorInS;
@@ -20,6 +22,20 @@ namespace defaultRKPropagator {
       return LocalVectorType(theField->inTesla(gp).basicVector());
     }
 
+    void valuesInTesla(const LocalPointType* lp, LocalVectorType* values, int n) const override {
+      constexpr int chunk = 64;
+      GlobalPoint gp[chunk];
+      GlobalVector gv[chunk];
+      for (int first = 0; first < n; first += chunk) {
+        int m = std::min(chunk, n - first);
+        for (int i = 0; i < m; ++i)
+          gp[i] = GlobalPoint(lp[first + i].basicVector());
+        theField->inTeslaBatch(gp, gv, m);
+        for (int i = 0; i < m; ++i)
+          values[first + i] = LocalVectorType(gv[i].basicVector());
+      }
+    }
+
   private:
     const MagneticField* theField;
   };
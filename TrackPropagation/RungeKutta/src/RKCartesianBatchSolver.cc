@@ -0,0 +1,211 @@
+#include "RKCartesianBatchSolver.h"
+#include "RKAdaptiveSolver.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+void RKCartesianBatchSolver::operator()(Vector* state, const float* charge, const Scalar* step, int n, float eps) {
+  using namespace RKDetails;
+  constexpr float Safety = 0.9;
+
+  theCapacity = n;
+  for (auto* v : {&theStart, &theArg, &theResult, &theResult4})
+    v->resize(6 * n);
+  for (auto& k : theK)
+    k.resize(6 * n);
+  theStep.resize(n);
+  theCharge.resize(n);
+  theError.resize(n);
+  thePoints.resize(n);
+  theBField.resize(n);
+
+  // the step control of RKAdaptiveSolver, for each track
+  std::vector<double> remainingStep(step, step + n);
+  std::vector<double> stepSize(step, step + n);
+  std::vector<Vector> current(state, state + n);
+  std::vector<int> active(n);
+  std::iota(active.begin(), active.end(), 0);
+
+  while (!active.empty()) {
+    const int m = active.size();
+    for (int l = 0; l < m; ++l) {
+      const int i = active[l];
+      for (int c = 0; c < 6; ++c)
+        component(theStart, c)[l] = current[i][c];
+      theStep[l] = stepSize[i];
+      theCharge[l] = charge[i];
+    }
+
+    cashKarpStep(m);
+
+    int kept = 0;
+    for (int l = 0; l < m; ++l) {
+      const int i = active[l];
+      Vector tryStep;
+      for (int c = 0; c < 6; ++c)
+        tryStep[c] = component(theResult, c)[l];
+      float acc = theError[l];
+      double& remaining = remainingStep[i];
+      double& size = stepSize[i];
+
+      bool finished = false;
+      if (acc < eps || std::abs(size) < std::abs(remaining) * 0.1f) {
+        if (std::abs(remaining - size) < 0.5f * eps) {
+          finished = true;  // we are there
+        } else {
+          remaining -= size;
+          // increase step size
+          const float cut = std::pow(4.f / Safety, 5.f);
+          float factor = (eps < cut * acc) ? Safety * fastPow(eps / acc, 0.2) : 4.f;
+          double absRemainingStep = std::abs(remaining);
+          double absSize = std::min(std::abs(size * factor), absRemainingStep);
+          if (absSize < 0.05f * absRemainingStep)
+            absSize = 0.05f * absRemainingStep;
+          size = std::copysign(absSize, size);
+          current[i] = tryStep;
+        }
+      } else {
+        // decrease step size
+        constexpr float cut = Safety * Safety * Safety * Safety * 100 * 100;
+        float factor = (cut * eps > acc) ? Safety * fastPow(eps / acc, 0.25) : 0.1f;
+        size *= factor;
+        if (std::abs(size) < 0.05f * std::abs(remaining))
+          size = 0.05f * remaining;
+      }
+      if (finished || std::abs(remaining) <= eps * 0.5f)
+        state[i] = tryStep;
+      else
+        active[kept++] = i;
+    }
+    active.resize(kept);
+  }
+}
+
+void RKCartesianBatchSolver::cashKarpStep(int m) {
+  // same coefficients and order of the operations as in RKOneCashKarpStep
+  const Scalar b21 = 0.2;
+  const Scalar b31 = 3. / 40., b32 = 9. / 40.;
+  const Scalar b41 = 0.3, b42 = -0.9, b43 = 1.2;
+  const Scalar b51 = -11. / 54., b52 = 5. / 2., b53 = -70. / 27., b54 = 35. / 27.;
+  const Scalar b61 = 1631. / 55296., b62 = 175. / 512., b63 = 575. / 13824., b64 = 44275. / 110592., b65 = 253. / 4096.;
+  const Scalar c1 = 37. / 378., c3 = 250. / 621., c4 = 125. / 594., c6 = 512. / 1771.;
+  const Scalar d1 = 2825. / 27648., d3 = 18575. / 48384., d4 = 13525. / 55296., d5 = 277. / 14336., d6 = 0.25;
+
+  derivative(theStart.data(), theK[0].data(), m);
+
+  for (int c = 0; c < 6; ++c) {
+    const Scalar* v = component(theStart, c);
+    const Scalar* k1 = component(theK[0], c);
+    Scalar* arg = component(theArg, c);
+    for (int l = 0; l < m; ++l)
+      arg[l] = v[l] + b21 * k1[l];
+  }
+  derivative(theArg.data(), theK[1].data(), m);
+
+  for (int c = 0; c < 6; ++c) {
+    const Scalar* v = component(theStart, c);
+    const Scalar* k1 = component(theK[0], c);
+    const Scalar* k2 = component(theK[1], c);
+    Scalar* arg = component(theArg, c);
+    for (int l = 0; l < m; ++l)
+      arg[l] = v[l] + b31 * k1[l] + b32 * k2[l];
+  }
+  derivative(theArg.data(), theK[2].data(), m);
+
+  for (int c = 0; c < 6; ++c) {
+    const Scalar* v = component(theStart, c);
+    const Scalar* k1 = component(theK[0], c);
+    const Scalar* k2 = component(theK[1], c);
+    const Scalar* k3 = component(theK[2], c);
+    Scalar* arg = component(theArg, c);
+    for (int l = 0; l < m; ++l)
+      arg[l] = v[l] + b41 * k1[l] + b42 * k2[l] + b43 * k3[l];
+  }
+  derivative(theArg.data(), theK[3].data(), m);
+
+  for (int c = 0; c < 6; ++c) {
+    const Scalar* v = component(theStart, c);
+    const Scalar* k1 = component(theK[0], c);
+    const Scalar* k2 = component(theK[1], c);
+    const Scalar* k3 = component(theK[2], c);
+    const Scalar* k4 = component(theK[3], c);
+    Scalar* arg = component(theArg, c);
+    for (int l = 0; l < m; ++l)
+      arg[l] = v[l] + b51 * k1[l] + b52 * k2[l] + b53 * k3[l] + b54 * k4[l];
+  }
+  derivative(theArg.data(), theK[4].data(), m);
+
+  for (int c = 0; c < 6; ++c) {
+    const Scalar* v = component(theStart, c);
+    const Scalar* k1 = component(theK[0], c);
+    const Scalar* k2 = component(theK[1], c);
+    const Scalar* k3 = component(theK[2], c);
+    const Scalar* k4 = component(theK[3], c);
+    const Scalar* k5 = component(theK[4], c);
+    Scalar* arg = component(theArg, c);
+    for (int l = 0; l < m; ++l)
+      arg[l] = v[l] + b61 * k1[l] + b62 * k2[l] + b63 * k3[l] + b64 * k4[l] + b65 * k5[l];
+  }
+  derivative(theArg.data(), theK[5].data(), m);
+
+  for (int c = 0; c < 6; ++c) {
+    const Scalar* v = component(theStart, c);
+    const Scalar* k1 = component(theK[0], c);
+    const Scalar* k3 = component(theK[2], c);
+    const Scalar* k4 = component(theK[3], c);
+    const Scalar* k5 = component(theK[4], c);
+    const Scalar* k6 = component(theK[5], c);
+    Scalar* r5 = component(theResult, c);
+    Scalar* r4 = component(theResult4, c);
+    for (int l = 0; l < m; ++l) {
+      r5[l] = v[l] + c1 * k1[l] + c3 * k3[l] + c4 * k4[l] + c6 * k6[l];
+      r4[l] = v[l] + d1 * k1[l] + d3 * k3[l] + d4 * k4[l] + d5 * k5[l] + d6 * k6[l];
+    }
+  }
+
+  // RKCartesianDistance between the 4th and 5th order results, in single precision
+  const Scalar* a[6];
+  const Scalar* b[6];
+  for (int c = 0; c < 6; ++c) {
+    a[c] = component(theResult4, c);
+    b[c] = component(theResult, c);
+  }
+  for (int l = 0; l < m; ++l) {
+    float dx = float(a[0][l]) - float(b[0][l]), dy = float(a[1][l]) - float(b[1][l]),
+          dz = float(a[2][l]) - float(b[2][l]);
+    float dpx = float(a[3][l]) - float(b[3][l]), dpy = float(a[4][l]) - float(b[4][l]),
+          dpz = float(a[5][l]) - float(b[5][l]);
+    float px = b[3][l], py = b[4][l], pz = b[5][l];
+    theError[l] = std::sqrt(dx * dx + dy * dy + dz * dz) +
+                  std::sqrt(dpx * dpx + dpy * dpy + dpz * dpz) / std::sqrt(px * px + py * py + pz * pz);
+  }
+}
+
+void RKCartesianBatchSolver::derivative(const Scalar* x, Scalar* k, int m) {
+  const Scalar* pos[3] = {x, x + theCapacity, x + 2 * theCapacity};
+  const Scalar* mom[3] = {x + 3 * theCapacity, x + 4 * theCapacity, x + 5 * theCapacity};
+  for (int l = 0; l < m; ++l)
+    thePoints[l] = RKLocalFieldProvider::LocalPoint(float(pos[0][l]), float(pos[1][l]), float(pos[2][l]));
+  theField.inTesla(thePoints.data(), theBField.data(), m);
+
+  // as in CartesianLorentzForce
+  constexpr float kc = 2.99792458e-3;  // conversion to [cm]
+  for (int l = 0; l < m; ++l) {
+    float px = mom[0][l], py = mom[1][l], pz = mom[2][l];
+    float mag2 = px * px + py * py + pz * pz;
+    float norm = (0 != mag2) ? 1.f / std::sqrt(mag2) : 1.f;
+    // d(pos)/ds is the normalized momentum
+    float ux = px * norm, uy = py * norm, uz = pz * norm;
+    // Lorentz force in absence of electric field
+    float bx = theBField[l].x(), by = theBField[l].y(), bz = theBField[l].z();
+    float q = kc * theCharge[l];
+    Scalar h = theStep[l];
+    k[l] = h * ux;
+    k[theCapacity + l] = h * uy;
+    k[2 * theCapacity + l] = h * uz;
+    k[3 * theCapacity + l] = h * (q * (uy * bz - uz * by));
+    k[4 * theCapacity + l] = h * (q * (uz * bx - ux * bz));
+    k[5 * theCapacity + l] = h * (q * (ux * by - uy * bx));
+  }
+}
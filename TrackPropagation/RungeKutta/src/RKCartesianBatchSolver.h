@@ -0,0 +1,48 @@
+#ifndef RKCartesianBatchSolver_H
+#define RKCartesianBatchSolver_H
+
+#include "FWCore/Utilities/interface/Visibility.h"
+#include "RKSmallVector.h"
+#include "RKLocalFieldProvider.h"
+
+#include <vector>
+
+/** Adaptive Runge-Kutta integration of the cartesian Lorentz force equations
+ *  for many tracks in lock-step, each with its own charge and path length.
+ *  Each track takes the same steps as with RKAdaptiveSolver, RKOneCashKarpStep,
+ *  CartesianLorentzForce and RKCartesianDistance; the states of the tracks still
+ *  being integrated are kept as structure of arrays, so that every stage is a
+ *  vectorized loop over the tracks, with a single batched query of the field.
+ */
+
+class dso_internal RKCartesianBatchSolver {
+public:
+  typedef double Scalar;
+  typedef RKSmallVector<double, 6> Vector;
+
+  explicit RKCartesianBatchSolver(const RKLocalFieldProvider& field) : theField(field) {}
+
+  /// Integrates state[i] over the path length step[i], for i < n
+  void operator()(Vector* state, const float* charge, const Scalar* step, int n, float eps);
+
+private:
+  /// One Cash-Karp step of the m tracks in theStart; sets theResult and theError.
+  void cashKarpStep(int m);
+
+  /// k = step * Lorentz force at the states in x, for the m tracks
+  void derivative(const Scalar* x, Scalar* k, int m);
+
+  // component c of track i of a state is at [c * theCapacity + i]
+  Scalar* component(std::vector<Scalar>& v, int c) { return v.data() + c * theCapacity; }
+
+  const RKLocalFieldProvider& theField;
+
+  int theCapacity = 0;
+  std::vector<Scalar> theStart, theArg, theK[6], theResult, theResult4;
+  std::vector<Scalar> theStep;
+  std::vector<float> theCharge, theError;
+  std::vector<RKLocalFieldProvider::LocalPoint> thePoints;
+  std::vector<RKLocalFieldProvider::Vector> theBField;
+};
+
+#endif
@@ -3,6 +3,8 @@
 #include "MagneticField/VolumeGeometry/interface/MagVolume.h"
 #include "FWCore/Utilities/interface/Likely.h"
 
+#include <algorithm>
+
 RKLocalFieldProvider::RKLocalFieldProvider(const MagVolume& vol) : theVolume(vol), theFrame(vol), transform_(false) {}
 
 RKLocalFieldProvider::RKLocalFieldProvider(const MagVolume& vol, const Frame& frame)
@@ -16,3 +18,20 @@ RKLocalFieldProvider::Vector RKLocalFieldProvider::inTesla(const LocalPoint& lp)
     }
   return theVolume.fieldInTesla(lp).basicVector();
 }
+
+void RKLocalFieldProvider::inTesla(const LocalPoint* lp, Vector* result, int n) const {
+  if
+    UNLIKELY(transform_) {
+      for (int i = 0; i < n; ++i)
+        result[i] = inTesla(lp[i]);
+      return;
+    }
+  constexpr int chunk = 64;
+  LocalVector field[chunk];
+  for (int first = 0; first < n; first += chunk) {
+    int m = std::min(chunk, n - first);
+    theVolume.fieldInTesla(lp + first, field, m);
+    for (int i = 0; i < m; ++i)
+      result[first + i] = field[i].basicVector();
+  }
+}
@@ -30,6 +30,9 @@ public:
 
   Vector inTesla(const Vector& v) const { return inTesla(LocalPoint(v)); }
 
+  /// the field at n points, evaluated in a single batch by the field provider
+  void inTesla(const LocalPoint* lp, Vector* result, int n) const;
+
   /// The reference frame in which the field is defined
   const Frame& frame() const { return theFrame; }
 
@@ -7,6 +7,7 @@
 #include "RKAdaptiveSolver.h"
 #include "RKOne4OrderStep.h"
 #include "RKOneCashKarpStep.h"
+#include "RKCartesianBatchSolver.h"
 #include "PathToPlane2Order.h"
 #include "CartesianStateAdaptor.h"
 #include "TrackingTools/GeomPropagators/interface/StraightLineCylinderCrossing.h"
@@ -22,6 +23,8 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/Utilities/interface/Likely.h"
 
+#include <vector>
+
 std::pair<TrajectoryStateOnSurface, double> RKPropagatorInS::propagateWithPath(const FreeTrajectoryState& fts,
                                                                                const Plane& plane) const {
   GlobalParametersWithPath gp = propagateParametersOnPlane(fts, plane);
@@ -48,6 +51,26 @@ std::pair<TrajectoryStateOnSurface, double> RKPropagatorInS::propagateWithPath(c
   return analyticalErrorPropagation(fts, cyl, side, gp.parameters(), gp.s());
 }
 
+void RKPropagatorInS::propagateWithPath(const FreeTrajectoryState* fts,
+                                        const Plane* const* planes,
+                                        std::pair<TrajectoryStateOnSurface, double>* result,
+                                        int n) const {
+  std::vector<GlobalParametersWithPath> gp(n);
+  propagateParametersOnPlanes(fts, planes, gp.data(), n);
+  for (int i = 0; i < n; ++i) {
+    if
+      UNLIKELY(!gp[i]) {
+        result[i] = TsosWP(TrajectoryStateOnSurface(), 0.);
+        continue;
+      }
+    SurfaceSideDefinition::SurfaceSide side =
+        PropagationDirectionFromPath()(gp[i].s(), propagationDirection()) == alongMomentum
+            ? SurfaceSideDefinition::beforeSurface
+            : SurfaceSideDefinition::afterSurface;
+    result[i] = analyticalErrorPropagation(fts[i], *planes[i], side, gp[i].parameters(), gp[i].s());
+  }
+}
+
 GlobalParametersWithPath RKPropagatorInS::propagateParametersOnPlane(const FreeTrajectoryState& ts,
                                                                      const Plane& plane) const {
   GlobalPoint gpos(ts.position());
@@ -188,6 +211,102 @@ GlobalParametersWithPath RKPropagatorInS::propagateParametersOnPlane(const FreeT
   return GlobalParametersWithPath();
 }
 
+void RKPropagatorInS::propagateParametersOnPlanes(const FreeTrajectoryState* ts,
+                                                  const Plane* const* planes,
+                                                  GlobalParametersWithPath* result,
+                                                  int n) const {
+  typedef RKCartesianBatchSolver::Vector RKVector;
+
+  // the iterations of propagateParametersOnPlane, with the solver called once for all the tracks
+  struct Track {
+    RKVector start;
+    double startZ;
+    double stot;
+    PropagationDirection currentDirection;
+  };
+  std::vector<Track> tracks(n);
+  std::vector<int> active;
+  for (int i = 0; i < n; ++i) {
+    // straight lines are not integrated
+    if
+      UNLIKELY(fabs(ts[i].transverseCurvature()) < 1.e-10 || theVolume == nullptr) {
+        result[i] = propagateParametersOnPlane(ts[i], *planes[i]);
+        continue;
+      }
+    GlobalPoint gpos(ts[i].position());
+    tracks[i].start = CartesianStateAdaptor::rkstate(rkPosition(gpos), rkMomentum(ts[i].momentum()));
+    tracks[i].startZ = planes[i]->localZ(gpos);
+    tracks[i].stot = 0;
+    tracks[i].currentDirection = propagationDirection();
+    active.push_back(i);
+  }
+  if (active.empty())
+    return;
+
+  RKLocalFieldProvider field(fieldProvider());
+  PathToPlane2Order pathLength(field, &field.frame());
+  RKCartesianBatchSolver solver(field);
+  double eps = theTolerance;
+
+  std::vector<int> solving;
+  std::vector<RKVector> state;
+  std::vector<float> charge;
+  std::vector<double> step;
+  int safeGuard = 0;
+  while (!active.empty() && safeGuard++ < 100) {
+    solving.clear();
+    state.clear();
+    charge.clear();
+    step.clear();
+    for (int i : active) {
+      Track& track = tracks[i];
+      CartesianStateAdaptor startState(track.start);
+      std::pair<bool, double> path = pathLength(
+          *planes[i], startState.position(), startState.momentum(), (double)ts[i].charge(), track.currentDirection);
+      if
+        UNLIKELY(!path.first) {
+          LogDebug("RKPropagatorInS") << "RKPropagatorInS: Path length calculation to plane failed!";
+          result[i] = GlobalParametersWithPath();
+          continue;
+        }
+      if
+        UNLIKELY(std::abs(path.second) < eps) {
+          result[i] = GlobalParametersWithPath(gtpFromVolumeLocal(startState, ts[i].charge()), track.stot);
+          continue;
+        }
+      solving.push_back(i);
+      state.push_back(track.start);
+      charge.push_back(ts[i].charge());
+      step.push_back(path.second);
+    }
+
+    solver(state.data(), charge.data(), step.data(), state.size(), eps);
+
+    active.clear();
+    for (unsigned int j = 0; j < solving.size(); ++j) {
+      int i = solving[j];
+      Track& track = tracks[i];
+      track.stot += step[j];
+      CartesianStateAdaptor cur(state[j]);
+      double remainingZ = planes[i]->localZ(globalPosition(cur.position()));
+      if (fabs(remainingZ) < eps) {
+        result[i] = GlobalParametersWithPath(gtpFromVolumeLocal(cur, ts[i].charge()), track.stot);
+        continue;
+      }
+      track.start = state[j];
+      if (remainingZ * track.startZ <= 0)
+        track.currentDirection = invertDirection(track.currentDirection);
+      track.startZ = remainingZ;
+      active.push_back(i);
+    }
+  }
+
+  for (int i : active) {
+    edm::LogError("FailedPropagation") << " too many iterations trying to reach plane ";
+    result[i] = GlobalParametersWithPath();
+  }
+}
+
 GlobalParametersWithPath RKPropagatorInS::propagateParametersOnCylinder(const FreeTrajectoryState& ts,
                                                                         const Cylinder& cyl) const {
   typedef RKAdaptiveSolver<double, RKOneCashKarpStep, 6> Solver;
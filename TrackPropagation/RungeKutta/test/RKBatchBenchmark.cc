@@ -0,0 +1,128 @@
+// Compares the batched propagation of RKPropagatorInS with the propagation of one
+// track at a time, on the tracks of the events read: each track is propagated from
+// its reference point to planes perpendicular to its initial direction.
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "DataFormats/TrackReco/interface/TrackFwd.h"
+#include "DataFormats/GeometrySurface/interface/Plane.h"
+#include "MagneticField/Engine/interface/MagneticField.h"
+#include "MagneticField/Records/interface/IdealMagneticFieldRecord.h"
+#include "TrackingTools/TrajectoryState/interface/TrajectoryStateTransform.h"
+#include "TrackPropagation/RungeKutta/interface/defaultRKPropagator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+class RKBatchBenchmark : public edm::one::EDAnalyzer<> {
+public:
+  explicit RKBatchBenchmark(const edm::ParameterSet& pset);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  void analyze(const edm::Event& event, const edm::EventSetup& setup) override;
+  void endJob() override;
+
+private:
+  Surface::RotationType rotation(const GlobalVector& zDir) const;
+
+  const edm::EDGetTokenT<reco::TrackCollection> tracksToken_;
+  const edm::ESGetToken<MagneticField, IdealMagneticFieldRecord> fieldToken_;
+  const std::vector<double> distances_;
+  const double tolerance_;
+
+  unsigned long long nPropagations_ = 0;
+  unsigned long long nDifferent_ = 0;
+  double scalarTime_ = 0;
+  double batchTime_ = 0;
+  double maxDistance_ = 0;
+};
+
+RKBatchBenchmark::RKBatchBenchmark(const edm::ParameterSet& pset)
+    : tracksToken_(consumes<reco::TrackCollection>(pset.getParameter<edm::InputTag>("tracks"))),
+      fieldToken_(esConsumes<MagneticField, IdealMagneticFieldRecord>()),
+      distances_(pset.getParameter<std::vector<double>>("distances")),
+      tolerance_(pset.getParameter<double>("tolerance")) {}
+
+void RKBatchBenchmark::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("tracks", edm::InputTag("generalTracks"));
+  desc.add<std::vector<double>>("distances", {10., 50., 100., 200.})->setComment("in cm, along the initial direction");
+  desc.add<double>("tolerance", 5.e-5);
+  descriptions.add("rkBatchBenchmark", desc);
+}
+
+void RKBatchBenchmark::analyze(const edm::Event& event, const edm::EventSetup& setup) {
+  const MagneticField* field = &setup.getData(fieldToken_);
+  const auto& tracks = event.get(tracksToken_);
+
+  defaultRKPropagator::Product prod(field, alongMomentum, tolerance_);
+  const auto& propagator = prod.propagator;
+  const Propagator& scalarPropagator = prod.propagator;
+
+  std::vector<FreeTrajectoryState> states;
+  std::vector<Plane::PlanePointer> planes;
+  for (const auto& track : tracks) {
+    FreeTrajectoryState fts = trajectoryStateTransform::initialFreeState(track, field);
+    for (double d : distances_) {
+      GlobalVector dir = fts.momentum().unit();
+      states.push_back(fts);
+      planes.push_back(Plane::build(fts.position() + d * dir, rotation(dir)));
+    }
+  }
+  const int n = states.size();
+  std::vector<const Plane*> targets;
+  for (const auto& plane : planes)
+    targets.push_back(plane.get());
+
+  std::vector<std::pair<TrajectoryStateOnSurface, double>> scalar(n), batch(n);
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; ++i)
+    scalar[i] = scalarPropagator.propagateWithPath(states[i], *targets[i]);
+  auto middle = std::chrono::steady_clock::now();
+  propagator.propagateWithPath(states.data(), targets.data(), batch.data(), n);
+  auto stop = std::chrono::steady_clock::now();
+
+  scalarTime_ += std::chrono::duration<double, std::milli>(middle - start).count();
+  batchTime_ += std::chrono::duration<double, std::milli>(stop - middle).count();
+  nPropagations_ += n;
+  for (int i = 0; i < n; ++i) {
+    if (scalar[i].first.isValid() != batch[i].first.isValid()) {
+      ++nDifferent_;
+      continue;
+    }
+    if (!scalar[i].first.isValid())
+      continue;
+    double distance = (scalar[i].first.globalPosition() - batch[i].first.globalPosition()).mag();
+    if (distance != 0 || scalar[i].second != batch[i].second)
+      ++nDifferent_;
+    maxDistance_ = std::max(maxDistance_, distance);
+  }
+}
+
+void RKBatchBenchmark::endJob() {
+  edm::LogPrint("RKBatchBenchmark") << "propagations: " << nPropagations_ << "\n"
+                                    << "one at a time: " << scalarTime_ << " ms\n"
+                                    << "batched:       " << batchTime_ << " ms\n"
+                                    << "different results: " << nDifferent_
+                                    << ", largest distance between the two: " << maxDistance_ << " cm";
+}
+
+Surface::RotationType RKBatchBenchmark::rotation(const GlobalVector& zDir) const {
+  GlobalVector zAxis = zDir.unit();
+  GlobalVector yAxis(zAxis.y(), -zAxis.x(), 0);
+  GlobalVector xAxis = yAxis.cross(zAxis);
+  return Surface::RotationType(xAxis, yAxis, zAxis);
+}
+
+DEFINE_FWK_MODULE(RKBatchBenchmark);
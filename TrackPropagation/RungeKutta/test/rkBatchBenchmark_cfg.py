@@ -0,0 +1,33 @@
+#
+# Timing of the batched Runge-Kutta propagation against the propagation of one track at a time,
+# on the tracks of a RECO or AOD file:
+#
+#   cmsRun rkBatchBenchmark_cfg.py inputFiles=file:step3.root
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.parseArguments()
+
+process = cms.Process("RKBATCHBENCHMARK")
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:phase1_2018_realistic', '')
+
+process.rkBatchBenchmark = cms.EDAnalyzer("RKBatchBenchmark",
+    tracks = cms.InputTag("generalTracks"),
+    distances = cms.vdouble(10., 50., 100., 200.),
+    tolerance = cms.double(5.e-5)
+)
+
+process.p = cms.Path(process.rkBatchBenchmark)
@@ -42,6 +42,18 @@ public:
    */
   virtual HitReturnType estimate(const TrajectoryStateOnSurface& ts, const TrackingRecHit& hit) const = 0;
 
+  /** Estimates n RecHits on the surface of the TrajectoryStateOnSurface in one call:
+   *  result[i] is the same as estimate(ts, *hits[i]). The default calls estimate
+   *  for each hit; estimators that can evaluate several hits at once override it.
+   */
+  virtual void estimateBatch(const TrajectoryStateOnSurface& ts,
+                             const TrackingRecHit* const* hits,
+                             HitReturnType* result,
+                             int n) const {
+    for (int i = 0; i < n; ++i)
+      result[i] = estimate(ts, *hits[i]);
+  }
+
   /* verify the compatibility of the Hit with the Trajectory based
    * on hit properties other than those used in estimate 
    * (that usually computes the compatibility of the Trajectory with the Hit)
@@ -18,6 +18,12 @@ public:
 
   std::pair<bool, double> estimate(const TrajectoryStateOnSurface&, const TrackingRecHit&) const override;
 
+  /// The hits of dimension 1 and 2 are estimated together, the others one at a time.
+  void estimateBatch(const TrajectoryStateOnSurface&,
+                     const TrackingRecHit* const* hits,
+                     HitReturnType* result,
+                     int n) const override;
+
   Chi2MeasurementEstimator* clone() const override { return new Chi2MeasurementEstimator(*this); }
 };
 
@@ -37,6 +37,12 @@ public:
 
   TrajectoryStateOnSurface update(const TrajectoryStateOnSurface&, const TrackingRecHit&) const override;
 
+  /// The states updated with hits of dimension 1 and 2 are computed together, the others one at a time.
+  void updateBatch(const TrajectoryStateOnSurface* const* tsos,
+                   const TrackingRecHit* const* hits,
+                   TrajectoryStateOnSurface* result,
+                   int n) const override;
+
   KFUpdator* clone() const override { return new KFUpdator(*this); }
 };
 
@@ -5,6 +5,8 @@
 #include "DataFormats/GeometrySurface/interface/Plane.h"
 #include "DataFormats/Math/interface/invertPosDefMatrix.h"
 
+#include <algorithm>
+
 namespace {
   template <unsigned int D>
   double lestimate(const TrajectoryStateOnSurface& tsos, const TrackingRecHit& aRecHit) {
@@ -27,6 +29,60 @@ namespace {
     invertPosDefMatrix(R);
     return ROOT::Math::Similarity(r - rMeas, R);
   }
+
+  // Same as lestimate for the hits[which[i]], i < n, all of dimension D (1 or 2): the components
+  // are taken from each hit, then the chi2 are computed in a loop over the hits, on the
+  // residuals and their covariance laid out as structure of arrays.
+  template <unsigned int D>
+  void lestimateBatch(const TrajectoryStateOnSurface& tsos,
+                      const TrackingRecHit* const* hits,
+                      const int* which,
+                      int n,
+                      double* chi2) {
+    typedef typename AlgebraicROOTObject<D, D>::SymMatrix SMatDD;
+    typedef typename AlgebraicROOTObject<D>::Vector VecD;
+    using ROOT::Math::SMatrixNoInit;
+    constexpr int chunk = 32;
+    constexpr int S = D * (D + 1) / 2;
+
+    auto&& v = tsos.localParameters().vector();
+    auto&& m = tsos.localError().matrix();
+    for (int first = 0; first < n; first += chunk) {
+      const int k = std::min(chunk, n - first);
+      double res[D][chunk];
+      double cov[S][chunk];
+      for (int l = 0; l < k; ++l) {
+        VecD r, rMeas;
+        SMatDD R(SMatrixNoInit{}), RMeas(SMatrixNoInit{});
+        ProjectMatrix<double, 5, D> dummyProjFunc;
+        KfComponentsHolder holder;
+        holder.template setup<D>(&r, &R, &dummyProjFunc, &rMeas, &RMeas, v, m);
+        hits[which[first + l]]->getKfComponents(holder);
+        for (unsigned int i = 0; i < D; ++i)
+          res[i][l] = r(i) - rMeas(i);
+        for (int i = 0; i < S; ++i)
+          cov[i][l] = R.Array()[i] + RMeas.Array()[i];
+      }
+      // as invertPosDefMatrix and Similarity
+      double* out = chi2 + first;
+      if constexpr (D == 1) {
+        for (int l = 0; l < k; ++l)
+          out[l] = res[0][l] * ((1. / cov[0][l]) * res[0][l]);
+      } else {
+        for (int l = 0; l < k; ++l) {
+          double c0 = 1. / cov[0][l];
+          double c1 = cov[1][l] * cov[1][l] * c0;
+          double c2 = 1. / (cov[2][l] - c1);
+          double i00 = c1 * c0 * c2 + c0;
+          double i10 = -cov[1][l] * c0 * c2;
+          double i11 = c2;
+          double t0 = i00 * res[0][l] + i10 * res[1][l];
+          double t1 = i10 * res[0][l] + i11 * res[1][l];
+          out[l] = res[0][l] * t0 + res[1][l] * t1;
+        }
+      }
+    }
+  }
 }  // namespace
 
 std::pair<bool, double> Chi2MeasurementEstimator::estimate(const TrajectoryStateOnSurface& tsos,
@@ -45,3 +101,34 @@ std::pair<bool, double> Chi2MeasurementEstimator::estimate(const TrajectoryState
   }
   throw cms::Exception("RecHit of invalid size (not 1,2,3,4,5)");
 }
+
+void Chi2MeasurementEstimator::estimateBatch(const TrajectoryStateOnSurface& tsos,
+                                             const TrackingRecHit* const* hits,
+                                             HitReturnType* result,
+                                             int n) const {
+  constexpr int chunk = 64;
+  int which1[chunk], which2[chunk];
+  double chi2[chunk];
+  for (int first = 0; first < n; first += chunk) {
+    const int k = std::min(chunk, n - first);
+    int n1 = 0, n2 = 0;
+    for (int i = first; i < first + k; ++i) {
+      switch (hits[i]->dimension()) {
+        case 1:
+          which1[n1++] = i;
+          break;
+        case 2:
+          which2[n2++] = i;
+          break;
+        default:
+          result[i] = estimate(tsos, *hits[i]);
+      }
+    }
+    lestimateBatch<1>(tsos, hits, which1, n1, chi2);
+    for (int l = 0; l < n1; ++l)
+      result[which1[l]] = returnIt(chi2[l]);
+    lestimateBatch<2>(tsos, hits, which2, n2, chi2);
+    for (int l = 0; l < n2; ++l)
+      result[which2[l]] = returnIt(chi2[l]);
+  }
+}
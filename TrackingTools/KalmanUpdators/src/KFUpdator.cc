@@ -7,6 +7,8 @@
 #include "DataFormats/Math/interface/invertPosDefMatrix.h"
 #include "DataFormats/Math/interface/ProjectMatrix.h"
 
+#include <algorithm>
+
 // test of joseph form
 #ifdef KU_JF_TEST
 
@@ -172,6 +174,135 @@ namespace {
       return TrajectoryStateOnSurface();
     }
   }
+
+  // Same as lupdate for the tsos[which[i]] and hits[which[i]], i < n, all hits of dimension D
+  // (1 or 2). The components are taken from each hit, then the filtered states are computed
+  // in loops over the states, on the parameters, covariances and gains laid out as structure
+  // of arrays. The matrix products accumulate in the same order as the SMatrix ones.
+  template <unsigned int D>
+  void lupdateBatch(const TrajectoryStateOnSurface* const* tsos,
+                    const TrackingRecHit* const* hits,
+                    const int* which,
+                    int n,
+                    TrajectoryStateOnSurface* result) {
+    typedef typename AlgebraicROOTObject<D, D>::SymMatrix SMatDD;
+    typedef typename AlgebraicROOTObject<D>::Vector VecD;
+    using ROOT::Math::SMatrixNoInit;
+    constexpr int chunk = 16;
+    constexpr int S = D * (D + 1) / 2;
+    // index in the array of a symmetric matrix, as in MatRepSym
+    auto sym = [](int i, int j) { return i > j ? i * (i + 1) / 2 + j : j * (j + 1) / 2 + i; };
+
+    double x[5][chunk], C[5][5][chunk], M[5][5][chunk];
+    double r[D][chunk], V[S][chunk], R[S][chunk], K[5][D][chunk];
+    double MC[5][5][chunk], KV[5][D][chunk], fsv[5][chunk], fse[15][chunk];
+
+    for (int first = 0; first < n; first += chunk) {
+      const int k = std::min(chunk, n - first);
+      for (int l = 0; l < k; ++l) {
+        const TrajectoryStateOnSurface& ts = *tsos[which[first + l]];
+        auto&& lx = ts.localParameters().vector();
+        auto&& lC = ts.localError().matrix();
+        ProjectMatrix<double, 5, D> pf;
+        VecD lr, rMeas;
+        SMatDD lV(SMatrixNoInit{}), VMeas(SMatrixNoInit{});
+        KfComponentsHolder holder;
+        holder.template setup<D>(&lr, &lV, &pf, &rMeas, &VMeas, lx, lC);
+        hits[which[first + l]]->getKfComponents(holder);
+
+        for (int i = 0; i < 5; ++i) {
+          x[i][l] = lx(i);
+          for (int j = 0; j < 5; ++j)
+            C[i][j][l] = lC(i, j);
+        }
+        for (unsigned int i = 0; i < D; ++i)
+          r[i][l] = lr(i) - rMeas(i);
+        for (int i = 0; i < S; ++i) {
+          V[i][l] = lV.Array()[i];
+          R[i][l] = lV.Array()[i] + VMeas.Array()[i];
+        }
+        // invert R as invertPosDefMatrix
+        if constexpr (D == 1) {
+          R[0][l] = 1. / R[0][l];
+        } else {
+          double c0 = 1. / R[0][l];
+          double c1 = R[1][l] * R[1][l] * c0;
+          double c2 = 1. / (R[2][l] - c1);
+          R[0][l] = c1 * c0 * c2 + c0;
+          R[1][l] = -R[1][l] * c0 * c2;
+          R[2][l] = c2;
+        }
+        // Kalman gain, only the columns pf.index of C contribute to C * pf.project(R)
+        for (int i = 0; i < 5; ++i)
+          for (unsigned int j = 0; j < D; ++j) {
+            double kij = C[i][pf.index[0]][l] * R[sym(0, j)][l];
+            for (unsigned int a = 1; a < D; ++a)
+              kij += C[i][pf.index[a]][l] * R[sym(a, j)][l];
+            K[i][j][l] = kij;
+          }
+        // M = 1 - K * H
+        for (int i = 0; i < 5; ++i)
+          for (int j = 0; j < 5; ++j)
+            M[i][j][l] = i == j ? 1. : 0.;
+        for (int i = 0; i < 5; ++i)
+          for (unsigned int j = 0; j < D; ++j)
+            M[i][pf.index[j]][l] -= K[i][j][l];
+      }
+
+      // filtered state vector
+      for (int i = 0; i < 5; ++i)
+        for (int l = 0; l < k; ++l) {
+          double kr = K[i][0][l] * r[0][l];
+          for (unsigned int a = 1; a < D; ++a)
+            kr += K[i][a][l] * r[a][l];
+          fsv[i][l] = x[i][l] + kr;
+        }
+
+      // Joseph form: M * C * M^T + K * V * K^T
+      for (int i = 0; i < 5; ++i)
+        for (int j = 0; j < 5; ++j)
+          for (int l = 0; l < k; ++l) {
+            double s = M[i][0][l] * C[0][j][l];
+            for (int a = 1; a < 5; ++a)
+              s += M[i][a][l] * C[a][j][l];
+            MC[i][j][l] = s;
+          }
+      for (int i = 0; i < 5; ++i)
+        for (unsigned int j = 0; j < D; ++j)
+          for (int l = 0; l < k; ++l) {
+            double s = K[i][0][l] * V[sym(0, j)][l];
+            for (unsigned int a = 1; a < D; ++a)
+              s += K[i][a][l] * V[sym(a, j)][l];
+            KV[i][j][l] = s;
+          }
+      for (int i = 0; i < 5; ++i)
+        for (int j = 0; j <= i; ++j)
+          for (int l = 0; l < k; ++l) {
+            double s = MC[i][0][l] * M[j][0][l];
+            for (int a = 1; a < 5; ++a)
+              s += MC[i][a][l] * M[j][a][l];
+            double t = KV[i][0][l] * K[j][0][l];
+            for (unsigned int a = 1; a < D; ++a)
+              t += KV[i][a][l] * K[j][a][l];
+            fse[sym(i, j)][l] = s + t;
+          }
+
+      for (int l = 0; l < k; ++l) {
+        const TrajectoryStateOnSurface& ts = *tsos[which[first + l]];
+        AlgebraicVector5 lfsv;
+        for (int i = 0; i < 5; ++i)
+          lfsv(i) = fsv[i][l];
+        AlgebraicSymMatrix55 lfse(SMatrixNoInit{});
+        for (int i = 0; i < 15; ++i)
+          lfse.Array()[i] = fse[i][l];
+        result[which[first + l]] = TrajectoryStateOnSurface(LocalTrajectoryParameters(lfsv, ts.localParameters().pzSign()),
+                                                            LocalTrajectoryError(lfse),
+                                                            ts.surface(),
+                                                            &(ts.globalParameters().magneticField()),
+                                                            ts.surfaceSide());
+      }
+    }
+  }
 }  // namespace
 
 TrajectoryStateOnSurface KFUpdator::update(const TrajectoryStateOnSurface& tsos, const TrackingRecHit& aRecHit) const {
@@ -190,3 +321,29 @@ TrajectoryStateOnSurface KFUpdator::update(const TrajectoryStateOnSurface& tsos,
   throw cms::Exception("Rec hit of invalid dimension (not 1,2,3,4,5)")
       << "The value was " << aRecHit.dimension() << ", type is " << typeid(aRecHit).name() << "\n";
 }
+
+void KFUpdator::updateBatch(const TrajectoryStateOnSurface* const* tsos,
+                            const TrackingRecHit* const* hits,
+                            TrajectoryStateOnSurface* result,
+                            int n) const {
+  constexpr int chunk = 64;
+  int which1[chunk], which2[chunk];
+  for (int first = 0; first < n; first += chunk) {
+    const int k = std::min(chunk, n - first);
+    int n1 = 0, n2 = 0;
+    for (int i = first; i < first + k; ++i) {
+      switch (hits[i]->dimension()) {
+        case 1:
+          which1[n1++] = i;
+          break;
+        case 2:
+          which2[n2++] = i;
+          break;
+        default:
+          result[i] = update(*tsos[i], *hits[i]);
+      }
+    }
+    lupdateBatch<1>(tsos, hits, which1, n1, result);
+    lupdateBatch<2>(tsos, hits, which2, n2, result);
+  }
+}
@@ -82,6 +82,8 @@ void print(TrajectoryStateOnSurface const& ts) {
 }
 
 #include "FWCore/Utilities/interface/HRRealTime.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <vector>
 
@@ -213,5 +215,48 @@ int main() {
   chi2.time(ts, *thit);
   chi2.time(ts2, *thit);
 
-  return 0;
+  std::cout << "\n** Batched ** \n" << std::endl;
+
+  // the batched estimate and update must give the same results as the single ones
+  int nFail = 0;
+  const TrackingRecHit* hits[] = {thit, &hit2d, &hitpx, &hitpj, &hit1d, thit, &hit1d, &hitpx};
+  constexpr int nHits = sizeof(hits) / sizeof(hits[0]);
+  KFUpdator kfu;
+  Chi2MeasurementEstimator est(10.);
+  for (auto const* tsos : {&ts, &ts2}) {
+    MeasurementEstimator::HitReturnType estimates[nHits];
+    est.estimateBatch(*tsos, hits, estimates, nHits);
+    const TrajectoryStateOnSurface* states[nHits];
+    for (auto& state : states)
+      state = tsos;
+    TrajectoryStateOnSurface updated[nHits];
+    kfu.updateBatch(states, hits, updated, nHits);
+
+    for (int i = 0; i < nHits; ++i) {
+      auto single = est.estimate(*tsos, *hits[i]);
+      if (single != estimates[i]) {
+        std::cout << "chi2 of hit " << i << ": " << single.second << " one at a time, " << estimates[i].second
+                  << " batched" << std::endl;
+        ++nFail;
+      }
+      TrajectoryStateOnSurface up = kfu.update(*tsos, *hits[i]);
+      auto dv = up.localParameters().vector() - updated[i].localParameters().vector();
+      auto dm = up.localError().matrix() - updated[i].localError().matrix();
+      double maxDiff = 0;
+      for (int j = 0; j < 5; ++j) {
+        maxDiff = std::max(maxDiff, std::abs(dv(j)) / (std::abs(up.localParameters().vector()(j)) + 1.e-30));
+        for (int k = 0; k <= j; ++k)
+          maxDiff = std::max(maxDiff, std::abs(dm(j, k)) / (std::abs(up.localError().matrix()(j, k)) + 1.e-30));
+      }
+      if (maxDiff > 1.e-12) {
+        std::cout << "update with hit " << i << " differs by " << maxDiff << std::endl;
+        print(up);
+        print(updated[i]);
+        ++nFail;
+      }
+    }
+  }
+  std::cout << (nFail == 0 ? "batched results ok" : "batched results differ") << std::endl;
+
+  return nFail;
 }
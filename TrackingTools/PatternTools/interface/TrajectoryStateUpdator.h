@@ -18,6 +18,18 @@ public:
 
   virtual TrajectoryStateOnSurface update(const TrajectoryStateOnSurface&, const TrackingRecHit&) const = 0;
 
+  /** Updates n states in one call: result[i] is the same as update(*tsos[i], *hits[i]).
+   *  The default calls update for each state; updators that can combine several
+   *  states at once override it.
+   */
+  virtual void updateBatch(const TrajectoryStateOnSurface* const* tsos,
+                           const TrackingRecHit* const* hits,
+                           TrajectoryStateOnSurface* result,
+                           int n) const {
+    for (int i = 0; i < n; ++i)
+      result[i] = update(*tsos[i], *hits[i]);
+  }
+
   virtual TrajectoryStateUpdator* clone() const = 0;
 };
 